@@ -0,0 +1,43 @@
+// Verifica se a macro FRAME_SCHEDULER_H já foi definida
+#ifndef FRAME_SCHEDULER_H
+// Define a macro FRAME_SCHEDULER_H para evitar múltiplas inclusões
+#define FRAME_SCHEDULER_H
+
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico (repeating_timer, time_us_64)
+
+#define FRAME_SCHEDULER_MAX_CATCH_UP 8 // Máximo de atualizações executadas de uma vez para recuperar atraso (o excedente é descartado)
+
+typedef void (*frame_callback_t)(void *user_data); // Assinatura das funções de atualização e de renderização
+
+// Estatísticas de tempo dos frames (tempo de um frame = atualizações pendentes + renderização)
+typedef struct {
+    uint32_t frames; // Número de frames renderizados
+    uint32_t updates; // Número de atualizações (passos de tempo fixo) executadas
+    uint32_t skipped_renders; // Renderizações puladas porque ainda havia atualizações atrasadas
+    uint32_t dropped_ticks; // Passos de tempo descartados por excederem FRAME_SCHEDULER_MAX_CATCH_UP
+    uint32_t overruns; // Frames que excederam o orçamento de tempo (1 / fps)
+    uint32_t min_us; // Menor tempo de frame
+    uint32_t max_us; // Maior tempo de frame
+    uint64_t total_us; // Soma dos tempos de frame (média = total_us / frames)
+} frame_stats_t;
+
+// Escalonador de frames: atualizações em passo de tempo fixo disparadas por temporizador e renderização limitada ao fps alvo
+typedef struct {
+    frame_callback_t update; // Função chamada a cada passo de tempo fixo (lógica e animação)
+    frame_callback_t render; // Função chamada no máximo "fps" vezes por segundo (envio do buffer ao display)
+    void *user_data; // Argumento repassado às duas funções
+    uint32_t tick_us; // Período do passo de tempo fixo
+    uint32_t frame_us; // Orçamento de tempo de cada frame
+    bool skip_when_behind; // Pula a renderização enquanto houver atualizações atrasadas
+    uint64_t next_render_us; // Instante da próxima renderização
+    volatile uint32_t pending_ticks; // Passos de tempo sinalizados pelo temporizador e ainda não executados
+    repeating_timer_t timer; // Temporizador que gera os passos de tempo
+    frame_stats_t stats; // Estatísticas acumuladas
+} frame_scheduler_t;
+
+bool frame_scheduler_init(frame_scheduler_t *scheduler, uint update_hz, uint render_fps, frame_callback_t update, frame_callback_t render, void *user_data); // Configura o escalonador e inicia o temporizador
+void frame_scheduler_set_skip(frame_scheduler_t *scheduler, bool skip_when_behind); // Habilita ou desabilita o descarte de renderizações quando atrasado
+void frame_scheduler_run_once(frame_scheduler_t *scheduler); // Executa as atualizações pendentes, renderiza se chegou a hora e dorme até o próximo evento (a renderização é verificada a cada passo, então update_hz deve ser >= render_fps)
+void frame_scheduler_get_stats(frame_scheduler_t *scheduler, frame_stats_t *stats, bool reset); // Copia as estatísticas (e opcionalmente as reinicia)
+
+#endif // Fim da diretiva de inclusão condicional
@@ -4,6 +4,7 @@
 #include "hardware/adc.h" // Biblioteca para manipulação de ADCs
 #include "hardware/i2c.h" // Biblioteca para comunicação I2C
 #include "inc/ssd1306.h" // Biblioteca para controle do display OLED
+#include "inc/frame_scheduler.h" // Escalonador de frames com passo de tempo fixo
 
 #define JOYSTICK_X_PIN 27 // Pino do Eixo X do Joystick
 #define JOYSTICK_Y_PIN 26 // Pino do Eixo Y do Joystick
@@ -11,6 +12,12 @@
 #define ADC_CHANNEL_Y 0 // Canal do ADC para o Eixo Y
 #define OLED_SDA 14 // Pino SDA do display OLED
 #define OLED_SCL 15 // Pino SCL do display OLED
+#define SAMPLE_RATE_HZ 100 // Frequência de leitura do joystick
+#define RENDER_FPS 10 // Taxa de atualização do display (cada atualização exibe a média das leituras do período)
+
+uint32_t x_sum = 0; // Soma das leituras do Eixo X desde a última atualização do display
+uint32_t y_sum = 0; // Soma das leituras do Eixo Y desde a última atualização do display
+uint32_t n_samples = 0; // Número de leituras acumuladas
 
 uint8_t ssd[ssd1306_buffer_length]; // Buffer global para a configuração e manipulação do display OLED
 
@@ -77,6 +84,28 @@ void message_display( uint x_axis, uint y_axis) {
     show_message(y_value, 16, 49, false); // Exibe o valor do Eixo Y no display OLED
 }
 
+// Passo de tempo fixo: lê os dois eixos do joystick e acumula para a média exibida no próximo frame
+void sample_joystick(void *user_data) {
+    adc_select_input(ADC_CHANNEL_X); // Seleciona o canal ADC 1 (conectado ao Eixo X do Joystick)
+    x_sum += adc_read(); // Lê o valor convertido do ADC para o Eixo X (0 a 4095)
+
+    adc_select_input(ADC_CHANNEL_Y); // Seleciona o canal ADC 0 (conectado ao Eixo Y do Joystick)
+    y_sum += adc_read(); // Lê o valor convertido do ADC para o Eixo Y (0 a 4095)
+
+    n_samples++;
+}
+
+// Renderização: exibe a média das leituras acumuladas desde o último frame
+void render_joystick(void *user_data) {
+    if (n_samples == 0) {
+        return;
+    }
+    message_display(x_sum / n_samples, y_sum / n_samples); // Exibe os valores lidos e convertidos dos Eixos X e Y no display OLED
+    x_sum = 0;
+    y_sum = 0;
+    n_samples = 0;
+}
+
 int main()
 {
     stdio_init_all(); // Inicializa a entrada e saída padrão do sistema, permitindo a comunicação com o terminal via USB ou UART
@@ -85,16 +114,11 @@ int main()
     adc_gpio_init(JOYSTICK_X_PIN); // Configura o pino GPIO 27 (Eixo X do Joystick) como entrada analógica
     adc_gpio_init(JOYSTICK_Y_PIN); // Configura o pino GPIO 26 (Eixo Y do Joystick) como entrada analógica
 
-    while (true) {
-        
-        adc_select_input(ADC_CHANNEL_X); // Seleciona o canal ADC 1 (conectado ao Eixo X do Joystick)
-        uint x_val = adc_read(); // Lê o valor convertido do ADC para o Eixo X (0 a 4095)
-
-        adc_select_input(ADC_CHANNEL_Y); // Seleciona o canal ADC 0 (conectado ao Eixo Y do Joystick)
-        uint y_val = adc_read(); // Lê o valor convertido do ADC para o Eixo Y (0 a 4095)
-
-        message_display(x_val, y_val); // Exibe os valores lidos e convertidos dos Eixos X e Y no display OLED
+    // A leitura ocorre em taxa fixa e o display é atualizado em RENDER_FPS, independente do tempo gasto no envio pelo I2C
+    frame_scheduler_t scheduler;
+    frame_scheduler_init(&scheduler, SAMPLE_RATE_HZ, RENDER_FPS, sample_joystick, render_joystick, NULL);
 
-        sleep_ms(100); // Pausa o programa por 100 milissegundos antes de ler novamente
+    while (true) {
+        frame_scheduler_run_once(&scheduler); // Executa as leituras pendentes e atualiza o display quando chegar a hora
     }
 }
@@ -0,0 +1,69 @@
+#ifndef CBOR_H
+#define CBOR_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// CBOR (RFC 8949) sem alocação, só o necessário para mensagens pequenas de telemetria: inteiros, texto, booleanos,
+// arrays e mapas de tamanho definido. Leitura de mapas com chaves inteiras para uma struct descrita por uma tabela,
+// como json_parse_object(); itens desconhecidos (inclusive floats, tags e aninhados) são pulados
+
+#define CBOR_MAJOR_UINT 0
+#define CBOR_MAJOR_NEGATIVE 1
+#define CBOR_MAJOR_BYTES 2
+#define CBOR_MAJOR_TEXT 3
+#define CBOR_MAJOR_ARRAY 4
+#define CBOR_MAJOR_MAP 5
+#define CBOR_MAJOR_TAG 6
+#define CBOR_MAJOR_SIMPLE 7 // false, true, null, floats
+
+// Escritor: grava direto no buffer de destino; ao faltar espaço, marca overflow e para de escrever
+typedef struct {
+    uint8_t *buffer;
+    size_t size;
+    size_t len;
+    bool overflow;
+} cbor_writer_t;
+
+void cbor_writer_init(cbor_writer_t *w, uint8_t *buffer, size_t size);
+void cbor_write_uint(cbor_writer_t *w, uint64_t value);
+void cbor_write_int(cbor_writer_t *w, int64_t value);
+void cbor_write_bool(cbor_writer_t *w, bool value);
+void cbor_write_text(cbor_writer_t *w, const char *text);
+void cbor_begin_array(cbor_writer_t *w, uint32_t count); // Seguido de "count" itens
+void cbor_begin_map(cbor_writer_t *w, uint32_t count); // Seguido de "count" pares chave/valor
+size_t cbor_writer_finish(cbor_writer_t *w); // Tamanho gravado, ou 0 em overflow
+
+// Leitor
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+} cbor_reader_t;
+
+void cbor_reader_init(cbor_reader_t *r, const uint8_t *data, size_t len);
+bool cbor_read_head(cbor_reader_t *r, uint8_t *major, uint64_t *argument); // Cabeçalho de um item (tamanho indefinido não é aceito)
+bool cbor_read_int(cbor_reader_t *r, int64_t *value); // Inteiro com ou sem sinal que caiba em int64_t
+bool cbor_skip(cbor_reader_t *r); // Pula um item inteiro, com os aninhados
+
+// Campos de um mapa com chaves inteiras
+typedef enum {
+    CBOR_FIELD_INT, // int32_t (também ponto fixo: a escala fica definida pelo esquema, não pelo fio)
+    CBOR_FIELD_UINT, // uint32_t
+    CBOR_FIELD_BOOL, // bool
+    CBOR_FIELD_TEXT, // char[size], terminado em '\0'
+} cbor_field_type_t;
+
+typedef struct {
+    uint32_t key;
+    uint8_t type; // cbor_field_type_t
+    bool required;
+    uint16_t offset; // offsetof() na struct
+    uint16_t size; // Capacidade (CBOR_FIELD_TEXT)
+} cbor_field_t;
+
+// Lê um mapa completo (nada pode sobrar depois dele) para a struct
+bool cbor_parse_map(const uint8_t *data, size_t len, const cbor_field_t *fields, size_t count, void *out);
+// Array de mapas para structs consecutivas ("stride" bytes cada); retorna quantos elementos, ou -1
+int cbor_parse_array(const uint8_t *data, size_t len, const cbor_field_t *fields, size_t count, void *out, size_t stride, size_t max);
+#endif
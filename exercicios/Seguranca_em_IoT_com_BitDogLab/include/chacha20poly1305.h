@@ -0,0 +1,21 @@
+#ifndef CHACHA20POLY1305_H
+#define CHACHA20POLY1305_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// ChaCha20-Poly1305 (RFC 8439) em C portátil: só somas, XOR e rotações de 32 bits, sem tabelas,
+// adequado ao Cortex-M0+ do RP2040, que não tem acelerador de AES
+
+#define CHACHA20POLY1305_KEY_BYTES 32
+#define CHACHA20POLY1305_NONCE_BYTES 12
+#define CHACHA20POLY1305_TAG_BYTES 16
+
+// Cifra "data" no próprio buffer e calcula a etiqueta de autenticação sobre "aad" (dados autenticados, não cifrados) e o texto cifrado
+void chacha20poly1305_encrypt(const uint8_t key[CHACHA20POLY1305_KEY_BYTES], const uint8_t nonce[CHACHA20POLY1305_NONCE_BYTES],
+                              const uint8_t *aad, size_t aad_len, uint8_t *data, size_t len, uint8_t tag[CHACHA20POLY1305_TAG_BYTES]);
+
+// Confere a etiqueta e, só se ela for válida, decifra "data" no próprio buffer; retorna false (dados intactos) se a mensagem foi alterada
+bool chacha20poly1305_decrypt(const uint8_t key[CHACHA20POLY1305_KEY_BYTES], const uint8_t nonce[CHACHA20POLY1305_NONCE_BYTES],
+                              const uint8_t *aad, size_t aad_len, uint8_t *data, size_t len, const uint8_t tag[CHACHA20POLY1305_TAG_BYTES]);
+#endif
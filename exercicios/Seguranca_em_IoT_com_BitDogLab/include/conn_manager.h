@@ -0,0 +1,103 @@
+#ifndef CONN_MANAGER_H
+#define CONN_MANAGER_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Gerenciador de conexão sem bloqueio: Wi-Fi (associação e DHCP), conexão MQTT e assinaturas, com reconexão automática.
+// conn_poll(), chamada no laço principal, avança uma máquina de estados; nada espera com sleep_ms(). Cada falha
+// (tempo esgotado, recusa do broker, queda do Wi-Fi ou do MQTT) leva a uma espera exponencial com sorteio antes da
+// próxima tentativa, e as assinaturas registradas são refeitas a cada conexão.
+// As publicações não passam por aqui: a fila de saída (outbox.h) espera o estado CONN_ONLINE para enviar.
+//
+// Não depende do lwIP nem do driver do Wi-Fi (testado no computador): as operações reais ficam em conn_ops_t
+// (mqtt_comm.c e wifi_conn.c), e os callbacks do lwIP só avisam os eventos com conn_event_*().
+
+#define CONN_MAX_SUBSCRIPTIONS 4
+
+typedef enum {
+    CONN_IDLE, // Antes de conn_start()
+    CONN_WIFI_JOINING, // Associando ao ponto de acesso
+    CONN_WIFI_DHCP, // Associado, esperando o endereço IP
+    CONN_MQTT_CONNECTING, // CONNECT enviado, esperando o CONNACK
+    CONN_MQTT_SUBSCRIBING, // Refazendo as assinaturas, uma por vez
+    CONN_ONLINE,
+    CONN_BACKOFF, // Esperando para tentar de novo
+} conn_state_t;
+
+// Estado do enlace Wi-Fi, como o driver informa
+typedef enum {
+    CONN_LINK_DOWN,
+    CONN_LINK_JOINING,
+    CONN_LINK_NOIP, // Associado, sem IP ainda
+    CONN_LINK_UP, // Com IP
+    CONN_LINK_FAIL, // Senha errada, rede não encontrada etc.
+} conn_link_t;
+
+// Operações reais; as de início só disparam a ação (o resultado chega por wifi_status ou pelos eventos)
+typedef struct {
+    bool (*wifi_start)(void *arg);
+    void (*wifi_stop)(void *arg);
+    conn_link_t (*wifi_status)(void *arg);
+    bool (*mqtt_start)(void *arg); // Resultado: conn_event_mqtt_up() ou conn_event_mqtt_down()
+    void (*mqtt_stop)(void *arg); // Fecha sem gerar evento
+    bool (*mqtt_subscribe)(const char *topic, uint8_t qos, void *arg); // Resultado: conn_event_subscribed()
+    uint32_t (*random)(void *arg); // Sorteio da espera
+} conn_ops_t;
+
+typedef void (*conn_state_hook_t)(conn_state_t from, conn_state_t to, void *arg);
+
+typedef struct {
+    uint32_t wifi_timeout_ms; // Associação + DHCP
+    uint32_t mqtt_timeout_ms; // CONNACK e cada SUBACK
+    uint32_t backoff_min_ms; // Primeira espera
+    uint32_t backoff_max_ms; // Teto da espera
+} conn_config_t;
+
+typedef struct {
+    uint32_t connects; // Vezes em que ficou ONLINE
+    uint32_t wifi_failures;
+    uint32_t mqtt_failures; // Recusas e tempos esgotados no CONNECT ou nas assinaturas
+    uint32_t drops; // Quedas depois de ONLINE
+} conn_stats_t;
+
+typedef struct {
+    conn_config_t config;
+    const conn_ops_t *ops;
+    void *arg;
+    conn_state_hook_t hook;
+    void *hook_arg;
+
+    conn_state_t state;
+    uint32_t since_ms; // Início do estado atual
+    uint32_t wait_ms; // Espera sorteada (CONN_BACKOFF)
+    uint8_t attempt; // Falhas seguidas (expoente da espera)
+    uint8_t next_subscription; // Próxima assinatura a refazer
+
+    struct {
+        const char *topic;
+        uint8_t qos;
+    } subscriptions[CONN_MAX_SUBSCRIPTIONS];
+    uint8_t subscription_count;
+
+    // Eventos dos callbacks do lwIP: cada contador tem um único escritor (o callback) e o laço principal guarda o último visto
+    volatile uint8_t mqtt_up_posted, mqtt_down_posted, suback_ok_posted, suback_fail_posted;
+    uint8_t mqtt_up_seen, mqtt_down_seen, suback_ok_seen, suback_fail_seen;
+
+    conn_stats_t stats;
+} conn_manager_t;
+
+void conn_init(conn_manager_t *cm, const conn_config_t *config, const conn_ops_t *ops, void *arg);
+void conn_set_hook(conn_manager_t *cm, conn_state_hook_t hook, void *arg); // Chamado a cada troca de estado
+bool conn_subscribe(conn_manager_t *cm, const char *topic, uint8_t qos); // Registra; assina a cada conexão
+void conn_start(conn_manager_t *cm, uint32_t now_ms);
+void conn_poll(conn_manager_t *cm, uint32_t now_ms);
+
+conn_state_t conn_state(const conn_manager_t *cm);
+const char *conn_state_name(conn_state_t state);
+
+// Eventos (podem ser chamados dos callbacks do lwIP)
+void conn_event_mqtt_up(conn_manager_t *cm); // CONNACK aceito
+void conn_event_mqtt_down(conn_manager_t *cm); // Recusado, tempo esgotado ou conexão caiu
+void conn_event_subscribed(conn_manager_t *cm, bool ok); // SUBACK
+#endif
@@ -0,0 +1,84 @@
+#ifndef JSON_H
+#define JSON_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// JSON sem alocação: tokenizador de uma passada (no estilo do jsmn), extração de campos tipados para uma struct
+// descrita por uma tabela, números em ponto fixo (sem float nem strtod) e um escritor para montar as mensagens
+
+// Tokenizador: cada token aponta para um trecho do texto original (nada é copiado)
+typedef enum {
+    JSON_OBJECT = 1,
+    JSON_ARRAY,
+    JSON_STRING, // start/end sem as aspas; escapes não são convertidos
+    JSON_PRIMITIVE, // Número, true, false ou null
+} json_type_t;
+
+typedef struct {
+    uint8_t type; // json_type_t
+    uint16_t start; // Primeiro caractere
+    uint16_t end; // Um depois do último caractere
+    uint16_t size; // Objeto: número de chaves; array: número de elementos; chave: 1
+    int16_t parent; // Índice do token pai (-1 na raiz)
+} json_token_t;
+
+#define JSON_ERROR_NOMEM -1 // Tokens insuficientes
+#define JSON_ERROR_INVALID -2 // Texto inválido
+#define JSON_ERROR_PARTIAL -3 // Texto terminou no meio de um valor
+
+#define JSON_MAX_LENGTH 65535 // Posições em 16 bits
+
+int json_tokenize(const char *js, size_t len, json_token_t *tokens, unsigned max_tokens); // Número de tokens ou JSON_ERROR_*
+
+// Números em ponto fixo: "26.5" com 2 casas vira 2650 (arredondado, sem float)
+bool json_parse_fixed(const char *text, size_t len, uint8_t decimals, int32_t *value);
+size_t json_format_fixed(int32_t value, uint8_t decimals, char *out, size_t size); // Texto de um valor em ponto fixo (como snprintf)
+
+// Descrição dos campos de um objeto: nome, tipo e posição na struct de destino
+typedef enum {
+    JSON_FIELD_FIXED, // int32_t em ponto fixo com "decimals" casas
+    JSON_FIELD_INT, // int32_t
+    JSON_FIELD_UINT, // uint32_t
+    JSON_FIELD_BOOL, // bool
+    JSON_FIELD_STRING, // char[size], terminado em '\0' (escapes simples convertidos)
+} json_field_type_t;
+
+typedef struct {
+    const char *name;
+    uint8_t type; // json_field_type_t
+    uint8_t decimals; // Casas decimais (JSON_FIELD_FIXED)
+    bool required;
+    uint16_t offset; // offsetof() na struct
+    uint16_t size; // Capacidade (JSON_FIELD_STRING)
+} json_field_t;
+
+#define JSON_MAX_TOKENS 32 // Tokens usados por json_parse_object() (na pilha)
+
+// Preenche a struct com os campos do objeto; chaves desconhecidas (com qualquer valor) são ignoradas
+// Retorna false se o texto for inválido, um campo tiver o tipo errado ou estiver fora da faixa, ou faltar um campo obrigatório
+bool json_parse_object(const char *js, size_t len, const json_field_t *fields, size_t count, void *out);
+// Array de objetos para structs consecutivas ("stride" bytes cada); retorna quantos elementos, ou -1
+int json_parse_array(const char *js, size_t len, const json_field_t *fields, size_t count, void *out, size_t stride, size_t max);
+
+// Escritor: monta o texto direto no buffer de destino; ao faltar espaço, marca overflow e para de escrever
+typedef struct {
+    char *buffer;
+    size_t size;
+    size_t len;
+    bool need_comma; // Próximo valor do mesmo nível precisa de vírgula
+    bool overflow;
+} json_writer_t;
+
+void json_writer_init(json_writer_t *w, char *buffer, size_t size);
+void json_begin_object(json_writer_t *w, const char *name); // name NULL dentro de arrays ou na raiz
+void json_end_object(json_writer_t *w);
+void json_begin_array(json_writer_t *w, const char *name);
+void json_end_array(json_writer_t *w);
+void json_write_fixed(json_writer_t *w, const char *name, int32_t value, uint8_t decimals);
+void json_write_int(json_writer_t *w, const char *name, int32_t value);
+void json_write_uint(json_writer_t *w, const char *name, uint32_t value);
+void json_write_bool(json_writer_t *w, const char *name, bool value);
+void json_write_string(json_writer_t *w, const char *name, const char *value);
+size_t json_writer_finish(json_writer_t *w); // Tamanho do texto (terminado em '\0' se couber), ou 0 em overflow
+#endif
@@ -0,0 +1,38 @@
+#ifndef LEITURA_H
+#define LEITURA_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Mensagem do sensor publicada em escola/sala1/temperatura, com o formato em um único lugar para o publisher e o subscriber
+// JSON: {"valor":26.5,"ts":1}                                    (21 bytes)
+// CBOR: mapa {1: 2650, 2: 1} com chaves inteiras, valor em centésimos (a2 01 19 0a 5a 02 01: 7 bytes)
+// O formato é escolhido por tópico no publisher; o subscriber reconhece os dois pelo primeiro byte
+// Lote: array dessas mensagens, [{"valor":26.5,"ts":1},{"valor":26.6,"ts":6}] ou [{1: 2650, 2: 1}, {1: 2660, 2: 6}]
+
+#define LEITURA_DECIMALS 2 // Casas decimais de "valor"
+#define LEITURA_CBOR_VALOR 1 // Chave de "valor" no CBOR (inteiro em centésimos)
+#define LEITURA_CBOR_TS 2 // Chave de "ts" no CBOR
+#define LEITURA_LOTE_MAX 24 // Maior lote aceito pelo subscriber
+
+typedef enum {
+    LEITURA_JSON,
+    LEITURA_CBOR,
+} leitura_formato_t;
+
+typedef struct {
+    int32_t valor; // Leitura em ponto fixo (centésimos: 2650 = 26,50)
+    uint32_t ts; // Timestamp da leitura
+} leitura_t;
+
+size_t leitura_to_json(const leitura_t *leitura, char *out, size_t size); // Tamanho do texto, ou 0 se não couber
+bool leitura_from_json(const char *text, size_t len, leitura_t *leitura); // Aceita espaços, outra ordem e chaves extras
+size_t leitura_to_cbor(const leitura_t *leitura, uint8_t *out, size_t size); // Tamanho gravado, ou 0 se não couber
+bool leitura_from_cbor(const uint8_t *data, size_t len, leitura_t *leitura); // Aceita outra ordem e chaves extras
+
+size_t leitura_encode(leitura_formato_t formato, const leitura_t *leitura, uint8_t *out, size_t size);
+bool leitura_decode(const uint8_t *data, size_t len, leitura_t *leitura, leitura_formato_t *formato); // Reconhece o formato
+size_t leitura_lote_encode(leitura_formato_t formato, const leitura_t *leituras, size_t count, uint8_t *out, size_t size);
+int leitura_lote_decode(const uint8_t *data, size_t len, leitura_t *leituras, size_t max, leitura_formato_t *formato); // Quantas, ou -1
+const char *leitura_formato_nome(leitura_formato_t formato);
+#endif
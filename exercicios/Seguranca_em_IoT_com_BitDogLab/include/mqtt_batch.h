@@ -0,0 +1,59 @@
+#ifndef MQTT_BATCH_H
+#define MQTT_BATCH_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "include/leitura.h"
+#include "include/payload_crypto.h"
+
+// Publicação em lote: as leituras de um tópico se acumulam e saem juntas em uma única mensagem (array JSON ou CBOR,
+// ver leitura.h), cifrada uma vez só. O lote é enviado quando junta "max_count" leituras, quando a próxima leitura não
+// caberia em "max_bytes" ou quando a mais antiga espera "max_latency_ms" (conferido em mqtt_batch_poll()).
+// Cada publicação paga uma vez o cabeçalho MQTT, o tópico, o envelope da cifra e os cabeçalhos TCP/IP, e o rádio acorda
+// uma vez por lote. Não depende do lwIP (testado no computador): quem envia é a função registrada em mqtt_batch_init().
+
+#define MQTT_BATCH_MAX_READINGS LEITURA_LOTE_MAX // Maior lote (o subscriber não aceita mais que isso)
+#define MQTT_BATCH_PACKET_BYTES 256 // Maior pacote, com o envelope da cifra (o mesmo MQTT_RX_BUFFER_BYTES do subscriber)
+
+// Envia o pacote pronto; retorna false se a publicação não pôde ser enviada
+typedef bool (*mqtt_batch_publish_t)(const char *topic, const uint8_t *data, size_t len, uint8_t qos, void *arg);
+
+typedef struct {
+    const char *topic;
+    leitura_formato_t formato;
+    uint8_t qos; // QoS de cada lote (0: sem confirmação; 1: o broker confirma com PUBACK)
+    uint8_t max_count; // Envia ao juntar esse número de leituras (1 desliga o lote)
+    uint16_t max_bytes; // Maior mensagem em claro (limitada pelo pacote menos o envelope da cifra)
+    uint32_t max_latency_ms; // Maior espera da leitura mais antiga do lote
+} mqtt_batch_config_t;
+
+typedef struct {
+    uint32_t readings; // Leituras aceitas
+    uint32_t batches; // Lotes publicados
+    uint32_t bytes; // Bytes de payload publicados (com o envelope da cifra)
+    uint32_t flush_count; // Lotes enviados por max_count
+    uint32_t flush_bytes; // Lotes enviados porque a próxima leitura não caberia
+    uint32_t flush_latency; // Lotes enviados por max_latency_ms
+    uint32_t flush_manual; // Lotes enviados por mqtt_batch_flush()
+    uint32_t dropped; // Leituras perdidas (publicação recusada ou leitura maior que max_bytes)
+} mqtt_batch_stats_t;
+
+typedef struct {
+    mqtt_batch_config_t config;
+    payload_ctx_t *crypto; // NULL: payload em claro
+    mqtt_batch_publish_t publish;
+    void *arg;
+    leitura_t leituras[MQTT_BATCH_MAX_READINGS];
+    uint8_t count;
+    uint32_t oldest_ms; // Momento em que a primeira leitura do lote chegou
+    size_t len; // Tamanho do lote já codificado na área de texto claro do pacote
+    uint8_t packet[MQTT_BATCH_PACKET_BYTES];
+    mqtt_batch_stats_t stats;
+} mqtt_batch_t;
+
+void mqtt_batch_init(mqtt_batch_t *batch, const mqtt_batch_config_t *config, payload_ctx_t *crypto,
+                     mqtt_batch_publish_t publish, void *arg);
+bool mqtt_batch_add(mqtt_batch_t *batch, const leitura_t *leitura, uint32_t now_ms); // false: leitura perdida
+void mqtt_batch_poll(mqtt_batch_t *batch, uint32_t now_ms); // Envia o lote que atingiu max_latency_ms
+bool mqtt_batch_flush(mqtt_batch_t *batch); // Envia o que houver (true também com o lote vazio)
+#endif
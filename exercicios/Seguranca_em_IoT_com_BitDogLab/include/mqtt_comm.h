@@ -1,6 +1,20 @@
 #ifndef MQTT_COMM_H
 #define MQTT_COMM_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "include/payload_crypto.h"
+#include "include/outbox.h"
+#include "include/topic_router.h"
+#include "include/mqtt_tls.h"
 void mqtt_setup(const char *client_id, const char *broker_ip, const char *user, const char *pass);
 void mqtt_comm_publish(const char *topic, const uint8_t *data, size_t len);
+bool mqtt_comm_publish_qos(const char *topic, const uint8_t *data, size_t len, uint8_t qos);
 void mqtt_comm_subscribe(const char *topic);
+void mqtt_comm_subscribe_handler(const char *filter, topic_handler_t handler, void *arg);
+void mqtt_comm_set_payload_crypto(payload_ctx_t *ctx);
+bool mqtt_comm_set_tls(const char *ca_pem, const char *hostname, const uint8_t *pin);
+void mqtt_comm_poll(void);
+void mqtt_comm_get_queue_stats(outbox_stats_t *stats);
+void mqtt_comm_get_tls_stats(mqtt_tls_stats_t *stats);
 #endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef MQTT_RX_H
+#define MQTT_RX_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "include/payload_crypto.h"
+#include "include/replay.h"
+
+// Recepção de mensagens MQTT em fragmentos: o lwIP anuncia cada publicação (tópico e tamanho total) e entrega o payload
+// em pedaços, o último com MQTT_DATA_FLAG_LAST. Os fragmentos são juntados em um buffer de um conjunto fixo, que guarda
+// também o tópico. A mensagem completa fica no buffer até mqtt_rx_poll(), chamada no laço principal, decifrá-la no próprio
+// buffer e entregá-la ao tratador registrado: os callbacks do lwIP (interrupção em segundo plano) só copiam os fragmentos.
+// Não depende do lwIP (testado no computador): mqtt_comm.c repassa os dois callbacks para cá.
+
+#define MQTT_RX_SLOTS 4 // Buffers de remontagem (mensagens completas aguardando o laço principal + a que está chegando)
+#define MQTT_RX_BUFFER_BYTES 256 // Maior pacote aceito (cabeçalho e etiqueta da cifra incluídos)
+#define MQTT_RX_TOPIC_MAX 64 // Maior tópico aceito, com o '\0'
+#define MQTT_RX_FLAG_LAST 0x01 // Mesmo valor de MQTT_DATA_FLAG_LAST do lwIP
+
+// Recebe a mensagem completa, já decifrada e terminada em '\0' (o buffer pode ser alterado, mas só vale durante a chamada)
+typedef void (*mqtt_rx_handler_t)(const char *topic, char *payload, size_t len, void *arg);
+
+// Contadores de mensagens entregues e descartadas
+typedef struct {
+    uint32_t messages; // Entregues ao tratador (por mqtt_rx_poll)
+    uint32_t bytes; // Bytes de payload recebidos (antes da decifragem)
+    uint32_t dropped_too_large; // Maiores que MQTT_RX_BUFFER_BYTES (ou tópico longo demais)
+    uint32_t dropped_no_slot; // Sem buffer livre
+    uint32_t dropped_incomplete; // Interrompidas por outra publicação ou com tamanho diferente do anunciado
+    uint32_t dropped_auth; // Rejeitadas pela cifra (alteradas, outra chave ou curtas demais)
+    uint32_t dropped_replay; // Autênticas, mas repetidas ou antigas demais para a janela do remetente
+} mqtt_rx_stats_t;
+
+void mqtt_rx_init(payload_ctx_t *crypto, mqtt_rx_handler_t handler, void *arg); // crypto NULL: payload em claro
+void mqtt_rx_set_replay(replay_table_t *table); // Janela contra replay por remetente (só com payload cifrado; NULL desliga)
+void mqtt_rx_begin(const char *topic, uint32_t total_len); // Início de uma publicação (incoming_publish_cb)
+void mqtt_rx_data(const uint8_t *data, uint16_t len, uint8_t flags); // Um fragmento (incoming_data_cb)
+int mqtt_rx_poll(void); // Entrega as mensagens completas, na ordem de chegada; retorna quantas
+void mqtt_rx_get_stats(mqtt_rx_stats_t *stats);
+#endif
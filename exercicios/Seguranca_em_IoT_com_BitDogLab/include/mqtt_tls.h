@@ -0,0 +1,52 @@
+#ifndef MQTT_TLS_H
+#define MQTT_TLS_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "lwip/apps/mqtt.h"
+
+// TLS no enlace com o broker (porta 8883) pelo altcp_tls do lwIP com o mbedTLS do Pico SDK (opção MQTT_TLS do
+// CMakeLists.txt). Sem ela, as funções abaixo não fazem nada e mqtt_tls_init() retorna false.
+//
+// - O certificado do broker é conferido pela CA dada e, opcionalmente, pelo pino: o SHA-256 da chave pública
+//   (SubjectPublicKeyInfo em DER) do certificado do broker. Um certificado diferente, mesmo assinado pela mesma CA, é recusado
+// - A sessão TLS de cada conexão (id e ticket) é guardada e oferecida na próxima: uma reconexão aceita pelo broker pula a
+//   troca de chaves e a conferência do certificado (handshake abreviado)
+// - A cada conexão, mede o tempo até o CONNACK e o pico do heap do mbedTLS, separando handshakes completos e retomados
+
+#ifndef MQTT_TLS
+#define MQTT_TLS 0
+#endif
+
+#define MQTT_TLS_PORT 8883
+#define MQTT_TLS_PIN_BYTES 32 // SHA-256
+
+typedef struct {
+    uint32_t full_handshakes; // Conexões com handshake completo (certificado conferido)
+    uint32_t resumed_handshakes; // Conexões que retomaram a sessão anterior
+    uint32_t pin_failures; // Certificados recusados pelo pino
+    uint32_t last_full_ms; // Do início da conexão (TCP + TLS + CONNECT) ao CONNACK, no último handshake completo
+    uint32_t last_resumed_ms; // O mesmo, na última sessão retomada
+    uint32_t last_full_heap_peak; // Pico do heap do mbedTLS durante a conexão (bytes), no último handshake completo
+    uint32_t last_resumed_heap_peak;
+    uint32_t heap_in_use; // Heap do mbedTLS agora: configuração, sessão guardada e conexão aberta
+} mqtt_tls_stats_t;
+
+// Prepara a configuração do cliente (chamar antes de qualquer outro uso do mbedTLS, para o heap ser contado desde o início)
+// ca_pem: certificado da CA (ou o próprio certificado do broker, se autoassinado), em PEM
+// hostname: nome no certificado do broker (NULL: não confere o nome, só a CA e o pino)
+// pin: SHA-256 da chave pública do broker (NULL: sem pino). As strings e o pino precisam continuar valendo
+// Retorna false com o certificado inválido (ex.: o texto de exemplo) ou o pino todo zerado (não preenchido)
+bool mqtt_tls_init(const char *ca_pem, const char *hostname, const uint8_t *pin);
+bool mqtt_tls_enabled(void); // mqtt_tls_init() deu certo
+
+void mqtt_tls_client_info(struct mqtt_connect_client_info_t *info); // Preenche o tls_config do CONNECT
+
+// Ciclo de cada conexão (com o lwIP bloqueado ou nos callbacks dele)
+void mqtt_tls_begin(uint32_t now_ms); // Antes de mqtt_client_connect()
+void mqtt_tls_setup(mqtt_client_t *client); // Logo depois, antes do handshake: pino, nome e sessão guardada
+void mqtt_tls_connected(mqtt_client_t *client, uint32_t now_ms); // CONNACK aceito: mede e guarda a sessão
+void mqtt_tls_closed(void); // Recusa ou queda
+
+void mqtt_tls_get_stats(mqtt_tls_stats_t *stats);
+#endif
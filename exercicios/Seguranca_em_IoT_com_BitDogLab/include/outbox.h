@@ -0,0 +1,155 @@
+#ifndef OUTBOX_H
+#define OUTBOX_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Fila de saída das publicações (store-and-forward): nada é perdido enquanto o broker está fora do ar.
+// As mensagens entram num anel na RAM; com o anel cheio, a mais antiga passa para um log na flash. Com a conexão de pé,
+// a fila sai na ordem (flash primeiro, depois RAM), com um limite de mensagens aguardando confirmação e um intervalo mínimo
+// entre envios. Uma mensagem só sai da fila quando o lwIP confirma a entrega: PUBACK no QoS 1, envio no QoS 0.
+//
+// Log na flash: setores usados em círculo, com registros só acrescentados (nunca reescritos), cada um em páginas inteiras:
+//   magic u32 ("OBX1"), log_seq u32, id u32, len u16, topic_len u8, flags u8 (bit 7: confirmação; bits 0-1: QoS),
+//   crc32 u32 (dos 16 bytes anteriores, do tópico e do payload), tópico, payload
+// A remoção também é um registro: a cada OUTBOX_ACK_EVERY confirmações (e quando a flash esvazia) grava-se o id da primeira
+// mensagem ainda pendente. Um setor só é apagado quando a escrita precisa dele de novo.
+// Queda de energia no meio de uma gravação deixa um registro com CRC errado: ele é ignorado e a escrita continua depois
+// do espaço de um registro de tamanho máximo. Confirmações ainda não gravadas fazem a mensagem ser reenviada (pelo menos
+// uma vez); a janela contra replay do subscriber descarta a cópia, que tem o mesmo nonce.
+// Limites: o anel na RAM se perde num reset (use outbox_spill() antes de desligar); com a flash cheia, o setor mais
+// antigo é apagado com as mensagens pendentes dele (contadas em dropped).
+//
+// Não depende do hardware (testado no computador): a gravação da flash fica em src/outbox_flash.c.
+
+#define OUTBOX_MAGIC 0x3158424Fu // "OBX1"
+#define OUTBOX_HEADER_BYTES 20
+#define OUTBOX_TOPIC_MAX 63
+#define OUTBOX_PAYLOAD_MAX 256 // O mesmo MQTT_BATCH_PACKET_BYTES dos lotes
+#define OUTBOX_RECORD_MAX 512 // Maior registro já arredondado para páginas de 256 bytes
+#define OUTBOX_RAM_SLOTS 8
+#define OUTBOX_MAX_INFLIGHT 8
+#define OUTBOX_MAX_SECTORS 64
+#define OUTBOX_ACK_EVERY 8 // Confirmações por registro de remoção gravado
+#define OUTBOX_EVENTS 16 // Confirmações do lwIP aguardando outbox_poll()
+
+// Região da flash reservada para o log
+typedef struct {
+    const uint8_t *base; // Leitura direta (mapeamento XIP no RP2040)
+    uint32_t size; // Múltiplo de sector_size, de 2 a OUTBOX_MAX_SECTORS setores
+    uint32_t sector_size;
+    uint32_t page_size; // Unidade de gravação
+    bool (*program)(uint32_t offset, const uint8_t *data, size_t len, void *arg); // offset e len em páginas inteiras
+    bool (*erase)(uint32_t offset, void *arg); // Um setor
+    void *arg;
+} outbox_flash_t;
+
+// Entrega ao cliente MQTT; o resultado volta por outbox_event_ack() com o mesmo token. false: tentar depois
+typedef bool (*outbox_publish_t)(const char *topic, const uint8_t *data, size_t len, uint8_t qos, uint32_t token, void *arg);
+
+typedef struct {
+    uint32_t drain_interval_ms; // Intervalo mínimo entre envios (0: sem limite)
+    uint8_t max_inflight; // Mensagens aguardando confirmação (até OUTBOX_MAX_INFLIGHT)
+    uint32_t ack_timeout_ms; // Sem confirmação nesse prazo: reenvia a partir da mais antiga
+} outbox_config_t;
+
+typedef struct {
+    // Profundidade
+    uint32_t ram_depth;
+    uint32_t flash_depth;
+    uint32_t inflight;
+    uint32_t ram_peak; // Maiores profundidades desde a inicialização
+    uint32_t flash_peak;
+    uint32_t flash_free_bytes; // Espaço até o setor mais antigo ainda com mensagens pendentes
+    // Contadores
+    uint32_t pushed;
+    uint32_t spilled; // Passaram da RAM para a flash
+    uint32_t sent; // Envios (inclui reenvios)
+    uint32_t acked; // Saíram da fila confirmadas
+    uint32_t rewinds; // Reenvios a partir da mais antiga (queda, erro ou prazo esgotado)
+    uint32_t dropped; // Descartadas (grandes demais, flash cheia ou falha na flash)
+    uint32_t recovered; // Pendentes encontradas na flash na inicialização
+    uint32_t torn; // Registros com CRC errado encontrados na inicialização
+    uint32_t erases;
+    uint32_t flash_errors;
+    uint32_t events_lost; // Confirmações perdidas com a fila de eventos cheia (o prazo reenvia)
+} outbox_stats_t;
+
+typedef struct {
+    const char *topic; // Precisa continuar valendo (literal ou estático)
+    uint32_t id;
+    uint8_t qos;
+    uint16_t len;
+    uint8_t data[OUTBOX_PAYLOAD_MAX];
+} outbox_slot_t;
+
+// Posição no log: setor e deslocamento dentro dele
+typedef struct {
+    uint16_t sector;
+    uint16_t offset;
+} outbox_pos_t;
+
+typedef struct {
+    outbox_config_t config;
+    const outbox_flash_t *flash; // NULL: só RAM (com o anel cheio, a mais antiga é descartada)
+    outbox_publish_t publish;
+    void *arg;
+    uint16_t sectors;
+
+    // Anel na RAM (mensagens mais novas que as da flash)
+    outbox_slot_t ram[OUTBOX_RAM_SLOTS];
+    uint8_t ram_head;
+    uint8_t ram_count;
+    uint32_t next_id;
+
+    // Log na flash
+    outbox_pos_t head; // Próxima escrita
+    bool head_dirty; // Resto do setor atual não confiável: a próxima escrita vai para o setor seguinte
+    uint32_t log_seq; // Ordem dos registros (e dos setores)
+    uint32_t acked_id; // Mensagens com id menor já foram confirmadas
+    outbox_pos_t front; // Busca da mais antiga pendente
+    uint32_t flash_pending;
+    uint8_t pops_since_checkpoint;
+
+    // Aguardando confirmação: sempre o começo da fila (flash e depois RAM), na ordem de envio
+    struct {
+        uint32_t id;
+        uint32_t sent_ms;
+        bool acked;
+    } inflight[OUTBOX_MAX_INFLIGHT];
+    uint8_t inflight_count;
+    uint32_t last_send_ms;
+    bool sent_once;
+
+    // Confirmações dos callbacks do lwIP: o callback só escreve em event_head, outbox_poll() só em event_tail
+    struct {
+        uint32_t token;
+        bool ok;
+    } volatile events[OUTBOX_EVENTS];
+    volatile uint8_t event_head;
+    volatile uint8_t event_tail;
+
+    uint8_t record[OUTBOX_RECORD_MAX]; // Registro montado para gravar (precisa estar na RAM)
+    outbox_stats_t stats;
+} outbox_t;
+
+// Lê o log da flash (mensagens pendentes de antes de um reset entram na fila)
+void outbox_init(outbox_t *ob, const outbox_config_t *config, const outbox_flash_t *flash, outbox_publish_t publish, void *arg);
+
+// Guarda uma mensagem (o payload é copiado); false só se for descartada (grande demais)
+bool outbox_push(outbox_t *ob, const char *topic, const uint8_t *data, size_t len, uint8_t qos);
+
+// Processa confirmações e envia o que puder (chamar com frequência no laço principal)
+void outbox_poll(outbox_t *ob, uint32_t now_ms, bool online);
+
+// Confirmação do lwIP (pode ser chamada do callback de publicação)
+void outbox_event_ack(outbox_t *ob, uint32_t token, bool ok);
+
+// Passa todo o anel da RAM para a flash (ex.: antes de dormir ou desligar)
+bool outbox_spill(outbox_t *ob);
+
+void outbox_get_stats(const outbox_t *ob, outbox_stats_t *stats);
+
+// Últimos 8 setores da flash do Pico W, gravados com flash_safe_execute() (src/outbox_flash.c)
+extern const outbox_flash_t outbox_flash_pico;
+#endif
@@ -0,0 +1,69 @@
+#ifndef PAYLOAD_CRYPTO_H
+#define PAYLOAD_CRYPTO_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Proteção do payload MQTT com cifra autenticada (AEAD): confidencialidade e integridade em uma única operação
+//
+// Pacote:  cifra u8 | salt u32 | contador u64 | texto cifrado | etiqueta (16 bytes)     (inteiros em big-endian)
+// O cabeçalho (13 bytes) vai em claro, mas entra na autenticação: trocar a cifra, o salt ou o contador invalida a etiqueta.
+// O nonce de 96 bits é salt || contador: o salt e o contador inicial são sorteados a cada inicialização e o contador avança
+// a cada mensagem, então um nonce nunca se repete na mesma inicialização. Entre inicializações (ou placas com a mesma chave),
+// uma repetição exige o mesmo salt e faixas de contadores sobrepostas: com 32 + 63 bits sorteados, a chance fica desprezível
+// mesmo depois de milhões de reinícios (só o salt, 32 bits, repetiria com 50% de chance depois de ~2^16).
+
+// AES-256-GCM pelo mbedTLS do Pico SDK (biblioteca pico_mbedtls); sem acelerador de AES no RP2040, o ChaCha20-Poly1305 é mais rápido
+#ifndef PAYLOAD_CRYPTO_AES_GCM
+#define PAYLOAD_CRYPTO_AES_GCM 0
+#endif
+
+#if PAYLOAD_CRYPTO_AES_GCM
+#include "mbedtls/gcm.h"
+#endif
+
+#define PAYLOAD_KEY_BYTES 32
+#define PAYLOAD_HEADER_BYTES 13
+#define PAYLOAD_TAG_BYTES 16
+#define PAYLOAD_OVERHEAD (PAYLOAD_HEADER_BYTES + PAYLOAD_TAG_BYTES) // Bytes acrescentados a cada mensagem
+
+typedef enum {
+    PAYLOAD_CIPHER_CHACHA20_POLY1305 = 1,
+    PAYLOAD_CIPHER_AES_256_GCM = 2, // Requer PAYLOAD_CRYPTO_AES_GCM
+} payload_cipher_t;
+
+typedef struct {
+    payload_cipher_t cipher;
+    uint8_t key[PAYLOAD_KEY_BYTES];
+    uint32_t salt; // Parte fixa do nonce nesta inicialização
+    uint64_t counter; // Próximo contador de envio (começa num valor sorteado)
+#if PAYLOAD_CRYPTO_AES_GCM
+    mbedtls_gcm_context gcm; // Chave AES já expandida
+#endif
+} payload_ctx_t;
+
+// Identificação de uma mensagem recebida (para a proteção contra replay)
+typedef struct {
+    uint32_t salt;
+    uint64_t counter;
+} payload_nonce_t;
+
+// Onde o texto claro fica dentro do pacote: a mensagem é escrita e lida aí, e cifrada no próprio lugar
+static inline uint8_t *payload_plaintext(uint8_t *packet) {
+    return packet + PAYLOAD_HEADER_BYTES;
+}
+
+// salt e counter: parte fixa do nonce e primeiro contador de envio, sorteados a cada inicialização (counter abaixo de 2^63,
+// o que deixa ao menos 2^63 mensagens até o contador se esgotar). Retorna false se a cifra não foi compilada
+bool payload_init(payload_ctx_t *ctx, payload_cipher_t cipher, const uint8_t key[PAYLOAD_KEY_BYTES], uint32_t salt, uint64_t counter);
+void payload_free(payload_ctx_t *ctx); // Apaga a chave (e a chave expandida do AES)
+const char *payload_cipher_name(payload_cipher_t cipher);
+
+// Cifra os "len" bytes em payload_plaintext(packet) no próprio buffer, grava o cabeçalho e acrescenta a etiqueta
+// Retorna o tamanho do pacote (len + PAYLOAD_OVERHEAD), ou 0 se não couber em "size"
+size_t payload_seal(payload_ctx_t *ctx, uint8_t *packet, size_t len, size_t size);
+
+// Confere a etiqueta e decifra no próprio buffer; o texto claro fica em payload_plaintext(packet) com "*len" bytes
+// Retorna false para pacotes curtos demais, de outra cifra ou alterados (nesse caso o conteúdo do buffer não deve ser usado)
+bool payload_open(payload_ctx_t *ctx, uint8_t *packet, size_t packet_len, size_t *len, payload_nonce_t *nonce);
+#endif
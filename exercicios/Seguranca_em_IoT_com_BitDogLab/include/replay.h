@@ -0,0 +1,63 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+#include <stdint.h>
+#include <stdbool.h>
+
+// Proteção contra replay por remetente, com janela deslizante no estilo do IPsec (RFC 4303, seção 3.4.3):
+// para cada remetente guarda o maior contador aceito e um mapa de 64 bits dos contadores logo abaixo dele.
+// Uma mensagem é aceita se o contador for maior que o maior já visto ou, dentro da janela, ainda não tiver chegado:
+// mensagens fora de ordem (QoS 1, reenvios) passam, repetidas e antigas demais não.
+//
+// Os remetentes ficam em uma tabela de endereçamento aberto (sondagem linear, remoção sem lápides), com busca O(1).
+// Com a tabela cheia, um remetente novo substitui o usado há mais tempo, desde que esse não tenha mensagem aceita nas
+// últimas REPLAY_RECENT conferências; senão o remetente novo é recusado (REPLAY_TABLE_FULL) até algum envelhecer.
+//
+// No payload cifrado, o remetente é o salt do nonce (sorteado a cada inicialização da placa) e o contador é o do nonce:
+// os dois já passaram pela autenticação quando chegam aqui.
+// Limites: a tabela fica só na RAM e a primeira mensagem de um remetente desconhecido é sempre aceita. Uma gravação
+// completa das mensagens de um remetente que saiu da tabela, ou de antes de o subscriber reiniciar, é aceita inteira de
+// novo se for reenviada na ordem: a primeira mensagem recria a janela e as seguintes vêm acima dela. A proteção dos
+// remetentes recentes impede que uma gravação antiga tire da tabela um publisher ativo, mas uma enxurrada de mais de
+// REPLAY_RECENT mensagens gravadas envelhece também o publisher, se ele ficar esse tempo sem publicar.
+
+#define REPLAY_WINDOW 64 // Contadores abaixo do maior aceito que ainda podem chegar fora de ordem
+#define REPLAY_SLOTS 16 // Posições da tabela (potência de 2)
+#define REPLAY_MAX_SENDERS 12 // Remetentes guardados (ocupação de até 75% mantém as sondagens curtas)
+#define REPLAY_RECENT 256 // Conferências desde a última mensagem aceita abaixo das quais um remetente não é substituído
+
+typedef enum {
+    REPLAY_ACCEPTED,
+    REPLAY_DUPLICATE, // Contador já aceito
+    REPLAY_TOO_OLD, // Contador abaixo da janela
+    REPLAY_TABLE_FULL, // Remetente novo com a tabela cheia de remetentes recentes
+} replay_result_t;
+
+typedef struct {
+    uint32_t sender;
+    bool used;
+    uint64_t top; // Maior contador aceito
+    uint64_t bitmap; // Bit i: contador top - i já aceito
+    uint32_t last_used; // Para escolher quem sai com a tabela cheia
+} replay_entry_t;
+
+typedef struct {
+    uint32_t accepted;
+    uint32_t duplicates;
+    uint32_t too_old;
+    uint32_t new_senders;
+    uint32_t evictions; // Remetentes substituídos com a tabela cheia
+    uint32_t table_full; // Remetentes novos recusados (todos os da tabela recentes)
+} replay_stats_t;
+
+typedef struct {
+    replay_entry_t slots[REPLAY_SLOTS];
+    uint32_t senders; // Posições ocupadas
+    uint32_t clock; // Avança a cada mensagem conferida
+    replay_stats_t stats;
+} replay_table_t;
+
+void replay_init(replay_table_t *table);
+replay_result_t replay_check(replay_table_t *table, uint32_t sender, uint64_t counter); // Confere e registra
+bool replay_forget(replay_table_t *table, uint32_t sender); // Remove um remetente (false se não estava na tabela)
+const char *replay_result_name(replay_result_t result);
+#endif
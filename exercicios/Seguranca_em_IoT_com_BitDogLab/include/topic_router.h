@@ -0,0 +1,62 @@
+#ifndef TOPIC_ROUTER_H
+#define TOPIC_ROUTER_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Roteador de tópicos: cada filtro MQTT ("escola/+/temperatura", "bitdog1/comando/#") tem o seu tratador.
+// Os filtros ficam numa árvore de prefixos (trie) por nível do tópico: a entrega percorre o tópico uma vez, nível a
+// nível, seguindo o filho com o mesmo nome e o filho "+"; um "#" no fim do filtro vale para o nível dele e todos os de
+// baixo. O custo é proporcional ao tamanho do tópico (vezes os filhos de cada nível, poucos), não ao número de filtros.
+// Uma mensagem que casa com vários filtros vai para todos os tratadores deles.
+//
+// Regras do MQTT 3.1.1 (seção 4.7): "+" e "#" ocupam o nível inteiro e "#" só no fim; "a/#" também casa com "a";
+// tópicos começando com '$' (ex.: "$SYS/...") não casam com curinga no primeiro nível.
+// Nós e tratadores vêm de conjuntos fixos (sem malloc). Não depende do lwIP (testado no computador).
+
+#define TOPIC_ROUTER_NODES 32 // Níveis guardados, somando todos os filtros (o nó 0 é a raiz)
+#define TOPIC_ROUTER_ROUTES 8 // Filtros com tratador
+#define TOPIC_ROUTER_LEVEL_MAX 24 // Maior nome de nível, com o '\0'
+#define TOPIC_ROUTER_DEPTH 16 // Mais níveis que isso: o tópico não casa com nada
+
+// Mesmo formato do tratador de mqtt_rx.h: o payload só vale durante a chamada e é o mesmo buffer para todos os
+// tratadores da mensagem (não deve ser alterado)
+typedef void (*topic_handler_t)(const char *topic, char *payload, size_t len, void *arg);
+
+typedef struct {
+    char level[TOPIC_ROUTER_LEVEL_MAX]; // Nome do nível ("+": qualquer nome)
+    uint8_t child; // Primeiro filho (0: nenhum)
+    uint8_t sibling; // Próximo filho do mesmo pai (0: nenhum)
+    uint8_t exact; // Filtro que termina neste nível (número do tratador + 1; 0: nenhum)
+    uint8_t multi; // Filtro que termina em "/#" depois deste nível
+} topic_node_t;
+
+typedef struct {
+    topic_handler_t handler;
+    void *arg;
+} topic_route_t;
+
+typedef struct {
+    uint32_t dispatched; // Mensagens entregues a pelo menos um tratador
+    uint32_t unmatched; // Mensagens sem filtro correspondente
+    uint32_t calls; // Chamadas de tratadores
+} topic_router_stats_t;
+
+typedef struct {
+    topic_node_t nodes[TOPIC_ROUTER_NODES];
+    uint8_t node_count;
+    topic_route_t routes[TOPIC_ROUTER_ROUTES];
+    uint8_t route_count;
+    topic_router_stats_t stats;
+} topic_router_t;
+
+void topic_router_init(topic_router_t *router);
+
+// Registra o tratador de um filtro (o mesmo filtro de novo troca o tratador); false se o filtro for inválido ou não couber
+bool topic_router_add(topic_router_t *router, const char *filter, topic_handler_t handler, void *arg);
+
+// Entrega a mensagem aos tratadores dos filtros que casam com o tópico; retorna quantos foram chamados
+int topic_router_dispatch(topic_router_t *router, const char *topic, char *payload, size_t len);
+
+bool topic_filter_valid(const char *filter); // Curingas só em níveis inteiros e "#" só no fim
+#endif
@@ -1,4 +1,10 @@
 #ifndef WIFI_CONN_H
 #define WIFI_CONN_H
-void connect_to_wifi(const char *ssid, const char *password);
-#endif
\ No newline at end of file
+#include <stdbool.h>
+#include "include/conn_manager.h"
+bool wifi_conn_init(const char *ssid, const char *password);
+// Operações do gerenciador de conexão (conn_ops_t)
+bool wifi_conn_start(void *arg);
+void wifi_conn_stop(void *arg);
+conn_link_t wifi_conn_status(void *arg);
+#endif
@@ -4,45 +4,150 @@
 #include <stdint.h>                 // Biblioteca que permite o uso de tipos inteiros com tamanho fixo
 #include "pico/stdlib.h"            // Biblioteca padrão do Pico (GPIO, tempo, etc.)
 #include "pico/cyw43_arch.h"        // Driver WiFi para Pico W
-#include "include/wifi_conn.h"      // Funções personalizadas de conexão WiFi
+#include "pico/rand.h"              // Gerador de números aleatórios (salt e contador inicial do nonce)
+#include "include/wifi_conn.h"      // Funções personalizadas de conexão WiFi (sem bloqueio)
 #include "include/mqtt_comm.h"      // Funções personalizadas para MQTT
-#include "include/xor_cipher.h"     // Funções de cifra XOR
+#include "include/payload_crypto.h" // Cifra autenticada do payload
+#include "include/leitura.h"        // Formato da mensagem do sensor (JSON ou CBOR)
+#include "include/mqtt_batch.h"     // Publicação de várias leituras por mensagem
+
+// Cifra do payload: PAYLOAD_CIPHER_CHACHA20_POLY1305 (padrão, mais rápida no RP2040) ou PAYLOAD_CIPHER_AES_256_GCM
+// (compile com -DPAYLOAD_CRYPTO_AES_GCM=1, ver CMakeLists.txt). Publisher e subscriber precisam usar a mesma cifra e a mesma chave
+#define PAYLOAD_CIPHER PAYLOAD_CIPHER_CHACHA20_POLY1305
+
+// Chave de 256 bits compartilhada entre as placas. Troque por uma chave aleatória própria (ex.: openssl rand -hex 32)
+static const uint8_t chave_payload[PAYLOAD_KEY_BYTES] = {
+    0x3a, 0x91, 0x5c, 0x07, 0xe2, 0x4f, 0xb8, 0x16, 0x6d, 0xc3, 0x28, 0x9e, 0x51, 0x0a, 0xf7, 0x84,
+    0x2b, 0xd6, 0x73, 0x1e, 0x95, 0x40, 0xcc, 0x69, 0x07, 0xba, 0x5e, 0xf2, 0x38, 0x8d, 0x14, 0xa1,
+};
+
+static payload_ctx_t cripto; // Chave, cifra e contador de mensagens enviadas
+
+#if MQTT_TLS
+// TLS com o broker (porta 8883, opção MQTT_TLS do CMakeLists.txt): o usuário e a senha do CONNECT deixam de ir em texto claro.
+// Sem a opção, a placa conecta na porta 1883 sem TLS
+// Certificado do broker (autoassinado, chave EC P-256, ver README): cole aqui o conteúdo do broker.crt
+static const char certificado_broker[] =
+    "-----BEGIN CERTIFICATE-----\n"
+    "Cole aqui o certificado do broker\n"
+    "-----END CERTIFICATE-----\n";
+
+// Pino: SHA-256 da chave pública do broker. Troque pelo resultado de
+//   openssl x509 -in broker.crt -pubkey -noout | openssl pkey -pubin -outform der | openssl dgst -sha256
+// Zerado, mqtt_comm_set_tls() recusa a configuração; para conferir só o certificado, passe NULL no lugar do pino
+static const uint8_t pino_broker[32] = {0};
+#endif
+
+// Publicação de cada tópico: formato da mensagem, QoS e quando enviar o lote (o que vier primeiro)
+// - Formato: LEITURA_CBOR (7 bytes por leitura avulsa) ou LEITURA_JSON (21 bytes, legível no mosquitto_sub quando
+//   publicado sem criptografia). O subscriber reconhece os dois formatos e os lotes sozinho
+// - Com uma leitura a cada 5 s, 12 leituras ou 60 s dão uma publicação por minuto em vez de 12;
+//   max_count = 1 volta a publicar cada leitura
+static const mqtt_batch_config_t publicacoes[] = {
+    {.topic = "escola/sala1/temperatura", .formato = LEITURA_CBOR, .qos = 1, .max_count = 12, .max_bytes = 200, .max_latency_ms = 60000},
+};
+#define NUM_PUBLICACOES (sizeof(publicacoes) / sizeof(publicacoes[0]))
+
+static mqtt_batch_t lotes[NUM_PUBLICACOES]; // Leituras aguardando o envio, uma fila por tópico
+
+// Envia um lote pronto (já cifrado) pelo cliente MQTT
+static bool publicar_lote(const char *topic, const uint8_t *data, size_t len, uint8_t qos, void *arg) {
+    return mqtt_comm_publish_qos(topic, data, len, qos);
+}
+
+// Comandos para esta placa ("bitdog1/comando/led", "bitdog1/comando/intervalo", ...): o tópico diz o comando e a
+// mensagem, o valor. Chegam pelo mesmo caminho das leituras: decifrados e conferidos contra replay
+static void tratar_comando(const char *topic, char *mensagem, size_t len, void *arg) {
+    printf("Comando %s: %.*s\n", topic, (int)len, mensagem);
+}
 
 int main() {
     // Inicializa todas as interfaces de I/O padrão (USB serial, etc.)
     stdio_init_all();
-    
-    // Conecta à rede WiFi - Etapa 1
+
+#if MQTT_TLS
+    // Primeiro uso do mbedTLS: a partir daqui, o heap dele é contado (pico de cada handshake)
+    // O nome precisa estar no certificado do broker (subjectAltName). Com o certificado ou o pino do exemplo, a placa
+    // não conecta (a senha não vai em texto claro): preencha os dois acima
+    if (!mqtt_comm_set_tls(certificado_broker, "broker.local", pino_broker)) {
+        printf("TLS nao configurado: confira certificado_broker e pino_broker; a conexao com o broker nao sera feita\n");
+    }
+#endif
+
+    // Inicializa a cifra do payload. O salt e o contador inicial (63 bits) sorteados a cada inicialização mantêm o nonce único
+    // entre reinícios e entre placas com a mesma chave, sem guardar nada na flash
+    if (!payload_init(&cripto, PAYLOAD_CIPHER, chave_payload, get_rand_32(), get_rand_64() >> 1)) {
+        printf("Cifra %s nao disponivel nesta compilacao\n", payload_cipher_name(PAYLOAD_CIPHER));
+    }
+    mqtt_comm_set_payload_crypto(&cripto);
+    for (size_t i = 0; i < NUM_PUBLICACOES; i++) {
+        mqtt_batch_init(&lotes[i], &publicacoes[i], &cripto, publicar_lote, NULL);
+    }
+
+    // Inicializa o Wi-Fi com a rede a usar - Etapa 1
     // Parâmetros: Nome da rede (SSID) e senha da rede
-    connect_to_wifi("Nome da Rede", "Senha da Rede");
+    wifi_conn_init("Nome da Rede", "Senha da Rede");
 
     // Configura o cliente MQTT - Etapas 2 e 4 
     // Parâmetros: ID do cliente, IP do broker, usuário, senha
+    // A conexão (Wi-Fi, DHCP, broker e assinaturas) avança em mqtt_comm_poll() e é refeita sozinha depois de quedas;
+    // leituras publicadas antes disso ou sem conexão esperam na fila de saída (RAM e, se faltar espaço, flash)
     mqtt_setup("bitdog1", "IP do Broker", "Thiago", "senha123");
 
+    // Comandos para esta placa: "#" recebe todos os subtópicos, cada um entregue a tratar_comando()
+    mqtt_comm_subscribe_handler("bitdog1/comando/#", tratar_comando, NULL);
+
     //Descomente a seguinte linha do código para usar a placa como subscriber - Etapa 6
+    //Curingas valem no filtro: "escola/+/temperatura" recebe as leituras de todas as salas
     //mqtt_comm_subscribe("escola/sala1/temperatura");
 
+    absolute_time_t proxima_leitura = get_absolute_time(); // Lê logo na primeira volta
+    absolute_time_t proximo_relatorio = make_timeout_time_ms(30000);
+
     // Loop principal do programa
     while (true) {
-        // Cria mensagem no formato JSON com timestamp - Etapa 6
-        char mensagem[128]; // Buffer para armazenar o valor da mensagem original junto com o valor do tempo em que ela foi publicada
-        snprintf(mensagem, sizeof(mensagem), "{\"valor\":26.5,\"ts\":%lu}", time(NULL));
+        // Avança a conexão e trata as mensagens recebidas (parse e verificação contra replay ficam fora da interrupção do Wi-Fi)
+        mqtt_comm_poll();
+
+        uint32_t agora = to_ms_since_boot(get_absolute_time());
+        if (time_reached(proxima_leitura)) {
+            // Leitura com timestamp - Etapa 6
+            leitura_t leitura = {.valor = 2650, .ts = (uint32_t)time(NULL)}; // 26,50 em centésimos
+
+            // Entra no lote de cada tópico: o lote é codificado direto na área de texto claro do pacote e, no envio,
+            // cifrado e autenticado no próprio buffer (Etapas 5 e 6). Para publicar sem criptografia (Etapas 3 e 6),
+            // passe NULL no lugar de &cripto em mqtt_batch_init()
+            for (size_t i = 0; i < NUM_PUBLICACOES; i++) {
+                mqtt_batch_add(&lotes[i], &leitura, agora);
+            }
 
-        size_t len = strlen(mensagem); // Tamanho da mensagem em bytes
+            // Próxima leitura em 5 segundos
+            proxima_leitura = make_timeout_time_ms(5000);
+        }
 
-        // Criptografa a mensagem usando XOR com chave 42 - Etapa 5
-        uint8_t criptografada[128]; // Buffer para mensagem criptografada com timestamp 
-        xor_encrypt((uint8_t *)mensagem, criptografada, len, 42);
+        // Envia os lotes que já esperaram o tempo máximo
+        for (size_t i = 0; i < NUM_PUBLICACOES; i++) {
+            mqtt_batch_poll(&lotes[i], agora);
+        }
 
-        // Publica a mensagem sem criptografia com timestamp - Etapas 3 e 6
-        //mqtt_comm_publish("escola/sala1/temperatura", (uint8_t *)mensagem, len);
+        // Profundidade da fila de saída a cada 30 segundos
+        if (time_reached(proximo_relatorio)) {
+            outbox_stats_t fila;
+            mqtt_comm_get_queue_stats(&fila);
+            printf("Fila de saida: %lu na RAM, %lu na flash, %lu aguardando confirmacao (%lu bytes livres na flash, %lu descartadas)\n",
+                   (unsigned long)fila.ram_depth, (unsigned long)fila.flash_depth, (unsigned long)fila.inflight,
+                   (unsigned long)fila.flash_free_bytes, (unsigned long)fila.dropped);
 
-        // Publica a mensagem criptografada com timestamp - Etapas 5 e 6
-        mqtt_comm_publish("escola/sala1/temperatura", criptografada, len);
+            mqtt_tls_stats_t tls;
+            mqtt_comm_get_tls_stats(&tls);
+            printf("TLS: %lu completos (%lu ms, pico de %lu bytes), %lu retomados (%lu ms, pico de %lu bytes), %lu bytes em uso\n",
+                   (unsigned long)tls.full_handshakes, (unsigned long)tls.last_full_ms, (unsigned long)tls.last_full_heap_peak,
+                   (unsigned long)tls.resumed_handshakes, (unsigned long)tls.last_resumed_ms,
+                   (unsigned long)tls.last_resumed_heap_peak, (unsigned long)tls.heap_in_use);
+            proximo_relatorio = make_timeout_time_ms(30000);
+        }
 
-        // Aguarda 5 segundos antes da próxima publicação
-        sleep_ms(5000);
+        sleep_ms(10); // As mensagens recebidas esperam no máximo ~10 ms pelo tratamento
     }
     return 0;
 }
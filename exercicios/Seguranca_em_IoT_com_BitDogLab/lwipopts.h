@@ -19,7 +19,11 @@
 #define MEM_LIBC_MALLOC             0
 #endif
 #define MEM_ALIGNMENT               4
+#if MQTT_TLS
+#define MEM_SIZE                    8000 // O estado de cada conexão TLS e a configuração do altcp_tls também saem daqui
+#else
 #define MEM_SIZE                    4000
+#endif
 #define MEMP_NUM_TCP_SEG            32
 #define MEMP_NUM_ARP_QUEUE          10
 #define PBUF_POOL_SIZE              24
@@ -98,6 +102,19 @@
 // Isso ajuda a controlar o fluxo de mensagens no protocolo MQTT
 #define MQTT_REQ_MAX_IN_FLIGHT  (5)
 
+#if MQTT_TLS
+// TLS no enlace MQTT (opção MQTT_TLS do CMakeLists.txt): o cliente MQTT do lwIP usa o altcp_tls quando o tls_config do
+// CONNECT é preenchido (mqtt_tls.c)
+#define LWIP_ALTCP                  1
+#define LWIP_ALTCP_TLS              1
+#define LWIP_ALTCP_TLS_MBEDTLS      1
+// Certificado do broker que não confere com a CA (ou com o pino) derruba o handshake; o padrão do lwIP só avisa
+#define ALTCP_MBEDTLS_AUTHMODE      MBEDTLS_SSL_VERIFY_REQUIRED
+// Os buffers do mbedTLS ficam no heap da libc, onde mqtt_tls.c mede o pico; no heap do lwIP, MEM_SIZE precisaria de ~20 KB
+#define ALTCP_MBEDTLS_PLATFORM_ALLOC 0
+// O tamanho dos registros TLS (e, com ele, a maior parte da memória) está no mbedtls_config.h
+#endif
+
 // Estas definições são parte da personalização do LWIP para atender às necessidades específicas de um projeto, 
 // permitindo ajustar o comportamento da pilha de rede e do cliente MQTT de acordo com os requisitos de memória, 
 // desempenho e funcionalidade do sistema embarcado.
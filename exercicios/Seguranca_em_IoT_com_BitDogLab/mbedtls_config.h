@@ -0,0 +1,64 @@
+#ifndef MBEDTLS_CONFIG_H
+#define MBEDTLS_CONFIG_H
+
+// Configuração do mbedTLS do Pico SDK (biblioteca pico_mbedtls), usada com as opções PAYLOAD_CRYPTO_AES_GCM e MQTT_TLS
+// do CMakeLists.txt. Apenas o necessário para o AES-256-GCM do payload e, com MQTT_TLS, para o cliente TLS do broker
+
+#define MBEDTLS_NO_PLATFORM_ENTROPY   // Sem /dev/urandom
+#define MBEDTLS_ENTROPY_HARDWARE_ALT  // Entropia fornecida pelo pico_mbedtls (pico_rand)
+
+#define MBEDTLS_AES_C
+#define MBEDTLS_AES_FEWER_TABLES      // Tabelas de 2 KB em vez de 8 KB: menos RAM, pouco mais lento
+#define MBEDTLS_CIPHER_C
+#define MBEDTLS_GCM_C
+
+#if MQTT_TLS
+// Cliente TLS 1.2 com uma só suíte: ECDHE-ECDSA com AES-128-GCM. O broker precisa de um certificado com chave EC P-256
+#define MBEDTLS_SSL_TLS_C
+#define MBEDTLS_SSL_CLI_C
+#define MBEDTLS_SSL_PROTO_TLS1_2
+#define MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED
+#define MBEDTLS_SSL_CIPHERSUITES MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256
+#define MBEDTLS_SSL_EXTENDED_MASTER_SECRET // Retomar a sessão sem o ataque de triplo handshake
+#define MBEDTLS_SSL_SERVER_NAME_INDICATION // Nome do broker (mbedtls_ssl_set_hostname)
+
+// Retomada de sessão: pelo id (cache do broker) e pelo ticket (RFC 5077), que o broker não precisa guardar
+#define MBEDTLS_SSL_SESSION_TICKETS
+// Sem MBEDTLS_SSL_KEEP_PEER_CERTIFICATE: a sessão guardada leva só o hash do certificado do broker, não o certificado
+
+#define MBEDTLS_ECP_C
+#define MBEDTLS_ECDH_C
+#define MBEDTLS_ECDSA_C
+#define MBEDTLS_ECP_DP_SECP256R1_ENABLED // Só a P-256
+#define MBEDTLS_ECP_NIST_OPTIM
+#define MBEDTLS_BIGNUM_C
+#define MBEDTLS_MD_C
+#define MBEDTLS_SHA256_C
+#define MBEDTLS_CTR_DRBG_C
+#define MBEDTLS_ENTROPY_C
+
+#define MBEDTLS_X509_USE_C
+#define MBEDTLS_X509_CRT_PARSE_C
+#define MBEDTLS_PEM_PARSE_C
+#define MBEDTLS_BASE64_C
+#define MBEDTLS_ASN1_PARSE_C
+#define MBEDTLS_ASN1_WRITE_C
+#define MBEDTLS_OID_C
+#define MBEDTLS_PK_C
+#define MBEDTLS_PK_PARSE_C
+#define MBEDTLS_PK_WRITE_C // Chave pública em DER para o pino
+
+// calloc/free trocáveis: mqtt_tls.c conta o heap do mbedTLS
+#define MBEDTLS_PLATFORM_C
+#define MBEDTLS_PLATFORM_MEMORY
+
+// Memória. Os buffers de registro são o maior gasto: 16 KB na entrada e 16 KB na saída por padrão. As mensagens deste
+// projeto (lotes de até 512 bytes) e o handshake com um certificado P-256 cabem em registros de 4 KB e 2 KB; um registro
+// maior do broker derruba a conexão
+#define MBEDTLS_SSL_IN_CONTENT_LEN  4096
+#define MBEDTLS_SSL_OUT_CONTENT_LEN 2048
+#define MBEDTLS_ECP_WINDOW_SIZE     2 // Tabela menor na multiplicação de pontos (padrão 4): menos RAM, um pouco mais lento
+#define MBEDTLS_MPI_MAX_SIZE        48 // Números de até 384 bits (P-256 com folga); o padrão é para RSA de 8192 bits
+#endif
+
+#endif
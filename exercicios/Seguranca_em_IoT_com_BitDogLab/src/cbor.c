@@ -0,0 +1,287 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/cbor.h"
+#include <string.h> // Para memcpy() e strlen()
+
+#define CBOR_MAX_DEPTH 16 // Arrays, mapas e tags aninhados (limita a recursão de cbor_skip)
+
+// Escritor
+
+void cbor_writer_init(cbor_writer_t *w, uint8_t *buffer, size_t size) {
+    w->buffer = buffer;
+    w->size = size;
+    w->len = 0;
+    w->overflow = false;
+}
+
+static void put(cbor_writer_t *w, const void *data, size_t n) {
+    if (w->overflow) {
+        return;
+    }
+    if (n > w->size - w->len) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->buffer + w->len, data, n);
+    w->len += n;
+}
+
+/**
+ * Grava o cabeçalho de um item: tipo principal nos 3 bits altos e o argumento na menor forma possível
+ *
+ * Funcionamento:
+ * - Argumentos até 23 cabem no próprio byte inicial
+ * - Acima disso, o byte inicial indica 1, 2, 4 ou 8 bytes seguintes, em big-endian
+ */
+static void put_head(cbor_writer_t *w, uint8_t major, uint64_t argument) {
+    uint8_t head[9];
+    size_t n;
+    major = (uint8_t)(major << 5);
+    if (argument < 24) {
+        head[0] = major | (uint8_t)argument;
+        n = 1;
+    } else if (argument <= 0xff) {
+        head[0] = major | 24;
+        n = 2;
+    } else if (argument <= 0xffff) {
+        head[0] = major | 25;
+        n = 3;
+    } else if (argument <= 0xffffffffu) {
+        head[0] = major | 26;
+        n = 5;
+    } else {
+        head[0] = major | 27;
+        n = 9;
+    }
+    for (size_t i = 1; i < n; i++) {
+        head[i] = (uint8_t)(argument >> (8 * (n - 1 - i)));
+    }
+    put(w, head, n);
+}
+
+void cbor_write_uint(cbor_writer_t *w, uint64_t value) {
+    put_head(w, CBOR_MAJOR_UINT, value);
+}
+
+void cbor_write_int(cbor_writer_t *w, int64_t value) {
+    if (value >= 0) {
+        put_head(w, CBOR_MAJOR_UINT, (uint64_t)value);
+    } else {
+        put_head(w, CBOR_MAJOR_NEGATIVE, (uint64_t)(-1 - value)); // -1 - n, sem estouro em INT64_MIN
+    }
+}
+
+void cbor_write_bool(cbor_writer_t *w, bool value) {
+    put_head(w, CBOR_MAJOR_SIMPLE, value ? 21 : 20);
+}
+
+void cbor_write_text(cbor_writer_t *w, const char *text) {
+    size_t n = strlen(text);
+    put_head(w, CBOR_MAJOR_TEXT, n);
+    put(w, text, n);
+}
+
+void cbor_begin_array(cbor_writer_t *w, uint32_t count) {
+    put_head(w, CBOR_MAJOR_ARRAY, count);
+}
+
+void cbor_begin_map(cbor_writer_t *w, uint32_t count) {
+    put_head(w, CBOR_MAJOR_MAP, count);
+}
+
+size_t cbor_writer_finish(cbor_writer_t *w) {
+    return w->overflow ? 0 : w->len;
+}
+
+// Leitor
+
+void cbor_reader_init(cbor_reader_t *r, const uint8_t *data, size_t len) {
+    r->data = data;
+    r->len = len;
+    r->pos = 0;
+}
+
+bool cbor_read_head(cbor_reader_t *r, uint8_t *major, uint64_t *argument) {
+    if (r->pos >= r->len) {
+        return false;
+    }
+    uint8_t initial = r->data[r->pos++];
+    uint8_t info = initial & 0x1f;
+    *major = initial >> 5;
+
+    if (info < 24) {
+        *argument = info;
+        return true;
+    }
+    if (info > 27) {
+        return false; // 28 a 30 reservados; 31 é tamanho indefinido, não usado por estas mensagens
+    }
+    size_t n = (size_t)1 << (info - 24);
+    if (n > r->len - r->pos) {
+        return false;
+    }
+    uint64_t value = 0;
+    for (size_t i = 0; i < n; i++) {
+        value = (value << 8) | r->data[r->pos++];
+    }
+    *argument = value;
+    return true;
+}
+
+bool cbor_read_int(cbor_reader_t *r, int64_t *value) {
+    uint8_t major;
+    uint64_t argument;
+    if (!cbor_read_head(r, &major, &argument) || argument > INT64_MAX) {
+        return false;
+    }
+    if (major == CBOR_MAJOR_UINT) {
+        *value = (int64_t)argument;
+        return true;
+    }
+    if (major == CBOR_MAJOR_NEGATIVE) {
+        *value = -1 - (int64_t)argument;
+        return true;
+    }
+    return false;
+}
+
+static bool skip_item(cbor_reader_t *r, int depth) {
+    uint8_t major;
+    uint64_t argument;
+    if (depth > CBOR_MAX_DEPTH || !cbor_read_head(r, &major, &argument)) {
+        return false;
+    }
+    switch (major) {
+    case CBOR_MAJOR_BYTES:
+    case CBOR_MAJOR_TEXT:
+        if (argument > r->len - r->pos) return false;
+        r->pos += (size_t)argument;
+        return true;
+    case CBOR_MAJOR_ARRAY:
+    case CBOR_MAJOR_MAP: {
+        if (argument > r->len - r->pos) return false; // Cada item ocupa ao menos um byte: evita laços enormes com lixo
+        uint64_t items = major == CBOR_MAJOR_MAP ? argument * 2 : argument;
+        for (uint64_t i = 0; i < items; i++) {
+            if (!skip_item(r, depth + 1)) return false;
+        }
+        return true;
+    }
+    case CBOR_MAJOR_TAG:
+        return skip_item(r, depth + 1); // O item marcado pela tag
+    default:
+        return true; // Inteiros, simples e floats: o cabeçalho já consumiu o valor
+    }
+}
+
+bool cbor_skip(cbor_reader_t *r) {
+    return skip_item(r, 0);
+}
+
+// Converte um valor para o campo descrito
+static bool store_field(const cbor_field_t *field, cbor_reader_t *r, uint8_t *base) {
+    void *dest = base + field->offset;
+    int64_t integer;
+    uint8_t major;
+    uint64_t argument;
+
+    switch (field->type) {
+    case CBOR_FIELD_INT: {
+        if (!cbor_read_int(r, &integer) || integer < INT32_MIN || integer > INT32_MAX) return false;
+        int32_t v = (int32_t)integer;
+        memcpy(dest, &v, sizeof(v));
+        return true;
+    }
+    case CBOR_FIELD_UINT: {
+        if (!cbor_read_int(r, &integer) || integer < 0 || integer > UINT32_MAX) return false;
+        uint32_t v = (uint32_t)integer;
+        memcpy(dest, &v, sizeof(v));
+        return true;
+    }
+    case CBOR_FIELD_BOOL: {
+        if (!cbor_read_head(r, &major, &argument) || major != CBOR_MAJOR_SIMPLE || (argument != 20 && argument != 21)) return false;
+        bool v = argument == 21;
+        memcpy(dest, &v, sizeof(v));
+        return true;
+    }
+    case CBOR_FIELD_TEXT:
+        if (!cbor_read_head(r, &major, &argument) || major != CBOR_MAJOR_TEXT || argument >= field->size || argument > r->len - r->pos) return false;
+        memcpy(dest, r->data + r->pos, (size_t)argument);
+        ((char *)dest)[argument] = '\0';
+        r->pos += (size_t)argument;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Lê um mapa a partir da posição atual do leitor para a struct
+static bool read_map(cbor_reader_t *r, const cbor_field_t *fields, size_t count, void *out) {
+    uint8_t major;
+    uint64_t pairs;
+    if (count > 32 || !cbor_read_head(r, &major, &pairs) || major != CBOR_MAJOR_MAP || pairs > r->len - r->pos) {
+        return false;
+    }
+
+    uint32_t found = 0;
+    for (uint64_t p = 0; p < pairs; p++) {
+        size_t key_pos = r->pos;
+        uint64_t key;
+        const cbor_field_t *field = NULL;
+        if (cbor_read_head(r, &major, &key) && major == CBOR_MAJOR_UINT) {
+            for (size_t f = 0; f < count; f++) {
+                if (fields[f].key == key) {
+                    field = &fields[f];
+                    found |= 1u << f;
+                    break;
+                }
+            }
+        } else {
+            r->pos = key_pos; // Chave de outro tipo: pula inteira
+            if (!cbor_skip(r)) return false;
+        }
+
+        if (field != NULL) {
+            if (!store_field(field, r, (uint8_t *)out)) return false;
+        } else if (!cbor_skip(r)) {
+            return false;
+        }
+    }
+
+    for (size_t f = 0; f < count; f++) {
+        if (fields[f].required && (found & (1u << f)) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Preenche uma struct a partir de um mapa CBOR, seguindo a tabela de campos
+ *
+ * Funcionamento:
+ * - O item raiz deve ser um mapa de tamanho definido e ocupar todo o buffer
+ * - Pares com chave inteira presente na tabela são convertidos para o tipo do campo; os demais (inclusive chaves de texto)
+ *   são pulados com o valor inteiro
+ * - Um tipo errado, um valor fora da faixa ou um campo obrigatório ausente invalidam a mensagem
+ */
+bool cbor_parse_map(const uint8_t *data, size_t len, const cbor_field_t *fields, size_t count, void *out) {
+    cbor_reader_t r;
+    cbor_reader_init(&r, data, len);
+    return read_map(&r, fields, count, out) && r.pos == len;
+}
+
+// Array de mapas: cada um vai para a struct seguinte ("stride" bytes depois); o array deve ocupar todo o buffer
+int cbor_parse_array(const uint8_t *data, size_t len, const cbor_field_t *fields, size_t count, void *out, size_t stride, size_t max) {
+    cbor_reader_t r;
+    cbor_reader_init(&r, data, len);
+    uint8_t major;
+    uint64_t elements;
+    if (!cbor_read_head(&r, &major, &elements) || major != CBOR_MAJOR_ARRAY || elements > max) {
+        return -1;
+    }
+    for (uint64_t i = 0; i < elements; i++) {
+        if (!read_map(&r, fields, count, (uint8_t *)out + i * stride)) {
+            return -1;
+        }
+    }
+    return r.pos == len ? (int)elements : -1;
+}
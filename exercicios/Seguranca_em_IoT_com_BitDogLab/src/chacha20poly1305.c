@@ -0,0 +1,242 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/chacha20poly1305.h"
+#include <string.h> // Para memcpy() e memset()
+
+// Leitura e escrita de palavras little-endian byte a byte (o Cortex-M0+ não aceita acesso desalinhado)
+static inline uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void store32_le(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define QUARTER_ROUND(a, b, c, d)              \
+    a += b; d ^= a; d = ROTL32(d, 16);         \
+    c += d; b ^= c; b = ROTL32(b, 12);         \
+    a += b; d ^= a; d = ROTL32(d, 8);          \
+    c += d; b ^= c; b = ROTL32(b, 7);
+
+/**
+ * Gera um bloco de 64 bytes do fluxo de chave do ChaCha20
+ *
+ * @param state Estado de entrada (constantes, chave, contador de bloco e nonce)
+ * @param out   Bloco gerado
+ *
+ * Funcionamento:
+ * - 20 rodadas (10 pares de rodadas de colunas e diagonais) sobre uma cópia do estado
+ * - O estado original é somado ao resultado, o que torna a função não inversível
+ */
+static void chacha20_block(const uint32_t state[16], uint8_t out[64]) {
+    uint32_t x[16];
+    memcpy(x, state, sizeof(x));
+
+    for (int i = 0; i < 10; i++) {
+        // Rodada de colunas
+        QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        // Rodada de diagonais
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+
+    for (int i = 0; i < 16; i++) {
+        store32_le(out + 4 * i, x[i] + state[i]);
+    }
+}
+
+// Monta o estado inicial: constante "expand 32-byte k", chave, contador de bloco e nonce
+static void chacha20_setup(uint32_t state[16], const uint8_t key[32], const uint8_t nonce[12], uint32_t counter) {
+    state[0] = 0x61707865;
+    state[1] = 0x3320646e;
+    state[2] = 0x79622d32;
+    state[3] = 0x6b206574;
+    for (int i = 0; i < 8; i++) {
+        state[4 + i] = load32_le(key + 4 * i);
+    }
+    state[12] = counter;
+    for (int i = 0; i < 3; i++) {
+        state[13 + i] = load32_le(nonce + 4 * i);
+    }
+}
+
+// Cifra ou decifra (a operação é a mesma) aplicando XOR com o fluxo de chave, a partir do contador de bloco do estado
+static void chacha20_xor(uint32_t state[16], uint8_t *data, size_t len) {
+    uint8_t block[64];
+    while (len > 0) {
+        chacha20_block(state, block);
+        state[12]++;
+        size_t n = len < sizeof(block) ? len : sizeof(block);
+        for (size_t i = 0; i < n; i++) {
+            data[i] ^= block[i];
+        }
+        data += n;
+        len -= n;
+    }
+}
+
+// Acumulador do Poly1305 com limbs de 26 bits: os produtos cabem em 64 bits sem instruções de 128 bits
+typedef struct {
+    uint32_t r[5]; // Chave de multiplicação (com os bits exigidos pela especificação zerados)
+    uint32_t s[4]; // Chave somada no final
+    uint32_t h[5]; // Acumulador
+} poly1305_t;
+
+#define POLY1305_MASK 0x3ffffff
+
+static void poly1305_init(poly1305_t *p, const uint8_t key[32]) {
+    p->r[0] = load32_le(key + 0) & 0x3ffffff;
+    p->r[1] = (load32_le(key + 3) >> 2) & 0x3ffff03;
+    p->r[2] = (load32_le(key + 6) >> 4) & 0x3ffc0ff;
+    p->r[3] = (load32_le(key + 9) >> 6) & 0x3f03fff;
+    p->r[4] = (load32_le(key + 12) >> 8) & 0x00fffff;
+    for (int i = 0; i < 4; i++) {
+        p->s[i] = load32_le(key + 16 + 4 * i);
+    }
+    memset(p->h, 0, sizeof(p->h));
+}
+
+// Acumula um bloco de 16 bytes: h = (h + bloco + 2^128) * r mod 2^130 - 5
+static void poly1305_block(poly1305_t *p, const uint8_t m[16]) {
+    const uint32_t r0 = p->r[0], r1 = p->r[1], r2 = p->r[2], r3 = p->r[3], r4 = p->r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5; // 2^130 = 5 (mod p)
+    uint32_t h0 = p->h[0], h1 = p->h[1], h2 = p->h[2], h3 = p->h[3], h4 = p->h[4];
+
+    h0 += load32_le(m + 0) & POLY1305_MASK;
+    h1 += (load32_le(m + 3) >> 2) & POLY1305_MASK;
+    h2 += (load32_le(m + 6) >> 4) & POLY1305_MASK;
+    h3 += (load32_le(m + 9) >> 6) & POLY1305_MASK;
+    h4 += (load32_le(m + 12) >> 8) | (1u << 24);
+
+    uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+    uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+    uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+    uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+    uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+
+    // Propagação parcial dos carries
+    uint32_t c;
+    c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & POLY1305_MASK;
+    d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & POLY1305_MASK;
+    d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & POLY1305_MASK;
+    d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & POLY1305_MASK;
+    d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & POLY1305_MASK;
+    h0 += c * 5; c = h0 >> 26; h0 &= POLY1305_MASK;
+    h1 += c;
+
+    p->h[0] = h0; p->h[1] = h1; p->h[2] = h2; p->h[3] = h3; p->h[4] = h4;
+}
+
+// Acumula dados completando o último bloco com zeros, como a construção AEAD da RFC 8439 exige para o AAD e o texto cifrado
+static void poly1305_update_padded(poly1305_t *p, const uint8_t *data, size_t len) {
+    while (len >= 16) {
+        poly1305_block(p, data);
+        data += 16;
+        len -= 16;
+    }
+    if (len > 0) {
+        uint8_t block[16] = {0};
+        memcpy(block, data, len);
+        poly1305_block(p, block);
+    }
+}
+
+// Redução final módulo 2^130 - 5 e soma de s: gera a etiqueta de 16 bytes
+static void poly1305_finish(poly1305_t *p, uint8_t tag[16]) {
+    uint32_t h0 = p->h[0], h1 = p->h[1], h2 = p->h[2], h3 = p->h[3], h4 = p->h[4];
+    uint32_t c;
+
+    c = h1 >> 26; h1 &= POLY1305_MASK;
+    h2 += c; c = h2 >> 26; h2 &= POLY1305_MASK;
+    h3 += c; c = h3 >> 26; h3 &= POLY1305_MASK;
+    h4 += c; c = h4 >> 26; h4 &= POLY1305_MASK;
+    h0 += c * 5; c = h0 >> 26; h0 &= POLY1305_MASK;
+    h1 += c;
+
+    // g = h + 5 - 2^130; se não houver "empréstimo", h >= p e o resultado é g (seleção sem desvio, em tempo constante)
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= POLY1305_MASK;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= POLY1305_MASK;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= POLY1305_MASK;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= POLY1305_MASK;
+    uint32_t g4 = h4 + c - (1u << 26);
+
+    uint32_t mask = (g4 >> 31) - 1; // Todos os bits em 1 se g >= 0
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+    h2 = (h2 & ~mask) | (g2 & mask);
+    h3 = (h3 & ~mask) | (g3 & mask);
+    h4 = (h4 & ~mask) | (g4 & mask);
+
+    // Volta para 4 palavras de 32 bits e soma s (mod 2^128)
+    uint32_t w0 = h0 | (h1 << 26);
+    uint32_t w1 = (h1 >> 6) | (h2 << 20);
+    uint32_t w2 = (h2 >> 12) | (h3 << 14);
+    uint32_t w3 = (h3 >> 18) | (h4 << 8);
+
+    uint64_t f;
+    f = (uint64_t)w0 + p->s[0]; store32_le(tag + 0, (uint32_t)f);
+    f = (uint64_t)w1 + p->s[1] + (f >> 32); store32_le(tag + 4, (uint32_t)f);
+    f = (uint64_t)w2 + p->s[2] + (f >> 32); store32_le(tag + 8, (uint32_t)f);
+    f = (uint64_t)w3 + p->s[3] + (f >> 32); store32_le(tag + 12, (uint32_t)f);
+}
+
+// Etiqueta AEAD: Poly1305 com a chave de uso único (bloco 0 do ChaCha20) sobre AAD, texto cifrado e os dois tamanhos
+static void aead_tag(const uint8_t key[32], const uint8_t nonce[12], const uint8_t *aad, size_t aad_len,
+                     const uint8_t *ciphertext, size_t len, uint8_t tag[16]) {
+    uint32_t state[16];
+    uint8_t block[64];
+    chacha20_setup(state, key, nonce, 0);
+    chacha20_block(state, block);
+
+    poly1305_t poly;
+    poly1305_init(&poly, block);
+    poly1305_update_padded(&poly, aad, aad_len);
+    poly1305_update_padded(&poly, ciphertext, len);
+
+    uint8_t lengths[16];
+    store32_le(lengths + 0, (uint32_t)aad_len);
+    store32_le(lengths + 4, (uint32_t)((uint64_t)aad_len >> 32));
+    store32_le(lengths + 8, (uint32_t)len);
+    store32_le(lengths + 12, (uint32_t)((uint64_t)len >> 32));
+    poly1305_block(&poly, lengths);
+    poly1305_finish(&poly, tag);
+
+    memset(block, 0, sizeof(block)); // Não deixa a chave de uso único na pilha
+}
+
+void chacha20poly1305_encrypt(const uint8_t key[CHACHA20POLY1305_KEY_BYTES], const uint8_t nonce[CHACHA20POLY1305_NONCE_BYTES],
+                              const uint8_t *aad, size_t aad_len, uint8_t *data, size_t len, uint8_t tag[CHACHA20POLY1305_TAG_BYTES]) {
+    uint32_t state[16];
+    chacha20_setup(state, key, nonce, 1); // O bloco 0 fica reservado para a chave do Poly1305
+    chacha20_xor(state, data, len);
+    aead_tag(key, nonce, aad, aad_len, data, len, tag);
+}
+
+bool chacha20poly1305_decrypt(const uint8_t key[CHACHA20POLY1305_KEY_BYTES], const uint8_t nonce[CHACHA20POLY1305_NONCE_BYTES],
+                              const uint8_t *aad, size_t aad_len, uint8_t *data, size_t len, const uint8_t tag[CHACHA20POLY1305_TAG_BYTES]) {
+    uint8_t expected[CHACHA20POLY1305_TAG_BYTES];
+    aead_tag(key, nonce, aad, aad_len, data, len, expected);
+
+    // Comparação em tempo constante: o tempo não revela quantos bytes da etiqueta estavam certos
+    uint8_t diff = 0;
+    for (int i = 0; i < CHACHA20POLY1305_TAG_BYTES; i++) {
+        diff |= expected[i] ^ tag[i];
+    }
+    if (diff != 0) {
+        return false;
+    }
+
+    uint32_t state[16];
+    chacha20_setup(state, key, nonce, 1);
+    chacha20_xor(state, data, len);
+    return true;
+}
@@ -0,0 +1,261 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/conn_manager.h"
+#include <string.h> // Para memset()
+
+void conn_init(conn_manager_t *cm, const conn_config_t *config, const conn_ops_t *ops, void *arg) {
+    memset(cm, 0, sizeof(*cm));
+    cm->config = *config;
+    cm->ops = ops;
+    cm->arg = arg;
+    if (cm->config.backoff_min_ms == 0) {
+        cm->config.backoff_min_ms = 1;
+    }
+    if (cm->config.backoff_max_ms < cm->config.backoff_min_ms) {
+        cm->config.backoff_max_ms = cm->config.backoff_min_ms;
+    }
+}
+
+void conn_set_hook(conn_manager_t *cm, conn_state_hook_t hook, void *arg) {
+    cm->hook = hook;
+    cm->hook_arg = arg;
+}
+
+static void set_state(conn_manager_t *cm, conn_state_t to, uint32_t now_ms) {
+    conn_state_t from = cm->state;
+    cm->state = to;
+    cm->since_ms = now_ms;
+    if (cm->hook != NULL && from != to) {
+        cm->hook(from, to, cm->hook_arg);
+    }
+}
+
+// Consome os eventos pendentes de um tipo; true se havia algum
+static bool take(volatile uint8_t *posted, uint8_t *seen) {
+    uint8_t value = *posted;
+    if (value == *seen) {
+        return false;
+    }
+    *seen = value;
+    return true;
+}
+
+// Esquece eventos de uma conexão anterior antes de uma nova tentativa
+static void discard_events(conn_manager_t *cm) {
+    cm->mqtt_up_seen = cm->mqtt_up_posted;
+    cm->mqtt_down_seen = cm->mqtt_down_posted;
+    cm->suback_ok_seen = cm->suback_ok_posted;
+    cm->suback_fail_seen = cm->suback_fail_posted;
+}
+
+/**
+ * Espera antes da próxima tentativa
+ *
+ * Funcionamento:
+ * - O teto dobra a cada falha seguida, de backoff_min_ms até backoff_max_ms, e volta ao início quando fica ONLINE
+ * - A espera é sorteada entre metade do teto e o teto: placas que caíram juntas (queda do ponto de acesso ou do broker)
+ *   não tentam todas no mesmo instante
+ */
+static void backoff(conn_manager_t *cm, uint32_t now_ms) {
+    uint32_t cap = cm->config.backoff_max_ms;
+    if (cm->attempt < 31 && (cm->config.backoff_min_ms << cm->attempt) >> cm->attempt == cm->config.backoff_min_ms) {
+        uint32_t grown = cm->config.backoff_min_ms << cm->attempt;
+        if (grown < cap) {
+            cap = grown;
+        }
+    }
+    uint32_t half = cap / 2;
+    cm->wait_ms = half + cm->ops->random(cm->arg) % (cap - half + 1);
+    if (cm->attempt < UINT8_MAX) {
+        cm->attempt++;
+    }
+    set_state(cm, CONN_BACKOFF, now_ms);
+}
+
+static void start_wifi(conn_manager_t *cm, uint32_t now_ms) {
+    cm->ops->wifi_stop(cm->arg);
+    if (!cm->ops->wifi_start(cm->arg)) {
+        cm->stats.wifi_failures++;
+        backoff(cm, now_ms);
+        return;
+    }
+    set_state(cm, CONN_WIFI_JOINING, now_ms);
+}
+
+static void start_mqtt(conn_manager_t *cm, uint32_t now_ms) {
+    discard_events(cm);
+    if (!cm->ops->mqtt_start(cm->arg)) {
+        cm->stats.mqtt_failures++;
+        backoff(cm, now_ms);
+        return;
+    }
+    set_state(cm, CONN_MQTT_CONNECTING, now_ms);
+}
+
+// Falha no CONNECT ou nas assinaturas: fecha o cliente e espera
+static void mqtt_failed(conn_manager_t *cm, uint32_t now_ms) {
+    cm->ops->mqtt_stop(cm->arg);
+    cm->stats.mqtt_failures++;
+    backoff(cm, now_ms);
+}
+
+// Envia a próxima assinatura ou, se acabaram, fica ONLINE
+static void subscribe_next(conn_manager_t *cm, uint32_t now_ms) {
+    if (cm->next_subscription >= cm->subscription_count) {
+        cm->attempt = 0;
+        cm->stats.connects++;
+        set_state(cm, CONN_ONLINE, now_ms);
+        return;
+    }
+    if (!cm->ops->mqtt_subscribe(cm->subscriptions[cm->next_subscription].topic, cm->subscriptions[cm->next_subscription].qos, cm->arg)) {
+        mqtt_failed(cm, now_ms);
+        return;
+    }
+    set_state(cm, CONN_MQTT_SUBSCRIBING, now_ms); // Reinicia o prazo para cada SUBACK
+}
+
+bool conn_subscribe(conn_manager_t *cm, const char *topic, uint8_t qos) {
+    for (int i = 0; i < cm->subscription_count; i++) {
+        if (strcmp(cm->subscriptions[i].topic, topic) == 0) {
+            cm->subscriptions[i].qos = qos;
+            return true;
+        }
+    }
+    if (cm->subscription_count >= CONN_MAX_SUBSCRIPTIONS) {
+        return false;
+    }
+    cm->subscriptions[cm->subscription_count].topic = topic;
+    cm->subscriptions[cm->subscription_count].qos = qos;
+    cm->subscription_count++;
+
+    // Já conectado: assina na hora (o SUBACK só é conferido nas próximas conexões)
+    if (cm->state == CONN_ONLINE) {
+        cm->ops->mqtt_subscribe(topic, qos, cm->arg);
+    }
+    return true;
+}
+
+void conn_start(conn_manager_t *cm, uint32_t now_ms) {
+    if (cm->state == CONN_IDLE) {
+        start_wifi(cm, now_ms);
+    }
+}
+
+/**
+ * Avança a máquina de estados (chamar com frequência no laço principal)
+ *
+ * @param cm     Gerenciador
+ * @param now_ms Tempo atual em ms (ex.: to_ms_since_boot(get_absolute_time()))
+ *
+ * Funcionamento:
+ * - Wi-Fi: espera o enlace com IP (passando por CONN_WIFI_DHCP) até wifi_timeout_ms; falha do driver ou prazo esgotado
+ *   levam à espera
+ * - MQTT: espera o CONNACK e depois cada SUBACK até mqtt_timeout_ms; recusa, queda ou prazo esgotado fecham o cliente
+ * - ONLINE: queda do MQTT ou do Wi-Fi leva à espera
+ * - Depois da espera, tenta o MQTT de novo se o Wi-Fi continua de pé, ou recomeça pelo Wi-Fi
+ */
+void conn_poll(conn_manager_t *cm, uint32_t now_ms) {
+    uint32_t elapsed = now_ms - cm->since_ms;
+
+    switch (cm->state) {
+    case CONN_IDLE:
+        break;
+
+    case CONN_WIFI_JOINING:
+    case CONN_WIFI_DHCP: {
+        conn_link_t link = cm->ops->wifi_status(cm->arg);
+        if (link == CONN_LINK_UP) {
+            start_mqtt(cm, now_ms);
+        } else if (link == CONN_LINK_FAIL || elapsed >= cm->config.wifi_timeout_ms) {
+            cm->stats.wifi_failures++;
+            backoff(cm, now_ms);
+        } else if (link == CONN_LINK_NOIP && cm->state == CONN_WIFI_JOINING) {
+            uint32_t since = cm->since_ms;
+            set_state(cm, CONN_WIFI_DHCP, now_ms);
+            cm->since_ms = since; // O prazo vale para associação e DHCP juntos
+        }
+        break;
+    }
+
+    case CONN_MQTT_CONNECTING:
+        if (take(&cm->mqtt_down_posted, &cm->mqtt_down_seen)) {
+            mqtt_failed(cm, now_ms);
+        } else if (take(&cm->mqtt_up_posted, &cm->mqtt_up_seen)) {
+            cm->next_subscription = 0;
+            subscribe_next(cm, now_ms);
+        } else if (elapsed >= cm->config.mqtt_timeout_ms) {
+            mqtt_failed(cm, now_ms);
+        }
+        break;
+
+    case CONN_MQTT_SUBSCRIBING:
+        if (take(&cm->mqtt_down_posted, &cm->mqtt_down_seen) || take(&cm->suback_fail_posted, &cm->suback_fail_seen)) {
+            mqtt_failed(cm, now_ms);
+        } else if (take(&cm->suback_ok_posted, &cm->suback_ok_seen)) {
+            cm->next_subscription++;
+            subscribe_next(cm, now_ms);
+        } else if (elapsed >= cm->config.mqtt_timeout_ms) {
+            mqtt_failed(cm, now_ms);
+        }
+        break;
+
+    case CONN_ONLINE:
+        // SUBACKs de assinaturas feitas já conectado não mudam nada
+        take(&cm->suback_ok_posted, &cm->suback_ok_seen);
+        take(&cm->suback_fail_posted, &cm->suback_fail_seen);
+        if (take(&cm->mqtt_down_posted, &cm->mqtt_down_seen)) {
+            cm->stats.drops++;
+            cm->ops->mqtt_stop(cm->arg);
+            backoff(cm, now_ms);
+        } else if (cm->ops->wifi_status(cm->arg) != CONN_LINK_UP) {
+            cm->stats.drops++;
+            cm->ops->mqtt_stop(cm->arg);
+            backoff(cm, now_ms);
+        }
+        break;
+
+    case CONN_BACKOFF:
+        if (elapsed >= cm->wait_ms) {
+            if (cm->ops->wifi_status(cm->arg) == CONN_LINK_UP) {
+                start_mqtt(cm, now_ms);
+            } else {
+                start_wifi(cm, now_ms);
+            }
+        }
+        break;
+    }
+}
+
+conn_state_t conn_state(const conn_manager_t *cm) {
+    return cm->state;
+}
+
+const char *conn_state_name(conn_state_t state) {
+    switch (state) {
+    case CONN_IDLE: return "parado";
+    case CONN_WIFI_JOINING: return "associando ao Wi-Fi";
+    case CONN_WIFI_DHCP: return "esperando IP (DHCP)";
+    case CONN_MQTT_CONNECTING: return "conectando ao broker";
+    case CONN_MQTT_SUBSCRIBING: return "assinando topicos";
+    case CONN_ONLINE: return "conectado";
+    case CONN_BACKOFF: return "esperando para tentar de novo";
+    default: return "?";
+    }
+}
+
+// Eventos: só incrementam o contador do tipo (o callback do lwIP é o único escritor); conn_poll() trata depois
+
+void conn_event_mqtt_up(conn_manager_t *cm) {
+    cm->mqtt_up_posted++;
+}
+
+void conn_event_mqtt_down(conn_manager_t *cm) {
+    cm->mqtt_down_posted++;
+}
+
+void conn_event_subscribed(conn_manager_t *cm, bool ok) {
+    if (ok) {
+        cm->suback_ok_posted++;
+    } else {
+        cm->suback_fail_posted++;
+    }
+}
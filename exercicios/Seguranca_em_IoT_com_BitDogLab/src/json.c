@@ -0,0 +1,712 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/json.h"
+#include <string.h> // Para memcpy(), memcmp() e strlen()
+
+#define JSON_MAX_DEPTH 16 // Objetos e arrays aninhados (limita a recursão do tokenizador)
+
+// Estado do tokenizador
+typedef struct {
+    const char *js;
+    size_t len;
+    size_t pos;
+    json_token_t *tokens;
+    unsigned max_tokens;
+    unsigned count;
+    int depth;
+} parser_t;
+
+static void skip_whitespace(parser_t *p) {
+    while (p->pos < p->len) {
+        char c = p->js[p->pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            break;
+        }
+        p->pos++;
+    }
+}
+
+static int new_token(parser_t *p, json_type_t type, size_t start, int parent) {
+    if (p->count >= p->max_tokens) {
+        return JSON_ERROR_NOMEM;
+    }
+    json_token_t *t = &p->tokens[p->count];
+    t->type = (uint8_t)type;
+    t->start = (uint16_t)start;
+    t->end = (uint16_t)start;
+    t->size = 0;
+    t->parent = (int16_t)parent;
+    return (int)p->count++;
+}
+
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool is_hex(char c) {
+    return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// String entre aspas, com os escapes conferidos (p->pos na aspa de abertura)
+static int parse_string(parser_t *p, int parent) {
+    size_t start = ++p->pos;
+    while (p->pos < p->len) {
+        char c = p->js[p->pos];
+        if (c == '"') {
+            int index = new_token(p, JSON_STRING, start, parent);
+            if (index < 0) {
+                return index;
+            }
+            p->tokens[index].end = (uint16_t)p->pos++;
+            return index;
+        }
+        if ((unsigned char)c < 0x20) {
+            return JSON_ERROR_INVALID; // Caractere de controle sem escape
+        }
+        if (c == '\\') {
+            if (++p->pos >= p->len) {
+                return JSON_ERROR_PARTIAL;
+            }
+            c = p->js[p->pos];
+            if (c == 'u') {
+                for (int i = 0; i < 4; i++) {
+                    if (++p->pos >= p->len) {
+                        return JSON_ERROR_PARTIAL;
+                    }
+                    if (!is_hex(p->js[p->pos])) {
+                        return JSON_ERROR_INVALID;
+                    }
+                }
+            } else if (strchr("\"\\/bfnrt", c) == NULL || c == '\0') {
+                return JSON_ERROR_INVALID;
+            }
+        }
+        p->pos++;
+    }
+    return JSON_ERROR_PARTIAL;
+}
+
+// Número (gramática estrita do JSON) ou true/false/null
+static int parse_primitive(parser_t *p, int parent) {
+    size_t start = p->pos;
+    const char *js = p->js;
+    char c = js[p->pos];
+
+    if (c == 't' || c == 'f' || c == 'n') {
+        const char *word = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+        size_t n = strlen(word);
+        size_t available = p->len - p->pos;
+        if (memcmp(js + p->pos, word, available < n ? available : n) != 0) {
+            return JSON_ERROR_INVALID;
+        }
+        if (available < n) {
+            return JSON_ERROR_PARTIAL;
+        }
+        p->pos += n;
+    } else {
+        if (c == '-') {
+            p->pos++;
+        }
+        if (p->pos >= p->len) {
+            return JSON_ERROR_PARTIAL;
+        }
+        if (js[p->pos] == '0') {
+            p->pos++;
+        } else if (is_digit(js[p->pos])) {
+            while (p->pos < p->len && is_digit(js[p->pos])) p->pos++;
+        } else {
+            return JSON_ERROR_INVALID;
+        }
+        if (p->pos < p->len && js[p->pos] == '.') {
+            p->pos++;
+            if (p->pos >= p->len) return JSON_ERROR_PARTIAL;
+            if (!is_digit(js[p->pos])) return JSON_ERROR_INVALID;
+            while (p->pos < p->len && is_digit(js[p->pos])) p->pos++;
+        }
+        if (p->pos < p->len && (js[p->pos] == 'e' || js[p->pos] == 'E')) {
+            p->pos++;
+            if (p->pos < p->len && (js[p->pos] == '+' || js[p->pos] == '-')) p->pos++;
+            if (p->pos >= p->len) return JSON_ERROR_PARTIAL;
+            if (!is_digit(js[p->pos])) return JSON_ERROR_INVALID;
+            while (p->pos < p->len && is_digit(js[p->pos])) p->pos++;
+        }
+    }
+
+    int index = new_token(p, JSON_PRIMITIVE, start, parent);
+    if (index >= 0) {
+        p->tokens[index].end = (uint16_t)p->pos;
+    }
+    return index;
+}
+
+static int parse_value(parser_t *p, int parent);
+
+// Objeto ou array (p->pos na chave ou colchete de abertura)
+static int parse_container(parser_t *p, int parent) {
+    bool object = p->js[p->pos] == '{';
+    char close = object ? '}' : ']';
+    if (++p->depth > JSON_MAX_DEPTH) {
+        return JSON_ERROR_INVALID;
+    }
+    int index = new_token(p, object ? JSON_OBJECT : JSON_ARRAY, p->pos, parent);
+    if (index < 0) {
+        return index;
+    }
+    p->pos++;
+
+    skip_whitespace(p);
+    if (p->pos < p->len && p->js[p->pos] == close) {
+        p->pos++;
+    } else {
+        while (true) {
+            int value_parent = index;
+            if (object) {
+                skip_whitespace(p);
+                if (p->pos >= p->len) return JSON_ERROR_PARTIAL;
+                if (p->js[p->pos] != '"') return JSON_ERROR_INVALID;
+                int key = parse_string(p, index);
+                if (key < 0) return key;
+                p->tokens[key].size = 1;
+                skip_whitespace(p);
+                if (p->pos >= p->len) return JSON_ERROR_PARTIAL;
+                if (p->js[p->pos++] != ':') return JSON_ERROR_INVALID;
+                value_parent = key;
+            }
+            int value = parse_value(p, value_parent);
+            if (value < 0) return value;
+            p->tokens[index].size++;
+
+            skip_whitespace(p);
+            if (p->pos >= p->len) return JSON_ERROR_PARTIAL;
+            char c = p->js[p->pos++];
+            if (c == close) break;
+            if (c != ',') return JSON_ERROR_INVALID;
+        }
+    }
+
+    p->tokens[index].end = (uint16_t)p->pos;
+    p->depth--;
+    return index;
+}
+
+static int parse_value(parser_t *p, int parent) {
+    skip_whitespace(p);
+    if (p->pos >= p->len) {
+        return JSON_ERROR_PARTIAL;
+    }
+    char c = p->js[p->pos];
+    if (c == '{' || c == '[') {
+        return parse_container(p, parent);
+    }
+    if (c == '"') {
+        return parse_string(p, parent);
+    }
+    return parse_primitive(p, parent);
+}
+
+/**
+ * Divide o texto em tokens, em uma passada
+ *
+ * @param js         Texto (não precisa terminar em '\0': nunca é lido além de "len")
+ * @param len        Tamanho do texto
+ * @param tokens     Vetor de saída
+ * @param max_tokens Capacidade do vetor
+ *
+ * Funcionamento:
+ * - Descida recursiva limitada a JSON_MAX_DEPTH níveis; os tokens ficam em pré-ordem (pai antes dos filhos)
+ * - Os valores são conferidos pela gramática do JSON (números, literais, escapes), então quem lê os tokens não precisa
+ *   validar de novo
+ * - Texto depois do valor raiz (exceto espaços) é inválido
+ */
+int json_tokenize(const char *js, size_t len, json_token_t *tokens, unsigned max_tokens) {
+    if (len > JSON_MAX_LENGTH) {
+        return JSON_ERROR_INVALID;
+    }
+    parser_t p = {.js = js, .len = len, .tokens = tokens, .max_tokens = max_tokens};
+    int root = parse_value(&p, -1);
+    if (root < 0) {
+        return root;
+    }
+    skip_whitespace(&p);
+    if (p.pos != len) {
+        return JSON_ERROR_INVALID;
+    }
+    return (int)p.count;
+}
+
+static const uint32_t powers_of_10[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+/**
+ * Converte um número do JSON para ponto fixo com "decimals" casas, sem float
+ *
+ * Funcionamento:
+ * - Junta até 18 dígitos significativos em um inteiro de 64 bits e acompanha o expoente decimal (fração e notação "e")
+ * - Desloca para a escala pedida: multiplica (conferindo o estouro) ou divide arredondando para o mais próximo
+ * - Retorna false para texto que não é número ou valor fora de int32_t
+ */
+bool json_parse_fixed(const char *text, size_t len, uint8_t decimals, int32_t *value) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < len && text[i] == '-') {
+        negative = true;
+        i++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0; // Dígitos significativos guardados
+    int exponent = 0; // Expoente decimal da mantissa
+    bool any = false;
+
+    for (; i < len && is_digit(text[i]); i++) {
+        any = true;
+        if (digits < 18) {
+            mantissa = mantissa * 10 + (uint64_t)(text[i] - '0');
+            if (mantissa != 0) digits++;
+        } else {
+            exponent++; // Dígito além da precisão: só conta a ordem de grandeza
+        }
+    }
+    if (i < len && text[i] == '.') {
+        i++;
+        for (; i < len && is_digit(text[i]); i++) {
+            any = true;
+            if (digits < 18) {
+                mantissa = mantissa * 10 + (uint64_t)(text[i] - '0');
+                if (mantissa != 0) digits++;
+                exponent--;
+            }
+        }
+    }
+    if (!any) {
+        return false;
+    }
+    if (i < len && (text[i] == 'e' || text[i] == 'E')) {
+        i++;
+        bool exp_negative = false;
+        if (i < len && (text[i] == '+' || text[i] == '-')) {
+            exp_negative = text[i] == '-';
+            i++;
+        }
+        if (i >= len || !is_digit(text[i])) {
+            return false;
+        }
+        int e = 0;
+        for (; i < len && is_digit(text[i]); i++) {
+            if (e < 1000) e = e * 10 + (text[i] - '0'); // Mais que isso já dá zero ou estouro
+        }
+        exponent += exp_negative ? -e : e;
+    }
+    if (i != len) {
+        return false;
+    }
+
+    int shift = exponent + decimals;
+    if (mantissa == 0) {
+        *value = 0;
+        return true;
+    }
+    if (shift > 0) {
+        if (shift > 9) {
+            return false;
+        }
+        if (mantissa > (uint64_t)INT32_MAX + 1) {
+            return false;
+        }
+        mantissa *= powers_of_10[shift];
+    } else if (shift < 0) {
+        if (shift < -19) {
+            mantissa = 0;
+        } else {
+            uint64_t divisor = 1;
+            for (int k = 0; k < -shift; k++) divisor *= 10;
+            mantissa = (mantissa + divisor / 2) / divisor; // Metade arredonda para longe do zero
+        }
+    }
+    if (mantissa > (negative ? (uint64_t)INT32_MAX + 1 : (uint64_t)INT32_MAX)) {
+        return false;
+    }
+    *value = negative ? (int32_t)(0 - mantissa) : (int32_t)mantissa;
+    return true;
+}
+
+// Dígitos decimais de um inteiro sem sinal; retorna quantos (até 10)
+static int format_uint(uint32_t value, char digits[10]) {
+    char reversed[10];
+    int n = 0;
+    do {
+        reversed[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    for (int i = 0; i < n; i++) {
+        digits[i] = reversed[n - 1 - i];
+    }
+    return n;
+}
+
+size_t json_format_fixed(int32_t value, uint8_t decimals, char *out, size_t size) {
+    char text[24];
+    size_t n = 0;
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    if (value < 0) {
+        text[n++] = '-';
+    }
+    if (decimals > 9) {
+        decimals = 9;
+    }
+    uint32_t scale = powers_of_10[decimals];
+    n += (size_t)format_uint(magnitude / scale, text + n);
+
+    uint32_t fraction = magnitude % scale;
+    if (fraction != 0) { // Sem zeros à direita: 2650 com 2 casas vira "26.5"
+        int places = decimals;
+        while (fraction % 10 == 0) {
+            fraction /= 10;
+            places--;
+        }
+        text[n++] = '.';
+        char digits[10];
+        int count = format_uint(fraction, digits);
+        for (int i = count; i < places; i++) {
+            text[n++] = '0';
+        }
+        memcpy(text + n, digits, (size_t)count);
+        n += (size_t)count;
+    }
+
+    if (size > 0) {
+        size_t copy = n < size - 1 ? n : size - 1;
+        memcpy(out, text, copy);
+        out[copy] = '\0';
+    }
+    return n;
+}
+
+// Inteiro sem fração nem expoente, com sinal opcional
+static bool parse_integer(const char *text, size_t len, int64_t *value) {
+    size_t i = 0;
+    bool negative = len > 0 && text[0] == '-';
+    if (negative) i++;
+    if (i >= len || len - i > 10) {
+        return false;
+    }
+    int64_t v = 0;
+    for (; i < len; i++) {
+        if (!is_digit(text[i])) return false;
+        v = v * 10 + (text[i] - '0');
+    }
+    *value = negative ? -v : v;
+    return true;
+}
+
+static int hex_value(char c) {
+    if (is_digit(c)) return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return c - 'A' + 10;
+}
+
+// Copia uma string do JSON convertendo os escapes (\uXXXX vira UTF-8); false se não couber em "size" com o '\0'
+static bool copy_string(const char *text, size_t len, char *out, size_t size) {
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        char c = text[i];
+        char utf8[3];
+        size_t count = 1;
+        utf8[0] = c;
+        if (c == '\\') {
+            c = text[++i]; // O tokenizador já conferiu os escapes
+            switch (c) {
+            case 'b': utf8[0] = '\b'; break;
+            case 'f': utf8[0] = '\f'; break;
+            case 'n': utf8[0] = '\n'; break;
+            case 'r': utf8[0] = '\r'; break;
+            case 't': utf8[0] = '\t'; break;
+            case 'u': {
+                uint32_t code = 0;
+                for (int k = 0; k < 4; k++) code = (code << 4) | (uint32_t)hex_value(text[++i]);
+                if (code < 0x80) {
+                    utf8[0] = (char)code;
+                } else if (code < 0x800) {
+                    utf8[0] = (char)(0xc0 | (code >> 6));
+                    utf8[1] = (char)(0x80 | (code & 0x3f));
+                    count = 2;
+                } else {
+                    utf8[0] = (char)(0xe0 | (code >> 12));
+                    utf8[1] = (char)(0x80 | ((code >> 6) & 0x3f));
+                    utf8[2] = (char)(0x80 | (code & 0x3f));
+                    count = 3;
+                }
+                break;
+            }
+            default: utf8[0] = c; break; // \" \\ \/
+            }
+        }
+        if (n + count >= size) {
+            return false;
+        }
+        memcpy(out + n, utf8, count);
+        n += count;
+    }
+    out[n] = '\0';
+    return true;
+}
+
+// Converte um valor para o campo descrito
+static bool store_field(const json_field_t *field, const char *js, const json_token_t *t, uint8_t *base) {
+    const char *text = js + t->start;
+    size_t len = (size_t)(t->end - t->start);
+    void *dest = base + field->offset;
+    int64_t integer;
+
+    switch (field->type) {
+    case JSON_FIELD_FIXED: {
+        int32_t fixed;
+        if (t->type != JSON_PRIMITIVE || !json_parse_fixed(text, len, field->decimals, &fixed)) return false;
+        memcpy(dest, &fixed, sizeof(fixed));
+        return true;
+    }
+    case JSON_FIELD_INT: {
+        if (t->type != JSON_PRIMITIVE || !parse_integer(text, len, &integer) || integer < INT32_MIN || integer > INT32_MAX) return false;
+        int32_t v = (int32_t)integer;
+        memcpy(dest, &v, sizeof(v));
+        return true;
+    }
+    case JSON_FIELD_UINT: {
+        if (t->type != JSON_PRIMITIVE || !parse_integer(text, len, &integer) || integer < 0 || integer > UINT32_MAX) return false;
+        uint32_t v = (uint32_t)integer;
+        memcpy(dest, &v, sizeof(v));
+        return true;
+    }
+    case JSON_FIELD_BOOL: {
+        if (t->type != JSON_PRIMITIVE || (text[0] != 't' && text[0] != 'f')) return false;
+        bool v = text[0] == 't';
+        memcpy(dest, &v, sizeof(v));
+        return true;
+    }
+    case JSON_FIELD_STRING:
+        return t->type == JSON_STRING && copy_string(text, len, (char *)dest, field->size);
+    default:
+        return false;
+    }
+}
+
+// Preenche a struct com as chaves do objeto em tokens[0] (tokens de um único objeto, em pré-ordem)
+static bool fill_object(const char *js, const json_token_t *tokens, int n, const json_field_t *fields, size_t count, void *out) {
+    if (n < 1 || tokens[0].type != JSON_OBJECT || count > 32) {
+        return false;
+    }
+
+    uint32_t found = 0;
+    int i = 1;
+    for (unsigned k = 0; k < tokens[0].size; k++) {
+        const json_token_t *key = &tokens[i];
+        const json_token_t *value = &tokens[i + 1];
+        size_t key_len = (size_t)(key->end - key->start);
+
+        for (size_t f = 0; f < count; f++) {
+            if (strlen(fields[f].name) == key_len && memcmp(js + key->start, fields[f].name, key_len) == 0) {
+                if (!store_field(&fields[f], js, value, (uint8_t *)out)) {
+                    return false;
+                }
+                found |= 1u << f;
+                break;
+            }
+        }
+
+        // Próxima chave: o primeiro token depois do fim do valor (pula os filhos de objetos e arrays)
+        i += 2;
+        while (i < n && tokens[i].start < value->end) {
+            i++;
+        }
+    }
+
+    for (size_t f = 0; f < count; f++) {
+        if (fields[f].required && (found & (1u << f)) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Preenche uma struct a partir de um objeto JSON, seguindo a tabela de campos
+ *
+ * Funcionamento:
+ * - Tokeniza com JSON_MAX_TOKENS tokens na pilha (nenhuma alocação)
+ * - Percorre as chaves do objeto raiz em qualquer ordem; chaves sem campo na tabela são puladas junto com todo o valor
+ *   (objetos e arrays aninhados inclusive)
+ * - Cada campo encontrado é convertido para o tipo da tabela; um tipo errado invalida a mensagem
+ */
+bool json_parse_object(const char *js, size_t len, const json_field_t *fields, size_t count, void *out) {
+    json_token_t tokens[JSON_MAX_TOKENS];
+    int n = json_tokenize(js, len, tokens, JSON_MAX_TOKENS);
+    return fill_object(js, tokens, n, fields, count, out);
+}
+
+/**
+ * Preenche um vetor de structs a partir de um array de objetos JSON
+ *
+ * Funcionamento:
+ * - Cada elemento é tokenizado sozinho, reaproveitando os mesmos JSON_MAX_TOKENS tokens: o array pode ter muito mais
+ *   tokens do que cabem na pilha
+ * - Os elementos são gravados a cada "stride" bytes a partir de "out"; mais de "max" elementos invalidam o texto
+ * - Retorna o número de elementos (0 para "[]") ou -1
+ */
+int json_parse_array(const char *js, size_t len, const json_field_t *fields, size_t count, void *out, size_t stride, size_t max) {
+    if (len > JSON_MAX_LENGTH) {
+        return -1;
+    }
+    json_token_t tokens[JSON_MAX_TOKENS];
+    parser_t p = {.js = js, .len = len, .tokens = tokens, .max_tokens = JSON_MAX_TOKENS, .depth = 1};
+    skip_whitespace(&p);
+    if (p.pos >= len || js[p.pos++] != '[') {
+        return -1;
+    }
+
+    size_t elements = 0;
+    skip_whitespace(&p);
+    if (p.pos < len && js[p.pos] == ']') {
+        p.pos++;
+    } else {
+        while (true) {
+            if (elements >= max) {
+                return -1;
+            }
+            p.count = 0;
+            int root = parse_value(&p, -1);
+            if (root < 0 || !fill_object(js, tokens, (int)p.count, fields, count, (uint8_t *)out + elements * stride)) {
+                return -1;
+            }
+            elements++;
+
+            skip_whitespace(&p);
+            if (p.pos >= len) return -1;
+            char c = js[p.pos++];
+            if (c == ']') break;
+            if (c != ',') return -1;
+        }
+    }
+    skip_whitespace(&p);
+    return p.pos == len ? (int)elements : -1;
+}
+
+// Escritor
+
+void json_writer_init(json_writer_t *w, char *buffer, size_t size) {
+    w->buffer = buffer;
+    w->size = size;
+    w->len = 0;
+    w->need_comma = false;
+    w->overflow = false;
+}
+
+// Acrescenta bytes, sempre deixando espaço para o '\0'
+static void put(json_writer_t *w, const char *text, size_t n) {
+    if (w->overflow) {
+        return;
+    }
+    if (n >= w->size - w->len) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->buffer + w->len, text, n);
+    w->len += n;
+}
+
+static void put_escaped(json_writer_t *w, const char *text) {
+    put(w, "\"", 1);
+    const char *run = text; // Trecho sem escapes, copiado de uma vez
+    for (; *text; text++) {
+        unsigned char c = (unsigned char)*text;
+        if (c != '"' && c != '\\' && c >= 0x20) {
+            continue;
+        }
+        put(w, run, (size_t)(text - run));
+        char escape[6] = {'\\', (char)c, 0, 0, 0, 0};
+        size_t n = 2;
+        if (c < 0x20) {
+            const char *hex = "0123456789abcdef";
+            escape[1] = 'u';
+            escape[2] = '0';
+            escape[3] = '0';
+            escape[4] = hex[c >> 4];
+            escape[5] = hex[c & 0xf];
+            n = 6;
+        }
+        put(w, escape, n);
+        run = text + 1;
+    }
+    put(w, run, (size_t)(text - run));
+    put(w, "\"", 1);
+}
+
+// Vírgula (se não for o primeiro valor do nível) e "nome":
+static void put_name(json_writer_t *w, const char *name) {
+    if (w->need_comma) {
+        put(w, ",", 1);
+    }
+    if (name != NULL) {
+        put_escaped(w, name);
+        put(w, ":", 1);
+    }
+}
+
+void json_begin_object(json_writer_t *w, const char *name) {
+    put_name(w, name);
+    put(w, "{", 1);
+    w->need_comma = false;
+}
+
+void json_end_object(json_writer_t *w) {
+    put(w, "}", 1);
+    w->need_comma = true;
+}
+
+void json_begin_array(json_writer_t *w, const char *name) {
+    put_name(w, name);
+    put(w, "[", 1);
+    w->need_comma = false;
+}
+
+void json_end_array(json_writer_t *w) {
+    put(w, "]", 1);
+    w->need_comma = true;
+}
+
+void json_write_fixed(json_writer_t *w, const char *name, int32_t value, uint8_t decimals) {
+    char text[24];
+    size_t n = json_format_fixed(value, decimals, text, sizeof(text));
+    put_name(w, name);
+    put(w, text, n);
+    w->need_comma = true;
+}
+
+void json_write_int(json_writer_t *w, const char *name, int32_t value) {
+    json_write_fixed(w, name, value, 0);
+}
+
+void json_write_uint(json_writer_t *w, const char *name, uint32_t value) {
+    char digits[10];
+    int n = format_uint(value, digits);
+    put_name(w, name);
+    put(w, digits, (size_t)n);
+    w->need_comma = true;
+}
+
+void json_write_bool(json_writer_t *w, const char *name, bool value) {
+    put_name(w, name);
+    put(w, value ? "true" : "false", value ? 4 : 5);
+    w->need_comma = true;
+}
+
+void json_write_string(json_writer_t *w, const char *name, const char *value) {
+    put_name(w, name);
+    put_escaped(w, value);
+    w->need_comma = true;
+}
+
+size_t json_writer_finish(json_writer_t *w) {
+    if (w->overflow || w->size == 0) {
+        return 0;
+    }
+    w->buffer[w->len] = '\0';
+    return w->len;
+}
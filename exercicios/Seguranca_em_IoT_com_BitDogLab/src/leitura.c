@@ -0,0 +1,133 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/leitura.h"
+#include "include/json.h" // Tokenizador e escritor de JSON
+#include "include/cbor.h" // Codificação binária
+#include <stddef.h>       // Para offsetof()
+
+// Campos da mensagem: nome no JSON, tipo e posição na struct
+static const json_field_t campos_json[] = {
+    {"valor", JSON_FIELD_FIXED, LEITURA_DECIMALS, true, offsetof(leitura_t, valor), 0},
+    {"ts", JSON_FIELD_UINT, 0, true, offsetof(leitura_t, ts), 0},
+};
+
+// Os mesmos campos no CBOR: chave inteira no lugar do nome, "valor" como inteiro em centésimos (a escala é a do JSON)
+static const cbor_field_t campos_cbor[] = {
+    {LEITURA_CBOR_VALOR, CBOR_FIELD_INT, true, offsetof(leitura_t, valor), 0},
+    {LEITURA_CBOR_TS, CBOR_FIELD_UINT, true, offsetof(leitura_t, ts), 0},
+};
+
+static void escrever_json(json_writer_t *w, const leitura_t *leitura) {
+    json_begin_object(w, NULL);
+    json_write_fixed(w, "valor", leitura->valor, LEITURA_DECIMALS);
+    json_write_uint(w, "ts", leitura->ts);
+    json_end_object(w);
+}
+
+static void escrever_cbor(cbor_writer_t *w, const leitura_t *leitura) {
+    cbor_begin_map(w, 2);
+    cbor_write_uint(w, LEITURA_CBOR_VALOR);
+    cbor_write_int(w, leitura->valor);
+    cbor_write_uint(w, LEITURA_CBOR_TS);
+    cbor_write_uint(w, leitura->ts);
+}
+
+// Monta o texto direto no buffer de destino (no publisher, a área de texto claro do pacote)
+size_t leitura_to_json(const leitura_t *leitura, char *out, size_t size) {
+    json_writer_t w;
+    json_writer_init(&w, out, size);
+    escrever_json(&w, leitura);
+    return json_writer_finish(&w);
+}
+
+bool leitura_from_json(const char *text, size_t len, leitura_t *leitura) {
+    return json_parse_object(text, len, campos_json, sizeof(campos_json) / sizeof(campos_json[0]), leitura);
+}
+
+size_t leitura_to_cbor(const leitura_t *leitura, uint8_t *out, size_t size) {
+    cbor_writer_t w;
+    cbor_writer_init(&w, out, size);
+    escrever_cbor(&w, leitura);
+    return cbor_writer_finish(&w);
+}
+
+bool leitura_from_cbor(const uint8_t *data, size_t len, leitura_t *leitura) {
+    return cbor_parse_map(data, len, campos_cbor, sizeof(campos_cbor) / sizeof(campos_cbor[0]), leitura);
+}
+
+size_t leitura_encode(leitura_formato_t formato, const leitura_t *leitura, uint8_t *out, size_t size) {
+    if (formato == LEITURA_CBOR) {
+        return leitura_to_cbor(leitura, out, size);
+    }
+    return leitura_to_json(leitura, (char *)out, size);
+}
+
+/**
+ * Lê uma mensagem em qualquer um dos formatos
+ *
+ * Funcionamento:
+ * - Um mapa CBOR começa com um byte de 0xa0 a 0xbf (tipo principal 5); o JSON começa com '{' (0x7b) ou espaço,
+ *   então o primeiro byte basta para escolher o leitor
+ */
+bool leitura_decode(const uint8_t *data, size_t len, leitura_t *leitura, leitura_formato_t *formato) {
+    if (len > 0 && (data[0] >> 5) == CBOR_MAJOR_MAP) {
+        *formato = LEITURA_CBOR;
+        return leitura_from_cbor(data, len, leitura);
+    }
+    *formato = LEITURA_JSON;
+    return leitura_from_json((const char *)data, len, leitura);
+}
+
+// Lote: array com as mensagens na ordem, no mesmo formato de uma leitura avulsa
+size_t leitura_lote_encode(leitura_formato_t formato, const leitura_t *leituras, size_t count, uint8_t *out, size_t size) {
+    if (formato == LEITURA_CBOR) {
+        cbor_writer_t w;
+        cbor_writer_init(&w, out, size);
+        cbor_begin_array(&w, (uint32_t)count);
+        for (size_t i = 0; i < count; i++) {
+            escrever_cbor(&w, &leituras[i]);
+        }
+        return cbor_writer_finish(&w);
+    }
+    json_writer_t w;
+    json_writer_init(&w, (char *)out, size);
+    json_begin_array(&w, NULL);
+    for (size_t i = 0; i < count; i++) {
+        escrever_json(&w, &leituras[i]);
+    }
+    json_end_array(&w);
+    return json_writer_finish(&w);
+}
+
+/**
+ * Lê um lote ou uma leitura avulsa, em qualquer um dos formatos
+ *
+ * Funcionamento:
+ * - CBOR: array (0x80 a 0x9f) ou mapa (0xa0 a 0xbf) no primeiro byte; JSON: '[' ou '{' depois dos espaços
+ * - Uma leitura avulsa conta como um lote de uma, então o subscriber trata os dois casos igual
+ * - Retorna quantas leituras foram gravadas (no máximo "max"), ou -1 se a mensagem for inválida
+ */
+int leitura_lote_decode(const uint8_t *data, size_t len, leitura_t *leituras, size_t max, leitura_formato_t *formato) {
+    if (max == 0) {
+        return -1;
+    }
+    uint8_t major = len > 0 ? data[0] >> 5 : 0;
+    if (len > 0 && (major == CBOR_MAJOR_ARRAY || major == CBOR_MAJOR_MAP)) {
+        *formato = LEITURA_CBOR;
+        if (major == CBOR_MAJOR_MAP) {
+            return leitura_from_cbor(data, len, leituras) ? 1 : -1;
+        }
+        return cbor_parse_array(data, len, campos_cbor, sizeof(campos_cbor) / sizeof(campos_cbor[0]), leituras, sizeof(leitura_t), max);
+    }
+
+    *formato = LEITURA_JSON;
+    size_t i = 0;
+    while (i < len && (data[i] == ' ' || data[i] == '\t' || data[i] == '\n' || data[i] == '\r')) i++;
+    if (i < len && data[i] == '[') {
+        return json_parse_array((const char *)data, len, campos_json, sizeof(campos_json) / sizeof(campos_json[0]), leituras, sizeof(leitura_t), max);
+    }
+    return leitura_from_json((const char *)data, len, leituras) ? 1 : -1;
+}
+
+const char *leitura_formato_nome(leitura_formato_t formato) {
+    return formato == LEITURA_CBOR ? "CBOR" : "JSON";
+}
@@ -0,0 +1,117 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/mqtt_batch.h"
+#include "include/mqtt_rx.h" // Tamanho do buffer do subscriber
+#include <string.h>          // Para memset()
+
+_Static_assert(MQTT_BATCH_PACKET_BYTES <= MQTT_RX_BUFFER_BYTES, "o subscriber precisa aceitar o maior lote");
+
+// Área de texto claro do pacote: depois do cabeçalho da cifra, ou o pacote inteiro sem criptografia
+static uint8_t *plaintext(mqtt_batch_t *batch) {
+    return batch->crypto != NULL ? payload_plaintext(batch->packet) : batch->packet;
+}
+
+void mqtt_batch_init(mqtt_batch_t *batch, const mqtt_batch_config_t *config, payload_ctx_t *crypto,
+                     mqtt_batch_publish_t publish, void *arg) {
+    memset(batch, 0, sizeof(*batch));
+    batch->config = *config;
+    batch->crypto = crypto;
+    batch->publish = publish;
+    batch->arg = arg;
+
+    // Limites fora da faixa viram o mais próximo possível
+    size_t capacity = MQTT_BATCH_PACKET_BYTES - (crypto != NULL ? PAYLOAD_OVERHEAD : 0);
+    if (batch->config.max_bytes == 0 || batch->config.max_bytes > capacity) {
+        batch->config.max_bytes = (uint16_t)capacity;
+    }
+    if (batch->config.max_count == 0) {
+        batch->config.max_count = 1;
+    } else if (batch->config.max_count > MQTT_BATCH_MAX_READINGS) {
+        batch->config.max_count = MQTT_BATCH_MAX_READINGS;
+    }
+}
+
+// Codifica as leituras do lote na área de texto claro; 0 se não couberem em max_bytes
+static size_t encode(mqtt_batch_t *batch, uint8_t count) {
+    return leitura_lote_encode(batch->config.formato, batch->leituras, count, plaintext(batch), batch->config.max_bytes);
+}
+
+// Cifra e publica o lote, que fica vazio mesmo se a publicação falhar
+static bool send(mqtt_batch_t *batch) {
+    size_t size = batch->len;
+    if (batch->crypto != NULL) {
+        size = payload_seal(batch->crypto, batch->packet, batch->len, sizeof(batch->packet));
+    }
+    bool ok = size > 0 && batch->publish(batch->config.topic, batch->packet, size, batch->config.qos, batch->arg);
+    if (ok) {
+        batch->stats.batches++;
+        batch->stats.bytes += (uint32_t)size;
+    } else {
+        batch->stats.dropped += batch->count;
+    }
+
+    batch->count = 0;
+    batch->len = 0;
+    return ok;
+}
+
+/**
+ * Acrescenta uma leitura ao lote
+ *
+ * @param batch   Lote do tópico
+ * @param leitura Leitura a publicar
+ * @param now_ms  Tempo atual em ms (ex.: to_ms_since_boot(get_absolute_time()))
+ *
+ * Funcionamento:
+ * - O lote é recodificado a cada leitura direto na área de texto claro do pacote: no envio, só falta cifrar
+ * - Se a leitura nova não couber em max_bytes, o lote anterior é codificado de novo e enviado, e a leitura começa
+ *   o lote seguinte
+ * - Ao atingir max_count, o lote sai na hora
+ */
+bool mqtt_batch_add(mqtt_batch_t *batch, const leitura_t *leitura, uint32_t now_ms) {
+    if (batch->count == 0) {
+        batch->oldest_ms = now_ms;
+    }
+    batch->leituras[batch->count] = *leitura;
+    size_t len = encode(batch, batch->count + 1);
+
+    if (len == 0 && batch->count > 0) {
+        batch->len = encode(batch, batch->count);
+        batch->stats.flush_bytes++;
+        send(batch);
+
+        batch->oldest_ms = now_ms;
+        batch->leituras[0] = *leitura;
+        len = encode(batch, 1);
+    }
+    if (len == 0) { // Uma leitura sozinha já passa de max_bytes
+        batch->stats.dropped++;
+        return false;
+    }
+
+    batch->count++;
+    batch->len = len;
+    batch->stats.readings++;
+
+    if (batch->count >= batch->config.max_count) {
+        batch->stats.flush_count++;
+        send(batch);
+    }
+    return true;
+}
+
+// Chamar com frequência no laço principal: envia o lote cuja leitura mais antiga já esperou max_latency_ms
+void mqtt_batch_poll(mqtt_batch_t *batch, uint32_t now_ms) {
+    if (batch->count > 0 && now_ms - batch->oldest_ms >= batch->config.max_latency_ms) {
+        batch->stats.flush_latency++;
+        send(batch);
+    }
+}
+
+// Envia o lote antes do prazo (ex.: antes de dormir ou desligar)
+bool mqtt_batch_flush(mqtt_batch_t *batch) {
+    if (batch->count == 0) {
+        return true;
+    }
+    batch->stats.flush_manual++;
+    return send(batch);
+}
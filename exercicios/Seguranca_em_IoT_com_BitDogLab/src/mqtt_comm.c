@@ -1,7 +1,18 @@
 #include "lwip/apps/mqtt.h"       // Biblioteca MQTT do lwIP
 #include "include/mqtt_comm.h"    // Header file com as declarações locais
 #include "lwipopts.h"             // Configurações customizadas do lwIP. Esse header foi retirado do seguinte link: https://github.com/BitDogLab/BitDogLab-C/blob/main/wifi_button_and_led/lwipopts.h 
-#include "include/xor_cipher.h"   // Funções de cifra XOR
+#include "include/mqtt_rx.h"      // Remontagem, decifragem e entrega das mensagens recebidas
+#include "include/leitura.h"      // Formato da mensagem do sensor
+#include "include/json.h"         // Texto de valores em ponto fixo
+#include "include/replay.h"       // Janela contra replay por remetente
+#include "include/topic_router.h" // Tratador de cada filtro de tópico assinado
+#include "include/conn_manager.h" // Conexão e reconexão sem bloqueio
+#include "include/outbox.h"       // Fila de saída das publicações (RAM e flash)
+#include "include/wifi_conn.h"    // Operações do Wi-Fi usadas pelo gerenciador de conexão
+#include "include/mqtt_tls.h"     // TLS no enlace com o broker (porta 8883)
+#include "pico/stdlib.h"           // Tempo desde o boot (prazos da conexão)
+#include "pico/cyw43_arch.h"      // cyw43_arch_lwip_begin/end: chamadas ao lwIP fora dos callbacks
+#include "pico/rand.h"            // Sorteio da espera entre tentativas
 #include <stdint.h>               // Biblioteca que permite o uso de tipos inteiros com tamanho fixo
 #include <stdlib.h>               // Biblioteca padrão para funções utilitárias como alocação de memória
 #include <string.h>               // Para funções de string como strlen()
@@ -11,64 +22,85 @@
  * 'static' limita o escopo deste arquivo */
 static mqtt_client_t *client;
 
-static uint32_t ultima_timestamp_recebida = 0; // Armazena o último timestamp válido da última mensagem recebida para detectar e ignorar mensagens repetidas 
+// Broker e identificação guardados em mqtt_setup(): cada reconexão usa os mesmos dados
+static ip_addr_t broker_addr;
+static struct mqtt_connect_client_info_t client_info;
+static u16_t broker_port = 1883; // 8883 com TLS
+static bool tls_requested; // mqtt_comm_set_tls() foi chamada: sem TLS pronto, não conecta em texto claro
+
+// Wi-Fi, CONNECT e assinaturas avançam em mqtt_comm_poll(), sem bloquear; cada falha espera de 1 s a 60 s (dobrando,
+// com sorteio) antes de tentar de novo
+static conn_manager_t conexao;
+static const conn_config_t conexao_config = {
+    .wifi_timeout_ms = 30000, // Associação + DHCP (o mesmo limite de 30 s da conexão bloqueante anterior)
+    .mqtt_timeout_ms = 10000, // CONNACK e cada SUBACK
+    .backoff_min_ms = 1000,
+    .backoff_max_ms = 60000,
+};
+
+// Fila de saída: 8 mensagens na RAM e o resto num log nos últimos 32 KB da flash, que sobrevive a resets. Na volta da
+// conexão sai uma mensagem a cada 200 ms, com até 4 aguardando a confirmação (PUBACK no QoS 1)
+static outbox_t saida;
+static const outbox_config_t saida_config = {
+    .drain_interval_ms = 200,
+    .max_inflight = 4,
+    .ack_timeout_ms = 30000, // O mesmo prazo dos pedidos do cliente MQTT do lwIP (MQTT_REQ_TIMEOUT)
+};
+
+_Static_assert(MQTT_RX_FLAG_LAST == MQTT_DATA_FLAG_LAST, "mqtt_rx usa o mesmo bit de ultimo fragmento do lwIP");
+
+// Proteção contra replay: janela de 64 mensagens por remetente (salt e contador do nonce, conferidos em mqtt_rx_poll()).
+// Substitui o último timestamp global, que fazia dois publishers se rejeitarem, descartava mensagens do QoS 1 fora de ordem
+// e dependia do time(NULL), que no Pico não é um relógio de verdade
+static replay_table_t janela_replay;
+
+// Tratadores por filtro de tópico (com curingas): comandos, configuração e leituras de sensores na mesma placa
+static topic_router_t rotas;
+
+// Tratador das mensagens completas, chamado por mqtt_rx_poll() no laço principal (fora da interrupção do lwIP)
+// Recebe a mensagem já remontada, decifrada e autenticada (terminada em '\0', o que só importa para o JSON)
+static void tratar_leitura(const char *topic, char *mensagem, size_t len, void *arg) {
+    // Parse da mensagem em JSON ou CBOR (o formato é reconhecido pelo primeiro byte); um lote traz várias leituras
+    // Aceita as chaves em qualquer ordem; "valor" chega em ponto fixo (centésimos), sem float
+    leitura_t leituras[LEITURA_LOTE_MAX];
+    leitura_formato_t formato;
+    int quantidade = leitura_lote_decode((const uint8_t *)mensagem, len, leituras, LEITURA_LOTE_MAX, &formato);
+    if (quantidade < 0) {
+        if (formato == LEITURA_JSON) {
+            printf("Erro no parse da mensagem no formato JSON: %s\n", mensagem); // Caso o formato da mensagem esteja incorreto, exibe erro
+        } else {
+            printf("Erro no parse da mensagem no formato CBOR (%u bytes)\n", (unsigned)len);
+        }
+        return;
+    }
+
+    // A mensagem já passou pela janela contra replay (repetidas e antigas nem chegam aqui)
+    for (int i = 0; i < quantidade; i++) {
+        char valor[16];
+        json_format_fixed(leituras[i].valor, LEITURA_DECIMALS, valor, sizeof(valor));
+        printf("Nova leitura: %s (ts: %lu, %s)\n", valor, leituras[i].ts, leitura_formato_nome(formato)); // Exibe a nova leitura válida
+    }
+}
+
+// Entrega cada mensagem completa ao tratador do filtro que casa com o tópico dela (chamada por mqtt_rx_poll())
+static void rotear(const char *topic, char *mensagem, size_t len, void *arg) {
+    if (topic_router_dispatch(&rotas, topic, mensagem, len) == 0) {
+        printf("Mensagem sem tratador no topico %s\n", topic);
+    }
+}
 
 // Callback chamado automaticamente quando uma nova publicação MQTT é detectada em um tópico assinado
-// Esta função é usada apenas para notificar que uma nova mensagem chegou
+// Anuncia o tópico e o tamanho total: a recepção reserva um buffer (ou recusa a mensagem, se não couber) e guarda o
+// tópico junto, para os fragmentos seguintes; o tratador do tópico é escolhido em mqtt_comm_poll()
 static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len) {
-    printf("Mensagem recebida no tópico: %s (tamanho total: %u)\n", topic, tot_len);  // Exibe no terminal o nome do tópico onde a mensagem foi publicada e o tamanho total da mensagem recebida
+    mqtt_rx_begin(topic, tot_len);
 }
 
 // Callback chamado automaticamente quando os dados de uma mensagem MQTT publicada são recebidos
-// Esse é o ponto onde o conteúdo da mensagem é acessado e tratado (diferente do callback anterior que só detecta a publicação)
+// Mensagens grandes chegam em vários fragmentos; o último vem com MQTT_DATA_FLAG_LAST
+// Aqui só se junta os fragmentos: a decifragem e o parse ficam para mqtt_comm_poll(), no laço principal
 static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags) {
-
-    // Caso queira receber uma mensagem sem criptografia, utilize apenas as linhas 27, 29, 31, 33, 47, 48, 52 a 55 e 65 a 71
-    //char mensagem[128]; // Buffer para armazenar a mensagem sem criptografia no formato de string
-
-    //if (len >= sizeof(mensagem)) len = sizeof(mensagem) - 1; // Garante que não haverá overflow caso a mensagem seja maior que o buffer
-
-    //memcpy(mensagem, data, len); // Copia os dados recebidos (data) para o buffer local (mensagem)
-
-    //mensagem[len] = '\0'; // Adiciona caractere nulo ao final para garantir que a string seja válida
-
-    // Caso queira receber uma mensagem criptografada, utilize apenas as linhas 36, 38, 41, 43, 47, 48, 58 a 61 e 65 a 71
-    uint8_t decifrada[128]; // Buffer para armazenar a mensagem descriptografada
-
-    if (len >= sizeof(decifrada)) len = sizeof(decifrada) - 1; // Garante que não haverá overflow caso a mensagem seja maior que o buffer
-
-    // Descriptografar com XOR
-    xor_encrypt(data, decifrada, len, 42);
-
-    decifrada[len] = '\0'; // Adiciona caractere nulo ao final para garantir que a string seja válida
-
-    // Parse do JSON da mensagem (análise da mensagem no formato JSON)
-    // Declaração de variáveis para armazenar os dados extraídos do JSON
-    float valor; // valor da leitura (ex: temperatura)
-    uint32_t nova_ts; // timestamp da mensagem recebida
-
-    // Faz o parse da string JSON recebida, extraindo "valor" e "ts"
-    // Retorna o número de variáveis preenchidas (deve ser 2: valor e timestamp)
-    //if (sscanf(mensagem, "{\"valor\":%f,\"ts\":%lu}", &valor, &nova_ts) != 2) {
-        //printf("Erro no parse da mensagem no formato JSON: %s\n", mensagem); // Caso o formato da mensagem esteja incorreto, exibe a mensagem original e sai da função
-        //return;
-    //}
-
-    // Faz o parse da string JSON recebida, extraindo "valor" e "ts"
-    if (sscanf((char *)decifrada, "{\"valor\":%f,\"ts\":%lu}", &valor, &nova_ts) != 2) {
-        printf("Erro no parse da mensagem no formato JSON: %s\n", decifrada); // Caso o formato da mensagem esteja incorreto, exibe erro
-        return;
-    }
-
-    // Verificação contra replay
-     // Se o timestamp for mais recente que o último armazenado, a mensagem é aceita
-    if (nova_ts > ultima_timestamp_recebida) {
-        ultima_timestamp_recebida = nova_ts; // Atualiza o último timestamp recebido
-        printf("Nova leitura: %.2f (ts: %lu)\n", valor, nova_ts); // Exibe a nova leitura válida
-        
-    } else {
-        printf("Replay detectado (ts: %lu <= %lu)\n", nova_ts, ultima_timestamp_recebida); // Caso o timestamp seja repetido ou antigo, considera replay e ignora
-    }
+    mqtt_rx_data(data, len, flags);
 }
 
 // Função de callback chamada após uma tentativa de inscrição (subscribe) em um tópico MQTT
@@ -79,6 +111,7 @@ static void mqtt_sub_request_cb(void *arg, err_t result) {
     } else {
         printf("Erro ao se inscrever no tópico: %d\n", result);  // Caso ocorra erro na inscrição, exibe o código do erro retornado
     }
+    conn_event_subscribed(&conexao, result == ERR_OK); // A próxima assinatura (ou a volta ao ONLINE) fica para conn_poll()
 }
 
 /* Callback de conexão MQTT - chamado quando o status da conexão muda
@@ -89,31 +122,153 @@ static void mqtt_sub_request_cb(void *arg, err_t result) {
 static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection_status_t status) {
     if (status == MQTT_CONNECT_ACCEPTED) {
         printf("Conectado ao broker MQTT com sucesso!\n");
+        mqtt_tls_connected(client, to_ms_since_boot(get_absolute_time())); // Tempo do handshake e sessão para a próxima vez
 
         // Configura os callbacks do subscriber para mensagens recebidas
         mqtt_set_inpub_callback(client, mqtt_incoming_publish_cb, mqtt_incoming_data_cb, NULL); 
-
+        conn_event_mqtt_up(&conexao);
     } else {
+        // Recusa do broker, tempo esgotado ou queda de uma conexão que estava de pé: o gerenciador espera e reconecta
         printf("Falha ao conectar ao broker, código: %d\n", status);
+        mqtt_tls_closed();
+        conn_event_mqtt_down(&conexao);
+    }
+}
+
+/* Callback de confirmação de publicação
+ * Chamado quando o broker confirma recebimento da mensagem (QoS 1) ou quando ela é enviada (QoS 0)
+ * Parâmetros:
+ *   - arg: token da mensagem na fila de saída
+ *   - result: código de resultado da operação */
+static void mqtt_pub_request_cb(void *arg, err_t result) {
+    if (result == ERR_OK) {
+        printf("Publicação MQTT enviada com sucesso!\n");
+    } else {
+        printf("Erro ao publicar via MQTT: %d\n", result);
+    }
+    outbox_event_ack(&saida, (uint32_t)(uintptr_t)arg, result == ERR_OK); // Sai da fila (ou é reenviada) em outbox_poll()
+}
+
+// Operações do gerenciador de conexão: só disparam a ação no lwIP; o resultado chega pelos callbacks acima
+
+static bool conexao_mqtt_start(void *arg) {
+    cyw43_arch_lwip_begin();
+    mqtt_tls_begin(to_ms_since_boot(get_absolute_time()));
+    err_t status = mqtt_client_connect(client, &broker_addr, broker_port, mqtt_connection_cb, NULL, &client_info);
+    if (status == ERR_OK) {
+        mqtt_tls_setup(client); // Antes do handshake, que só começa depois que o TCP conectar
+    }
+    cyw43_arch_lwip_end();
+    return status == ERR_OK;
+}
+
+static void conexao_mqtt_stop(void *arg) {
+    cyw43_arch_lwip_begin();
+    mqtt_disconnect(client); // Não chama mqtt_connection_cb
+    cyw43_arch_lwip_end();
+}
+
+static bool conexao_mqtt_subscribe(const char *topic, uint8_t qos, void *arg) {
+    cyw43_arch_lwip_begin();
+    err_t status = mqtt_subscribe(client, topic, qos, mqtt_sub_request_cb, NULL);
+    cyw43_arch_lwip_end();
+    return status == ERR_OK;
+}
+
+static uint32_t conexao_random(void *arg) {
+    return get_rand_32();
+}
+
+static const conn_ops_t conexao_ops = {
+    .wifi_start = wifi_conn_start,
+    .wifi_stop = wifi_conn_stop,
+    .wifi_status = wifi_conn_status,
+    .mqtt_start = conexao_mqtt_start,
+    .mqtt_stop = conexao_mqtt_stop,
+    .mqtt_subscribe = conexao_mqtt_subscribe,
+    .random = conexao_random,
+};
+
+// Envio da fila de saída: o token volta em mqtt_pub_request_cb()
+static bool saida_publish(const char *topic, const uint8_t *data, size_t len, uint8_t qos, uint32_t token, void *arg) {
+    cyw43_arch_lwip_begin();
+    err_t status = mqtt_publish(client, topic, data, (u16_t)len, qos, 0, mqtt_pub_request_cb, (void *)(uintptr_t)token);
+    cyw43_arch_lwip_end();
+    if (status != ERR_OK) {
+        printf("Publicação MQTT falhou ao ser enviada: %d\n", status); // Sem espaço no buffer de saída: tenta de novo depois
+        return false;
+    }
+    return true;
+}
+
+// Mostra cada troca de estado da conexão no terminal serial
+static void conexao_mudou(conn_state_t from, conn_state_t to, void *arg) {
+    if (to == CONN_BACKOFF) {
+        printf("Conexao: %s -> %s (%lu ms)\n", conn_state_name(from), conn_state_name(to), (unsigned long)conexao.wait_ms);
+    } else {
+        printf("Conexao: %s -> %s\n", conn_state_name(from), conn_state_name(to));
+    }
+}
+
+// Define a cifra usada para abrir as mensagens recebidas (a mesma chave do publisher)
+void mqtt_comm_set_payload_crypto(payload_ctx_t *ctx) {
+    mqtt_rx_init(ctx, rotear, NULL);
+    replay_init(&janela_replay);
+    mqtt_rx_set_replay(&janela_replay);
+}
+
+/* Liga o TLS no enlace com o broker (porta 8883); chamar antes de mqtt_setup() e de qualquer outro uso do mbedTLS
+ * Parâmetros:
+ *   - ca_pem: certificado da CA que assinou o do broker (ou o do próprio broker, se autoassinado), em PEM
+ *   - hostname: nome no certificado do broker (NULL: confere só a CA e o pino)
+ *   - pin: SHA-256 da chave pública do broker (NULL: sem pino)
+ * Se falhar (certificado inválido ou firmware sem a opção MQTT_TLS), mqtt_setup() não conecta: o usuário e a senha não
+ * vão em texto claro por engano */
+bool mqtt_comm_set_tls(const char *ca_pem, const char *hostname, const uint8_t *pin) {
+    tls_requested = true;
+    return mqtt_tls_init(ca_pem, hostname, pin);
+}
+
+// Trata as mensagens recebidas completas (chamar com frequência no laço principal)
+void mqtt_comm_poll(void) {
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    conn_poll(&conexao, agora); // Wi-Fi, reconexão e assinaturas
+    outbox_poll(&saida, agora, conn_state(&conexao) == CONN_ONLINE); // Confirmações e envios da fila de saída
+    mqtt_rx_poll();
+
+    // Avisa quando a janela contra replay descarta mensagens (repetidas ou antigas demais)
+    static uint32_t replays_avisados = 0;
+    mqtt_rx_stats_t stats;
+    mqtt_rx_get_stats(&stats);
+    if (stats.dropped_replay != replays_avisados) {
+        printf("Replay detectado: %lu mensagem(ns) descartada(s)\n", (unsigned long)(stats.dropped_replay - replays_avisados));
+        replays_avisados = stats.dropped_replay;
     }
 }
 
-/* Função para configurar e iniciar a conexão MQTT
+/* Função para configurar o cliente MQTT e iniciar a conexão (Wi-Fi e broker) sem bloquear
+ * A conexão avança em mqtt_comm_poll() e é refeita sozinha depois de quedas; chame wifi_conn_init() antes
  * Parâmetros:
  *   - client_id: identificador único para este cliente
  *   - broker_ip: endereço IP do broker como string (ex: "192.168.1.1")
  *   - user: nome de usuário para autenticação (pode ser NULL)
- *   - pass: senha para autenticação (pode ser NULL) */
+ *   - pass: senha para autenticação (pode ser NULL)
+ * As strings precisam continuar valendo (literais): são usadas de novo a cada reconexão */
 void mqtt_setup(const char *client_id, const char *broker_ip, const char *user, const char *pass) {
-    ip_addr_t broker_addr;  // Estrutura para armazenar o IP do broker
-    
+    topic_router_init(&rotas);
+
     // Converte o IP de string para formato numérico
     if (!ip4addr_aton(broker_ip, &broker_addr)) {
         printf("Erro no IP\n");
         return;
     }
 
-    // Cria uma nova instância do cliente MQTT
+    if (tls_requested && !mqtt_tls_enabled()) {
+        printf("TLS pedido, mas nao configurado: conexao cancelada\n");
+        return;
+    }
+
+    // Cria uma nova instância do cliente MQTT (reaproveitada em todas as reconexões)
     client = mqtt_client_new();
     if (client == NULL) {
         printf("Falha ao criar o cliente MQTT\n");
@@ -121,25 +276,44 @@ void mqtt_setup(const char *client_id, const char *broker_ip, const char *user,
     }
 
     // Configura as informações de conexão do cliente
-    struct mqtt_connect_client_info_t ci = {
+    client_info = (struct mqtt_connect_client_info_t){
         .client_id = client_id,  // ID do cliente
         .client_user = user,     // Usuário (opcional)
-        .client_pass = pass      // Senha (opcional)
+        .client_pass = pass,     // Senha (opcional)
+        .keep_alive = 60         // PINGREQ a cada 60 s: sem resposta, o lwIP fecha a conexão e a queda é percebida
     };
+    if (mqtt_tls_enabled()) {
+        mqtt_tls_client_info(&client_info);
+        broker_port = MQTT_TLS_PORT;
+    }
+
+    // Mensagens que ficaram na flash antes de um reset voltam para a fila
+    outbox_init(&saida, &saida_config, &outbox_flash_pico, saida_publish, NULL);
+    outbox_stats_t stats;
+    outbox_get_stats(&saida, &stats);
+    if (stats.recovered > 0 || stats.torn > 0) {
+        printf("Fila de saida: %lu mensagem(ns) recuperada(s) da flash, %lu registro(s) interrompido(s)\n",
+               (unsigned long)stats.recovered, (unsigned long)stats.torn);
+    }
 
-    // Inicia a conexão com o broker
-    // Parâmetros:
-    //   - client: instância do cliente
-    //   - &broker_addr: endereço do broker
-    //   - 1883: porta padrão MQTT
-    //   - mqtt_connection_cb: callback de status
-    //   - NULL: argumento opcional para o callback
-    //   - &ci: informações de conexão
-    mqtt_client_connect(client, &broker_addr, 1883, mqtt_connection_cb, NULL, &ci);
+    // A conexão com o broker (porta padrão 1883) é feita pelo gerenciador quando o Wi-Fi tiver IP
+    conn_init(&conexao, &conexao_config, &conexao_ops, NULL);
+    conn_set_hook(&conexao, conexao_mudou, NULL);
+    conn_start(&conexao, to_ms_since_boot(get_absolute_time()));
 }
 
 // Função para inscrever o cliente MQTT em um tópico específico para receber mensagens publicadas por outros dispositivos
+// As mensagens vão para o tratador das leituras de sensor; o tópico pode ter curingas (ex.: "escola/+/temperatura")
 void mqtt_comm_subscribe(const char *topic) {
+    mqtt_comm_subscribe_handler(topic, tratar_leitura, NULL);
+}
+
+/* Assina um filtro de tópico com um tratador próprio (ex.: comandos ou configuração)
+ * Parâmetros:
+ *   - filter: filtro MQTT, com "+" (um nível) e "#" (o resto); precisa continuar valendo (literal)
+ *   - handler: recebe o tópico e a mensagem já decifrada e conferida contra replay, no laço principal
+ * Uma mensagem que casa com mais de um filtro vai para todos os tratadores deles */
+void mqtt_comm_subscribe_handler(const char *filter, topic_handler_t handler, void *arg) {
 
     // Verifica se o cliente MQTT foi inicializado corretamente
     if (client == NULL) {
@@ -147,25 +321,15 @@ void mqtt_comm_subscribe(const char *topic) {
         return;
     }
 
-    // Registra os callbacks de publicação e dados recebidos
-    // - mqtt_incoming_publish_cb: chamado ao receber o cabeçalho da mensagem (tópico, tamanho etc.)
-    // - mqtt_incoming_data_cb: chamado ao receber o conteúdo (payload) da mensagem
-    mqtt_set_inpub_callback(client, mqtt_incoming_publish_cb, mqtt_incoming_data_cb, NULL);
-
-    // Inscreve-se no tópico especificado
-    mqtt_subscribe(client, topic, 0, mqtt_sub_request_cb, NULL);
-}
+    if (!topic_router_add(&rotas, filter, handler, arg)) {
+        printf("Filtro de topico invalido ou sem espaco: %s\n", filter);
+        return;
+    }
 
-/* Callback de confirmação de publicação
- * Chamado quando o broker confirma recebimento da mensagem (para QoS > 0)
- * Parâmetros:
- *   - arg: argumento opcional
- *   - result: código de resultado da operação */
-static void mqtt_pub_request_cb(void *arg, err_t result) {
-    if (result == ERR_OK) {
-        printf("Publicação MQTT enviada com sucesso!\n");
-    } else {
-        printf("Erro ao publicar via MQTT: %d\n", result);
+    // Registra o tópico: a assinatura é feita a cada conexão (e refeita depois de quedas) pelo gerenciador
+    // Os callbacks de publicação e dados recebidos são registrados em mqtt_connection_cb()
+    if (!conn_subscribe(&conexao, filter, 0)) {
+        printf("Muitos topicos assinados (maximo %d)\n", CONN_MAX_SUBSCRIPTIONS);
     }
 }
 
@@ -175,24 +339,36 @@ static void mqtt_pub_request_cb(void *arg, err_t result) {
  *   - data: payload da mensagem (bytes)
  *   - len: tamanho do payload */
 void mqtt_comm_publish(const char *topic, const uint8_t *data, size_t len) {
+    mqtt_comm_publish_qos(topic, data, len, 0);
+}
+
+/* Publica com o QoS escolhido e informa se a mensagem foi aceita na fila de saída, que a envia com a conexão de pé e
+ * só a remove com a confirmação do lwIP (o payload é copiado: o buffer pode ser reaproveitado logo depois)
+ * Parâmetros:
+ *   - topic: precisa continuar valendo (literal ou estático) enquanto a mensagem estiver na RAM
+ *   - qos: 0 (sai da fila quando é enviada) ou 1 (sai com o PUBACK do broker, ver mqtt_pub_request_cb) */
+bool mqtt_comm_publish_qos(const char *topic, const uint8_t *data, size_t len, uint8_t qos) {
     if (client == NULL) {
         printf("Cliente MQTT não inicializado\n");
-        return;
+        return false;
     }
-    
-    // Envia a mensagem MQTT
-    err_t status = mqtt_publish(
-        client,              // Instância do cliente
-        topic,               // Tópico de publicação
-        data,                // Dados a serem enviados
-        len,                 // Tamanho dos dados
-        0,                   // QoS 0 (nenhuma confirmação)
-        0,                   // Não reter mensagem
-        mqtt_pub_request_cb, // Callback de confirmação
-        NULL                 // Argumento para o callback
-    );
 
-    if (status != ERR_OK) {
-        printf("Publicação MQTT falhou ao ser enviada: %d\n", status);
+    // Com a RAM cheia, a mensagem mais antiga passa para a flash
+    if (!outbox_push(&saida, topic, data, len, qos)) {
+        printf("Publicação MQTT descartada (%u bytes, maior que a fila)\n", (unsigned)len);
+        return false;
     }
-}
\ No newline at end of file
+    return true;
+}
+
+// Profundidade e contadores da fila de saída
+void mqtt_comm_get_queue_stats(outbox_stats_t *stats) {
+    outbox_get_stats(&saida, stats);
+}
+
+// Handshakes completos e retomados, com o tempo e o pico do heap do mbedTLS de cada tipo
+void mqtt_comm_get_tls_stats(mqtt_tls_stats_t *stats) {
+    cyw43_arch_lwip_begin(); // Atualizados nos callbacks do lwIP
+    mqtt_tls_get_stats(stats);
+    cyw43_arch_lwip_end();
+}
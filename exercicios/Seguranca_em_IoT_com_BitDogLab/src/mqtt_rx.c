@@ -0,0 +1,175 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/mqtt_rx.h"
+#include <string.h> // Para memcpy(), strlen() e strcpy()
+
+// Estados de um buffer de remontagem: o callback do lwIP passa de FREE para RECEIVING e READY; mqtt_rx_poll() devolve a FREE
+typedef enum {
+    SLOT_FREE,
+    SLOT_RECEIVING,
+    SLOT_READY,
+} slot_state_t;
+
+// Buffer de remontagem de uma publicação
+typedef struct {
+    volatile slot_state_t state;
+    uint32_t sequence; // Ordem de chegada (entrega em ordem)
+    char topic[MQTT_RX_TOPIC_MAX];
+    uint32_t expected; // Tamanho total anunciado pelo broker
+    uint32_t received; // Bytes recebidos até agora
+    uint8_t buffer[MQTT_RX_BUFFER_BYTES + 1]; // +1 para o '\0' de uma mensagem em claro
+} rx_slot_t;
+
+static rx_slot_t slots[MQTT_RX_SLOTS];
+static rx_slot_t *current = NULL; // Publicação que está recebendo fragmentos (NULL: fragmentos são ignorados)
+static uint32_t next_sequence = 0;
+static payload_ctx_t *cipher = NULL;
+static replay_table_t *replay = NULL;
+static mqtt_rx_handler_t handler = NULL;
+static void *handler_arg = NULL;
+static mqtt_rx_stats_t stats; // Cada contador tem um único escritor: o callback do lwIP ou mqtt_rx_poll()
+
+// Ordena as escritas no buffer antes da troca de estado (e a leitura depois dela): o callback do lwIP interrompe o laço principal
+#define SLOT_BARRIER() __sync_synchronize()
+
+void mqtt_rx_init(payload_ctx_t *crypto, mqtt_rx_handler_t on_message, void *arg) {
+    memset(slots, 0, sizeof(slots));
+    memset(&stats, 0, sizeof(stats));
+    current = NULL;
+    next_sequence = 0;
+    cipher = crypto;
+    handler = on_message;
+    handler_arg = arg;
+}
+
+void mqtt_rx_set_replay(replay_table_t *table) {
+    replay = table;
+}
+
+// Libera um buffer que não vai terminar de receber
+static void abandon(void) {
+    current->state = SLOT_FREE;
+    current = NULL;
+    stats.dropped_incomplete++;
+}
+
+/**
+ * Início de uma publicação
+ *
+ * @param topic     Tópico da publicação
+ * @param total_len Tamanho total do payload anunciado pelo broker
+ *
+ * Funcionamento:
+ * - O lwIP entrega uma publicação de cada vez: se a anterior não chegou ao último fragmento (conexão caiu no meio),
+ *   ela é descartada
+ * - Mensagens maiores que o buffer são recusadas aqui, antes de chegar qualquer byte; os fragmentos delas são ignorados
+ */
+void mqtt_rx_begin(const char *topic, uint32_t total_len) {
+    if (current != NULL) {
+        abandon();
+    }
+
+    if (total_len > MQTT_RX_BUFFER_BYTES || strlen(topic) >= MQTT_RX_TOPIC_MAX) {
+        stats.dropped_too_large++;
+        return;
+    }
+
+    for (int i = 0; i < MQTT_RX_SLOTS; i++) {
+        if (slots[i].state == SLOT_FREE) {
+            current = &slots[i];
+            break;
+        }
+    }
+    if (current == NULL) { // Todos ocupados com mensagens que o laço principal ainda não tratou
+        stats.dropped_no_slot++;
+        return;
+    }
+
+    strcpy(current->topic, topic);
+    current->expected = total_len;
+    current->received = 0;
+    current->sequence = next_sequence++;
+    current->state = SLOT_RECEIVING;
+}
+
+void mqtt_rx_data(const uint8_t *data, uint16_t len, uint8_t flags) {
+    if (current == NULL) {
+        return; // Publicação recusada no início
+    }
+
+    stats.bytes += len;
+    if (len > current->expected - current->received) { // Mais bytes que o anunciado: não confia no restante
+        abandon();
+        return;
+    }
+    memcpy(current->buffer + current->received, data, len); // A única cópia: o lwIP reaproveita o pbuf depois do callback
+    current->received += len;
+
+    if ((flags & MQTT_RX_FLAG_LAST) == 0) {
+        return;
+    }
+    if (current->received != current->expected) {
+        abandon();
+        return;
+    }
+    SLOT_BARRIER();
+    current->state = SLOT_READY;
+    current = NULL;
+}
+
+/**
+ * Entrega as mensagens completas ao tratador (chamada no laço principal)
+ *
+ * Funcionamento:
+ * - Escolhe a mensagem pronta mais antiga, decifra e confere a etiqueta no próprio buffer, sem outra cópia
+ * - Mensagens rejeitadas pela cifra são contadas e descartadas
+ * - Com a janela contra replay ligada, o salt e o contador do nonce (já autenticados) passam por replay_check():
+ *   mensagens repetidas, antigas demais ou de um remetente novo com a tabela cheia também são descartadas, antes do tratador
+ * - O buffer volta ao conjunto depois que o tratador retorna
+ */
+int mqtt_rx_poll(void) {
+    int delivered = 0;
+
+    while (true) {
+        rx_slot_t *slot = NULL;
+        for (int i = 0; i < MQTT_RX_SLOTS; i++) {
+            if (slots[i].state == SLOT_READY && (slot == NULL || (int32_t)(slots[i].sequence - slot->sequence) < 0)) {
+                slot = &slots[i];
+            }
+        }
+        if (slot == NULL) {
+            return delivered;
+        }
+        SLOT_BARRIER();
+
+        char *payload = (char *)slot->buffer;
+        size_t len = slot->received;
+        bool ok = true;
+        bool replayed = false;
+        if (cipher != NULL) {
+            payload_nonce_t nonce;
+            ok = payload_open(cipher, slot->buffer, slot->received, &len, &nonce);
+            payload = (char *)payload_plaintext(slot->buffer);
+            replayed = ok && replay != NULL && replay_check(replay, nonce.salt, nonce.counter) != REPLAY_ACCEPTED;
+        }
+
+        if (!ok) {
+            stats.dropped_auth++;
+        } else if (replayed) {
+            stats.dropped_replay++;
+        } else {
+            payload[len] = '\0'; // Sobre a etiqueta já conferida, ou no byte reservado da mensagem em claro
+            stats.messages++;
+            delivered++;
+            if (handler != NULL) {
+                handler(slot->topic, payload, len, handler_arg);
+            }
+        }
+
+        SLOT_BARRIER();
+        slot->state = SLOT_FREE;
+    }
+}
+
+void mqtt_rx_get_stats(mqtt_rx_stats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,216 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/mqtt_tls.h"
+#include <string.h> // Para memset(), memcmp() e strlen()
+
+#if MQTT_TLS
+#include <stdio.h>               // printf() a cada conexão
+#include <stdlib.h>              // calloc() e free() da libc, contados abaixo
+#include "lwip/altcp_tls.h"      // Configuração do TLS e contexto do mbedTLS de cada conexão
+#include "lwip/apps/mqtt_priv.h" // Conexão (altcp) do cliente MQTT
+#include "mbedtls/ssl.h"
+#include "mbedtls/platform.h"    // mbedtls_platform_set_calloc_free()
+#include "mbedtls/sha256.h"
+#include "mbedtls/pk.h"
+
+#define PUBKEY_DER_MAX 128 // Chave pública P-256 em DER: 91 bytes
+
+static struct altcp_tls_config *config;
+static const char *nome_broker;
+static const uint8_t *pino;
+
+// Sessão da última conexão aceita (id, segredo mestre e ticket), oferecida ao broker na próxima
+static mbedtls_ssl_session sessao;
+static bool sessao_guardada;
+
+static bool conectando; // Entre mqtt_tls_begin() e o CONNACK
+static uint32_t inicio_ms;
+static uint32_t certificados; // Certificados do broker conferidos nesta conexão (0 no CONNACK: sessão retomada)
+static mqtt_tls_stats_t stats;
+
+// Heap do mbedTLS: cada bloco guarda o tamanho na frente, para o free() descontar
+typedef union {
+    size_t len;
+    max_align_t align;
+} bloco_t;
+
+static size_t heap_atual, heap_pico;
+
+static void *contar_calloc(size_t n, size_t size) {
+    if (size != 0 && n > (SIZE_MAX - sizeof(bloco_t)) / size) {
+        return NULL;
+    }
+    bloco_t *bloco = calloc(1, sizeof(bloco_t) + n * size);
+    if (bloco == NULL) {
+        return NULL;
+    }
+    bloco->len = n * size;
+    heap_atual += bloco->len;
+    if (heap_atual > heap_pico) {
+        heap_pico = heap_atual;
+    }
+    return bloco + 1;
+}
+
+static void contar_free(void *p) {
+    if (p == NULL) {
+        return;
+    }
+    bloco_t *bloco = (bloco_t *)p - 1;
+    heap_atual -= bloco->len;
+    free(bloco);
+}
+
+// Chamada pelo mbedTLS para cada certificado da cadeia, da CA (depth maior) ao do broker (depth 0), só no handshake completo
+// A conferência pela CA já está em *flags; aqui entra o pino
+static int conferir_certificado(void *arg, mbedtls_x509_crt *crt, int depth, uint32_t *flags) {
+    if (depth != 0) {
+        return 0;
+    }
+    certificados++;
+    if (pino == NULL) {
+        return 0;
+    }
+
+    // A chave pública é escrita no fim do buffer
+    uint8_t der[PUBKEY_DER_MAX];
+    uint8_t hash[MQTT_TLS_PIN_BYTES];
+    int len = mbedtls_pk_write_pubkey_der(&crt->pk, der, sizeof(der));
+    if (len <= 0 || mbedtls_sha256(der + sizeof(der) - len, (size_t)len, hash, 0) != 0 ||
+        memcmp(hash, pino, MQTT_TLS_PIN_BYTES) != 0) {
+        *flags |= MBEDTLS_X509_BADCERT_NOT_TRUSTED; // O handshake falha (ALTCP_MBEDTLS_AUTHMODE exige a verificação)
+        stats.pin_failures++;
+        printf("TLS: chave publica do broker diferente do pino\n");
+    }
+    return 0;
+}
+
+// Pino do exemplo, ainda não preenchido: recusaria todo broker e a placa tentaria reconectar para sempre
+static bool pino_zerado(const uint8_t *pin) {
+    uint8_t bits = 0;
+    for (int i = 0; i < MQTT_TLS_PIN_BYTES; i++) {
+        bits |= pin[i];
+    }
+    return bits == 0;
+}
+
+bool mqtt_tls_init(const char *ca_pem, const char *hostname, const uint8_t *pin) {
+    if (pin != NULL && pino_zerado(pin)) {
+        printf("TLS: pino zerado; preencha com o SHA-256 da chave publica do broker (ou passe NULL)\n");
+        return false;
+    }
+
+    // A partir daqui, tudo o que o mbedTLS aloca é contado (a configuração, as conexões e a sessão guardada)
+    mbedtls_platform_set_calloc_free(contar_calloc, contar_free);
+    mbedtls_ssl_session_init(&sessao);
+
+    // O PEM é lido com o '\0' do fim
+    config = altcp_tls_create_config_client((const u8_t *)ca_pem, strlen(ca_pem) + 1);
+    if (config == NULL) {
+        printf("TLS: certificado da CA invalido; cole o PEM do broker.crt (ou da CA)\n");
+        return false;
+    }
+    nome_broker = hostname;
+    pino = pin;
+    printf("TLS: configuracao pronta (%lu bytes no heap do mbedTLS)\n", (unsigned long)heap_atual);
+    return true;
+}
+
+bool mqtt_tls_enabled(void) {
+    return config != NULL;
+}
+
+void mqtt_tls_client_info(struct mqtt_connect_client_info_t *info) {
+    info->tls_config = config;
+}
+
+void mqtt_tls_begin(uint32_t now_ms) {
+    conectando = true;
+    inicio_ms = now_ms;
+    certificados = 0;
+    heap_pico = heap_atual; // Os buffers da conexão são alocados já em mqtt_client_connect()
+}
+
+void mqtt_tls_setup(mqtt_client_t *client) {
+    if (config == NULL) {
+        return;
+    }
+    // O handshake começa quando o TCP conectar, depois desta função (o lwIP está bloqueado)
+    mbedtls_ssl_context *ssl = altcp_tls_context(client->conn);
+    mbedtls_ssl_set_verify(ssl, conferir_certificado, NULL);
+    mbedtls_ssl_set_hostname(ssl, nome_broker); // Também vai no SNI; NULL dispensa a conferência do nome
+    if (sessao_guardada && mbedtls_ssl_set_session(ssl, &sessao) != 0) {
+        printf("TLS: sessao guardada nao pode ser oferecida\n"); // Segue com o handshake completo
+    }
+}
+
+void mqtt_tls_connected(mqtt_client_t *client, uint32_t now_ms) {
+    if (config == NULL || !conectando) {
+        return;
+    }
+    conectando = false;
+    uint32_t ms = now_ms - inicio_ms;
+    bool retomada = certificados == 0; // O certificado só é enviado (e conferido) no handshake completo
+    if (retomada) {
+        stats.resumed_handshakes++;
+        stats.last_resumed_ms = ms;
+        stats.last_resumed_heap_peak = (uint32_t)heap_pico;
+    } else {
+        stats.full_handshakes++;
+        stats.last_full_ms = ms;
+        stats.last_full_heap_peak = (uint32_t)heap_pico;
+    }
+    printf("TLS: %s em %lu ms, pico de %lu bytes no heap do mbedTLS\n", retomada ? "sessao retomada" : "handshake completo",
+           (unsigned long)ms, (unsigned long)heap_pico);
+
+    // Guarda a sessão desta conexão (com o ticket novo, se o broker mandou) para a próxima
+    mbedtls_ssl_session_free(&sessao);
+    mbedtls_ssl_session_init(&sessao);
+    sessao_guardada = mbedtls_ssl_get_session(altcp_tls_context(client->conn), &sessao) == 0;
+}
+
+void mqtt_tls_closed(void) {
+    // Falhou antes do CONNACK: a próxima tentativa faz o handshake completo, caso a sessão oferecida seja o problema
+    if (conectando && sessao_guardada) {
+        mbedtls_ssl_session_free(&sessao);
+        mbedtls_ssl_session_init(&sessao);
+        sessao_guardada = false;
+    }
+    conectando = false;
+}
+
+void mqtt_tls_get_stats(mqtt_tls_stats_t *out) {
+    *out = stats;
+    out->heap_in_use = (uint32_t)heap_atual;
+}
+
+#else
+
+// Sem a opção MQTT_TLS: a conexão continua na porta 1883, sem TLS
+bool mqtt_tls_init(const char *ca_pem, const char *hostname, const uint8_t *pin) {
+    return false;
+}
+
+bool mqtt_tls_enabled(void) {
+    return false;
+}
+
+void mqtt_tls_client_info(struct mqtt_connect_client_info_t *info) {
+}
+
+void mqtt_tls_begin(uint32_t now_ms) {
+}
+
+void mqtt_tls_setup(mqtt_client_t *client) {
+}
+
+void mqtt_tls_connected(mqtt_client_t *client, uint32_t now_ms) {
+}
+
+void mqtt_tls_closed(void) {
+}
+
+void mqtt_tls_get_stats(mqtt_tls_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+}
+
+#endif
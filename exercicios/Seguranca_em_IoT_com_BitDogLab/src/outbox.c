@@ -0,0 +1,550 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/outbox.h"
+#include <string.h> // Para memset(), memcpy() e strlen()
+
+#define FLAG_ACK 0x80 // Registro de remoção (id = primeira mensagem ainda pendente)
+#define FLAG_QOS 0x03
+
+// Cabeçalho de um registro lido da flash
+typedef struct {
+    uint32_t log_seq;
+    uint32_t id;
+    uint16_t len;
+    uint8_t topic_len;
+    uint8_t flags;
+} record_t;
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// CRC-32 (polinômio refletido 0xEDB88320), bit a bit: os registros são pequenos
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+static uint32_t record_size(const outbox_t *ob, uint32_t topic_len, uint32_t len) {
+    uint32_t page = ob->flash->page_size;
+    return (OUTBOX_HEADER_BYTES + topic_len + len + page - 1) / page * page;
+}
+
+static const uint8_t *at(const outbox_t *ob, outbox_pos_t pos) {
+    return ob->flash->base + (uint32_t)pos.sector * ob->flash->sector_size + pos.offset;
+}
+
+static bool blank(const uint8_t *p, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Lê o registro em pos: 1 válido, 0 nada gravado (magic apagado ou fim do setor), -1 estragado (gravação interrompida)
+static int read_record(const outbox_t *ob, outbox_pos_t pos, record_t *rec) {
+    if ((uint32_t)pos.offset + OUTBOX_HEADER_BYTES > ob->flash->sector_size) {
+        return 0;
+    }
+    const uint8_t *p = at(ob, pos);
+    uint32_t magic = get_u32(p);
+    if (magic != OUTBOX_MAGIC) {
+        return magic == 0xFFFFFFFFu ? 0 : -1;
+    }
+    rec->log_seq = get_u32(p + 4);
+    rec->id = get_u32(p + 8);
+    rec->len = (uint16_t)(p[12] | (p[13] << 8));
+    rec->topic_len = p[14];
+    rec->flags = p[15];
+    if (rec->topic_len > OUTBOX_TOPIC_MAX || rec->len > OUTBOX_PAYLOAD_MAX ||
+        pos.offset + record_size(ob, rec->topic_len, rec->len) > ob->flash->sector_size) {
+        return -1;
+    }
+    uint32_t crc = crc32_update(0xFFFFFFFFu, p, 16);
+    crc = crc32_update(crc, p + OUTBOX_HEADER_BYTES, (size_t)rec->topic_len + rec->len);
+    return ~crc == get_u32(p + 16) ? 1 : -1;
+}
+
+// Espaço pulado depois de um registro estragado: a gravação interrompida não passa do tamanho do maior registro
+static uint16_t after_torn(const outbox_t *ob, outbox_pos_t pos) {
+    uint32_t offset = pos.offset + record_size(ob, OUTBOX_TOPIC_MAX, OUTBOX_PAYLOAD_MAX);
+    return (uint16_t)(offset < ob->flash->sector_size ? offset : ob->flash->sector_size);
+}
+
+// Próximo registro válido dentro do setor de pos, pulando os estragados; false no espaço livre ou no fim do setor
+static bool scan(const outbox_t *ob, outbox_pos_t *pos, record_t *rec, uint32_t *torn) {
+    int status;
+    while ((status = read_record(ob, *pos, rec)) < 0) {
+        if (torn != NULL) {
+            (*torn)++;
+        }
+        pos->offset = after_torn(ob, *pos);
+    }
+    return status > 0;
+}
+
+/**
+ * Próximo registro válido a partir de pos, na ordem do log
+ *
+ * Funcionamento:
+ * - Dentro de um setor, os registros ficam um depois do outro (com um espaço depois de cada gravação interrompida); no
+ *   espaço livre ou no fim do setor a busca passa para o setor seguinte
+ * - Termina na posição de escrita (false)
+ */
+static bool walk(const outbox_t *ob, outbox_pos_t *pos, record_t *rec) {
+    for (uint32_t n = 0; n <= ob->sectors; n++) {
+        bool head_sector = pos->sector == ob->head.sector;
+        if (!(head_sector && pos->offset >= ob->head.offset) && scan(ob, pos, rec, NULL) &&
+            !(head_sector && pos->offset >= ob->head.offset)) {
+            return true;
+        }
+        if (head_sector) {
+            return false;
+        }
+        pos->sector = (uint16_t)((pos->sector + 1) % ob->sectors);
+        pos->offset = 0;
+    }
+    return false;
+}
+
+// Próxima mensagem pendente a partir de pos (pula remoções e mensagens já confirmadas)
+static bool find_pending(const outbox_t *ob, outbox_pos_t *pos, record_t *rec) {
+    while (walk(ob, pos, rec)) {
+        if (!(rec->flags & FLAG_ACK) && (int32_t)(rec->id - ob->acked_id) >= 0) {
+            return true;
+        }
+        pos->offset = (uint16_t)(pos->offset + record_size(ob, rec->topic_len, rec->len));
+    }
+    return false;
+}
+
+// Tudo o que estava aguardando confirmação volta a ser enviado, a partir da mais antiga
+static void resend_all(outbox_t *ob) {
+    if (ob->inflight_count > 0) {
+        ob->stats.rewinds++;
+    }
+    ob->inflight_count = 0;
+}
+
+/**
+ * Prepara o setor seguinte para a escrita
+ *
+ * Funcionamento:
+ * - É o setor mais antigo do círculo; se ainda tiver mensagens pendentes, a flash está cheia e elas são descartadas
+ * - Se a busca da mais antiga apontava para dentro dele, recomeça do início (os registros novos serão gravados ali)
+ * - Só é apagado se tiver algo gravado
+ */
+static bool prepare(outbox_t *ob, uint16_t sector) {
+    record_t rec;
+    uint32_t dropped = 0;
+    while (ob->flash_pending > 0 && find_pending(ob, &ob->front, &rec) && ob->front.sector == sector) {
+        ob->front.offset = (uint16_t)(ob->front.offset + record_size(ob, rec.topic_len, rec.len));
+        ob->flash_pending--;
+        dropped++;
+    }
+    if (dropped > 0) {
+        ob->stats.dropped += dropped;
+        resend_all(ob);
+    }
+    if (ob->front.sector == sector) {
+        ob->front.offset = 0;
+    }
+
+    uint32_t sector_size = ob->flash->sector_size;
+    if (!blank(ob->flash->base + (uint32_t)sector * sector_size, sector_size)) {
+        if (!ob->flash->erase((uint32_t)sector * sector_size, ob->flash->arg)) {
+            ob->stats.flash_errors++;
+            return false;
+        }
+        ob->stats.erases++;
+    }
+    return true;
+}
+
+/**
+ * Acrescenta um registro no fim do log
+ *
+ * Funcionamento:
+ * - Muda de setor quando o registro não cabe (ou quando o resto do setor tem algo gravado que não é do log)
+ * - Se a gravação falhar, o começo do registro é zerado (de 1 para 0 sempre se pode gravar) para que a leitura o veja
+ *   como estragado e pule o espaço dele; sem conseguir nem isso, a escrita passa para o setor seguinte
+ */
+static bool append(outbox_t *ob, uint8_t flags, uint32_t id, const char *topic, uint8_t topic_len, const uint8_t *data, uint16_t len) {
+    uint32_t size = record_size(ob, topic_len, len);
+    if (ob->head_dirty || ob->head.offset + size > ob->flash->sector_size) {
+        uint16_t next = (uint16_t)((ob->head.sector + 1) % ob->sectors);
+        if (!prepare(ob, next)) {
+            return false;
+        }
+        ob->head = (outbox_pos_t){.sector = next, .offset = 0};
+        ob->head_dirty = false;
+    }
+
+    uint8_t *r = ob->record;
+    memset(r, 0xFF, size);
+    put_u32(r, OUTBOX_MAGIC);
+    put_u32(r + 4, ob->log_seq++);
+    put_u32(r + 8, id);
+    r[12] = (uint8_t)len;
+    r[13] = (uint8_t)(len >> 8);
+    r[14] = topic_len;
+    r[15] = flags;
+    if (topic_len > 0) {
+        memcpy(r + OUTBOX_HEADER_BYTES, topic, topic_len);
+    }
+    if (len > 0) {
+        memcpy(r + OUTBOX_HEADER_BYTES + topic_len, data, len);
+    }
+    uint32_t crc = crc32_update(0xFFFFFFFFu, r, 16);
+    crc = crc32_update(crc, r + OUTBOX_HEADER_BYTES, (size_t)topic_len + len);
+    put_u32(r + 16, ~crc);
+
+    uint32_t offset = (uint32_t)ob->head.sector * ob->flash->sector_size + ob->head.offset;
+    if (!ob->flash->program(offset, r, size, ob->flash->arg)) {
+        ob->stats.flash_errors++;
+        memset(r, 0, ob->flash->page_size);
+        if (ob->flash->program(offset, r, ob->flash->page_size, ob->flash->arg)) {
+            ob->head.offset = after_torn(ob, ob->head);
+        } else {
+            ob->head_dirty = true;
+        }
+        return false;
+    }
+    ob->head.offset = (uint16_t)(ob->head.offset + size);
+    return true;
+}
+
+/**
+ * Reconstrói o estado a partir do log
+ *
+ * Funcionamento:
+ * - O setor escrito por último é o de maior log_seq no primeiro registro válido; a escrita continua depois do último registro
+ *   dele, válido ou estragado (ou no setor seguinte, se o resto do setor não estiver apagado)
+ * - Os setores são lidos do mais antigo ao mais novo: a maior remoção gravada diz até onde já houve confirmação, e as
+ *   mensagens a partir dali voltam para a fila
+ */
+static void recover(outbox_t *ob) {
+    record_t rec;
+    bool any = false;
+    uint16_t last = 0;
+    uint32_t last_seq = 0;
+    for (uint16_t s = 0; s < ob->sectors; s++) {
+        outbox_pos_t first = {.sector = s, .offset = 0};
+        if (scan(ob, &first, &rec, NULL) && (!any || (int32_t)(rec.log_seq - last_seq) > 0)) {
+            any = true;
+            last = s;
+            last_seq = rec.log_seq;
+        }
+    }
+
+    uint32_t sector_size = ob->flash->sector_size;
+    ob->head = (outbox_pos_t){.sector = last, .offset = 0};
+    if (any) {
+        while (scan(ob, &ob->head, &rec, NULL)) {
+            ob->head.offset = (uint16_t)(ob->head.offset + record_size(ob, rec.topic_len, rec.len));
+        }
+    }
+    ob->head_dirty = !blank(at(ob, ob->head), sector_size - ob->head.offset);
+
+    // Primeira passada: confirmações, maior id e maior log_seq
+    bool ids = false;
+    uint32_t max_id = 0;
+    for (uint16_t k = 1; k <= ob->sectors; k++) {
+        outbox_pos_t pos = {.sector = (uint16_t)((last + k) % ob->sectors), .offset = 0};
+        while (scan(ob, &pos, &rec, &ob->stats.torn)) {
+            if ((int32_t)(rec.log_seq - last_seq) > 0) {
+                last_seq = rec.log_seq;
+            }
+            if (rec.flags & FLAG_ACK) {
+                if ((int32_t)(rec.id - ob->acked_id) > 0) {
+                    ob->acked_id = rec.id;
+                }
+            } else if (!ids || (int32_t)(rec.id - max_id) > 0) {
+                ids = true;
+                max_id = rec.id;
+            }
+            pos.offset = (uint16_t)(pos.offset + record_size(ob, rec.topic_len, rec.len));
+        }
+    }
+    ob->log_seq = any ? last_seq + 1 : 0;
+    ob->next_id = ids && (int32_t)(max_id + 1 - ob->acked_id) > 0 ? max_id + 1 : ob->acked_id;
+
+    // Segunda passada: mensagens pendentes, da mais antiga para a mais nova
+    ob->front = (outbox_pos_t){.sector = (uint16_t)((last + 1) % ob->sectors), .offset = 0};
+    outbox_pos_t pos = ob->front;
+    while (find_pending(ob, &pos, &rec)) {
+        ob->flash_pending++;
+        pos.offset = (uint16_t)(pos.offset + record_size(ob, rec.topic_len, rec.len));
+    }
+    ob->stats.recovered = ob->flash_pending;
+    ob->stats.flash_peak = ob->flash_pending;
+}
+
+void outbox_init(outbox_t *ob, const outbox_config_t *config, const outbox_flash_t *flash, outbox_publish_t publish, void *arg) {
+    memset(ob, 0, sizeof(*ob));
+    ob->config = *config;
+    if (ob->config.max_inflight == 0) {
+        ob->config.max_inflight = 1;
+    }
+    if (ob->config.max_inflight > OUTBOX_MAX_INFLIGHT) {
+        ob->config.max_inflight = OUTBOX_MAX_INFLIGHT;
+    }
+    ob->publish = publish;
+    ob->arg = arg;
+
+    // Região inválida: fica só com a RAM
+    if (flash != NULL && flash->sector_size > 0 && flash->sector_size <= UINT16_MAX && flash->size % flash->sector_size == 0 &&
+        flash->size / flash->sector_size >= 2 && flash->size / flash->sector_size <= OUTBOX_MAX_SECTORS && flash->page_size > 0 &&
+        flash->sector_size % flash->page_size == 0) {
+        ob->flash = flash;
+        ob->sectors = (uint16_t)(flash->size / flash->sector_size);
+        if (record_size(ob, OUTBOX_TOPIC_MAX, OUTBOX_PAYLOAD_MAX) > OUTBOX_RECORD_MAX ||
+            record_size(ob, OUTBOX_TOPIC_MAX, OUTBOX_PAYLOAD_MAX) > flash->sector_size) {
+            ob->flash = NULL;
+        }
+    }
+    if (ob->flash != NULL) {
+        recover(ob);
+    }
+}
+
+// Passa a mensagem mais antiga da RAM para o fim do log (a ordem da fila não muda: a flash vem antes da RAM)
+static bool spill_front(outbox_t *ob) {
+    if (ob->flash == NULL) {
+        return false;
+    }
+    outbox_slot_t *slot = &ob->ram[ob->ram_head];
+    if (!append(ob, slot->qos & FLAG_QOS, slot->id, slot->topic, (uint8_t)strlen(slot->topic), slot->data, slot->len)) {
+        return false;
+    }
+    ob->ram_head = (uint8_t)((ob->ram_head + 1) % OUTBOX_RAM_SLOTS);
+    ob->ram_count--;
+    ob->flash_pending++;
+    ob->stats.spilled++;
+    if (ob->flash_pending > ob->stats.flash_peak) {
+        ob->stats.flash_peak = ob->flash_pending;
+    }
+    return true;
+}
+
+/**
+ * Guarda uma mensagem no fim da fila
+ *
+ * Funcionamento:
+ * - Entra no anel da RAM; com o anel cheio, a mais antiga da RAM vai para a flash (sem flash ou com falha na gravação,
+ *   ela é descartada)
+ * - O id da mensagem é o token de confirmação passado ao cliente MQTT
+ */
+bool outbox_push(outbox_t *ob, const char *topic, const uint8_t *data, size_t len, uint8_t qos) {
+    if (len > OUTBOX_PAYLOAD_MAX || strlen(topic) > OUTBOX_TOPIC_MAX) {
+        ob->stats.dropped++;
+        return false;
+    }
+    if (ob->ram_count == OUTBOX_RAM_SLOTS && !spill_front(ob)) {
+        if (ob->inflight_count > ob->flash_pending) {
+            resend_all(ob); // A descartada estava aguardando confirmação
+        }
+        ob->ram_head = (uint8_t)((ob->ram_head + 1) % OUTBOX_RAM_SLOTS);
+        ob->ram_count--;
+        ob->stats.dropped++;
+    }
+
+    outbox_slot_t *slot = &ob->ram[(ob->ram_head + ob->ram_count) % OUTBOX_RAM_SLOTS];
+    slot->topic = topic;
+    slot->id = ob->next_id++;
+    slot->qos = qos;
+    slot->len = (uint16_t)len;
+    memcpy(slot->data, data, len);
+    ob->ram_count++;
+    ob->stats.pushed++;
+    if (ob->ram_count > ob->stats.ram_peak) {
+        ob->stats.ram_peak = ob->ram_count;
+    }
+    return true;
+}
+
+bool outbox_spill(outbox_t *ob) {
+    while (ob->ram_count > 0) {
+        if (!spill_front(ob)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Tira a mensagem mais antiga (confirmada) da fila
+static void pop_front(outbox_t *ob) {
+    if (ob->flash_pending > 0) {
+        record_t rec;
+        if (find_pending(ob, &ob->front, &rec)) {
+            ob->acked_id = rec.id + 1;
+            ob->front.offset = (uint16_t)(ob->front.offset + record_size(ob, rec.topic_len, rec.len));
+        }
+        ob->flash_pending--;
+        ob->pops_since_checkpoint++;
+    } else {
+        ob->ram_head = (uint8_t)((ob->ram_head + 1) % OUTBOX_RAM_SLOTS);
+        ob->ram_count--;
+    }
+    ob->stats.acked++;
+}
+
+static void handle_ack(outbox_t *ob, uint32_t token, bool ok) {
+    for (int i = 0; i < ob->inflight_count; i++) {
+        if (ob->inflight[i].id == token && !ob->inflight[i].acked) {
+            if (ok) {
+                ob->inflight[i].acked = true;
+            } else {
+                resend_all(ob); // Erro ou tempo esgotado no lwIP: reenvia na ordem
+            }
+            return;
+        }
+    }
+    // Token desconhecido: confirmação atrasada de um envio já refeito
+}
+
+// Mensagem pendente de número k na flash (0: a mais antiga); k é no máximo OUTBOX_MAX_INFLIGHT, então a busca é curta
+static bool nth_pending(const outbox_t *ob, uint32_t k, outbox_pos_t *pos, record_t *rec) {
+    *pos = ob->front;
+    for (;;) {
+        if (!find_pending(ob, pos, rec)) {
+            return false;
+        }
+        if (k-- == 0) {
+            return true;
+        }
+        pos->offset = (uint16_t)(pos->offset + record_size(ob, rec->topic_len, rec->len));
+    }
+}
+
+// Envia a próxima mensagem depois das que aguardam confirmação
+static bool send_next(outbox_t *ob, uint32_t now_ms) {
+    uint32_t k = ob->inflight_count;
+    uint32_t id;
+    if (k < ob->flash_pending) {
+        outbox_pos_t pos;
+        record_t rec;
+        if (!nth_pending(ob, k, &pos, &rec)) {
+            return false;
+        }
+        const uint8_t *p = at(ob, pos);
+        char topic[OUTBOX_TOPIC_MAX + 1];
+        memcpy(topic, p + OUTBOX_HEADER_BYTES, rec.topic_len);
+        topic[rec.topic_len] = '\0';
+        if (!ob->publish(topic, p + OUTBOX_HEADER_BYTES + rec.topic_len, rec.len, rec.flags & FLAG_QOS, rec.id, ob->arg)) {
+            return false;
+        }
+        id = rec.id;
+    } else if (k - ob->flash_pending < ob->ram_count) {
+        const outbox_slot_t *slot = &ob->ram[(ob->ram_head + k - ob->flash_pending) % OUTBOX_RAM_SLOTS];
+        if (!ob->publish(slot->topic, slot->data, slot->len, slot->qos, slot->id, ob->arg)) {
+            return false;
+        }
+        id = slot->id;
+    } else {
+        return false;
+    }
+    ob->inflight[k].id = id;
+    ob->inflight[k].sent_ms = now_ms;
+    ob->inflight[k].acked = false;
+    ob->inflight_count++;
+    ob->last_send_ms = now_ms;
+    ob->sent_once = true;
+    ob->stats.sent++;
+    return true;
+}
+
+/**
+ * Processa confirmações e envia o que puder
+ *
+ * @param ob     Fila
+ * @param now_ms Tempo atual em ms (ex.: to_ms_since_boot(get_absolute_time()))
+ * @param online Conexão MQTT de pé (sem ela, o que aguardava confirmação será reenviado)
+ *
+ * Funcionamento:
+ * - Confirmações fora de ordem esperam as anteriores: a fila só anda pelo começo
+ * - A cada OUTBOX_ACK_EVERY mensagens da flash confirmadas, e quando a flash esvazia, grava um registro de remoção
+ * - Envia até max_inflight mensagens sem confirmação, no máximo uma a cada drain_interval_ms
+ */
+void outbox_poll(outbox_t *ob, uint32_t now_ms, bool online) {
+    while (ob->event_tail != ob->event_head) {
+        uint8_t tail = ob->event_tail;
+        uint32_t token = ob->events[tail % OUTBOX_EVENTS].token;
+        bool ok = ob->events[tail % OUTBOX_EVENTS].ok;
+        ob->event_tail = (uint8_t)(tail + 1);
+        handle_ack(ob, token, ok);
+    }
+    while (ob->inflight_count > 0 && ob->inflight[0].acked) {
+        pop_front(ob);
+        ob->inflight_count--;
+        memmove(&ob->inflight[0], &ob->inflight[1], ob->inflight_count * sizeof(ob->inflight[0]));
+    }
+    if (ob->flash != NULL && ob->pops_since_checkpoint > 0 && (ob->pops_since_checkpoint >= OUTBOX_ACK_EVERY || ob->flash_pending == 0)) {
+        if (append(ob, FLAG_ACK, ob->acked_id, "", 0, NULL, 0)) {
+            ob->pops_since_checkpoint = 0;
+        }
+    }
+
+    if (!online) {
+        resend_all(ob);
+        return;
+    }
+    if (ob->inflight_count > 0 && now_ms - ob->inflight[0].sent_ms >= ob->config.ack_timeout_ms) {
+        resend_all(ob);
+    }
+    while (ob->inflight_count < ob->config.max_inflight && (!ob->sent_once || now_ms - ob->last_send_ms >= ob->config.drain_interval_ms)) {
+        if (!send_next(ob, now_ms)) {
+            break;
+        }
+    }
+}
+
+void outbox_event_ack(outbox_t *ob, uint32_t token, bool ok) {
+    uint8_t head = ob->event_head;
+    if ((uint8_t)(head - ob->event_tail) >= OUTBOX_EVENTS) {
+        ob->stats.events_lost++;
+        return;
+    }
+    ob->events[head % OUTBOX_EVENTS].token = token;
+    ob->events[head % OUTBOX_EVENTS].ok = ok;
+    ob->event_head = (uint8_t)(head + 1); // Publica o evento depois de escrito
+}
+
+void outbox_get_stats(const outbox_t *ob, outbox_stats_t *stats) {
+    *stats = ob->stats;
+    stats->ram_depth = ob->ram_count;
+    stats->flash_depth = ob->flash_pending;
+    stats->inflight = ob->inflight_count;
+    stats->flash_free_bytes = 0;
+    if (ob->flash == NULL) {
+        return;
+    }
+
+    // Do fim do setor atual até o setor mais antigo que ainda tem mensagens pendentes
+    uint32_t sector_size = ob->flash->sector_size;
+    uint16_t limit = ob->head.sector;
+    outbox_pos_t pos = ob->front;
+    record_t rec;
+    if (ob->flash_pending > 0 && find_pending(ob, &pos, &rec)) {
+        limit = pos.sector;
+    }
+    if (!ob->head_dirty) {
+        stats->flash_free_bytes = sector_size - ob->head.offset;
+    }
+    for (uint16_t s = (uint16_t)((ob->head.sector + 1) % ob->sectors); s != limit && s != ob->head.sector; s = (uint16_t)((s + 1) % ob->sectors)) {
+        stats->flash_free_bytes += sector_size;
+    }
+}
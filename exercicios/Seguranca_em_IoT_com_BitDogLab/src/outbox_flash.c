@@ -0,0 +1,53 @@
+#include <string.h> // Para memcpy()
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "pico/flash.h" // flash_safe_execute()
+#include "hardware/flash.h" // Apagamento e gravação da flash
+#include "include/outbox.h" // Formato do log e região da flash
+
+#define OUTBOX_FLASH_SECTORS 8 // 32 KB: cerca de 60 mensagens de lote (até 512 bytes por registro)
+#define OUTBOX_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - OUTBOX_FLASH_SECTORS * FLASH_SECTOR_SIZE) // Últimos setores, longe do programa
+#define OUTBOX_FLASH_TIMEOUT_MS 100 // Espera máxima para pausar o outro núcleo
+
+// Pedido executado por flash_safe_execute(): o registro é copiado para cá (precisa estar na RAM)
+static struct {
+    uint32_t offset;
+    size_t len;
+    uint8_t data[OUTBOX_RECORD_MAX];
+} pedido;
+
+// Executadas com o outro núcleo pausado e as interrupções desligadas: nada pode rodar da flash enquanto ela é gravada
+static void program_pages(void *param) {
+    (void)param;
+    flash_range_program(OUTBOX_FLASH_OFFSET + pedido.offset, pedido.data, pedido.len);
+}
+
+static void erase_sector(void *param) {
+    (void)param;
+    flash_range_erase(OUTBOX_FLASH_OFFSET + pedido.offset, FLASH_SECTOR_SIZE);
+}
+
+static bool outbox_flash_program(uint32_t offset, const uint8_t *data, size_t len, void *arg) {
+    if (len > sizeof(pedido.data)) {
+        return false;
+    }
+    pedido.offset = offset;
+    pedido.len = len;
+    memcpy(pedido.data, data, len);
+    return flash_safe_execute(program_pages, NULL, OUTBOX_FLASH_TIMEOUT_MS) == PICO_OK;
+}
+
+static bool outbox_flash_erase(uint32_t offset, void *arg) {
+    pedido.offset = offset;
+    return flash_safe_execute(erase_sector, NULL, OUTBOX_FLASH_TIMEOUT_MS) == PICO_OK;
+}
+
+// O log é lido diretamente pelo mapeamento XIP
+const outbox_flash_t outbox_flash_pico = {
+    .base = (const uint8_t *)(XIP_BASE + OUTBOX_FLASH_OFFSET),
+    .size = OUTBOX_FLASH_SECTORS * FLASH_SECTOR_SIZE,
+    .sector_size = FLASH_SECTOR_SIZE,
+    .page_size = FLASH_PAGE_SIZE,
+    .program = outbox_flash_program,
+    .erase = outbox_flash_erase,
+    .arg = NULL,
+};
@@ -0,0 +1,128 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/payload_crypto.h"
+#include "include/chacha20poly1305.h" // Cifra padrão, em C portátil
+#include <string.h>                   // Para memcpy() e memset()
+
+// Monta o cabeçalho do pacote; os 12 últimos bytes (salt e contador) são o nonce
+static void write_header(uint8_t header[PAYLOAD_HEADER_BYTES], payload_cipher_t cipher, uint32_t salt, uint64_t counter) {
+    header[0] = (uint8_t)cipher;
+    for (int i = 0; i < 4; i++) {
+        header[1 + i] = (uint8_t)(salt >> (24 - 8 * i));
+    }
+    for (int i = 0; i < 8; i++) {
+        header[5 + i] = (uint8_t)(counter >> (56 - 8 * i));
+    }
+}
+
+// Zera a memória com escritas voláteis: um memset() num objeto que não é mais lido depois pode ser removido pelo compilador
+static void wipe(void *p, size_t len) {
+    volatile uint8_t *bytes = p;
+    while (len--) {
+        *bytes++ = 0;
+    }
+}
+
+bool payload_init(payload_ctx_t *ctx, payload_cipher_t cipher, const uint8_t key[PAYLOAD_KEY_BYTES], uint32_t salt, uint64_t counter) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->cipher = cipher;
+    ctx->salt = salt;
+    ctx->counter = counter;
+    memcpy(ctx->key, key, PAYLOAD_KEY_BYTES);
+
+    switch (cipher) {
+    case PAYLOAD_CIPHER_CHACHA20_POLY1305:
+        return true;
+#if PAYLOAD_CRYPTO_AES_GCM
+    case PAYLOAD_CIPHER_AES_256_GCM:
+        mbedtls_gcm_init(&ctx->gcm);
+        return mbedtls_gcm_setkey(&ctx->gcm, MBEDTLS_CIPHER_ID_AES, key, PAYLOAD_KEY_BYTES * 8) == 0; // Expande a chave uma vez só
+#endif
+    default:
+        return false;
+    }
+}
+
+void payload_free(payload_ctx_t *ctx) {
+#if PAYLOAD_CRYPTO_AES_GCM
+    if (ctx->cipher == PAYLOAD_CIPHER_AES_256_GCM) {
+        mbedtls_gcm_free(&ctx->gcm);
+    }
+#endif
+    wipe(ctx, sizeof(*ctx));
+}
+
+const char *payload_cipher_name(payload_cipher_t cipher) {
+    switch (cipher) {
+    case PAYLOAD_CIPHER_CHACHA20_POLY1305: return "ChaCha20-Poly1305";
+    case PAYLOAD_CIPHER_AES_256_GCM: return "AES-256-GCM";
+    default: return "desconhecida";
+    }
+}
+
+size_t payload_seal(payload_ctx_t *ctx, uint8_t *packet, size_t len, size_t size) {
+    if (size < PAYLOAD_OVERHEAD || len > size - PAYLOAD_OVERHEAD || ctx->counter == UINT64_MAX) {
+        return 0; // Não cabe, ou contador esgotado (o nonce se repetiria)
+    }
+
+    uint8_t *data = payload_plaintext(packet);
+    uint8_t *tag = data + len;
+    write_header(packet, ctx->cipher, ctx->salt, ctx->counter);
+    const uint8_t *nonce = packet + 1;
+
+    switch (ctx->cipher) {
+    case PAYLOAD_CIPHER_CHACHA20_POLY1305:
+        chacha20poly1305_encrypt(ctx->key, nonce, packet, PAYLOAD_HEADER_BYTES, data, len, tag);
+        break;
+#if PAYLOAD_CRYPTO_AES_GCM
+    case PAYLOAD_CIPHER_AES_256_GCM:
+        if (mbedtls_gcm_crypt_and_tag(&ctx->gcm, MBEDTLS_GCM_ENCRYPT, len, nonce, 12, packet, PAYLOAD_HEADER_BYTES,
+                                      data, data, PAYLOAD_TAG_BYTES, tag) != 0) {
+            return 0;
+        }
+        break;
+#endif
+    default:
+        return 0;
+    }
+
+    ctx->counter++; // Só avança depois de usar o nonce
+    return len + PAYLOAD_OVERHEAD;
+}
+
+bool payload_open(payload_ctx_t *ctx, uint8_t *packet, size_t packet_len, size_t *len, payload_nonce_t *nonce) {
+    if (packet_len < PAYLOAD_OVERHEAD || packet[0] != (uint8_t)ctx->cipher) {
+        return false;
+    }
+
+    size_t data_len = packet_len - PAYLOAD_OVERHEAD;
+    uint8_t *data = payload_plaintext(packet);
+    const uint8_t *tag = data + data_len;
+    bool ok = false;
+
+    switch (ctx->cipher) {
+    case PAYLOAD_CIPHER_CHACHA20_POLY1305:
+        ok = chacha20poly1305_decrypt(ctx->key, packet + 1, packet, PAYLOAD_HEADER_BYTES, data, data_len, tag);
+        break;
+#if PAYLOAD_CRYPTO_AES_GCM
+    case PAYLOAD_CIPHER_AES_256_GCM:
+        ok = mbedtls_gcm_auth_decrypt(&ctx->gcm, data_len, packet + 1, 12, packet, PAYLOAD_HEADER_BYTES,
+                                      tag, PAYLOAD_TAG_BYTES, data, data) == 0;
+        break;
+#endif
+    default:
+        break;
+    }
+    if (!ok) {
+        return false;
+    }
+
+    *len = data_len;
+    if (nonce != NULL) {
+        nonce->salt = ((uint32_t)packet[1] << 24) | ((uint32_t)packet[2] << 16) | ((uint32_t)packet[3] << 8) | packet[4];
+        nonce->counter = 0;
+        for (int i = 0; i < 8; i++) {
+            nonce->counter = (nonce->counter << 8) | packet[5 + i];
+        }
+    }
+    return true;
+}
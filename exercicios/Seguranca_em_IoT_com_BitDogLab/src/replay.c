@@ -0,0 +1,159 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/replay.h"
+#include <string.h> // Para memset()
+
+_Static_assert((REPLAY_SLOTS & (REPLAY_SLOTS - 1)) == 0, "REPLAY_SLOTS precisa ser potência de 2");
+_Static_assert(REPLAY_MAX_SENDERS < REPLAY_SLOTS, "a tabela precisa de ao menos uma posição livre");
+_Static_assert(REPLAY_WINDOW == 64, "o mapa da janela é um uint64_t");
+
+#define MASK (REPLAY_SLOTS - 1)
+
+void replay_init(replay_table_t *table) {
+    memset(table, 0, sizeof(*table));
+}
+
+// Posição inicial de um remetente (hash multiplicativo de Fibonacci)
+static uint32_t home(uint32_t sender) {
+    return ((sender * 2654435769u) >> 16) & MASK;
+}
+
+// Posição do remetente, ou -1
+static int find(const replay_table_t *table, uint32_t sender) {
+    for (uint32_t i = home(sender), n = 0; n < REPLAY_SLOTS; i = (i + 1) & MASK, n++) {
+        if (!table->slots[i].used) {
+            return -1; // A sequência de sondagem termina na primeira posição livre
+        }
+        if (table->slots[i].sender == sender) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Libera uma posição sem deixar lápide
+ *
+ * Funcionamento:
+ * - Os remetentes seguintes da mesma sequência de sondagem voltam para o buraco quando a posição inicial deles não
+ *   fica entre o buraco e a posição atual (na ordem circular); assim a busca pode parar na primeira posição livre
+ */
+static void remove_at(replay_table_t *table, uint32_t hole) {
+    uint32_t j = hole;
+    while (true) {
+        j = (j + 1) & MASK;
+        if (!table->slots[j].used) {
+            break;
+        }
+        uint32_t k = home(table->slots[j].sender);
+        // k está no intervalo circular (hole, j]? então o remetente em j continua alcançável e fica onde está
+        bool stays = hole <= j ? (hole < k && k <= j) : (hole < k || k <= j);
+        if (!stays) {
+            table->slots[hole] = table->slots[j];
+            hole = j;
+        }
+    }
+    table->slots[hole].used = false;
+    table->senders--;
+}
+
+// Remetente usado há mais tempo (só com a tabela cheia)
+static uint32_t least_recent(const replay_table_t *table) {
+    uint32_t oldest = 0;
+    uint32_t oldest_age = 0;
+    for (uint32_t i = 0; i < REPLAY_SLOTS; i++) {
+        uint32_t age = table->clock - table->slots[i].last_used;
+        if (table->slots[i].used && age >= oldest_age) {
+            oldest = i;
+            oldest_age = age;
+        }
+    }
+    return oldest;
+}
+
+// false: tabela cheia e nenhum remetente pode sair
+static bool insert(replay_table_t *table, uint32_t sender, uint64_t counter) {
+    if (table->senders >= REPLAY_MAX_SENDERS) {
+        uint32_t oldest = least_recent(table);
+        if (table->clock - table->slots[oldest].last_used < REPLAY_RECENT) {
+            return false;
+        }
+        remove_at(table, oldest);
+        table->stats.evictions++;
+    }
+    uint32_t i = home(sender);
+    while (table->slots[i].used) {
+        i = (i + 1) & MASK;
+    }
+    table->slots[i] = (replay_entry_t){.sender = sender, .used = true, .top = counter, .bitmap = 1, .last_used = table->clock};
+    table->senders++;
+    table->stats.new_senders++;
+    return true;
+}
+
+/**
+ * Confere o contador de uma mensagem autenticada e, se for aceita, registra
+ *
+ * @param table   Tabela de remetentes
+ * @param sender  Identificação do remetente (salt do nonce)
+ * @param counter Contador da mensagem (contador do nonce)
+ *
+ * Funcionamento:
+ * - Remetente novo: aceito, e a janela começa nesse contador. Com a tabela cheia, substitui o usado há mais tempo, ou é
+ *   recusado se todos tiverem mensagem aceita nas últimas REPLAY_RECENT conferências
+ * - Contador acima do maior aceito: a janela anda (o mapa é deslocado) e o bit 0 marca o novo maior
+ * - Contador dentro da janela: aceito só se o bit dele ainda estiver zerado
+ * - Chamar só depois de conferir a etiqueta: senão uma mensagem forjada moveria a janela
+ */
+replay_result_t replay_check(replay_table_t *table, uint32_t sender, uint64_t counter) {
+    int index = find(table, sender);
+    table->clock++;
+    if (index < 0) {
+        if (!insert(table, sender, counter)) {
+            table->stats.table_full++;
+            return REPLAY_TABLE_FULL;
+        }
+        table->stats.accepted++;
+        return REPLAY_ACCEPTED;
+    }
+
+    replay_entry_t *entry = &table->slots[index];
+    if (counter > entry->top) {
+        uint64_t shift = counter - entry->top;
+        entry->bitmap = shift >= REPLAY_WINDOW ? 0 : entry->bitmap << shift;
+        entry->bitmap |= 1;
+        entry->top = counter;
+    } else {
+        uint64_t offset = entry->top - counter;
+        if (offset >= REPLAY_WINDOW) {
+            table->stats.too_old++;
+            return REPLAY_TOO_OLD;
+        }
+        if (entry->bitmap & ((uint64_t)1 << offset)) {
+            table->stats.duplicates++;
+            return REPLAY_DUPLICATE;
+        }
+        entry->bitmap |= (uint64_t)1 << offset;
+    }
+    entry->last_used = table->clock;
+    table->stats.accepted++;
+    return REPLAY_ACCEPTED;
+}
+
+bool replay_forget(replay_table_t *table, uint32_t sender) {
+    int index = find(table, sender);
+    if (index < 0) {
+        return false;
+    }
+    remove_at(table, (uint32_t)index);
+    return true;
+}
+
+const char *replay_result_name(replay_result_t result) {
+    switch (result) {
+    case REPLAY_ACCEPTED: return "aceita";
+    case REPLAY_DUPLICATE: return "repetida";
+    case REPLAY_TOO_OLD: return "antiga demais";
+    case REPLAY_TABLE_FULL: return "tabela cheia";
+    default: return "?";
+    }
+}
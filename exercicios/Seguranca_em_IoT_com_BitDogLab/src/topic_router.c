@@ -0,0 +1,196 @@
+// Inclusão do arquivo de cabeçalho que contém a declaração das funções
+#include "include/topic_router.h"
+#include <string.h> // Para memset(), memcmp(), memcpy(), strlen() e strcspn()
+
+// Um nível do tópico: começo e tamanho dentro da string
+typedef struct {
+    const char *name;
+    size_t len;
+} level_t;
+
+void topic_router_init(topic_router_t *router) {
+    memset(router, 0, sizeof(*router));
+    router->node_count = 1; // Raiz (nível vazio, antes do primeiro)
+}
+
+bool topic_filter_valid(const char *filter) {
+    if (filter == NULL || filter[0] == '\0') {
+        return false;
+    }
+    const char *p = filter;
+    for (;;) {
+        size_t len = strcspn(p, "/");
+        bool wildcard = memchr(p, '+', len) != NULL || memchr(p, '#', len) != NULL;
+        if (wildcard && len != 1) {
+            return false; // "a+/b", "sala#"
+        }
+        if (p[0] == '#' && p[len] != '\0') {
+            return false; // "#/a"
+        }
+        if (p[len] == '\0') {
+            return true;
+        }
+        p += len + 1;
+    }
+}
+
+static bool is_plus(const topic_node_t *node) {
+    return node->level[0] == '+' && node->level[1] == '\0';
+}
+
+// Filho de parent com o nome dado (0: não existe)
+static uint8_t find_child(const topic_router_t *router, uint8_t parent, const char *name, size_t len) {
+    for (uint8_t c = router->nodes[parent].child; c != 0; c = router->nodes[c].sibling) {
+        const topic_node_t *node = &router->nodes[c];
+        if (strlen(node->level) == len && memcmp(node->level, name, len) == 0) {
+            return c;
+        }
+    }
+    return 0;
+}
+
+// Novo filho no fim da lista de parent (a ordem de registro é a ordem de entrega)
+static uint8_t add_child(topic_router_t *router, uint8_t parent, const char *name, size_t len) {
+    uint8_t n = router->node_count++;
+    topic_node_t *node = &router->nodes[n];
+    memset(node, 0, sizeof(*node));
+    memcpy(node->level, name, len);
+    node->level[len] = '\0';
+
+    uint8_t *link = &router->nodes[parent].child;
+    while (*link != 0) {
+        link = &router->nodes[*link].sibling;
+    }
+    *link = n;
+    return n;
+}
+
+/**
+ * Registra o tratador de um filtro
+ *
+ * Funcionamento:
+ * - Cada nível do filtro é um nó da árvore; os níveis que já existem (prefixo comum com outros filtros) são reaproveitados
+ * - Primeiro conta os nós que faltam: se eles ou o tratador não couberem, nada é alterado
+ * - O filtro termina no nó do último nível (exact) ou, se o último nível for "#", no nó anterior (multi)
+ */
+bool topic_router_add(topic_router_t *router, const char *filter, topic_handler_t handler, void *arg) {
+    if (!topic_filter_valid(filter) || handler == NULL) {
+        return false;
+    }
+
+    // Primeira passada: confere os níveis e conta os nós que faltam
+    uint8_t node = 0;
+    int missing = 0, depth = 0;
+    bool multi = false;
+    for (const char *p = filter;; p += strcspn(p, "/") + 1) {
+        size_t len = strcspn(p, "/");
+        if (len == 1 && p[0] == '#') {
+            multi = true;
+            break;
+        }
+        if (len >= TOPIC_ROUTER_LEVEL_MAX || ++depth > TOPIC_ROUTER_DEPTH) {
+            return false;
+        }
+        uint8_t c = missing == 0 ? find_child(router, node, p, len) : 0;
+        if (c != 0) {
+            node = c;
+        } else {
+            missing++;
+        }
+        if (p[len] == '\0') {
+            break;
+        }
+    }
+    const topic_node_t *last = &router->nodes[node];
+    bool new_route = missing > 0 || (multi ? last->multi : last->exact) == 0;
+    if (router->node_count + missing > TOPIC_ROUTER_NODES || (new_route && router->route_count == TOPIC_ROUTER_ROUTES)) {
+        return false;
+    }
+
+    // Segunda passada: cria os que faltam
+    node = 0;
+    const char *p = filter;
+    for (int i = 0; i < depth; i++) {
+        size_t len = strcspn(p, "/");
+        uint8_t c = find_child(router, node, p, len);
+        node = c != 0 ? c : add_child(router, node, p, len);
+        p += len + 1;
+    }
+
+    uint8_t *slot = multi ? &router->nodes[node].multi : &router->nodes[node].exact;
+    if (*slot == 0) {
+        *slot = (uint8_t)(++router->route_count);
+    }
+    router->routes[*slot - 1] = (topic_route_t){.handler = handler, .arg = arg};
+    return true;
+}
+
+static int call(topic_router_t *router, uint8_t route, const char *topic, char *payload, size_t len) {
+    const topic_route_t *r = &router->routes[route - 1];
+    r->handler(topic, payload, len, r->arg);
+    return 1;
+}
+
+// Casa os níveis a partir de depth com os filhos de node (o '+' e o '#' não valem para '$' no primeiro nível)
+static int match(topic_router_t *router, uint8_t node, const level_t *levels, int count, int depth, bool system,
+                 const char *topic, char *payload, size_t len) {
+    const topic_node_t *n = &router->nodes[node];
+    int calls = 0;
+    if (n->multi != 0 && !(system && depth == 0)) {
+        calls += call(router, n->multi, topic, payload, len); // "a/#" vale para "a" e tudo abaixo dele
+    }
+    if (depth == count) {
+        if (n->exact != 0) {
+            calls += call(router, n->exact, topic, payload, len);
+        }
+        return calls;
+    }
+
+    const level_t *level = &levels[depth];
+    for (uint8_t c = n->child; c != 0; c = router->nodes[c].sibling) {
+        const topic_node_t *child = &router->nodes[c];
+        bool same = strlen(child->level) == level->len && memcmp(child->level, level->name, level->len) == 0;
+        if (same || (is_plus(child) && !(system && depth == 0))) {
+            calls += match(router, c, levels, count, depth + 1, system, topic, payload, len);
+        }
+    }
+    return calls;
+}
+
+/**
+ * Entrega uma mensagem aos tratadores
+ *
+ * @param router  Roteador
+ * @param topic   Tópico da publicação (sem curingas)
+ * @param payload Mensagem (a mesma para todos os tratadores)
+ * @param len     Tamanho da mensagem
+ *
+ * Funcionamento:
+ * - Separa os níveis do tópico uma vez e desce pela árvore, nível a nível, pelo filho de mesmo nome e pelo "+"
+ * - Retorna quantos tratadores foram chamados (0: nenhum filtro casou)
+ */
+int topic_router_dispatch(topic_router_t *router, const char *topic, char *payload, size_t len) {
+    level_t levels[TOPIC_ROUTER_DEPTH];
+    int count = 0;
+    for (const char *p = topic;; p += levels[count - 1].len + 1) {
+        if (count == TOPIC_ROUTER_DEPTH) {
+            router->stats.unmatched++; // Mais níveis que qualquer filtro pode ter
+            return 0;
+        }
+        levels[count].name = p;
+        levels[count].len = strcspn(p, "/");
+        count++;
+        if (p[levels[count - 1].len] == '\0') {
+            break;
+        }
+    }
+
+    int calls = match(router, 0, levels, count, 0, topic[0] == '$', topic, payload, len);
+    if (calls > 0) {
+        router->stats.dispatched++;
+        router->stats.calls += (uint32_t)calls;
+    } else {
+        router->stats.unmatched++;
+    }
+    return calls;
+}
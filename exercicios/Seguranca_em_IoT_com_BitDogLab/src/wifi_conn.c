@@ -1,29 +1,62 @@
-#include "include/wifi_conn.h"         // Cabeçalho com a declaração da função de conexão Wi-Fi
+#include "include/wifi_conn.h"         // Cabeçalho com a declaração das funções de conexão Wi-Fi
 #include "pico/cyw43_arch.h"           // Biblioteca para controle do chip Wi-Fi CYW43 no Raspberry Pi Pico W
 #include <stdio.h>                     // Biblioteca padrão de entrada/saída (para usar printf)
 
+// Rede guardada em wifi_conn_init() e usada a cada nova tentativa do gerenciador de conexão
+static const char *wifi_ssid;
+static const char *wifi_password;
+static bool wifi_ready = false;
+
 /**
- * Função: connect_to_wifi
- * Objetivo: Inicializar o chip Wi-Fi da Pico W e conectar a uma rede usando SSID e senha fornecidos
+ * Função: wifi_conn_init
+ * Objetivo: Inicializar o chip Wi-Fi da Pico W em modo estação e guardar a rede (SSID e senha)
+ * A conexão em si fica com o gerenciador de conexão (conn_manager), sem bloquear o laço principal
  */
-void connect_to_wifi(const char *ssid, const char *password) {
+bool wifi_conn_init(const char *ssid, const char *password) {
     // Inicializa o driver Wi-Fi (CYW43). Retorna 0 se for bem-sucedido
     if (cyw43_arch_init()) {
         printf("Erro ao iniciar Wi-Fi\n");
-        return;
+        return false;
     }
 
     // Habilita o modo estação (STA) para se conectar a um ponto de acesso
     cyw43_arch_enable_sta_mode();
 
-    sleep_ms(3000); // Aguarda um tempo de 3 segundos antes de tentar se conectar com a rede pelo nome e senha que foram passados
-    // Esse tempo é necessário para se conseguir vizualizar, em um terminal serial, os prints das mensagens
+    wifi_ssid = ssid;
+    wifi_password = password;
+    wifi_ready = true;
+    return true;
+}
+
+// Dispara a associação e volta na hora; o andamento é acompanhado por wifi_conn_status()
+// Utiliza autenticação WPA2 com criptografia AES
+bool wifi_conn_start(void *arg) {
+    if (!wifi_ready) {
+        return false;
+    }
+    if (cyw43_arch_wifi_connect_async(wifi_ssid, wifi_password, CYW43_AUTH_WPA2_AES_PSK)) {
+        printf("Erro ao conectar\n");
+        return false;
+    }
+    return true;
+}
+
+// Sai da rede (antes de uma nova tentativa, para o driver não ficar preso numa associação que falhou)
+void wifi_conn_stop(void *arg) {
+    if (wifi_ready) {
+        cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+    }
+}
 
-    // Tenta conectar à rede Wi-Fi com um tempo limite de 30 segundos (30000 ms)
-    // Utiliza autenticação WPA2 com criptografia AES
-    if (cyw43_arch_wifi_connect_timeout_ms(ssid, password, CYW43_AUTH_WPA2_AES_PSK, 30000)) {
-        printf("Erro ao conectar\n");  // Se falhar, imprime mensagem de erro
-    } else {        
-        printf("Conectado ao Wi-Fi\n");  // Se conectar com sucesso, exibe confirmação
+// Estado do enlace como o driver informa, incluindo o DHCP do lwIP
+conn_link_t wifi_conn_status(void *arg) {
+    switch (cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA)) {
+    case CYW43_LINK_UP: return CONN_LINK_UP;
+    case CYW43_LINK_NOIP: return CONN_LINK_NOIP;
+    case CYW43_LINK_JOIN: return CONN_LINK_JOINING;
+    case CYW43_LINK_FAIL:
+    case CYW43_LINK_NONET:
+    case CYW43_LINK_BADAUTH: return CONN_LINK_FAIL;
+    default: return CONN_LINK_DOWN;
     }
 }
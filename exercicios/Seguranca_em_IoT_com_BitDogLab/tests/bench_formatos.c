@@ -0,0 +1,74 @@
+// Benchmark no computador (host) dos dois formatos da mensagem do sensor: tamanho médio (com e sem o envelope cifrado)
+// e tempo de leitura_encode()/leitura_decode() em JSON e em CBOR, com leituras realistas (timestamps Unix atuais,
+// temperaturas de -10 a 50 °C em centésimos)
+//
+// Compilação e execução (a partir da pasta exercicios/Seguranca_em_IoT_com_BitDogLab):
+//   gcc -std=c11 -O2 -I. tests/bench_formatos.c src/cbor.c src/json.c src/leitura.c -o bench_formatos && ./bench_formatos
+//
+// O decode passa pelo reconhecimento do formato, como no subscriber
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "include/leitura.h"
+#include "include/payload_crypto.h"
+
+#define MESSAGES 1024
+#define ROUNDS 2000
+
+static leitura_t leituras[MESSAGES];
+static uint8_t messages[MESSAGES][48];
+static size_t lengths[MESSAGES];
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench(leitura_formato_t formato) {
+    size_t total = 0;
+    for (int i = 0; i < MESSAGES; i++) {
+        lengths[i] = leitura_encode(formato, &leituras[i], messages[i], sizeof(messages[i]));
+        total += lengths[i];
+    }
+    double count = (double)MESSAGES * ROUNDS;
+
+    uint8_t out[48];
+    unsigned long checksum = 0;
+    double t0 = now_s();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < MESSAGES; i++) {
+            leitura_t l = {.valor = leituras[i].valor + r, .ts = leituras[i].ts};
+            checksum += leitura_encode(formato, &l, out, sizeof(out));
+        }
+    }
+    double encode = now_s() - t0;
+
+    t0 = now_s();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < MESSAGES; i++) {
+            leitura_t l;
+            leitura_formato_t detectado;
+            if (leitura_decode(messages[i], lengths[i], &l, &detectado)) checksum += (unsigned long)l.valor + l.ts + detectado;
+        }
+    }
+    double decode = now_s() - t0;
+
+    double media = (double)total / MESSAGES;
+    printf("%-5s %6.1f B %8.1f B cifrado %9.1f ns encode %9.1f ns decode   (soma %lu)\n", leitura_formato_nome(formato),
+           media, media + PAYLOAD_OVERHEAD, encode / count * 1e9, decode / count * 1e9, checksum);
+}
+
+int main(void) {
+    srand(7);
+    for (int i = 0; i < MESSAGES; i++) {
+        leituras[i].valor = rand() % 6001 - 1000;
+        leituras[i].ts = 1700000000u + (uint32_t)i * 5;
+    }
+    printf("formato  tamanho   com envelope       tempo por mensagem\n");
+    bench(LEITURA_JSON);
+    bench(LEITURA_CBOR);
+    return 0;
+}
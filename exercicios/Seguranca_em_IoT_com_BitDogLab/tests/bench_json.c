@@ -0,0 +1,82 @@
+// Benchmark no computador (host) da mensagem do sensor: leitura_from_json() contra o sscanf() com formato fixo da versão anterior,
+// e leitura_to_json() contra o snprintf(), em mensagens por segundo
+//
+// Compilação e execução (a partir da pasta exercicios/Seguranca_em_IoT_com_BitDogLab):
+//   gcc -std=c11 -O2 -I. tests/bench_json.c src/json.c src/cbor.c src/leitura.c -o bench_json && ./bench_json
+//
+// No computador, o sscanf e o snprintf usam a glibc. No RP2040 a diferença tende a ser maior: o %f puxa a conversão de
+// ponto flutuante da newlib em software (o Cortex-M0+ não tem FPU), e o parser em ponto fixo não usa float
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "include/leitura.h"
+
+#define MESSAGES 1024
+#define ROUNDS 2000
+
+static char texts[MESSAGES][48];
+static size_t lengths[MESSAGES];
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *name, double seconds, unsigned long checksum) {
+    double count = (double)MESSAGES * ROUNDS;
+    printf("%-28s %12.0f msg/s %9.1f ns/msg   (soma %lu)\n", name, count / seconds, seconds / count * 1e9, checksum);
+}
+
+int main(void) {
+    srand(7);
+    for (int i = 0; i < MESSAGES; i++) {
+        leitura_t l = {.valor = rand() % 100000 - 50000, .ts = (uint32_t)rand()};
+        lengths[i] = leitura_to_json(&l, texts[i], sizeof(texts[i]));
+    }
+
+    unsigned long checksum = 0;
+    double t0 = now_s();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < MESSAGES; i++) {
+            leitura_t l;
+            if (leitura_from_json(texts[i], lengths[i], &l)) checksum += (unsigned long)l.valor + l.ts;
+        }
+    }
+    report("leitura_from_json", now_s() - t0, checksum);
+
+    checksum = 0;
+    t0 = now_s();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < MESSAGES; i++) {
+            float valor;
+            unsigned long ts;
+            if (sscanf(texts[i], "{\"valor\":%f,\"ts\":%lu}", &valor, &ts) == 2) checksum += (unsigned long)(long)(valor * 100) + ts;
+        }
+    }
+    report("sscanf (versao anterior)", now_s() - t0, checksum);
+
+    char out[48];
+    checksum = 0;
+    t0 = now_s();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < MESSAGES; i++) {
+            leitura_t l = {.valor = i * 37 - 9000, .ts = (uint32_t)(r * MESSAGES + i)};
+            checksum += leitura_to_json(&l, out, sizeof(out));
+        }
+    }
+    report("leitura_to_json", now_s() - t0, checksum);
+
+    checksum = 0;
+    t0 = now_s();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < MESSAGES; i++) {
+            checksum += (unsigned long)snprintf(out, sizeof(out), "{\"valor\":%.2f,\"ts\":%lu}", (i * 37 - 9000) / 100.0, (unsigned long)(r * MESSAGES + i));
+        }
+    }
+    report("snprintf (versao anterior)", now_s() - t0, checksum);
+    return 0;
+}
@@ -0,0 +1,184 @@
+// Benchmark no computador (host) da proteção do payload
+// Confere o ChaCha20-Poly1305 com o vetor de teste da RFC 8439 (seção 2.8.2) e a ida e volta de payload_seal()/payload_open()
+// para cada cifra compilada; depois mede bytes/s e ciclos/byte para pacotes de 64, 128 e 512 bytes
+//
+// Compilação e execução (a partir da pasta exercicios/Seguranca_em_IoT_com_BitDogLab):
+//   gcc -std=c11 -O2 -I. tests/bench_payload.c src/payload_crypto.c src/chacha20poly1305.c -o bench_payload && ./bench_payload
+// Com o AES-256-GCM (requer os headers e a biblioteca do mbedTLS instalados no computador):
+//   gcc -std=c11 -O2 -I. -DPAYLOAD_CRYPTO_AES_GCM=1 tests/bench_payload.c src/payload_crypto.c src/chacha20poly1305.c -lmbedcrypto -o bench_payload
+//
+// Os ciclos são os do contador de tempo do processador do computador (rdtsc em x86), não os do RP2040: no Cortex-M0+ a 125 MHz,
+// sem multiplicação 32x32->64 em uma instrução, o Poly1305 custa proporcionalmente mais. Meça no alvo antes de dimensionar a taxa.
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "include/payload_crypto.h"
+#include "include/chacha20poly1305.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLES 1
+#else
+#define HAVE_CYCLES 0
+#endif
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FALHA: %s\n", what);
+        failures++;
+    }
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t cycles(void) {
+#if HAVE_CYCLES
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// RFC 8439, seção 2.8.2
+static void test_rfc8439(void) {
+    uint8_t key[32];
+    for (int i = 0; i < 32; i++) {
+        key[i] = (uint8_t)(0x80 + i);
+    }
+    const uint8_t nonce[12] = {0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+    const uint8_t aad[12] = {0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
+    const char *plaintext = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+    const uint8_t ciphertext_start[16] = {0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2};
+    const uint8_t expected_tag[16] = {0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91};
+
+    uint8_t data[128];
+    size_t len = strlen(plaintext);
+    memcpy(data, plaintext, len);
+    uint8_t tag[16];
+    chacha20poly1305_encrypt(key, nonce, aad, sizeof(aad), data, len, tag);
+    check(memcmp(data, ciphertext_start, sizeof(ciphertext_start)) == 0, "RFC 8439: texto cifrado");
+    check(memcmp(tag, expected_tag, sizeof(tag)) == 0, "RFC 8439: etiqueta");
+
+    check(chacha20poly1305_decrypt(key, nonce, aad, sizeof(aad), data, len, tag), "RFC 8439: etiqueta aceita");
+    check(memcmp(data, plaintext, len) == 0, "RFC 8439: texto decifrado");
+
+    chacha20poly1305_encrypt(key, nonce, aad, sizeof(aad), data, len, tag);
+    data[len - 1] ^= 0x01;
+    check(!chacha20poly1305_decrypt(key, nonce, aad, sizeof(aad), data, len, tag), "RFC 8439: texto alterado rejeitado");
+}
+
+// Ida e volta pelo formato do pacote, com cabeçalho alterado e pacote truncado
+static void test_roundtrip(payload_cipher_t cipher) {
+    uint8_t key[PAYLOAD_KEY_BYTES];
+    for (int i = 0; i < PAYLOAD_KEY_BYTES; i++) {
+        key[i] = (uint8_t)(i * 7 + 1);
+    }
+    payload_ctx_t tx, rx;
+    check(payload_init(&tx, cipher, key, 0x12345678, 0x7000000000000000), "payload_init (envio)");
+    check(payload_init(&rx, cipher, key, 0, 0), "payload_init (recepção)");
+
+    uint8_t packet[128];
+    const char *message = "{\"valor\":26.5,\"ts\":1}";
+    size_t len = strlen(message);
+    memcpy(payload_plaintext(packet), message, len);
+    size_t packet_len = payload_seal(&tx, packet, len, sizeof(packet));
+    check(packet_len == len + PAYLOAD_OVERHEAD, "payload_seal: tamanho do pacote");
+    check(memcmp(payload_plaintext(packet), message, len) != 0, "payload_seal: texto cifrado no lugar");
+
+    uint8_t copy[128];
+    memcpy(copy, packet, packet_len);
+    size_t out_len = 0;
+    payload_nonce_t nonce;
+    check(payload_open(&rx, copy, packet_len, &out_len, &nonce), "payload_open: pacote válido");
+    check(out_len == len && memcmp(payload_plaintext(copy), message, len) == 0, "payload_open: texto decifrado");
+    check(nonce.salt == 0x12345678 && nonce.counter == 0x7000000000000000, "payload_open: salt e contador inicial");
+
+    memcpy(copy, packet, packet_len);
+    copy[PAYLOAD_HEADER_BYTES - 1] ^= 0x01; // Contador alterado: o cabeçalho é autenticado
+    check(!payload_open(&rx, copy, packet_len, &out_len, NULL), "payload_open: cabeçalho alterado rejeitado");
+    memcpy(copy, packet, packet_len);
+    check(!payload_open(&rx, copy, packet_len - 1, &out_len, NULL), "payload_open: pacote truncado rejeitado");
+
+    memcpy(payload_plaintext(packet), message, len);
+    payload_seal(&tx, packet, len, sizeof(packet));
+    check(payload_open(&rx, packet, len + PAYLOAD_OVERHEAD, &out_len, &nonce) && nonce.counter == 0x7000000000000001, "contador avança a cada mensagem");
+
+    check(payload_seal(&tx, packet, sizeof(packet) - PAYLOAD_OVERHEAD + 1, sizeof(packet)) == 0, "payload_seal: mensagem que não cabe");
+
+    payload_free(&tx);
+    payload_free(&rx);
+    static const uint8_t zeros[PAYLOAD_KEY_BYTES];
+    check(memcmp(tx.key, zeros, sizeof(zeros)) == 0 && tx.counter == 0, "payload_free: chave apagada");
+}
+
+// Mede cifrar (payload_seal) e decifrar (payload_open, incluindo a cópia do pacote, desprezível perto da cifra)
+static void bench(payload_cipher_t cipher, size_t len) {
+    static uint8_t packet[512 + PAYLOAD_OVERHEAD];
+    static uint8_t sealed[512 + PAYLOAD_OVERHEAD];
+    uint8_t key[PAYLOAD_KEY_BYTES] = {1, 2, 3};
+    payload_ctx_t ctx;
+    payload_init(&ctx, cipher, key, 1, 0);
+    memset(packet, 'a', sizeof(packet));
+
+    const int iterations = (int)(20000000 / (len + 64)); // ~0,1 a 0,3 s por medida
+
+    double t0 = now_s();
+    uint64_t c0 = cycles();
+    for (int i = 0; i < iterations; i++) {
+        payload_seal(&ctx, packet, len, sizeof(packet));
+    }
+    uint64_t seal_cycles = cycles() - c0;
+    double seal_s = now_s() - t0;
+
+    size_t packet_len = payload_seal(&ctx, sealed, len, sizeof(sealed));
+    size_t out_len;
+    t0 = now_s();
+    c0 = cycles();
+    for (int i = 0; i < iterations; i++) {
+        memcpy(packet, sealed, packet_len);
+        if (!payload_open(&ctx, packet, packet_len, &out_len, NULL)) {
+            failures++;
+        }
+    }
+    uint64_t open_cycles = cycles() - c0;
+    double open_s = now_s() - t0;
+
+    double total = (double)len * iterations;
+    printf("%-18s %5zu %12.1f %12.1f", payload_cipher_name(cipher), len, total / seal_s / 1e6, total / open_s / 1e6);
+    if (HAVE_CYCLES) {
+        printf(" %10.2f %10.2f", seal_cycles / total, open_cycles / total);
+    }
+    printf("\n");
+    payload_free(&ctx);
+}
+
+int main(void) {
+    test_rfc8439();
+    test_roundtrip(PAYLOAD_CIPHER_CHACHA20_POLY1305);
+#if PAYLOAD_CRYPTO_AES_GCM
+    test_roundtrip(PAYLOAD_CIPHER_AES_256_GCM);
+#endif
+
+    const size_t sizes[] = {64, 128, 512};
+    printf("%-18s %5s %12s %12s", "cifra", "bytes", "cifrar MB/s", "decifrar MB/s");
+    if (HAVE_CYCLES) {
+        printf(" %10s %10s", "cic/B cif", "cic/B dec");
+    }
+    printf("\n");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench(PAYLOAD_CIPHER_CHACHA20_POLY1305, sizes[i]);
+#if PAYLOAD_CRYPTO_AES_GCM
+        bench(PAYLOAD_CIPHER_AES_256_GCM, sizes[i]);
+#endif
+    }
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,289 @@
+// Teste no computador (host) do CBOR sem alocação (src/cbor.c) e da mensagem do sensor em CBOR (src/leitura.c)
+// Vetores do apêndice A da RFC 8949 para o escritor e o leitor, itens que o leitor só precisa pular (floats, tags, bytes,
+// aninhados), entradas inválidas e um fuzz com mensagens alteradas e bytes aleatórios em buffers do tamanho exato,
+// para o AddressSanitizer acusar qualquer leitura além do fim. Por fim, ida e volta e reconhecimento do formato
+//
+// Compilação e execução (a partir da pasta exercicios/Seguranca_em_IoT_com_BitDogLab):
+//   gcc -std=c11 -O1 -g -fsanitize=address,undefined -I. tests/teste_cbor.c src/cbor.c src/json.c src/leitura.c -o teste_cbor && ./teste_cbor
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "include/cbor.h"
+#include "include/leitura.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FALHA: %s\n", what);
+        failures++;
+    }
+}
+
+// Converte "1903e8" em bytes
+static size_t from_hex(const char *hex, uint8_t *out) {
+    size_t n = 0;
+    for (; hex[0] && hex[1]; hex += 2) {
+        unsigned byte;
+        sscanf(hex, "%2x", &byte);
+        out[n++] = (uint8_t)byte;
+    }
+    return n;
+}
+
+static bool same_bytes(const uint8_t *data, size_t len, const char *hex) {
+    uint8_t expected[64];
+    size_t n = from_hex(hex, expected);
+    return len == n && memcmp(data, expected, n) == 0;
+}
+
+// Cópia em memória do tamanho exato
+static bool parse_exact(const uint8_t *data, size_t len, leitura_t *leitura) {
+    uint8_t *copy = malloc(len ? len : 1);
+    memcpy(copy, data, len);
+    bool ok = leitura_from_cbor(copy, len, leitura);
+    free(copy);
+    return ok;
+}
+
+static bool skip_exact(const char *hex) {
+    uint8_t data[64];
+    size_t n = from_hex(hex, data);
+    uint8_t *copy = malloc(n ? n : 1);
+    memcpy(copy, data, n);
+    cbor_reader_t r;
+    cbor_reader_init(&r, copy, n);
+    bool ok = cbor_skip(&r) && r.pos == n;
+    free(copy);
+    return ok;
+}
+
+static void test_integer_vectors(void) {
+    static const struct {
+        int64_t value;
+        const char *hex;
+    } vectors[] = {
+        {0, "00"}, {1, "01"}, {10, "0a"}, {23, "17"}, {24, "1818"}, {25, "1819"}, {100, "1864"}, {1000, "1903e8"},
+        {1000000, "1a000f4240"}, {1000000000000, "1b000000e8d4a51000"}, {-1, "20"}, {-10, "29"}, {-100, "3863"},
+        {-1000, "3903e7"}, {INT64_MIN, "3b7fffffffffffffff"},
+    };
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        uint8_t buffer[16];
+        cbor_writer_t w;
+        cbor_writer_init(&w, buffer, sizeof(buffer));
+        cbor_write_int(&w, vectors[i].value);
+        size_t len = cbor_writer_finish(&w);
+        check(same_bytes(buffer, len, vectors[i].hex), vectors[i].hex);
+
+        cbor_reader_t r;
+        int64_t value;
+        cbor_reader_init(&r, buffer, len);
+        check(cbor_read_int(&r, &value) && value == vectors[i].value && r.pos == len, "leitura de inteiro");
+    }
+
+    uint8_t buffer[16];
+    cbor_writer_t w;
+    cbor_writer_init(&w, buffer, sizeof(buffer));
+    cbor_write_uint(&w, UINT64_MAX);
+    check(same_bytes(buffer, cbor_writer_finish(&w), "1bffffffffffffffff"), "18446744073709551615");
+
+    // Fora da faixa de int64_t: o leitor recusa, mas o item ainda pode ser pulado
+    cbor_reader_t r;
+    int64_t value;
+    cbor_reader_init(&r, buffer, 9);
+    check(!cbor_read_int(&r, &value), "uint64 maximo nao cabe em int64_t");
+    check(skip_exact("3bffffffffffffffff"), "pula -18446744073709551616");
+}
+
+static void test_other_vectors(void) {
+    uint8_t buffer[64];
+    cbor_writer_t w;
+
+    cbor_writer_init(&w, buffer, sizeof(buffer));
+    cbor_write_bool(&w, false);
+    cbor_write_bool(&w, true);
+    cbor_write_text(&w, "");
+    cbor_write_text(&w, "a");
+    cbor_write_text(&w, "IETF");
+    check(same_bytes(buffer, cbor_writer_finish(&w), "f4f56061616449455446"), "false, true, textos");
+
+    // [1, [2, 3], [4, 5]]
+    cbor_writer_init(&w, buffer, sizeof(buffer));
+    cbor_begin_array(&w, 3);
+    cbor_write_uint(&w, 1);
+    cbor_begin_array(&w, 2);
+    cbor_write_uint(&w, 2);
+    cbor_write_uint(&w, 3);
+    cbor_begin_array(&w, 2);
+    cbor_write_uint(&w, 4);
+    cbor_write_uint(&w, 5);
+    check(same_bytes(buffer, cbor_writer_finish(&w), "8301820203820405"), "arrays aninhados");
+
+    // {1: 2, 3: 4}
+    cbor_writer_init(&w, buffer, sizeof(buffer));
+    cbor_begin_map(&w, 2);
+    cbor_write_uint(&w, 1);
+    cbor_write_uint(&w, 2);
+    cbor_write_uint(&w, 3);
+    cbor_write_uint(&w, 4);
+    check(same_bytes(buffer, cbor_writer_finish(&w), "a201020304"), "mapa");
+
+    // Sem espaço: nada de escrita além do buffer, e o tamanho volta 0
+    cbor_writer_init(&w, buffer, 4);
+    cbor_write_text(&w, "IETF");
+    check(cbor_writer_finish(&w) == 0, "overflow");
+}
+
+static void test_skip(void) {
+    check(skip_exact("f93c00"), "pula float16 1.0");
+    check(skip_exact("fa47c35000"), "pula float32 100000.0");
+    check(skip_exact("fb3ff199999999999a"), "pula float64 1.1");
+    check(skip_exact("f6"), "pula null");
+    check(skip_exact("4401020304"), "pula bytes");
+    check(skip_exact("c074323031332d30332d32315432303a30343a30305a"), "pula tag 0 com texto");
+    check(skip_exact("a26161016162820203"), "pula {\"a\": 1, \"b\": [2, 3]}");
+    check(skip_exact("80") && skip_exact("a0"), "pula vazios");
+
+    check(!skip_exact(""), "vazio");
+    check(!skip_exact("9fff"), "array de tamanho indefinido");
+    check(!skip_exact("5f42010243030405ff"), "bytes de tamanho indefinido");
+    check(!skip_exact("1c"), "informacao adicional reservada");
+    check(!skip_exact("19e8"), "argumento cortado");
+    check(!skip_exact("644945544600"), "sobra depois do texto");
+    check(!skip_exact("644945"), "texto cortado");
+    check(!skip_exact("8301020300"), "sobra depois do array");
+    check(!skip_exact("9bffffffffffffffff"), "array enorme");
+
+    // Aninhamento além do limite
+    char deep[2 * 40 + 1] = {0};
+    for (int i = 0; i < 40; i++) memcpy(deep + 2 * i, "81", 2);
+    check(!skip_exact(deep), "aninhamento profundo");
+}
+
+static void test_leitura(void) {
+    leitura_t l = {.valor = 2650, .ts = 1};
+    uint8_t buffer[32];
+    size_t len = leitura_to_cbor(&l, buffer, sizeof(buffer));
+    check(same_bytes(buffer, len, "a201190a5a0201"), "leitura em CBOR");
+
+    leitura_t out;
+    leitura_formato_t formato;
+    check(parse_exact(buffer, len, &out) && out.valor == 2650 && out.ts == 1, "ida e volta");
+
+    // Outra ordem, chave desconhecida (inteira e de texto) com valor aninhado
+    uint8_t data[64];
+    len = from_hex("a4" "0218ff" "6161" "826162f5" "01390a59" "1863" "8101", data);
+    check(parse_exact(data, len, &out) && out.valor == -2650 && out.ts == 255, "ordem trocada e chaves extras");
+
+    check(!parse_exact(data, len - 1, &out), "cortada");
+    len = from_hex("a10201", data);
+    check(!parse_exact(data, len, &out), "sem valor");
+    len = from_hex("a2011a800000000201", data);
+    check(!parse_exact(data, len, &out), "valor fora de int32_t");
+    len = from_hex("a201200220", data);
+    check(!parse_exact(data, len, &out), "ts negativo");
+    len = from_hex("a20161610201", data);
+    check(!parse_exact(data, len, &out), "valor com tipo errado");
+    len = from_hex("a2010102010000", data);
+    check(!parse_exact(data, len, &out), "bytes depois do mapa");
+    len = from_hex("820102", data);
+    check(!parse_exact(data, len, &out), "raiz nao e mapa");
+
+    check(leitura_to_cbor(&l, buffer, 6) == 0, "buffer curto demais");
+    l.valor = INT32_MIN;
+    l.ts = UINT32_MAX;
+    len = leitura_to_cbor(&l, buffer, sizeof(buffer));
+    check(parse_exact(buffer, len, &out) && out.valor == INT32_MIN && out.ts == UINT32_MAX, "extremos");
+
+    // Reconhecimento do formato pelo primeiro byte
+    l = (leitura_t){.valor = -5, .ts = 42};
+    len = leitura_encode(LEITURA_CBOR, &l, buffer, sizeof(buffer));
+    check(leitura_decode(buffer, len, &out, &formato) && formato == LEITURA_CBOR && out.valor == -5 && out.ts == 42, "decode CBOR");
+    len = leitura_encode(LEITURA_JSON, &l, buffer, sizeof(buffer));
+    check(len == strlen("{\"valor\":-0.05,\"ts\":42}"), "encode JSON");
+    check(leitura_decode(buffer, len, &out, &formato) && formato == LEITURA_JSON && out.valor == -5 && out.ts == 42, "decode JSON");
+    check(!leitura_decode(buffer, 0, &out, &formato), "mensagem vazia");
+
+    // Lotes nos dois formatos; uma leitura avulsa conta como lote de uma
+    leitura_t lote[4] = {{100, 1}, {-200, 2}, {300, 3}, {0, 4}}, lidas[4];
+    for (int f = 0; f < 2; f++) {
+        leitura_formato_t esperado = f ? LEITURA_CBOR : LEITURA_JSON;
+        len = leitura_lote_encode(esperado, lote, 4, buffer, 16);
+        check(len == 0, "lote grande demais para o buffer");
+        uint8_t grande[128];
+        len = leitura_lote_encode(esperado, lote, 4, grande, sizeof(grande));
+        check(leitura_lote_decode(grande, len, lidas, 4, &formato) == 4 && formato == esperado && lidas[1].valor == -200 && lidas[3].ts == 4, "lote");
+        check(leitura_lote_decode(grande, len, lidas, 3, &formato) == -1, "lote maior que o vetor");
+        check(leitura_lote_decode(grande, len - 1, lidas, 4, &formato) == -1, "lote cortado");
+        len = leitura_lote_encode(esperado, lote, 0, grande, sizeof(grande));
+        check(leitura_lote_decode(grande, len, lidas, 4, &formato) == 0, "lote vazio");
+        len = leitura_encode(esperado, &lote[2], grande, sizeof(grande));
+        check(leitura_lote_decode(grande, len, lidas, 4, &formato) == 1 && lidas[0].valor == 300, "leitura avulsa como lote");
+    }
+    const char *texto = " [ {\"ts\": 9, \"valor\": 1.5} ,{\"valor\":2,\"ts\":10,\"x\":[1,{}]}] ";
+    check(leitura_lote_decode((const uint8_t *)texto, strlen(texto), lidas, 4, &formato) == 2 && lidas[0].valor == 150 && lidas[1].ts == 10, "lote JSON com espacos");
+    texto = "[{\"valor\":1,\"ts\":1},]";
+    check(leitura_lote_decode((const uint8_t *)texto, strlen(texto), lidas, 4, &formato) == -1, "virgula sobrando no lote");
+}
+
+// Mensagens válidas alteradas e bytes aleatórios: o leitor nunca pode ler fora do buffer nem aceitar um mapa sem os campos
+static void test_fuzz(void) {
+    srand(11);
+    uint8_t data[48];
+    for (int i = 0; i < 300000; i++) {
+        size_t len;
+        if (i % 3 == 0) {
+            len = (size_t)(rand() % (int)sizeof(data));
+            for (size_t k = 0; k < len; k++) data[k] = (uint8_t)rand();
+            if (len > 0 && (i & 1)) data[0] = (uint8_t)(0xa0 | (rand() & 0x1f));
+        } else {
+            leitura_t l = {.valor = rand() - RAND_MAX / 2, .ts = (uint32_t)rand()};
+            len = leitura_to_cbor(&l, data, sizeof(data));
+            int edits = 1 + rand() % 3;
+            for (int e = 0; e < edits && len > 0; e++) {
+                size_t at = (size_t)rand() % len;
+                switch (rand() % 3) {
+                case 0: data[at] = (uint8_t)rand(); break;
+                case 1: len = at; break;
+                default:
+                    if (len < sizeof(data)) {
+                        memmove(data + at + 1, data + at, len - at);
+                        data[at] = (uint8_t)rand();
+                        len++;
+                    }
+                }
+            }
+        }
+        leitura_t out;
+        parse_exact(data, len, &out);
+        uint8_t *copy = malloc(len ? len : 1);
+        memcpy(copy, data, len);
+        cbor_reader_t r;
+        cbor_reader_init(&r, copy, len);
+        cbor_skip(&r);
+        check(r.pos <= len, "posicao dentro do buffer");
+        free(copy);
+    }
+
+    // Ida e volta de leituras aleatórias
+    for (int i = 0; i < 100000; i++) {
+        leitura_t l = {.valor = (int32_t)((uint32_t)rand() << 1 ^ (uint32_t)rand()), .ts = (uint32_t)rand() << 1 ^ (uint32_t)rand()}, out;
+        size_t len = leitura_to_cbor(&l, data, sizeof(data));
+        if (!parse_exact(data, len, &out) || out.valor != l.valor || out.ts != l.ts) {
+            check(false, "ida e volta aleatoria");
+            break;
+        }
+    }
+}
+
+int main(void) {
+    test_integer_vectors();
+    test_other_vectors();
+    test_skip();
+    test_leitura();
+    test_fuzz();
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,326 @@
+// Teste no computador (host) do gerenciador de conexão (src/conn_manager.c) com um Wi-Fi e um lwIP simulados
+// As operações falsas registram o que foi pedido e o teste decide o que o "driver" e o "broker" respondem, avançando
+// um relógio simulado: conexão normal, tempo esgotado no Wi-Fi, senha errada, recusa do broker, queda depois de
+// conectado (com as assinaturas refeitas), queda do Wi-Fi, espera exponencial com sorteio e eventos atrasados de uma
+// conexão anterior
+//
+// Compilação e execução (a partir da pasta exercicios/Seguranca_em_IoT_com_BitDogLab):
+//   gcc -std=c11 -O1 -g -fsanitize=address,undefined -I. tests/teste_conn.c src/conn_manager.c -o teste_conn && ./teste_conn
+
+#include <stdio.h>
+#include <string.h>
+#include "include/conn_manager.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FALHA: %s\n", what);
+        failures++;
+    }
+}
+
+// Rede e broker simulados
+typedef struct {
+    conn_link_t link;
+    bool wifi_start_ok, mqtt_start_ok, subscribe_ok;
+    int wifi_starts, wifi_stops, mqtt_starts, mqtt_stops;
+    const char *subscribed[16];
+    int subscribe_calls;
+    uint32_t random_value;
+} mock_t;
+
+static mock_t mock;
+static conn_manager_t cm;
+static uint32_t now;
+
+static bool mock_wifi_start(void *arg) { mock.wifi_starts++; if (mock.wifi_start_ok) mock.link = CONN_LINK_JOINING; return mock.wifi_start_ok; }
+static void mock_wifi_stop(void *arg) { mock.wifi_stops++; mock.link = CONN_LINK_DOWN; }
+static conn_link_t mock_wifi_status(void *arg) { return mock.link; }
+static bool mock_mqtt_start(void *arg) { mock.mqtt_starts++; return mock.mqtt_start_ok; }
+static void mock_mqtt_stop(void *arg) { mock.mqtt_stops++; }
+static uint32_t mock_random(void *arg) { return mock.random_value; }
+
+static bool mock_subscribe(const char *topic, uint8_t qos, void *arg) {
+    if (mock.subscribe_calls < 16) mock.subscribed[mock.subscribe_calls] = topic;
+    mock.subscribe_calls++;
+    return mock.subscribe_ok;
+}
+
+static const conn_ops_t ops = {
+    .wifi_start = mock_wifi_start,
+    .wifi_stop = mock_wifi_stop,
+    .wifi_status = mock_wifi_status,
+    .mqtt_start = mock_mqtt_start,
+    .mqtt_stop = mock_mqtt_stop,
+    .mqtt_subscribe = mock_subscribe,
+    .random = mock_random,
+};
+
+static const conn_config_t config = {.wifi_timeout_ms = 30000, .mqtt_timeout_ms = 10000, .backoff_min_ms = 1000, .backoff_max_ms = 60000};
+
+// Trocas de estado vistas pelo gancho
+static conn_state_t transitions[64];
+static int transition_count;
+
+static void hook(conn_state_t from, conn_state_t to, void *arg) {
+    check(cm.state == to, "gancho chamado depois da troca");
+    if (transition_count < 64) transitions[transition_count++] = to;
+}
+
+static void reset(void) {
+    memset(&mock, 0, sizeof(mock));
+    mock.wifi_start_ok = mock.mqtt_start_ok = mock.subscribe_ok = true;
+    transition_count = 0;
+    now = 5000;
+    conn_init(&cm, &config, &ops, NULL);
+    conn_set_hook(&cm, hook, NULL);
+}
+
+static void poll_at(uint32_t ms) {
+    now += ms;
+    conn_poll(&cm, now);
+}
+
+// Wi-Fi com IP, CONNACK aceito e cada SUBACK confirmado
+static void bring_online(void) {
+    mock.link = CONN_LINK_UP;
+    poll_at(10);
+    conn_event_mqtt_up(&cm);
+    poll_at(10);
+    while (cm.state == CONN_MQTT_SUBSCRIBING) {
+        conn_event_subscribed(&cm, true);
+        poll_at(10);
+    }
+}
+
+static void test_normal_path(void) {
+    reset();
+    conn_subscribe(&cm, "a/1", 0);
+    conn_subscribe(&cm, "b/2", 1);
+    check(conn_subscribe(&cm, "c", 0) && cm.subscription_count == 3, "registro");
+    conn_subscribe(&cm, "a/1", 1); // Repetido: só troca o QoS
+    check(cm.subscription_count == 3 && cm.subscriptions[0].qos == 1, "registro repetido");
+
+    poll_at(100);
+    check(cm.state == CONN_IDLE && mock.wifi_starts == 0, "parado antes de conn_start");
+    conn_start(&cm, now);
+    check(cm.state == CONN_WIFI_JOINING && mock.wifi_starts == 1, "associacao disparada");
+
+    mock.link = CONN_LINK_NOIP;
+    poll_at(2000);
+    check(cm.state == CONN_WIFI_DHCP, "esperando DHCP");
+    mock.link = CONN_LINK_UP;
+    poll_at(500);
+    check(cm.state == CONN_MQTT_CONNECTING && mock.mqtt_starts == 1, "CONNECT disparado");
+    poll_at(100);
+    check(cm.state == CONN_MQTT_CONNECTING, "esperando CONNACK");
+
+    conn_event_mqtt_up(&cm);
+    poll_at(10);
+    check(cm.state == CONN_MQTT_SUBSCRIBING && mock.subscribe_calls == 1 && strcmp(mock.subscribed[0], "a/1") == 0, "primeira assinatura");
+    poll_at(10);
+    check(mock.subscribe_calls == 1, "uma assinatura por vez");
+    conn_event_subscribed(&cm, true);
+    poll_at(10);
+    conn_event_subscribed(&cm, true);
+    poll_at(10);
+    check(mock.subscribe_calls == 3 && strcmp(mock.subscribed[2], "c") == 0 && cm.state == CONN_MQTT_SUBSCRIBING, "assinaturas em ordem");
+    conn_event_subscribed(&cm, true);
+    poll_at(10);
+    check(cm.state == CONN_ONLINE && cm.stats.connects == 1, "online");
+
+    conn_state_t expected[] = {CONN_WIFI_JOINING, CONN_WIFI_DHCP, CONN_MQTT_CONNECTING, CONN_MQTT_SUBSCRIBING, CONN_ONLINE};
+    check(transition_count == 5 && memcmp(transitions, expected, sizeof(expected)) == 0, "trocas de estado no gancho");
+
+    // Assinatura nova já conectado: vai na hora, sem sair do ONLINE
+    conn_subscribe(&cm, "d", 0);
+    conn_event_subscribed(&cm, true);
+    poll_at(10);
+    check(mock.subscribe_calls == 4 && cm.state == CONN_ONLINE, "assinatura com a conexao de pe");
+    check(!conn_subscribe(&cm, "e", 0) && mock.subscribe_calls == 4, "limite de assinaturas");
+}
+
+// Prazo do Wi-Fi (associação + DHCP juntos) e espera crescente, com o teto e o sorteio
+static void test_wifi_timeout_and_backoff(void) {
+    reset();
+    conn_start(&cm, now);
+    mock.link = CONN_LINK_JOINING;
+    poll_at(20000);
+    mock.link = CONN_LINK_NOIP;
+    poll_at(9000);
+    check(cm.state == CONN_WIFI_DHCP, "DHCP dentro do prazo");
+    poll_at(1000);
+    check(cm.state == CONN_BACKOFF && cm.stats.wifi_failures == 1, "prazo vale para associacao e DHCP juntos");
+
+    // A cada falha seguida o teto dobra (1 s, 2 s, 4 s ... até 60 s) e a espera fica entre metade do teto e o teto
+    mock.random_value = 0xffffffffu;
+    uint32_t expected_cap = 1000;
+    bool growth_ok = true;
+    for (int i = 0; i < 10; i++) {
+        growth_ok &= cm.wait_ms >= expected_cap / 2 && cm.wait_ms <= expected_cap;
+        int starts = mock.wifi_starts;
+        poll_at(cm.wait_ms - 1);
+        growth_ok &= cm.state == CONN_BACKOFF;
+        poll_at(1);
+        growth_ok &= cm.state == CONN_WIFI_JOINING && mock.wifi_starts == starts + 1 && mock.wifi_stops == starts + 1;
+        mock.link = CONN_LINK_FAIL; // Senha errada ou rede ausente: falha na hora
+        poll_at(10);
+        growth_ok &= cm.state == CONN_BACKOFF;
+        expected_cap = expected_cap * 2 > 60000 ? 60000 : expected_cap * 2;
+    }
+    check(growth_ok, "espera dobra ate o teto");
+    check(cm.wait_ms <= 60000 && cm.wait_ms >= 30000, "teto de 60 s");
+
+    // Sorteio no mínimo: metade do teto
+    mock.random_value = 0;
+    poll_at(cm.wait_ms);
+    mock.link = CONN_LINK_FAIL;
+    poll_at(10);
+    check(cm.wait_ms == 30000, "metade do teto com sorteio zero");
+
+    // Muitas falhas seguidas não estouram o deslocamento
+    cm.attempt = 250;
+    mock.random_value = 12345;
+    poll_at(cm.wait_ms);
+    mock.link = CONN_LINK_FAIL;
+    poll_at(10);
+    check(cm.state == CONN_BACKOFF && cm.wait_ms >= 30000 && cm.wait_ms <= 60000, "sem estouro com muitas falhas");
+
+    // Conectar zera a espera
+    poll_at(cm.wait_ms);
+    bring_online();
+    check(cm.state == CONN_ONLINE && cm.attempt == 0, "online zera as tentativas");
+    mock.random_value = 0xffffffffu;
+    conn_event_mqtt_down(&cm);
+    poll_at(10);
+    check(cm.state == CONN_BACKOFF && cm.wait_ms <= 1000, "espera volta ao minimo");
+
+    // Driver recusando iniciar
+    reset();
+    mock.wifi_start_ok = false;
+    conn_start(&cm, now);
+    check(cm.state == CONN_BACKOFF && cm.stats.wifi_failures == 1, "driver recusou");
+}
+
+// Recusa do broker: a nova tentativa é só do MQTT, o Wi-Fi continua
+static void test_mqtt_refused(void) {
+    reset();
+    conn_start(&cm, now);
+    mock.link = CONN_LINK_UP;
+    poll_at(10);
+    conn_event_mqtt_down(&cm); // CONNACK recusado
+    poll_at(10);
+    check(cm.state == CONN_BACKOFF && cm.stats.mqtt_failures == 1 && mock.mqtt_stops == 1, "recusa do broker");
+    poll_at(cm.wait_ms);
+    check(cm.state == CONN_MQTT_CONNECTING && mock.wifi_starts == 1 && mock.mqtt_starts == 2, "tenta de novo so o MQTT");
+
+    // Sem CONNACK no prazo
+    poll_at(10000);
+    check(cm.state == CONN_BACKOFF && cm.stats.mqtt_failures == 2 && mock.mqtt_stops == 2, "CONNACK fora do prazo");
+
+    // mqtt_client_connect recusando na hora (ex.: sem memória)
+    mock.mqtt_start_ok = false;
+    poll_at(cm.wait_ms);
+    check(cm.state == CONN_BACKOFF && cm.stats.mqtt_failures == 3, "cliente recusou o CONNECT");
+    mock.mqtt_start_ok = true;
+
+    // SUBACK com erro e SUBACK que não chega
+    conn_subscribe(&cm, "x", 0);
+    poll_at(cm.wait_ms);
+    conn_event_mqtt_up(&cm);
+    poll_at(10);
+    conn_event_subscribed(&cm, false);
+    poll_at(10);
+    check(cm.state == CONN_BACKOFF && cm.stats.mqtt_failures == 4, "SUBACK com erro");
+    poll_at(cm.wait_ms);
+    conn_event_mqtt_up(&cm);
+    poll_at(10);
+    poll_at(10000);
+    check(cm.state == CONN_BACKOFF && cm.stats.mqtt_failures == 5, "SUBACK fora do prazo");
+    mock.subscribe_ok = false;
+    poll_at(cm.wait_ms);
+    conn_event_mqtt_up(&cm);
+    poll_at(10);
+    check(cm.state == CONN_BACKOFF && cm.stats.mqtt_failures == 6, "cliente recusou o SUBSCRIBE");
+}
+
+// Queda depois de conectado: as assinaturas são todas refeitas
+static void test_drop_resubscribes(void) {
+    reset();
+    conn_subscribe(&cm, "a", 0);
+    conn_subscribe(&cm, "b", 0);
+    conn_start(&cm, now);
+    bring_online();
+    check(cm.state == CONN_ONLINE && mock.subscribe_calls == 2, "online com duas assinaturas");
+
+    conn_event_mqtt_down(&cm);
+    poll_at(10);
+    check(cm.state == CONN_BACKOFF && cm.stats.drops == 1 && cm.stats.mqtt_failures == 0, "queda contada");
+    poll_at(cm.wait_ms);
+    check(cm.state == CONN_MQTT_CONNECTING && mock.wifi_starts == 1, "reconecta so o MQTT");
+    conn_event_mqtt_up(&cm);
+    poll_at(10);
+    conn_event_subscribed(&cm, true);
+    poll_at(10);
+    conn_event_subscribed(&cm, true);
+    poll_at(10);
+    check(cm.state == CONN_ONLINE && mock.subscribe_calls == 4 && strcmp(mock.subscribed[2], "a") == 0 &&
+          strcmp(mock.subscribed[3], "b") == 0 && cm.stats.connects == 2, "assinaturas refeitas");
+}
+
+// Wi-Fi cai com o MQTT de pé: fecha o cliente e recomeça pelo Wi-Fi
+static void test_wifi_lost(void) {
+    reset();
+    conn_start(&cm, now);
+    bring_online();
+    mock.link = CONN_LINK_DOWN;
+    poll_at(10);
+    check(cm.state == CONN_BACKOFF && mock.mqtt_stops == 1 && cm.stats.drops == 1, "queda do Wi-Fi");
+    poll_at(cm.wait_ms);
+    check(cm.state == CONN_WIFI_JOINING && mock.wifi_starts == 2, "recomeca pelo Wi-Fi");
+    bring_online();
+    check(cm.state == CONN_ONLINE && cm.stats.connects == 2, "volta a ficar online");
+}
+
+// Eventos de uma conexão anterior não valem para a próxima
+static void test_stale_events(void) {
+    reset();
+    conn_subscribe(&cm, "a", 0);
+    conn_start(&cm, now);
+    mock.link = CONN_LINK_UP;
+    poll_at(10);
+    poll_at(10000); // CONNACK não chegou
+    check(cm.state == CONN_BACKOFF, "prazo esgotado");
+    conn_event_mqtt_up(&cm); // Chega atrasado, durante a espera
+    conn_event_subscribed(&cm, true);
+    poll_at(cm.wait_ms);
+    check(cm.state == CONN_MQTT_CONNECTING, "nova tentativa");
+    poll_at(10);
+    check(cm.state == CONN_MQTT_CONNECTING, "CONNACK atrasado ignorado");
+
+    // Queda e CONNACK juntos: a queda vale
+    conn_event_mqtt_up(&cm);
+    conn_event_mqtt_down(&cm);
+    poll_at(10);
+    check(cm.state == CONN_BACKOFF, "queda tem prioridade");
+
+    // Contadores de 8 bits dão a volta sem perder eventos
+    cm.mqtt_up_posted = cm.mqtt_up_seen = 255;
+    cm.mqtt_down_posted = cm.mqtt_down_seen = 255;
+    poll_at(cm.wait_ms);
+    conn_event_mqtt_up(&cm);
+    poll_at(10);
+    check(cm.state == CONN_MQTT_SUBSCRIBING, "contador deu a volta");
+}
+
+int main(void) {
+    test_normal_path();
+    test_wifi_timeout_and_backoff();
+    test_mqtt_refused();
+    test_drop_resubscribes();
+    test_wifi_lost();
+    test_stale_events();
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,226 @@
+// Teste no computador (host) do JSON sem alocação (src/json.c) e da mensagem do sensor (src/leitura.c)
+// Casos fixos (espaços, ordem das chaves, chaves extras, aninhamento, escapes, números, erros) e um fuzz: mensagens válidas
+// com bytes trocados, inseridos ou cortados e textos aleatórios, cada um em um buffer do tamanho exato (sem '\0'),
+// para o AddressSanitizer acusar qualquer leitura além do fim. Por fim, ida e volta de leituras aleatórias pelo escritor
+//
+// Compilação e execução (a partir da pasta exercicios/Seguranca_em_IoT_com_BitDogLab):
+//   gcc -std=c11 -O1 -g -fsanitize=address,undefined -I. tests/teste_json.c src/json.c src/cbor.c src/leitura.c -o teste_json && ./teste_json
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "include/json.h"
+#include "include/leitura.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FALHA: %s\n", what);
+        failures++;
+    }
+}
+
+// Cópia sem '\0' em memória do tamanho exato
+static bool parse_exact(const char *text, size_t len, leitura_t *leitura) {
+    char *copy = malloc(len ? len : 1);
+    memcpy(copy, text, len);
+    bool ok = leitura_from_json(copy, len, leitura);
+    free(copy);
+    return ok;
+}
+
+static bool parse(const char *text, leitura_t *leitura) {
+    return parse_exact(text, strlen(text), leitura);
+}
+
+static void test_messages(void) {
+    leitura_t l;
+    check(parse("{\"valor\":26.5,\"ts\":1}", &l) && l.valor == 2650 && l.ts == 1, "mensagem do publisher");
+    check(parse(" {\n \"ts\" : 4294967295 ,\t\"valor\" : -3.14159 } ", &l) && l.valor == -314 && l.ts == 4294967295u, "espaços e outra ordem");
+    check(parse("{\"id\":\"bitdog1\",\"valor\":1e1,\"extra\":{\"a\":[1,{\"b\":null}],\"c\":true},\"ts\":7}", &l) && l.valor == 1000 && l.ts == 7,
+          "chaves extras com valores aninhados");
+    check(parse("{\"valor\":0.005,\"ts\":0}", &l) && l.valor == 1, "arredondamento para cima (meio)");
+    check(parse("{\"valor\":-0.005,\"ts\":0}", &l) && l.valor == -1, "arredondamento negativo");
+    check(parse("{\"valor\":2.5E-3,\"ts\":0}", &l) && l.valor == 0, "expoente negativo");
+    check(parse("{\"valor\":21474836.47,\"ts\":0}", &l) && l.valor == INT32_MAX, "maior valor");
+    check(parse("{\"valor\":-21474836.48,\"ts\":0}", &l) && l.valor == INT32_MIN, "menor valor");
+
+    check(!parse("{\"valor\":21474836.48,\"ts\":0}", &l), "estouro de int32");
+    check(!parse("{\"valor\":1e30,\"ts\":0}", &l), "expoente grande");
+    check(!parse("{\"valor\":26.5}", &l), "falta campo obrigatório");
+    check(!parse("{\"valor\":\"26.5\",\"ts\":1}", &l), "tipo errado (string no lugar de número)");
+    check(!parse("{\"valor\":26.5,\"ts\":-1}", &l), "uint negativo");
+    check(!parse("{\"valor\":26.5,\"ts\":1.5}", &l), "uint com fração");
+    check(!parse("{\"valor\":26.5,\"ts\":4294967296}", &l), "uint fora da faixa");
+    check(!parse("{\"valor\":26.5,\"ts\":1", &l), "texto cortado");
+    check(!parse("{\"valor\":26.5,\"ts\":1}x", &l), "lixo depois do objeto");
+    check(!parse("{\"valor\":026.5,\"ts\":1}", &l), "zero à esquerda");
+    check(!parse("{\"valor\":.5,\"ts\":1}", &l), "número sem parte inteira");
+    check(!parse("{\"valor\":26.5,,\"ts\":1}", &l), "vírgula dupla");
+    check(!parse("{\"valor\":26.5,\"ts\":1,}", &l), "vírgula no fim");
+    check(!parse("[26.5,1]", &l), "raiz não é objeto");
+    check(!parse("", &l), "texto vazio");
+}
+
+static void test_tokenizer(void) {
+    json_token_t t[16];
+    const char *js = "{\"a\\\"b\\u00e9\":[1,true,null],\"c\":{}}";
+    int n = json_tokenize(js, strlen(js), t, 16);
+    check(n == 8, "número de tokens");
+    check(t[0].type == JSON_OBJECT && t[0].size == 2 && t[0].parent == -1, "objeto raiz");
+    check(t[1].type == JSON_STRING && t[1].size == 1 && t[1].end - t[1].start == 10, "chave com escapes");
+    check(t[2].type == JSON_ARRAY && t[2].size == 3 && t[2].parent == 1, "array filho da chave");
+    check(t[4].type == JSON_PRIMITIVE && js[t[4].start] == 't' && t[4].parent == 2, "literal no array");
+    check(t[7].type == JSON_OBJECT && t[7].size == 0, "objeto vazio");
+    check(json_tokenize(js, strlen(js), t, 5) == JSON_ERROR_NOMEM, "tokens insuficientes");
+    check(json_tokenize("{\"a\":1", 6, t, 16) == JSON_ERROR_PARTIAL, "texto incompleto");
+    check(json_tokenize("{\"a\":tru}", 9, t, 16) == JSON_ERROR_INVALID, "literal inválido");
+    check(json_tokenize("\"a\x01\"", 4, t, 16) == JSON_ERROR_INVALID, "caractere de controle na string");
+    check(json_tokenize("\"\\x\"", 4, t, 16) == JSON_ERROR_INVALID, "escape inválido");
+
+    char deep[64];
+    memset(deep, '[', 20);
+    memset(deep + 20, ']', 20);
+    check(json_tokenize(deep, 40, t, 16) < 0, "aninhamento além do limite");
+}
+
+// Struct com todos os tipos de campo
+typedef struct {
+    int32_t fixed;
+    int32_t integer;
+    uint32_t unsigned_value;
+    bool flag;
+    char name[8];
+} all_types_t;
+
+static const json_field_t all_fields[] = {
+    {"f", JSON_FIELD_FIXED, 3, true, offsetof(all_types_t, fixed), 0},
+    {"i", JSON_FIELD_INT, 0, false, offsetof(all_types_t, integer), 0},
+    {"u", JSON_FIELD_UINT, 0, false, offsetof(all_types_t, unsigned_value), 0},
+    {"b", JSON_FIELD_BOOL, 0, false, offsetof(all_types_t, flag), 0},
+    {"s", JSON_FIELD_STRING, 0, false, offsetof(all_types_t, name), 8},
+};
+
+static void test_fields(void) {
+    all_types_t v = {0};
+    const char *js = "{\"s\":\"a\\tb\\u00e9\",\"b\":true,\"u\":42,\"i\":-2147483648,\"f\":-1.0005}";
+    check(json_parse_object(js, strlen(js), all_fields, 5, &v), "todos os tipos");
+    check(v.fixed == -1001 && v.integer == INT32_MIN && v.unsigned_value == 42 && v.flag, "valores convertidos");
+    check(strcmp(v.name, "a\tb\xc3\xa9") == 0, "string com escapes convertidos para UTF-8");
+
+    const char *too_long = "{\"f\":1,\"s\":\"12345678\"}";
+    check(!json_parse_object(too_long, strlen(too_long), all_fields, 5, &v), "string maior que o campo");
+    const char *wrong = "{\"f\":1,\"b\":1}";
+    check(!json_parse_object(wrong, strlen(wrong), all_fields, 5, &v), "bool com número");
+}
+
+static void test_writer(void) {
+    char out[96];
+    json_writer_t w;
+    json_writer_init(&w, out, sizeof(out));
+    json_begin_object(&w, NULL);
+    json_write_string(&w, "id", "bit\"dog\n");
+    json_begin_array(&w, "v");
+    json_write_fixed(&w, NULL, 2650, 2);
+    json_write_fixed(&w, NULL, -5, 2);
+    json_write_fixed(&w, NULL, 100, 2);
+    json_end_array(&w);
+    json_write_bool(&w, "ok", false);
+    json_write_int(&w, "n", INT32_MIN);
+    json_end_object(&w);
+    size_t len = json_writer_finish(&w);
+    const char *expected = "{\"id\":\"bit\\\"dog\\u000a\",\"v\":[26.5,-0.05,1],\"ok\":false,\"n\":-2147483648}";
+    check(len == strlen(expected) && strcmp(out, expected) == 0, "escritor: objeto, array e escapes");
+
+    leitura_t l = {.valor = 2650, .ts = 1};
+    check(leitura_to_json(&l, out, sizeof(out)) == 21 && strcmp(out, "{\"valor\":26.5,\"ts\":1}") == 0, "mensagem do publisher");
+    check(leitura_to_json(&l, out, 21) == 0, "buffer sem espaço para o '\\0'");
+    check(leitura_to_json(&l, out, 22) == 21, "buffer do tamanho exato");
+}
+
+static void test_fuzz(void) {
+    const char *seeds[] = {
+        "{\"valor\":26.5,\"ts\":1}",
+        " { \"ts\" : 123 , \"valor\" : -1.25e+1 , \"x\" : [ \"a\\u0041\" , { \"y\" : null } ] } ",
+        "{\"s\":\"\\\"\\\\\\/\\b\\f\\n\\r\\t\",\"f\":0.001,\"b\":false}",
+    };
+    const char alphabet[] = "{}[]\",:.-+eE0123456789tfnul\\ \"ax";
+    char text[160];
+    int accepted = 0;
+
+    for (int iter = 0; iter < 300000; iter++) {
+        size_t len;
+        if (iter % 4 == 3) { // Texto aleatório
+            len = (size_t)(rand() % 64);
+            for (size_t i = 0; i < len; i++) {
+                text[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+            }
+        } else { // Mensagem válida com 1 a 3 mutações
+            const char *seed = seeds[iter % 3];
+            len = strlen(seed);
+            memcpy(text, seed, len);
+            int mutations = 1 + rand() % 3;
+            for (int m = 0; m < mutations && len > 0; m++) {
+                size_t at = (size_t)rand() % len;
+                switch (rand() % 4) {
+                case 0: text[at] = alphabet[rand() % (sizeof(alphabet) - 1)]; break; // Troca
+                case 1: text[at] = (char)(rand() & 0xff); break; // Byte qualquer
+                case 2: len = at; break; // Corta
+                default: // Insere
+                    if (len < sizeof(text) - 1) {
+                        memmove(text + at + 1, text + at, len - at);
+                        text[at] = alphabet[rand() % (sizeof(alphabet) - 1)];
+                        len++;
+                    }
+                }
+            }
+        }
+
+        char *exact = malloc(len ? len : 1);
+        memcpy(exact, text, len);
+        json_token_t tokens[24];
+        int n = json_tokenize(exact, len, tokens, 24);
+        for (int i = 0; i < n; i++) { // Tokens sempre dentro do texto e com o pai antes do filho
+            if (tokens[i].end > len || tokens[i].start > tokens[i].end || tokens[i].parent >= i) {
+                failures++;
+                printf("FALHA: token inconsistente no fuzz\n");
+                break;
+            }
+        }
+        all_types_t v;
+        leitura_t l;
+        if (json_parse_object(exact, len, all_fields, 5, &v)) accepted++;
+        if (leitura_from_json(exact, len, &l)) accepted++;
+        free(exact);
+    }
+    printf("Fuzz: 300000 textos, %d aceitos\n", accepted);
+}
+
+static void test_roundtrip(void) {
+    int bad = 0;
+    for (int i = 0; i < 100000; i++) {
+        leitura_t in = {.valor = (int32_t)((uint32_t)rand() << 16 ^ (uint32_t)rand()), .ts = (uint32_t)rand() * 7u};
+        char text[64];
+        leitura_t out;
+        size_t len = leitura_to_json(&in, text, sizeof(text));
+        if (len == 0 || !parse_exact(text, len, &out) || out.valor != in.valor || out.ts != in.ts) {
+            bad++;
+        }
+    }
+    check(bad == 0, "ida e volta de 100000 leituras aleatórias");
+}
+
+int main(void) {
+    srand(1234);
+    test_messages();
+    test_tokenizer();
+    test_fields();
+    test_writer();
+    test_fuzz();
+    test_roundtrip();
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
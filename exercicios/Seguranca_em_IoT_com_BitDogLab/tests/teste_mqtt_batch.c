@@ -0,0 +1,282 @@
+// Teste no computador (host) da publicação em lote (src/mqtt_batch.c) contra um broker simulado
+// O publisher entrega cada lote ao "broker", que monta o pacote PUBLISH do MQTT 3.1.1 como ele sai no fio (cabeçalho fixo,
+// tamanho restante, tópico, identificador do pacote no QoS 1 e payload), confere o pacote, responde PUBACK no QoS 1 e
+// repassa o payload ao subscriber pela recepção em fragmentos (src/mqtt_rx.c), que decifra e lê o lote.
+// Primeiro casos fixos (envio por quantidade, por tamanho, por tempo, QoS, falha na publicação); depois 1000 leituras,
+// uma a cada 5 s, em cada configuração, com mensagens e bytes no fio por 1000 leituras
+//
+// Compilação e execução (a partir da pasta exercicios/Seguranca_em_IoT_com_BitDogLab):
+//   gcc -std=c11 -O2 -I. tests/teste_mqtt_batch.c src/mqtt_batch.c src/mqtt_rx.c src/replay.c src/leitura.c src/json.c src/cbor.c src/payload_crypto.c src/chacha20poly1305.c -o teste_mqtt_batch && ./teste_mqtt_batch
+//
+// Bytes no fio: pacotes MQTT mais 40 bytes de cabeçalhos IPv4 e TCP por segmento (um segmento por PUBLISH e por PUBACK,
+// sem opções TCP e sem contar o cabeçalho do Wi-Fi, que soma o mesmo por segmento)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/mqtt_batch.h"
+#include "include/mqtt_rx.h"
+
+#define TCP_IP_HEADER_BYTES 40
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FALHA: %s\n", what);
+        failures++;
+    }
+}
+
+// Broker simulado: contadores do que passou pelo fio e leituras que chegaram ao subscriber
+typedef struct {
+    uint32_t publishes;
+    uint32_t pubacks;
+    uint32_t mqtt_bytes; // PUBLISH + PUBACK
+    uint32_t wire_bytes; // Com TCP/IP
+    uint8_t last_qos;
+    bool fail; // Simula a publicação recusada pelo cliente MQTT
+    uint16_t next_packet_id;
+} broker_t;
+
+static broker_t broker;
+static leitura_t delivered[2048];
+static uint32_t delivered_count = 0;
+static uint32_t delivered_batches = 0;
+static uint32_t bad_messages = 0;
+
+// Subscriber: mesma leitura de lote do tratador do firmware
+static void subscriber(const char *topic, char *payload, size_t len, void *arg) {
+    (void)topic;
+    (void)arg;
+    leitura_t leituras[LEITURA_LOTE_MAX];
+    leitura_formato_t formato;
+    int n = leitura_lote_decode((const uint8_t *)payload, len, leituras, LEITURA_LOTE_MAX, &formato);
+    if (n < 0) {
+        bad_messages++;
+        return;
+    }
+    for (int i = 0; i < n && delivered_count < sizeof(delivered) / sizeof(delivered[0]); i++) {
+        delivered[delivered_count++] = leituras[i];
+    }
+    delivered_batches++;
+}
+
+// Tamanho restante do MQTT em base 128 (1 a 4 bytes)
+static size_t put_remaining_length(uint8_t *out, size_t value) {
+    size_t n = 0;
+    do {
+        uint8_t byte = value % 128;
+        value /= 128;
+        out[n++] = value > 0 ? (byte | 0x80) : byte;
+    } while (value > 0);
+    return n;
+}
+
+// Publicação: monta o PUBLISH como o cliente enviaria, confere o pacote do lado do broker e entrega ao subscriber
+static bool broker_publish(const char *topic, const uint8_t *data, size_t len, uint8_t qos, void *arg) {
+    (void)arg;
+    if (broker.fail) {
+        return false;
+    }
+
+    uint8_t frame[512];
+    size_t topic_len = strlen(topic);
+    size_t remaining = 2 + topic_len + (qos > 0 ? 2 : 0) + len;
+    size_t n = 0;
+    frame[n++] = (uint8_t)(0x30 | (qos << 1)); // PUBLISH, sem DUP nem RETAIN
+    n += put_remaining_length(frame + n, remaining);
+    frame[n++] = (uint8_t)(topic_len >> 8);
+    frame[n++] = (uint8_t)topic_len;
+    memcpy(frame + n, topic, topic_len);
+    n += topic_len;
+    if (qos > 0) {
+        uint16_t id = ++broker.next_packet_id;
+        frame[n++] = (uint8_t)(id >> 8);
+        frame[n++] = (uint8_t)id;
+    }
+    memcpy(frame + n, data, len);
+    n += len;
+
+    // Lado do broker: lê o cabeçalho fixo e o tamanho restante de volta
+    size_t pos = 1, value = 0, shift = 0;
+    uint8_t byte;
+    do {
+        byte = frame[pos++];
+        value |= (size_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    check((frame[0] >> 4) == 3 && ((frame[0] >> 1) & 3) == qos, "cabecalho fixo do PUBLISH");
+    check(pos + value == n, "tamanho restante do PUBLISH");
+    size_t payload_at = pos + 2 + ((size_t)frame[pos] << 8 | frame[pos + 1]) + (qos > 0 ? 2 : 0);
+    check(n - payload_at == len, "payload do PUBLISH");
+
+    broker.publishes++;
+    broker.mqtt_bytes += (uint32_t)n;
+    broker.wire_bytes += (uint32_t)n + TCP_IP_HEADER_BYTES;
+    broker.last_qos = qos;
+    if (qos > 0) {
+        broker.pubacks++;
+        broker.mqtt_bytes += 4; // PUBACK: 0x40, 0x02 e o identificador
+        broker.wire_bytes += 4 + TCP_IP_HEADER_BYTES;
+    }
+
+    // Entrega ao subscriber em fragmentos de até 64 bytes, como o lwIP faz com mensagens grandes
+    mqtt_rx_begin(topic, (uint32_t)len);
+    for (size_t offset = 0; offset < len; offset += 64) {
+        size_t chunk = len - offset < 64 ? len - offset : 64;
+        mqtt_rx_data(frame + payload_at + offset, (uint16_t)chunk, offset + chunk == len ? MQTT_RX_FLAG_LAST : 0);
+    }
+    mqtt_rx_poll();
+    return true;
+}
+
+static const uint8_t key[PAYLOAD_KEY_BYTES] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+                                               17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32};
+static payload_ctx_t tx, rx;
+
+static void reset(bool crypto) {
+    memset(&broker, 0, sizeof(broker));
+    delivered_count = 0;
+    delivered_batches = 0;
+    bad_messages = 0;
+    payload_init(&tx, PAYLOAD_CIPHER_CHACHA20_POLY1305, key, 0x1234, 0);
+    payload_init(&rx, PAYLOAD_CIPHER_CHACHA20_POLY1305, key, 0, 0);
+    mqtt_rx_init(crypto ? &rx : NULL, subscriber, NULL);
+}
+
+static leitura_t reading(uint32_t i) {
+    leitura_t l = {.valor = 2000 + (int32_t)(i * 37 % 1500), .ts = 1700000000u + i * 5};
+    return l;
+}
+
+static bool delivered_in_order(uint32_t count) {
+    if (delivered_count != count) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        leitura_t l = reading(i);
+        if (delivered[i].valor != l.valor || delivered[i].ts != l.ts) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_policies(void) {
+    mqtt_batch_t batch;
+    mqtt_batch_config_t config = {.topic = "escola/sala1/temperatura", .formato = LEITURA_CBOR, .qos = 0,
+                                  .max_count = 4, .max_bytes = 200, .max_latency_ms = 60000};
+
+    // Por quantidade: a 4a leitura envia o lote na hora
+    reset(true);
+    mqtt_batch_init(&batch, &config, &tx, broker_publish, NULL);
+    leitura_t l;
+    for (uint32_t i = 0; i < 3; i++) {
+        l = reading(i);
+        mqtt_batch_add(&batch, &l, i * 5000);
+    }
+    check(broker.publishes == 0, "nada antes de max_count");
+    l = reading(3);
+    mqtt_batch_add(&batch, &l, 15000);
+    check(broker.publishes == 1 && batch.stats.flush_count == 1 && delivered_in_order(4), "envio por quantidade");
+    check(batch.stats.bytes == 1 + 4 * 11 + PAYLOAD_OVERHEAD, "tamanho do lote CBOR cifrado");
+
+    // Por tempo: o prazo conta da leitura mais antiga, inclusive com o relógio dando a volta
+    reset(true);
+    config.max_latency_ms = 10000;
+    mqtt_batch_init(&batch, &config, &tx, broker_publish, NULL);
+    l = reading(0);
+    mqtt_batch_add(&batch, &l, 0xfffff000u);
+    l = reading(1);
+    mqtt_batch_add(&batch, &l, 0xfffff000u + 5000);
+    mqtt_batch_poll(&batch, 0xfffff000u + 9999);
+    check(broker.publishes == 0, "antes do prazo");
+    mqtt_batch_poll(&batch, 0xfffff000u + 10000);
+    check(broker.publishes == 1 && batch.stats.flush_latency == 1 && delivered_in_order(2), "envio por tempo");
+    mqtt_batch_poll(&batch, 0xfffff000u + 30000);
+    check(broker.publishes == 1, "lote vazio nao e enviado");
+
+    // Por tamanho: a leitura que não caberia vai para o lote seguinte; nenhum pacote passa de max_bytes
+    reset(true);
+    config = (mqtt_batch_config_t){.topic = "escola/sala1/temperatura", .formato = LEITURA_JSON, .qos = 1,
+                                   .max_count = 24, .max_bytes = 100, .max_latency_ms = 60000};
+    mqtt_batch_init(&batch, &config, &tx, broker_publish, NULL);
+    for (uint32_t i = 0; i < 10; i++) {
+        l = reading(i);
+        mqtt_batch_add(&batch, &l, i * 5000);
+        check(batch.len <= 100, "lote dentro de max_bytes");
+    }
+    check(broker.publishes > 0 && batch.stats.flush_bytes == broker.publishes, "envio por tamanho");
+    check(mqtt_batch_flush(&batch) && batch.stats.flush_manual == 1, "envio manual");
+    check(delivered_in_order(10) && broker.pubacks == broker.publishes && broker.last_qos == 1, "QoS do lote");
+
+    // Leitura maior que max_bytes e publicação recusada: contadas como perdidas
+    reset(true);
+    config.max_bytes = 10;
+    mqtt_batch_init(&batch, &config, &tx, broker_publish, NULL);
+    l = reading(0);
+    check(!mqtt_batch_add(&batch, &l, 0) && batch.stats.dropped == 1 && batch.count == 0, "leitura grande demais");
+    config.max_bytes = 200;
+    config.max_count = 2;
+    mqtt_batch_init(&batch, &config, &tx, broker_publish, NULL);
+    broker.fail = true;
+    mqtt_batch_add(&batch, &l, 0);
+    mqtt_batch_add(&batch, &l, 1);
+    check(batch.stats.dropped == 2 && batch.stats.batches == 0 && batch.count == 0, "publicacao recusada");
+
+    // Sem criptografia, o lote sai em claro e o subscriber lê do mesmo jeito
+    reset(false);
+    config = (mqtt_batch_config_t){.topic = "t", .formato = LEITURA_JSON, .qos = 0, .max_count = 3, .max_bytes = 0};
+    mqtt_batch_init(&batch, &config, NULL, broker_publish, NULL);
+    for (uint32_t i = 0; i < 3; i++) {
+        l = reading(i);
+        mqtt_batch_add(&batch, &l, 0);
+    }
+    check(delivered_in_order(3) && bad_messages == 0, "lote em claro");
+}
+
+// 1000 leituras, uma a cada 5 s, com o laço principal chamando mqtt_batch_poll() a cada 10 ms
+static void run_scenario(const char *name, const mqtt_batch_config_t *config) {
+    reset(true);
+    mqtt_batch_t batch;
+    mqtt_batch_init(&batch, config, &tx, broker_publish, NULL);
+    uint32_t max_wait = 0; // Maior espera de uma leitura no lote
+    for (uint32_t i = 0; i < 1000; i++) {
+        leitura_t l = reading(i);
+        uint32_t now = i * 5000;
+        for (uint32_t t = now - (i ? 5000 : 0); t < now; t += 10) mqtt_batch_poll(&batch, t);
+        if (batch.count > 0 && now - batch.oldest_ms > max_wait) max_wait = now - batch.oldest_ms;
+        mqtt_batch_add(&batch, &l, now);
+    }
+    mqtt_batch_flush(&batch);
+    check(delivered_in_order(1000) && bad_messages == 0, name);
+
+    printf("%-28s %7u %10u %10u %8.1f %8.1f %7.1f s\n", name, broker.publishes + broker.pubacks, broker.mqtt_bytes,
+           broker.wire_bytes, broker.mqtt_bytes / 1000.0, broker.wire_bytes / 1000.0, max_wait / 1000.0);
+}
+
+int main(void) {
+    test_policies();
+
+    printf("\nPor 1000 leituras (uma a cada 5 s, ChaCha20-Poly1305, topico escola/sala1/temperatura):\n");
+    printf("%-28s %7s %10s %10s %8s %8s %9s\n", "configuracao", "pacotes", "bytes MQTT", "bytes fio", "MQTT/l", "fio/l", "espera");
+    static const struct {
+        const char *name;
+        mqtt_batch_config_t config;
+    } scenarios[] = {
+        {"JSON avulso QoS 0", {"escola/sala1/temperatura", LEITURA_JSON, 0, 1, 0, 60000}},
+        {"CBOR avulso QoS 0", {"escola/sala1/temperatura", LEITURA_CBOR, 0, 1, 0, 60000}},
+        {"JSON lote 12/60 s QoS 0", {"escola/sala1/temperatura", LEITURA_JSON, 0, 12, 0, 60000}},
+        {"CBOR lote 12/60 s QoS 0", {"escola/sala1/temperatura", LEITURA_CBOR, 0, 12, 0, 60000}},
+        {"CBOR lote 12/60 s QoS 1", {"escola/sala1/temperatura", LEITURA_CBOR, 1, 12, 200, 60000}},
+        {"CBOR lote 24/120 s QoS 1", {"escola/sala1/temperatura", LEITURA_CBOR, 1, 24, 0, 120000}},
+        {"CBOR avulso QoS 1", {"escola/sala1/temperatura", LEITURA_CBOR, 1, 1, 0, 60000}},
+    };
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        run_scenario(scenarios[i].name, &scenarios[i].config);
+    }
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
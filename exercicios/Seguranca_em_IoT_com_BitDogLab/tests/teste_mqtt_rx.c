@@ -0,0 +1,222 @@
+// Teste no computador (host) da recepção em fragmentos (src/mqtt_rx.c)
+// Reproduz as sequências de callbacks do lwIP (início da publicação + fragmentos, o último com a flag de fim) com pacotes
+// cifrados por payload_seal(): mensagens cortadas em pedaços aleatórios, grandes demais, interrompidas, com tamanho diferente
+// do anunciado, alteradas, repetidas (janela contra replay), fila cheia e payload em claro
+//
+// Compilação e execução (a partir da pasta exercicios/Seguranca_em_IoT_com_BitDogLab):
+//   gcc -std=c11 -O2 -I. tests/teste_mqtt_rx.c src/mqtt_rx.c src/replay.c src/payload_crypto.c src/chacha20poly1305.c -o teste_mqtt_rx && ./teste_mqtt_rx
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/mqtt_rx.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FALHA: %s\n", what);
+        failures++;
+    }
+}
+
+// Mensagens entregues ao tratador
+#define MAX_RECEIVED 8
+static char received_topic[MAX_RECEIVED][MQTT_RX_TOPIC_MAX];
+static char received_payload[MAX_RECEIVED][MQTT_RX_BUFFER_BYTES + 1];
+static size_t received_len[MAX_RECEIVED];
+static int received = 0;
+
+static void handler(const char *topic, char *payload, size_t len, void *arg) {
+    (void)arg;
+    if (received < MAX_RECEIVED) {
+        strcpy(received_topic[received], topic);
+        memcpy(received_payload[received], payload, len + 1); // Inclui o '\0' colocado pela recepção
+        received_len[received] = len;
+    }
+    received++;
+}
+
+static payload_ctx_t tx, rx;
+
+// Cifra uma mensagem de texto; retorna o tamanho do pacote
+static size_t seal(const char *text, uint8_t *packet, size_t size) {
+    size_t len = strlen(text);
+    memcpy(payload_plaintext(packet), text, len);
+    return payload_seal(&tx, packet, len, size);
+}
+
+// Entrega um pacote em fragmentos de até "max_fragment" bytes (0: tamanhos aleatórios de 1 a 40)
+static void feed(const char *topic, const uint8_t *packet, size_t len, size_t max_fragment) {
+    mqtt_rx_begin(topic, (uint32_t)len);
+    size_t offset = 0;
+    do {
+        size_t n = max_fragment ? max_fragment : (size_t)(1 + rand() % 40);
+        if (n > len - offset) n = len - offset;
+        mqtt_rx_data(packet + offset, (uint16_t)n, offset + n == len ? MQTT_RX_FLAG_LAST : 0);
+        offset += n;
+    } while (offset < len);
+}
+
+static void test_fragmented_sequences(void) {
+    mqtt_rx_init(&rx, handler, NULL);
+    uint8_t packet[MQTT_RX_BUFFER_BYTES];
+    char text[MQTT_RX_BUFFER_BYTES];
+    int bad = 0;
+
+    for (int m = 0; m < 500; m++) {
+        size_t text_len = (size_t)(rand() % (MQTT_RX_BUFFER_BYTES - PAYLOAD_OVERHEAD + 1));
+        for (size_t i = 0; i < text_len; i++) {
+            text[i] = (char)('a' + rand() % 26);
+        }
+        text[text_len] = '\0';
+        size_t len = seal(text, packet, sizeof(packet));
+
+        received = 0;
+        feed(m % 2 ? "escola/sala1/temperatura" : "escola/sala2/umidade", packet, len, m % 3 == 0 ? len : 0);
+        int delivered = mqtt_rx_poll();
+        if (delivered != 1 || received != 1 || received_len[0] != text_len || strcmp(received_payload[0], text) != 0 ||
+            strcmp(received_topic[0], m % 2 ? "escola/sala1/temperatura" : "escola/sala2/umidade") != 0) {
+            bad++;
+        }
+    }
+    check(bad == 0, "500 mensagens em fragmentos aleatórios entregues inteiras, com o tópico certo");
+
+    mqtt_rx_stats_t stats;
+    mqtt_rx_get_stats(&stats);
+    check(stats.messages == 500 && stats.dropped_auth == 0 && stats.dropped_incomplete == 0, "contadores sem descartes");
+}
+
+static void test_drops(void) {
+    mqtt_rx_init(&rx, handler, NULL);
+    uint8_t packet[MQTT_RX_BUFFER_BYTES + 64];
+    mqtt_rx_stats_t stats;
+
+    // Maior que o buffer: recusada no início, fragmentos ignorados, a seguinte é recebida
+    received = 0;
+    char big[MQTT_RX_BUFFER_BYTES];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    size_t big_len = seal(big, packet, sizeof(packet));
+    feed("t", packet, big_len, 50);
+    size_t len = seal("{\"valor\":1}", packet, sizeof(packet));
+    feed("t", packet, len, 5);
+    mqtt_rx_poll();
+    mqtt_rx_get_stats(&stats);
+    check(stats.dropped_too_large == 1 && received == 1 && strcmp(received_payload[0], "{\"valor\":1}") == 0, "mensagem grande demais descartada");
+
+    // Tópico longo demais
+    char topic[MQTT_RX_TOPIC_MAX + 1];
+    memset(topic, 'a', MQTT_RX_TOPIC_MAX);
+    topic[MQTT_RX_TOPIC_MAX] = '\0';
+    feed(topic, packet, len, 0);
+    mqtt_rx_get_stats(&stats);
+    check(stats.dropped_too_large == 2, "tópico longo demais descartado");
+
+    // Interrompida por outra publicação (conexão caiu no meio da anterior)
+    received = 0;
+    len = seal("{\"valor\":2}", packet, sizeof(packet));
+    mqtt_rx_begin("t", (uint32_t)len);
+    mqtt_rx_data(packet, 10, 0);
+    feed("t", packet, len, 3);
+    mqtt_rx_poll();
+    mqtt_rx_get_stats(&stats);
+    check(stats.dropped_incomplete == 1 && received == 1 && strcmp(received_payload[0], "{\"valor\":2}") == 0, "mensagem interrompida descartada");
+
+    // Último fragmento antes do tamanho anunciado
+    mqtt_rx_begin("t", (uint32_t)len + 4);
+    mqtt_rx_data(packet, (uint16_t)len, MQTT_RX_FLAG_LAST);
+    mqtt_rx_get_stats(&stats);
+    check(stats.dropped_incomplete == 2, "mensagem menor que a anunciada descartada");
+
+    // Mais bytes que o anunciado
+    mqtt_rx_begin("t", 8);
+    mqtt_rx_data(packet, 6, 0);
+    mqtt_rx_data(packet, 6, MQTT_RX_FLAG_LAST);
+    mqtt_rx_get_stats(&stats);
+    check(stats.dropped_incomplete == 3, "mensagem maior que a anunciada descartada");
+
+    // Alterada no caminho
+    received = 0;
+    len = seal("{\"valor\":3}", packet, sizeof(packet));
+    packet[PAYLOAD_HEADER_BYTES + 2] ^= 0x20;
+    feed("t", packet, len, 4);
+    mqtt_rx_poll();
+    mqtt_rx_get_stats(&stats);
+    check(stats.dropped_auth == 1 && received == 0, "mensagem alterada rejeitada");
+
+    // Nenhum buffer ficou preso pelos descartes: a fila inteira ainda está disponível
+    received = 0;
+    char text[16];
+    for (int i = 0; i < MQTT_RX_SLOTS + 1; i++) {
+        snprintf(text, sizeof(text), "msg %d", i);
+        len = seal(text, packet, sizeof(packet));
+        feed("t", packet, len, 7);
+    }
+    int delivered = mqtt_rx_poll();
+    mqtt_rx_get_stats(&stats);
+    check(delivered == MQTT_RX_SLOTS && stats.dropped_no_slot == 1, "fila cheia: a mensagem excedente é contada");
+    bool in_order = true;
+    for (int i = 0; i < MQTT_RX_SLOTS && i < MAX_RECEIVED; i++) {
+        snprintf(text, sizeof(text), "msg %d", i);
+        in_order &= strcmp(received_payload[i], text) == 0;
+    }
+    check(in_order, "mensagens entregues na ordem de chegada");
+}
+
+// Janela contra replay: fora de ordem passa, repetida não, e dois publishers não se atrapalham
+static void test_replay(void) {
+    static replay_table_t table;
+    replay_init(&table);
+    mqtt_rx_init(&rx, handler, NULL);
+    mqtt_rx_set_replay(&table);
+    received = 0;
+
+    uint8_t key[PAYLOAD_KEY_BYTES] = {9, 8, 7};
+    payload_ctx_t other;
+    payload_init(&other, PAYLOAD_CIPHER_CHACHA20_POLY1305, key, 0x5555, 0);
+    uint8_t a1[64], a2[64], b1[64];
+    size_t n1 = seal("a1", a1, sizeof(a1));
+    size_t n2 = seal("a2", a2, sizeof(a2));
+    memcpy(payload_plaintext(b1), "b1", 2);
+    size_t nb = payload_seal(&other, b1, 2, sizeof(b1));
+
+    feed("t", a2, n2, 0);
+    mqtt_rx_poll();
+    feed("t", b1, nb, 0); // Outro remetente com contador menor
+    mqtt_rx_poll();
+    feed("t", a1, n1, 0); // Fora de ordem (QoS 1)
+    mqtt_rx_poll();
+    feed("t", a2, n2, 0); // Repetida
+    mqtt_rx_poll();
+
+    mqtt_rx_stats_t stats;
+    mqtt_rx_get_stats(&stats);
+    check(received == 3 && stats.dropped_replay == 1, "replay descartado, fora de ordem e outro remetente aceitos");
+    check(strcmp(received_payload[1], "b1") == 0 && strcmp(received_payload[2], "a1") == 0, "ordem de entrega com replay");
+    mqtt_rx_set_replay(NULL);
+}
+
+static void test_plaintext(void) {
+    mqtt_rx_init(NULL, handler, NULL);
+    received = 0;
+    const char *text = "{\"valor\":26.5,\"ts\":7}";
+    feed("escola/sala1/temperatura", (const uint8_t *)text, strlen(text), 4);
+    mqtt_rx_poll();
+    check(received == 1 && strcmp(received_payload[0], text) == 0, "payload em claro entregue terminado em '\\0'");
+}
+
+int main(void) {
+    uint8_t key[PAYLOAD_KEY_BYTES] = {9, 8, 7};
+    payload_init(&tx, PAYLOAD_CIPHER_CHACHA20_POLY1305, key, 0xabcdef01, 0);
+    payload_init(&rx, PAYLOAD_CIPHER_CHACHA20_POLY1305, key, 0, 0);
+    srand(42);
+
+    test_fragmented_sequences();
+    test_drops();
+    test_replay();
+    test_plaintext();
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,512 @@
+// Teste no computador (host) da fila de saída (src/outbox.c) com uma flash NOR simulada
+// A flash simulada só deixa gravar bits de 1 para 0, em páginas inteiras, e apaga setores inteiros; pode "faltar energia"
+// no meio de uma gravação (parte do registro gravada) ou de um apagamento (parte das páginas apagadas)
+// Casos fixos: envio na ordem (flash e depois RAM), intervalo entre envios e limite sem confirmação, confirmações fora de
+// ordem, erro e prazo esgotado, queda da conexão, recuperação depois de um reset, gravação interrompida e flash cheia.
+// Depois, uma sequência aleatória com quedas de energia: nenhuma mensagem gravada na flash se perde, a ordem se mantém
+// e o conteúdo chega íntegro
+//
+// Compilação e execução (a partir da pasta exercicios/Seguranca_em_IoT_com_BitDogLab):
+//   gcc -std=c11 -O1 -g -fsanitize=address,undefined -I. tests/teste_outbox.c src/outbox.c -o teste_outbox && ./teste_outbox
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/outbox.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FALHA: %s\n", what);
+        failures++;
+    }
+}
+
+// Flash NOR simulada: 8 setores de 4 KB, páginas de 256 bytes
+#define SECTOR 4096
+#define PAGE 256
+#define SECTORS 8
+
+static uint8_t flash_mem[SECTORS * SECTOR];
+static int flash_violations; // Gravação de 0 para 1, fora de página ou fora da região
+static int crash_countdown = -1; // Operações até a falta de energia (-1: nunca)
+static bool powered_off;
+static bool program_fails; // Próxima gravação falha sem gravar nada (ex.: tempo esgotado no flash_safe_execute)
+static int programs, erases;
+
+static bool sim_program(uint32_t offset, const uint8_t *data, size_t len, void *arg) {
+    if (powered_off) return false;
+    if (program_fails) {
+        program_fails = false;
+        return false;
+    }
+    if (offset % PAGE || len % PAGE || offset + len > sizeof(flash_mem)) {
+        flash_violations++;
+        return false;
+    }
+    size_t n = len;
+    bool crash = crash_countdown == 0;
+    if (crash) {
+        n = (size_t)(rand() % (int)len); // Só o começo foi gravado
+        powered_off = true;
+    }
+    if (crash_countdown >= 0) crash_countdown--;
+    for (size_t i = 0; i < n; i++) {
+        if ((flash_mem[offset + i] & data[i]) != data[i]) flash_violations++;
+        flash_mem[offset + i] &= data[i];
+    }
+    programs++;
+    return !crash;
+}
+
+static bool sim_erase(uint32_t offset, void *arg) {
+    if (powered_off) return false;
+    if (offset % SECTOR || offset >= sizeof(flash_mem)) {
+        flash_violations++;
+        return false;
+    }
+    bool crash = crash_countdown == 0;
+    if (crash_countdown >= 0) crash_countdown--;
+    for (uint32_t page = 0; page < SECTOR / PAGE; page++) {
+        if (!crash || rand() % 2) memset(flash_mem + offset + page * PAGE, 0xFF, PAGE); // Na falta de energia, só algumas páginas
+    }
+    erases++;
+    if (crash) powered_off = true;
+    return !crash;
+}
+
+static const outbox_flash_t flash = {
+    .base = flash_mem,
+    .size = sizeof(flash_mem),
+    .sector_size = SECTOR,
+    .page_size = PAGE,
+    .program = sim_program,
+    .erase = sim_erase,
+};
+
+// Cliente MQTT simulado: guarda o que foi enviado e ainda não confirmado
+typedef struct {
+    uint32_t token;
+    char topic[OUTBOX_TOPIC_MAX + 1];
+    uint8_t data[OUTBOX_PAYLOAD_MAX];
+    size_t len;
+    uint8_t qos;
+} wire_msg_t;
+
+static wire_msg_t wire[64];
+static int wire_count;
+static bool wire_refuse;
+
+static bool sim_publish(const char *topic, const uint8_t *data, size_t len, uint8_t qos, uint32_t token, void *arg) {
+    if (wire_refuse || wire_count == 64) return false;
+    wire_msg_t *m = &wire[wire_count++];
+    m->token = token;
+    snprintf(m->topic, sizeof(m->topic), "%s", topic);
+    memcpy(m->data, data, len);
+    m->len = len;
+    m->qos = qos;
+    return true;
+}
+
+static outbox_t ob;
+static uint32_t now;
+static const outbox_config_t fast = {.drain_interval_ms = 0, .max_inflight = 4, .ack_timeout_ms = 30000};
+
+static void reset_flash(void) {
+    memset(flash_mem, 0xFF, sizeof(flash_mem));
+    flash_violations = 0;
+    crash_countdown = -1;
+    powered_off = false;
+    program_fails = false;
+    programs = erases = 0;
+}
+
+static void boot(const outbox_config_t *config) {
+    wire_count = 0;
+    wire_refuse = false;
+    powered_off = false;
+    crash_countdown = -1;
+    outbox_init(&ob, config, &flash, sim_publish, NULL);
+}
+
+// Payload derivado do número da mensagem (nos 2 primeiros bytes): tamanho e conteúdo conferíveis na chegada
+static size_t make_payload(uint32_t n, uint8_t *out) {
+    size_t len = 2 + (n * 37) % (OUTBOX_PAYLOAD_MAX - 1);
+    for (size_t i = 0; i < len; i++) out[i] = (uint8_t)(n * 131 + i * 7);
+    out[0] = (uint8_t)n;
+    out[1] = (uint8_t)(n >> 8);
+    return len;
+}
+
+// Número da mensagem no payload recebido (-1 se o conteúdo não confere)
+static int64_t payload_number(const uint8_t *data, size_t len) {
+    if (len < 2) return -1;
+    uint32_t n = data[0] | (uint32_t)data[1] << 8;
+    uint8_t expected[OUTBOX_PAYLOAD_MAX];
+    size_t elen = make_payload(n, expected);
+    return elen == len && memcmp(expected, data, len) == 0 ? (int64_t)n : -1;
+}
+
+static void push_n(uint32_t n) {
+    uint8_t payload[OUTBOX_PAYLOAD_MAX];
+    size_t len = make_payload(n, payload);
+    check(outbox_push(&ob, n % 2 ? "escola/sala1/temperatura" : "escola/sala2/umidade", payload, len, 1), "push");
+}
+
+// Confirma as mensagens do fio (todas ou só a primeira)
+static void ack_wire(int count, bool ok) {
+    for (int i = 0; i < count && i < wire_count; i++) outbox_event_ack(&ob, wire[i].token, ok);
+    memmove(wire, wire + count, (size_t)(wire_count - count) * sizeof(wire[0]));
+    wire_count -= count;
+}
+
+static outbox_stats_t stats(void) {
+    outbox_stats_t s;
+    outbox_get_stats(&ob, &s);
+    return s;
+}
+
+// Esvazia a fila com a conexão de pé, conferindo a ordem e o conteúdo; devolve quantas chegaram
+static int drain_all(uint32_t first) {
+    int delivered = 0;
+    int64_t expected = first;
+    bool ordered = true;
+    for (int round = 0; round < 1000 && (stats().ram_depth + stats().flash_depth) > 0; round++) {
+        now += 10;
+        outbox_poll(&ob, now, true);
+        for (int i = 0; i < wire_count; i++) {
+            int64_t n = payload_number(wire[i].data, wire[i].len);
+            ordered &= n == expected;
+            expected = n + 1;
+            delivered++;
+        }
+        ack_wire(wire_count, true);
+    }
+    now += 10;
+    outbox_poll(&ob, now, true);
+    check(ordered, "ordem e conteudo na entrega");
+    return delivered;
+}
+
+static void test_online(void) {
+    reset_flash();
+    boot(&fast);
+    for (uint32_t i = 0; i < 3; i++) push_n(i);
+    outbox_poll(&ob, now, true);
+    check(wire_count == 3 && wire[0].qos == 1 && strcmp(wire[1].topic, "escola/sala1/temperatura") == 0, "envio direto");
+    check(stats().inflight == 3 && stats().ram_depth == 3, "aguardando PUBACK");
+    ack_wire(3, true);
+    outbox_poll(&ob, now, true);
+    check(stats().ram_depth == 0 && stats().acked == 3 && programs == 0, "confirmadas sem tocar na flash");
+
+    uint8_t big[OUTBOX_PAYLOAD_MAX + 1] = {0};
+    check(!outbox_push(&ob, "t", big, sizeof(big), 0) && stats().dropped == 1, "grande demais");
+}
+
+// 20 mensagens sem conexão: 8 na RAM, 12 na flash; saem na ordem, no ritmo configurado
+static void test_spill_and_rate(void) {
+    reset_flash();
+    const outbox_config_t slow = {.drain_interval_ms = 100, .max_inflight = 3, .ack_timeout_ms = 30000};
+    boot(&slow);
+    for (uint32_t i = 0; i < 20; i++) push_n(i);
+    outbox_poll(&ob, now, false);
+    outbox_stats_t s = stats();
+    check(s.ram_depth == OUTBOX_RAM_SLOTS && s.flash_depth == 12 && s.spilled == 12 && wire_count == 0, "transbordou para a flash");
+    check(s.flash_peak == 12 && s.ram_peak == OUTBOX_RAM_SLOTS && s.flash_free_bytes < SECTORS * SECTOR, "profundidade");
+
+    outbox_poll(&ob, now, true);
+    check(wire_count == 1, "um envio por intervalo");
+    now += 50;
+    outbox_poll(&ob, now, true);
+    check(wire_count == 1, "espera o intervalo");
+    for (int i = 0; i < 5; i++) {
+        now += 100;
+        outbox_poll(&ob, now, true);
+    }
+    check(wire_count == 3 && stats().inflight == 3, "limite sem confirmacao");
+
+    // Daqui em diante, com confirmações: tudo chega na ordem (flash e depois RAM)
+    int before = wire_count;
+    int64_t first = payload_number(wire[0].data, wire[0].len);
+    check(first == 0, "comeca pela mais antiga");
+    int64_t expected = 0;
+    bool ordered = true;
+    int delivered = 0;
+    for (int round = 0; round < 200 && (stats().ram_depth + stats().flash_depth) > 0; round++) {
+        for (int i = 0; i < wire_count; i++) {
+            int64_t n = payload_number(wire[i].data, wire[i].len);
+            ordered &= n == expected;
+            expected = n + 1;
+            delivered++;
+        }
+        ack_wire(wire_count, true);
+        now += 100;
+        outbox_poll(&ob, now, true);
+    }
+    check(ordered && delivered == 20 && before == 3, "ordem flash e depois RAM");
+    check(stats().acked == 20 && stats().flash_depth == 0, "fila vazia");
+
+    // A remoção foi gravada: depois de um reset não há nada pendente
+    boot(&fast);
+    check(stats().flash_depth == 0 && stats().recovered == 0, "nada pendente depois do reset");
+    check(flash_violations == 0, "gravacoes validas na flash");
+}
+
+static void test_acks(void) {
+    reset_flash();
+    boot(&fast);
+    for (uint32_t i = 0; i < 12; i++) push_n(i); // 4 na flash
+    outbox_poll(&ob, now, true);
+    check(wire_count == 4, "quatro aguardando");
+
+    // Fora de ordem: a terceira confirmada antes não tira nada da fila
+    outbox_event_ack(&ob, wire[2].token, true);
+    outbox_poll(&ob, now, true);
+    check(stats().acked == 0 && stats().inflight == 4, "espera a primeira");
+    outbox_event_ack(&ob, wire[0].token, true);
+    outbox_event_ack(&ob, wire[1].token, true);
+    outbox_poll(&ob, now, true);
+    check(stats().acked == 3 && stats().flash_depth == 1 && stats().inflight == 4 && wire_count == 7, "tres confirmadas e o limite completo");
+    uint32_t fourth = wire[3].token, fifth = wire[4].token;
+    wire_count = 0;
+
+    // Erro na quarta: reenvia a partir dela
+    outbox_event_ack(&ob, fourth, false);
+    outbox_poll(&ob, now, true);
+    check(stats().rewinds == 1 && wire_count == 4 && wire[0].token == fourth, "reenvio depois de erro");
+    outbox_event_ack(&ob, fifth, true); // Confirmação atrasada da quinta: mesmo token (mesma mensagem), vale
+    outbox_event_ack(&ob, 0xdeadbeef, true); // Token desconhecido
+    outbox_poll(&ob, now, true);
+    check(stats().acked == 3 && stats().inflight == 4, "confirmacao sem a anterior nao anda");
+
+    // Prazo esgotado
+    wire_count = 0;
+    now += 30000;
+    outbox_poll(&ob, now, true);
+    check(stats().rewinds == 2 && wire_count == 4 && wire[0].token == fourth, "reenvio por prazo");
+
+    // Queda da conexão
+    wire_count = 0;
+    outbox_poll(&ob, now, false);
+    check(stats().inflight == 0 && stats().rewinds == 3, "queda descarta o que aguardava");
+    wire_refuse = true; // Cliente sem espaço
+    outbox_poll(&ob, now, true);
+    check(stats().inflight == 0 && stats().sent == 4 + 3 + 4 + 4, "cliente recusou");
+    wire_refuse = false;
+    check(drain_all(3) == 9, "restantes entregues");
+
+    // Fila de eventos cheia: as confirmações a mais se perdem e o prazo reenvia
+    for (int i = 0; i < OUTBOX_EVENTS + 2; i++) outbox_event_ack(&ob, 1000 + (uint32_t)i, true);
+    check(ob.stats.events_lost == 2, "eventos perdidos");
+    outbox_poll(&ob, now, true);
+}
+
+// Reset com mensagens na flash: voltam para a fila, na ordem, com a confirmação gravada valendo
+static void test_recovery(void) {
+    reset_flash();
+    boot(&fast);
+    for (uint32_t i = 0; i < 30; i++) push_n(i);
+    check(outbox_spill(&ob) && stats().flash_depth == 30 && stats().ram_depth == 0, "tudo na flash");
+
+    boot(&fast);
+    check(stats().recovered == 30 && stats().torn == 0, "30 recuperadas");
+
+    // Confirma 10 (grava a remoção depois de 8) e reinicia
+    for (int round = 0; round < 5; round++) {
+        outbox_poll(&ob, now, true);
+        int n = wire_count < 2 ? wire_count : 2;
+        ack_wire(n, true);
+        outbox_poll(&ob, now, true);
+    }
+    check(stats().acked == 10, "dez confirmadas");
+    boot(&fast);
+    check(stats().recovered == 22, "remocao gravada a cada 8");
+    check(drain_all(8) == 22, "reenvia a partir da ultima remocao gravada");
+
+    // Mensagens novas continuam a numeração: nada se confunde com as antigas
+    push_n(100);
+    check(drain_all(100) == 1, "mensagem nova depois do reset");
+    check(flash_violations == 0, "gravacoes validas na flash");
+}
+
+// Falta de energia no meio de uma gravação
+static void test_torn_write(void) {
+    reset_flash();
+    boot(&fast);
+    for (uint32_t i = 0; i < 5; i++) push_n(i);
+    outbox_spill(&ob);
+    srand(3);
+    crash_countdown = 0;
+    push_n(5);
+    outbox_spill(&ob);
+    check(powered_off, "faltou energia");
+
+    boot(&fast);
+    check(stats().recovered == 5 && stats().torn == 1, "registro interrompido ignorado");
+    for (uint32_t i = 6; i < 9; i++) push_n(i);
+    outbox_spill(&ob);
+    check(ob.head.sector == 0 && ob.head.offset > 5 * PAGE + OUTBOX_RECORD_MAX, "escrita continua depois do espaco pulado");
+
+    // Falha sem queda de energia: o começo do registro é zerado e a mensagem fica na RAM para a próxima tentativa
+    program_fails = true;
+    push_n(9);
+    check(!outbox_spill(&ob) && stats().ram_depth == 1 && stats().flash_errors == 1, "falha na gravacao");
+    check(outbox_spill(&ob) && ob.head.sector == 0, "nova tentativa no mesmo setor");
+    boot(&fast);
+    check(stats().recovered == 9 && stats().torn == 2, "novas depois dos registros interrompidos");
+    int64_t expected[] = {0, 1, 2, 3, 4, 6, 7, 8, 9};
+    bool ordered = true;
+    int got = 0;
+    for (int round = 0; round < 100 && stats().flash_depth > 0; round++) {
+        outbox_poll(&ob, now, true);
+        for (int i = 0; i < wire_count; i++) {
+            ordered &= got < 9 && payload_number(wire[i].data, wire[i].len) == expected[got];
+            got++;
+        }
+        ack_wire(wire_count, true);
+    }
+    check(ordered && got == 9, "ordem com o registro perdido");
+    check(flash_violations == 0, "gravacoes validas na flash");
+}
+
+// Flash cheia: o setor mais antigo é reaproveitado e as mensagens pendentes dele são contadas
+static void test_full(void) {
+    reset_flash();
+    boot(&fast);
+    for (uint32_t i = 0; i < 300; i++) {
+        push_n(i);
+    }
+    outbox_spill(&ob);
+    outbox_stats_t s = stats();
+    check(s.dropped > 0 && s.flash_depth + s.dropped == 300, "descartadas contadas");
+    check(s.erases > 0 && flash_violations == 0, "setores reaproveitados");
+    uint32_t first = 300 - s.flash_depth;
+    boot(&fast);
+    check(stats().recovered == s.flash_depth, "recupera as restantes");
+    check(drain_all(first) == (int)s.flash_depth, "restantes na ordem");
+}
+
+/**
+ * Sequência aleatória com quedas de energia
+ *
+ * Verifica:
+ * - Conteúdo íntegro e, a cada primeira entrega, número maior que o da entrega anterior (ordem)
+ * - Toda mensagem que não estava só na RAM numa queda de energia é entregue (na flash, nada se perde)
+ * - Nenhuma gravação inválida na flash
+ */
+#define RANDOM_MESSAGES 3000
+static bool delivered[RANDOM_MESSAGES];
+static bool maybe_lost[RANDOM_MESSAGES];
+
+static void test_random_crashes(void) {
+    reset_flash();
+    srand(11);
+    boot(&fast);
+    memset(delivered, 0, sizeof(delivered));
+    memset(maybe_lost, 0, sizeof(maybe_lost));
+    uint32_t next = 0;
+    int64_t last_first = -1;
+    bool ordered = true, intact = true;
+    int crashes = 0;
+    bool online = false;
+
+    while (next < RANDOM_MESSAGES) {
+        // Mensagens na RAM antes da operação
+        int snapshot_count = 0;
+        uint32_t snapshot[OUTBOX_RAM_SLOTS];
+        for (int i = 0; i < ob.ram_count; i++) {
+            const outbox_slot_t *slot = &ob.ram[(ob.ram_head + i) % OUTBOX_RAM_SLOTS];
+            snapshot[snapshot_count++] = (uint32_t)payload_number(slot->data, slot->len);
+        }
+
+        int op = rand() % 10;
+        if (op < 4) {
+            outbox_stats_t s = stats();
+            if (s.ram_depth + s.flash_depth < 40) push_n(next++);
+        } else if (op < 7) {
+            now += (uint32_t)(rand() % 50);
+            outbox_poll(&ob, now, online);
+        } else if (op == 7) {
+            // Broker confirma a primeira do fio; raramente com erro, e aí o resto do fio também se perdeu
+            if (wire_count > 0 && online) {
+                int64_t n = payload_number(wire[0].data, wire[0].len);
+                intact &= n >= 0;
+                bool ok = rand() % 20 != 0;
+                if (ok && n >= 0 && !delivered[n]) {
+                    ordered &= n > last_first;
+                    last_first = n;
+                    delivered[n] = true;
+                }
+                outbox_event_ack(&ob, wire[0].token, ok);
+                memmove(wire, wire + 1, (size_t)(wire_count - 1) * sizeof(wire[0]));
+                wire_count = ok ? wire_count - 1 : 0;
+            }
+        } else if (op == 8) {
+            online = rand() % 4 != 0;
+            if (!online) {
+                // Queda da conexão: o que estava no fio se perde, e o laço principal vê a queda antes de reconectar
+                wire_count = 0;
+                outbox_poll(&ob, now, false);
+            }
+        } else if (rand() % 8 == 0 && crash_countdown < 0) {
+            crash_countdown = rand() % 6;
+        }
+
+        if (powered_off) {
+            // Reset: o que estava só na RAM, antes ou depois da operação, pode ter se perdido (inclusive a que caiu ao passar para a flash)
+            for (int i = 0; i < snapshot_count; i++) maybe_lost[snapshot[i]] = true;
+            for (int i = 0; i < ob.ram_count; i++) {
+                const outbox_slot_t *slot = &ob.ram[(ob.ram_head + i) % OUTBOX_RAM_SLOTS];
+                maybe_lost[payload_number(slot->data, slot->len)] = true;
+            }
+            crashes++;
+            boot(&fast);
+            online = false;
+            wire_count = 0; // A conexão TCP cai junto: confirmações da sessão anterior não chegam mais
+        }
+    }
+
+    // Sem mais quedas: tudo o que ficou sai
+    crash_countdown = -1;
+    for (int round = 0; round < 5000 && (stats().ram_depth + stats().flash_depth) > 0; round++) {
+        now += 10;
+        outbox_poll(&ob, now, true);
+        for (int i = 0; i < wire_count; i++) {
+            int64_t n = payload_number(wire[i].data, wire[i].len);
+            intact &= n >= 0;
+            if (n >= 0 && !delivered[n]) {
+                ordered &= n > last_first;
+                last_first = n;
+                delivered[n] = true;
+            }
+        }
+        ack_wire(wire_count, true);
+    }
+
+    int lost = 0, missing = 0;
+    for (uint32_t n = 0; n < RANDOM_MESSAGES; n++) {
+        if (!delivered[n]) {
+            if (maybe_lost[n]) lost++;
+            else missing++;
+        }
+    }
+    check(crashes > 20, "quedas de energia suficientes");
+    check(intact, "conteudo integro");
+    check(ordered, "ordem das primeiras entregas");
+    check(missing == 0, "nada gravado na flash se perde");
+    check(flash_violations == 0, "gravacoes validas na flash");
+    printf("aleatorio: %d mensagens, %d quedas de energia, %d perdidas da RAM, %d apagamentos\n", RANDOM_MESSAGES, crashes, lost, erases);
+}
+
+int main(void) {
+    test_online();
+    test_spill_and_rate();
+    test_acks();
+    test_recovery();
+    test_torn_write();
+    test_full();
+    test_random_crashes();
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,228 @@
+// Teste no computador (host) da janela contra replay por remetente (src/replay.c)
+// Casos fixos: mensagens fora de ordem, repetidas, antigas demais, saltos maiores que a janela, contador no limite,
+// remetentes intercalados, substituição do remetente usado há mais tempo com a tabela cheia (nunca de um recente) e a
+// reprodução de uma gravação inteira depois que o remetente sai da tabela ou o subscriber reinicia. Depois, sequências aleatórias
+// comparadas com um modelo simples (conjunto de contadores aceitos por remetente, lista de remetentes em ordem de uso),
+// com muito mais remetentes que lugares na tabela (colisões e remoções no meio das sequências de sondagem)
+//
+// Compilação e execução (a partir da pasta exercicios/Seguranca_em_IoT_com_BitDogLab):
+//   gcc -std=c11 -O1 -g -fsanitize=address,undefined -I. tests/teste_replay.c src/replay.c -o teste_replay && ./teste_replay
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/replay.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FALHA: %s\n", what);
+        failures++;
+    }
+}
+
+static replay_table_t table;
+
+static void test_window(void) {
+    replay_init(&table);
+    check(replay_check(&table, 1, 100) == REPLAY_ACCEPTED, "primeira mensagem");
+    check(replay_check(&table, 1, 100) == REPLAY_DUPLICATE, "repetida");
+    check(replay_check(&table, 1, 103) == REPLAY_ACCEPTED, "salto para frente");
+    check(replay_check(&table, 1, 101) == REPLAY_ACCEPTED && replay_check(&table, 1, 102) == REPLAY_ACCEPTED, "fora de ordem");
+    check(replay_check(&table, 1, 101) == REPLAY_DUPLICATE && replay_check(&table, 1, 103) == REPLAY_DUPLICATE, "repetidas fora de ordem");
+
+    // Borda da janela: top - 63 ainda entra, top - 64 não
+    check(replay_check(&table, 1, 200) == REPLAY_ACCEPTED, "avanca a janela");
+    check(replay_check(&table, 1, 200 - 63) == REPLAY_ACCEPTED, "ultima posicao da janela");
+    check(replay_check(&table, 1, 200 - 64) == REPLAY_TOO_OLD, "abaixo da janela");
+    check(replay_check(&table, 1, 103) == REPLAY_TOO_OLD, "antiga ja aceita");
+
+    // Salto maior que a janela limpa o mapa
+    check(replay_check(&table, 1, 1000) == REPLAY_ACCEPTED, "salto maior que a janela");
+    check(replay_check(&table, 1, 999) == REPLAY_ACCEPTED && replay_check(&table, 1, 937) == REPLAY_ACCEPTED, "mapa limpo depois do salto");
+    check(replay_check(&table, 1, 936) == REPLAY_TOO_OLD, "abaixo da janela depois do salto");
+
+    // Contador no limite de 64 bits (sem estouro no deslocamento)
+    check(replay_check(&table, 2, UINT64_MAX - 1) == REPLAY_ACCEPTED, "perto do limite");
+    check(replay_check(&table, 2, UINT64_MAX) == REPLAY_ACCEPTED && replay_check(&table, 2, UINT64_MAX) == REPLAY_DUPLICATE, "no limite");
+    check(replay_check(&table, 2, 0) == REPLAY_TOO_OLD, "zero bem abaixo da janela");
+
+    // Começar no zero
+    check(replay_check(&table, 3, 0) == REPLAY_ACCEPTED && replay_check(&table, 3, 0) == REPLAY_DUPLICATE, "contador zero");
+
+    check(table.stats.accepted == 12 && table.stats.duplicates == 5 && table.stats.too_old == 4, "contadores");
+}
+
+// Dois publishers intercalados: com o timestamp global, um rejeitava o outro
+static void test_interleaved(void) {
+    replay_init(&table);
+    bool all = true;
+    for (uint64_t i = 0; i < 500; i++) {
+        all &= replay_check(&table, 0xaaaa0001, 1000 + i) == REPLAY_ACCEPTED;
+        all &= replay_check(&table, 0xbbbb0002, i) == REPLAY_ACCEPTED;
+    }
+    check(all && table.senders == 2, "remetentes intercalados");
+    check(replay_check(&table, 0xaaaa0001, 1499) == REPLAY_DUPLICATE && replay_check(&table, 0xbbbb0002, 499) == REPLAY_DUPLICATE, "janelas separadas");
+}
+
+static void test_eviction(void) {
+    replay_init(&table);
+    for (uint32_t s = 1; s <= REPLAY_MAX_SENDERS; s++) {
+        replay_check(&table, s, 10);
+    }
+    check(table.senders == REPLAY_MAX_SENDERS && table.stats.evictions == 0, "tabela cheia");
+
+    // Todos recentes: o remetente novo é recusado e ninguém sai
+    check(replay_check(&table, 100, 5) == REPLAY_TABLE_FULL && table.stats.table_full == 1, "tabela cheia de recentes");
+    check(table.stats.evictions == 0 && replay_check(&table, 2, 10) == REPLAY_DUPLICATE, "recente nao substituido");
+
+    // O remetente 1 continua publicando; o 2 passa a ser o usado há mais tempo e, velho o bastante, sai quando chega um novo
+    for (uint64_t i = 0; i < REPLAY_RECENT; i++) {
+        replay_check(&table, 1, 11 + i);
+    }
+    check(replay_check(&table, 100, 5) == REPLAY_ACCEPTED, "remetente novo depois de envelhecer");
+    check(table.stats.evictions == 1 && table.senders == REPLAY_MAX_SENDERS, "substituicao");
+    check(replay_check(&table, 1, 11 + REPLAY_RECENT - 1) == REPLAY_DUPLICATE, "remetente recente continua");
+    check(replay_check(&table, 3, 10) == REPLAY_DUPLICATE, "outro remetente continua");
+    // O 2 foi esquecido: a mesma mensagem volta a ser aceita (limite documentado) e tira outro da tabela
+    check(replay_check(&table, 2, 10) == REPLAY_ACCEPTED && table.stats.evictions == 2, "remetente substituido e esquecido");
+
+    check(replay_forget(&table, 100) && !replay_forget(&table, 100), "remocao explicita");
+    check(replay_check(&table, 100, 5) == REPLAY_ACCEPTED, "remetente removido volta como novo");
+}
+
+// Uma gravação das mensagens de um remetente, reenviada na mesma ordem
+#define STREAM 100
+
+static int replay_stream(uint32_t sender) {
+    int accepted = 0;
+    for (uint64_t i = 0; i < STREAM; i++) {
+        accepted += replay_check(&table, sender, 1000 + i) == REPLAY_ACCEPTED;
+    }
+    return accepted;
+}
+
+static void test_stream_replay(void) {
+    // Com o remetente na tabela, nada da gravação passa
+    replay_init(&table);
+    check(replay_stream(7) == STREAM, "gravacao original");
+    check(replay_stream(7) == 0, "gravacao rejeitada com o remetente na tabela");
+
+    // Depois de o subscriber reiniciar, a gravação inteira passa de novo (limite documentado em replay.h)
+    replay_init(&table);
+    check(replay_stream(7) == STREAM, "gravacao inteira aceita depois de reiniciar");
+
+    // Idem depois de o remetente sair da tabela: outros ocupam a tabela e o 7 fica sem publicar
+    for (uint32_t s = 1; s < REPLAY_MAX_SENDERS; s++) {
+        replay_check(&table, 100 + s, 0);
+    }
+    for (uint64_t i = 1; i <= REPLAY_RECENT; i++) {
+        replay_check(&table, 101, i);
+    }
+    check(replay_check(&table, 200, 0) == REPLAY_ACCEPTED && table.stats.evictions == 1, "remetente da gravacao substituido");
+    check(replay_stream(7) == STREAM, "gravacao inteira aceita depois de sair da tabela");
+
+    // Uma gravação antiga não tira da tabela um publisher que publicou há pouco: com a tabela cheia de recentes, é recusada
+    replay_init(&table);
+    for (uint32_t s = 1; s <= REPLAY_MAX_SENDERS; s++) {
+        replay_check(&table, 100 + s, 0);
+    }
+    check(replay_stream(7) == 0 && table.stats.table_full == STREAM, "gravacao antiga recusada com a tabela cheia de recentes");
+    check(replay_check(&table, 101, 1) == REPLAY_ACCEPTED && replay_check(&table, 101, 0) == REPLAY_DUPLICATE, "publisher continua na tabela");
+}
+
+// Modelo de referência: contadores aceitos (até 64 abaixo do maior) e ordem de uso por remetente
+#define MODEL_SENDERS 64
+typedef struct {
+    bool present;
+    uint64_t top;
+    uint64_t seen[REPLAY_WINDOW]; // Contadores aceitos dentro da janela
+    int seen_count;
+    uint32_t last_used;
+} model_sender_t;
+
+static model_sender_t model[MODEL_SENDERS];
+static uint32_t model_clock;
+
+static replay_result_t model_check(uint32_t s, uint64_t counter) {
+    model_sender_t *m = &model[s];
+    model_clock++;
+    if (!m->present) {
+        int present = 0, oldest = -1;
+        for (int i = 0; i < MODEL_SENDERS; i++) {
+            if (model[i].present) {
+                present++;
+                if (oldest < 0 || model_clock - model[i].last_used > model_clock - model[oldest].last_used) oldest = i;
+            }
+        }
+        if (present >= REPLAY_MAX_SENDERS) {
+            if (model_clock - model[oldest].last_used < REPLAY_RECENT) return REPLAY_TABLE_FULL;
+            model[oldest].present = false;
+        }
+        *m = (model_sender_t){.present = true, .top = counter, .seen = {counter}, .seen_count = 1, .last_used = model_clock};
+        return REPLAY_ACCEPTED;
+    }
+    if (counter + REPLAY_WINDOW <= m->top) return REPLAY_TOO_OLD;
+    for (int i = 0; i < m->seen_count; i++) {
+        if (m->seen[i] == counter) return REPLAY_DUPLICATE;
+    }
+    if (counter > m->top) m->top = counter;
+    int kept = 0; // Guarda só o que ainda está na janela
+    for (int i = 0; i < m->seen_count; i++) {
+        if (m->seen[i] + REPLAY_WINDOW > m->top) m->seen[kept++] = m->seen[i];
+    }
+    m->seen[kept++] = counter;
+    m->seen_count = kept;
+    m->last_used = model_clock;
+    return REPLAY_ACCEPTED;
+}
+
+// 64 remetentes se revezando em 12 lugares de 16 posições: colisões e remoções no meio das sequências de sondagem o tempo todo
+static uint32_t sender_ids[MODEL_SENDERS];
+
+static void test_against_model(void) {
+    srand(5);
+    replay_init(&table);
+    memset(model, 0, sizeof(model));
+    model_clock = 0;
+    for (int i = 0; i < MODEL_SENDERS; i++) {
+        sender_ids[i] = 0x9e370000u + (uint32_t)i * 7919u;
+    }
+    uint64_t next[MODEL_SENDERS] = {0};
+
+    bool same = true;
+    for (int step = 0; step < 500000 && same; step++) {
+        int s = rand() % (step % 2 ? 6 : MODEL_SENDERS); // Alguns remetentes frequentes, muitos raros
+        uint64_t counter;
+        switch (rand() % 4) {
+        case 0: counter = next[s]++; break; // Em ordem
+        case 1: counter = next[s] > 70 ? next[s] - (uint64_t)(rand() % 70) : 0; break; // Atrasada ou repetida
+        case 2: next[s] += (uint64_t)(rand() % 100); counter = next[s]; break; // Salto
+        default: counter = next[s] + (uint64_t)(rand() % 8); break; // Um pouco adiantada
+        }
+        replay_result_t expected = model_check((uint32_t)s, counter);
+        replay_result_t got = replay_check(&table, sender_ids[s], counter);
+        if (got != expected) {
+            printf("passo %d: remetente %d contador %llu: %s, esperado %s\n", step, s, (unsigned long long)counter,
+                   replay_result_name(got), replay_result_name(expected));
+            same = false;
+        }
+    }
+    check(same, "igual ao modelo");
+
+    int present = 0;
+    for (int i = 0; i < MODEL_SENDERS; i++) present += model[i].present;
+    check((int)table.senders == present, "mesmo numero de remetentes");
+    check(table.stats.evictions > 0 && table.stats.table_full > 0, "substituicoes e recusas com a tabela cheia");
+}
+
+int main(void) {
+    test_window();
+    test_interleaved();
+    test_eviction();
+    test_stream_replay();
+    test_against_model();
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
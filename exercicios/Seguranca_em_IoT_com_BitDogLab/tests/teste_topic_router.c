@@ -0,0 +1,202 @@
+// Teste no computador (host) do roteador de tópicos (src/topic_router.c)
+// Casos fixos: filtros inválidos, nível exato, "+" e "#" (inclusive "a/#" casando com "a"), níveis vazios, tópicos com
+// '$', vários filtros para a mesma mensagem, troca de tratador e os limites de nós e de tratadores. Depois, filtros e
+// tópicos aleatórios comparados com uma comparação direta, nível a nível, de cada filtro com o tópico
+//
+// Compilação e execução (a partir da pasta exercicios/Seguranca_em_IoT_com_BitDogLab):
+//   gcc -std=c11 -O1 -g -fsanitize=address,undefined -I. tests/teste_topic_router.c src/topic_router.c -o teste_topic_router && ./teste_topic_router
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/topic_router.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FALHA: %s\n", what);
+        failures++;
+    }
+}
+
+static topic_router_t router;
+
+// Cada tratador marca o seu bit (o arg é o número do filtro)
+static uint32_t called;
+static int call_count;
+static char last_payload[32];
+
+static void handler(const char *topic, char *payload, size_t len, void *arg) {
+    called |= 1u << (uintptr_t)arg;
+    call_count++;
+    snprintf(last_payload, sizeof(last_payload), "%.*s", (int)len, payload);
+}
+
+static void other_handler(const char *topic, char *payload, size_t len, void *arg) {
+    called |= 1u << 31;
+    call_count++;
+}
+
+static uint32_t deliver(const char *topic) {
+    called = 0;
+    call_count = 0;
+    char payload[] = "26.5";
+    int calls = topic_router_dispatch(&router, topic, payload, strlen(payload));
+    check(calls == call_count, "retorno igual as chamadas");
+    return called;
+}
+
+static bool add(const char *filter, uintptr_t n) {
+    return topic_router_add(&router, filter, handler, (void *)n);
+}
+
+static void test_filters(void) {
+    check(topic_filter_valid("a/b") && topic_filter_valid("+") && topic_filter_valid("#") && topic_filter_valid("a/+/c/#"), "filtros validos");
+    check(topic_filter_valid("/") && topic_filter_valid("a//b") && topic_filter_valid("+/+"), "niveis vazios");
+    check(!topic_filter_valid("") && !topic_filter_valid(NULL), "filtro vazio");
+    check(!topic_filter_valid("a+/b") && !topic_filter_valid("sala#") && !topic_filter_valid("a/#/b") && !topic_filter_valid("#/"), "curinga no meio do nivel ou # fora do fim");
+
+    topic_router_init(&router);
+    check(!add("a/#/b", 0) && router.node_count == 1, "filtro invalido nao altera a arvore");
+    check(!topic_router_add(&router, "a", NULL, NULL), "sem tratador");
+    char long_level[TOPIC_ROUTER_LEVEL_MAX + 1];
+    memset(long_level, 'x', TOPIC_ROUTER_LEVEL_MAX);
+    long_level[TOPIC_ROUTER_LEVEL_MAX] = '\0';
+    check(!add(long_level, 0) && add(long_level + 1, 0), "nivel longo demais");
+}
+
+static void test_matching(void) {
+    topic_router_init(&router);
+    check(add("escola/sala1/temperatura", 0), "exato");
+    check(add("escola/+/temperatura", 1), "mais");
+    check(add("escola/#", 2), "cerquilha");
+    check(add("bitdog1/comando/#", 3), "comando");
+    check(add("#", 4), "tudo");
+    check(add("+/+", 5), "dois niveis");
+    check(add("escola//x", 6), "nivel vazio");
+
+    check(deliver("escola/sala1/temperatura") == (1u << 0 | 1u << 1 | 1u << 2 | 1u << 4), "varios filtros na mesma mensagem");
+    check(strcmp(last_payload, "26.5") == 0, "payload entregue");
+    check(deliver("escola/sala2/temperatura") == (1u << 1 | 1u << 2 | 1u << 4), "mais casa um nivel");
+    check(deliver("escola/sala2/umidade") == (1u << 2 | 1u << 4), "so cerquilha");
+    check(deliver("escola") == (1u << 2 | 1u << 4), "a/# casa com a");
+    check(deliver("escola/sala1") == (1u << 2 | 1u << 4 | 1u << 5), "+/+");
+    check(deliver("escola/sala1/temperatura/extra") == (1u << 2 | 1u << 4), "mais nao casa niveis a mais");
+    check(deliver("bitdog1/comando") == (1u << 3 | 1u << 4 | 1u << 5), "comando sem subnivel");
+    check(deliver("bitdog1/comando/led/vermelho") == (1u << 3 | 1u << 4), "comando com subniveis");
+    check(deliver("escola//x") == (1u << 2 | 1u << 4 | 1u << 6), "nivel vazio no topico");
+    check(deliver("/") == (1u << 4 | 1u << 5), "topico so com niveis vazios");
+
+    check(deliver("$SYS/broker/uptime") == 0 && router.stats.unmatched == 1, "curinga nao casa com $");
+    check(deliver("sala/$x") == (1u << 4 | 1u << 5), "$ depois do primeiro nivel");
+
+    // Mesmo filtro de novo: troca o tratador, sem ocupar outro
+    uint8_t routes = router.route_count, nodes = router.node_count;
+    check(topic_router_add(&router, "escola/+/temperatura", other_handler, NULL) && router.route_count == routes && router.node_count == nodes, "troca de tratador");
+    check(deliver("escola/sala9/temperatura") == (1u << 31 | 1u << 2 | 1u << 4), "tratador novo");
+
+    check(router.stats.dispatched > 0 && router.stats.calls >= router.stats.dispatched, "contadores");
+
+    // '$' no primeiro nível só casa com filtro que comece com '$'
+    topic_router_init(&router);
+    check(add("#", 0) && add("+/+/uptime", 1) && add("$SYS/#", 2) && add("$SYS/+/uptime", 3), "filtros $SYS");
+    check(deliver("$SYS/broker/uptime") == (1u << 2 | 1u << 3), "$SYS so com filtro proprio");
+    check(deliver("sala/broker/uptime") == (1u << 0 | 1u << 1), "sem $");
+}
+
+static void test_limits(void) {
+    // Tratadores
+    topic_router_init(&router);
+    char filter[32];
+    for (int i = 0; i < TOPIC_ROUTER_ROUTES; i++) {
+        snprintf(filter, sizeof(filter), "t/%d", i);
+        check(add(filter, (uintptr_t)i), "cabe");
+    }
+    uint8_t nodes = router.node_count;
+    check(!add("outro/filtro", 0) && router.node_count == nodes, "tratadores esgotados sem criar nos");
+    check(add("t/3", 9), "troca com os tratadores esgotados");
+
+    // Nós
+    topic_router_init(&router);
+    check(add("a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p", 0), "profundidade maxima");
+    check(!add("a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q", 1), "profundidade demais");
+    check(deliver("a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p") == 1u, "topico na profundidade maxima");
+    check(deliver("a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q") == 0, "topico fundo demais");
+    int added = 0;
+    for (int i = 0; i < TOPIC_ROUTER_NODES; i++) {
+        snprintf(filter, sizeof(filter), "x%d/y", i);
+        if (add(filter, 2)) added++;
+    }
+    check(router.node_count <= TOPIC_ROUTER_NODES && added == (TOPIC_ROUTER_NODES - 17) / 2, "nos esgotados");
+    nodes = router.node_count;
+    check(!add("z/w", 3) && router.node_count == nodes, "sem nos nao altera");
+}
+
+// Comparação direta, nível a nível (a referência do teste aleatório)
+static bool reference_match(const char *filter, const char *topic) {
+    if (topic[0] == '$' && (filter[0] == '+' || filter[0] == '#')) return false;
+    const char *f = filter, *t = topic;
+    for (;;) {
+        size_t fl = strcspn(f, "/"), tl = strcspn(t, "/");
+        if (fl == 1 && f[0] == '#') return true;
+        if (!(fl == 1 && f[0] == '+') && (fl != tl || memcmp(f, t, fl) != 0)) return false;
+        bool f_end = f[fl] == '\0', t_end = t[tl] == '\0';
+        if (t_end) return f_end || strcmp(f + fl, "/#") == 0;
+        if (f_end) return false;
+        f += fl + 1;
+        t += tl + 1;
+    }
+}
+
+static void random_levels(char *out, size_t size, bool filter) {
+    static const char *names[] = {"a", "b", "sala", "", "$SYS"};
+    int count = 1 + rand() % 4;
+    out[0] = '\0';
+    for (int i = 0; i < count; i++) {
+        const char *name = names[rand() % 5];
+        if (filter && rand() % 4 == 0) name = "+";
+        if (filter && i == count - 1 && rand() % 4 == 0) name = "#";
+        if (i > 0) strncat(out, "/", size - strlen(out) - 1);
+        strncat(out, name, size - strlen(out) - 1);
+    }
+}
+
+static void test_random(void) {
+    srand(7);
+    int compared = 0, matches = 0;
+    for (int round = 0; round < 2000; round++) {
+        topic_router_init(&router);
+        char filters[TOPIC_ROUTER_ROUTES][40];
+        int n = 0;
+        for (int i = 0; i < TOPIC_ROUTER_ROUTES; i++) {
+            random_levels(filters[n], sizeof(filters[n]), true);
+            bool duplicate = false;
+            for (int j = 0; j < n; j++) duplicate |= strcmp(filters[j], filters[n]) == 0;
+            if (!duplicate && add(filters[n], (uintptr_t)n)) n++;
+        }
+        for (int k = 0; k < 20; k++) {
+            char topic[40];
+            random_levels(topic, sizeof(topic), false);
+            uint32_t expected = 0;
+            for (int j = 0; j < n; j++) {
+                if (reference_match(filters[j], topic)) expected |= 1u << j;
+            }
+            bool same = deliver(topic) == expected && call_count == __builtin_popcount(expected);
+            if (!same) printf("  topico '%s' casou diferente\n", topic);
+            check(same, "igual a comparacao direta");
+            compared++;
+            matches += call_count;
+        }
+    }
+    printf("aleatorio: %d topicos, %d entregas\n", compared, matches);
+}
+
+int main(void) {
+    test_filters();
+    test_matching();
+    test_limits();
+    test_random();
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,17 @@
+// Arquivo gerado por tools/bitmap_rle.py a partir de assets/Galton_Board_Bitmap_128_64.png - não edite manualmente
+// 128x64 pixels: 1024 bytes sem compressão, 90 bytes em RLE
+#ifndef GALTON_BOARD_RLE_H
+#define GALTON_BOARD_RLE_H
+
+#include <stdint.h>
+
+static const uint8_t galton_board_rle[90] = {
+    0x80, 0x40, 0xBC, 0x00, 0x00, 0x80, 0xF7, 0x00, 0x00, 0x20, 0x9C, 0x00, 0xA7, 0x01, 0xB0, 0x00,
+    0x00, 0x08, 0x89, 0x00, 0x00, 0x08, 0x96, 0x00, 0xA7, 0x01, 0xA4, 0x00, 0x00, 0x80, 0x83, 0x00,
+    0x00, 0x02, 0x83, 0x00, 0x00, 0x80, 0x83, 0x00, 0x00, 0x02, 0x83, 0x00, 0x00, 0x80, 0x96, 0x00,
+    0xA7, 0x01, 0xAA, 0x00, 0x00, 0x20, 0x89, 0x00, 0x00, 0x20, 0x9C, 0x00, 0xA7, 0x01, 0xB0, 0x00,
+    0x00, 0x08, 0x89, 0x00, 0x00, 0x08, 0x96, 0x00, 0xA7, 0x01, 0xB6, 0x00, 0x00, 0x02, 0x83, 0x00,
+    0x00, 0x80, 0x96, 0x00, 0xA7, 0x01, 0xD5, 0x00, 0xA7, 0x01,
+};
+
+#endif
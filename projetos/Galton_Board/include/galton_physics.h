@@ -0,0 +1,28 @@
+// Verifica se a macro GALTON_PHYSICS_H já foi definida
+#ifndef GALTON_PHYSICS_H
+// Define a macro GALTON_PHYSICS_H para evitar múltiplas inclusões
+#define GALTON_PHYSICS_H
+
+#include <stdint.h> // Tipos inteiros com tamanho fixo
+#include <stdbool.h> // Tipo bool
+
+// As probabilidades são representadas em ponto fixo Q16 (65536 = 100%), evitando operações em ponto flutuante no RP2040 (que não possui FPU)
+#define GALTON_PROB_ONE 65536u // Probabilidade de 100% em Q16
+#define GALTON_PROB_HALF 32768u // Probabilidade de 50% em Q16 (Galton Board nivelada)
+#define GALTON_PROB_MIN 3277u // Probabilidade mínima (~5%), para que a bola nunca fique totalmente presa em um lado
+#define GALTON_PROB_MAX (GALTON_PROB_ONE - GALTON_PROB_MIN) // Probabilidade máxima (~95%)
+
+#define GALTON_TILT_FILTER_SHIFT 3 // Constante do filtro passa-baixa da inclinação (média móvel exponencial com peso 1/8 para a nova amostra)
+
+// Estrutura do filtro passa-baixa aplicado à aceleração lateral antes do cálculo da probabilidade
+typedef struct {
+    int32_t state; // Aceleração lateral filtrada, em mg, escalada por 2^GALTON_TILT_FILTER_SHIFT
+    bool primed; // Indica se o filtro já recebeu a primeira amostra
+} galton_tilt_filter_t;
+
+void galton_tilt_filter_reset(galton_tilt_filter_t *filter); // Reinicia o filtro passa-baixa
+int32_t galton_tilt_filter_update(galton_tilt_filter_t *filter, int32_t lateral_mg); // Insere uma nova amostra (mg) e retorna o valor filtrado (mg)
+uint32_t galton_tilt_probability(int32_t lateral_mg); // Converte a aceleração lateral (mg) na probabilidade Q16 da bola desviar para a direção 1 em cada pino
+uint8_t galton_bounce(uint32_t probability, uint32_t random_32); // Decide a direção (0 ou 1) de um choque com o pino a partir da probabilidade Q16 e de um número aleatório de 32 bits
+
+#endif // Fim da diretiva de inclusão condicional
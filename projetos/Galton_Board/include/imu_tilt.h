@@ -0,0 +1,18 @@
+// Verifica se a macro IMU_TILT_H já foi definida
+#ifndef IMU_TILT_H
+// Define a macro IMU_TILT_H para evitar múltiplas inclusões
+#define IMU_TILT_H
+
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+
+#define IMU_SDA 0 // Pino SDA do MPU6050 (barramento i2c0, o mesmo usado em Robo_Equilibrista/Acelerometro)
+#define IMU_SCL 1 // Pino SCL do MPU6050
+#define IMU_TILT_AXIS 1 // Eixo do acelerômetro alinhado com a direção lateral da Galton Board (0 = X, 1 = Y, 2 = Z)
+#define IMU_TILT_SIGN 1 // Sinal do eixo lateral (troque para -1 caso a bola desvie para o lado oposto ao da inclinação)
+
+void imu_tilt_init(uint sample_rate_hz); // Configura o MPU6050 e inicia a leitura periódica (não bloqueante) da aceleração
+int32_t imu_tilt_lateral_mg(void); // Retorna a última aceleração lateral filtrada, em mg
+uint32_t imu_tilt_sample_count(void); // Retorna o número de amostras lidas com sucesso desde a inicialização
+uint32_t imu_tilt_error_count(void); // Retorna o número de transferências abortadas (MPU6050 ausente ou barramento com falha)
+
+#endif // Fim da diretiva de inclusão condicional
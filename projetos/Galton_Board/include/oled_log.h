@@ -0,0 +1,27 @@
+// Verifica se a macro OLED_LOG_H já foi definida
+#ifndef OLED_LOG_H
+// Define a macro OLED_LOG_H para evitar múltiplas inclusões
+#define OLED_LOG_H
+
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+
+#define OLED_LOG_LINE_CHARS 16 // Caracteres por linha (128 pixels / 8 pixels por caractere)
+
+// Visualização de log/letreiro com rolagem vertical pela linha inicial do display (comando 0x40 | linha)
+// Cada nova linha custa o envio de uma única página (128 bytes) mais um byte de comando, em vez do buffer inteiro (1 KB)
+typedef struct {
+    uint8_t *ssd; // Buffer do display (cada página do buffer corresponde a uma página da RAM do display)
+    uint8_t top_page; // Página da RAM exibida no topo da tela
+    uint8_t lines_used; // Linhas já preenchidas (a rolagem só começa com a tela cheia)
+    uint8_t start_line; // Linha inicial atual do display (0 a 63)
+    uint8_t target_line; // Linha inicial ao fim da rolagem suave em andamento
+    bool smooth; // Rolagem suave (1 pixel por chamada de oled_log_update()) ou imediata (8 pixels de uma vez)
+    bool has_pending; // Existe uma linha aguardando o fim da rolagem suave para ser desenhada
+    char pending[OLED_LOG_LINE_CHARS + 1]; // Texto da linha aguardando o fim da rolagem
+} oled_log_t;
+
+void oled_log_init(oled_log_t *log, uint8_t *ssd, bool smooth); // Limpa a tela e prepara o log
+void oled_log_push(oled_log_t *log, const char *text); // Acrescenta uma linha no fim do log, rolando as anteriores para cima
+bool oled_log_update(oled_log_t *log); // Avança a rolagem suave em 1 pixel; retorna true enquanto a rolagem estiver em andamento
+
+#endif // Fim da diretiva de inclusão condicional
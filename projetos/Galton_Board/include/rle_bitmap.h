@@ -0,0 +1,20 @@
+// Verifica se a macro RLE_BITMAP_H já foi definida
+#ifndef RLE_BITMAP_H
+// Define a macro RLE_BITMAP_H para evitar múltiplas inclusões
+#define RLE_BITMAP_H
+
+#include <stdint.h> // Tipos inteiros com tamanho fixo
+
+// Formato gerado por tools/bitmap_rle.py (bytes organizados em páginas de 8 linhas, como no buffer do SSD1306):
+//   byte 0: largura em pixels | byte 1: altura em pixels (múltiplo de 8)
+//   bloco c < 0x80: c + 1 bytes literais em seguida | bloco c >= 0x80: o byte seguinte repetido (c & 0x7F) + 2 vezes
+
+#define rle_bitmap_width(asset) ((asset)[0]) // Largura do bitmap em pixels
+#define rle_bitmap_height(asset) ((asset)[1]) // Altura do bitmap em pixels
+
+// Descomprime o bitmap diretamente no buffer do display, com o canto superior esquerdo em (x, y)
+// O bitmap é lido byte a byte da memória flash (XIP), sem cópia intermediária em RAM, e o que ficar fora da tela é recortado
+// Com y múltiplo de 8 os bytes da área são substituídos; caso contrário, os pixels acesos são combinados (OR) com o conteúdo atual
+void rle_bitmap_draw(uint8_t *ssd, const uint8_t *asset, int x, int y);
+
+#endif // Fim da diretiva de inclusão condicional
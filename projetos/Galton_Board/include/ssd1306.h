@@ -4,7 +4,15 @@ extern void ssd1306_send_command(uint8_t cmd);
 extern void ssd1306_send_command_list(uint8_t *ssd, int number);
 extern void ssd1306_send_buffer(uint8_t ssd[], int buffer_length);
 extern void ssd1306_init();
+extern void ssd1306_select(ssd1306_t *ssd);
+extern void ssd1306_init_display(ssd1306_t *ssd, i2c_inst_t *i2c, uint8_t address);
 extern void ssd1306_scroll(bool set);
+extern void ssd1306_scroll_horizontal(bool left, uint8_t start_page, uint8_t end_page, uint8_t interval);
+extern void ssd1306_scroll_diagonal(bool left, uint8_t start_page, uint8_t end_page, uint8_t interval, uint8_t vertical_offset);
+extern void ssd1306_scroll_vertical_area(uint8_t fixed_rows, uint8_t scroll_rows);
+extern void ssd1306_scroll_stop();
+extern void ssd1306_set_start_line(uint8_t line);
+extern void render_page(uint8_t *ssd, uint8_t page);
 extern void render_on_display(uint8_t *ssd, struct render_area *area);
 extern void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set);
 extern void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set);
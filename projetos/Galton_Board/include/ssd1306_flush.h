@@ -0,0 +1,28 @@
+// Verifica se a macro SSD1306_FLUSH_H já foi definida
+#ifndef SSD1306_FLUSH_H
+// Define a macro SSD1306_FLUSH_H para evitar múltiplas inclusões
+#define SSD1306_FLUSH_H
+
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "include/ssd1306.h" // Handle ssd1306_t e dimensões do display
+
+#define SSD1306_FLUSH_MAX_DISPLAYS 4 // Displays registrados ao mesmo tempo (até dois por barramento: 0x3C e 0x3D)
+#define SSD1306_FLUSH_HEADER_WORDS 8 // Byte de controle + 6 comandos de endereçamento (com STOP) + byte de controle dos dados
+#define SSD1306_FLUSH_WORDS (SSD1306_FLUSH_HEADER_WORDS + ssd1306_buffer_length) // Palavras de 16 bits escritas pelo DMA no registrador IC_DATA_CMD a cada envio
+
+// Estatísticas de envio de um display
+typedef struct {
+    uint32_t flushes; // Envios concluídos
+    uint32_t rejected; // Envios recusados porque o anterior ainda não havia terminado
+    uint32_t aborts; // Envios abortados pelo barramento (NACK: display ausente ou endereço errado)
+    uint32_t last_us; // Duração do último envio (do início do DMA ao STOP final)
+    uint32_t max_us; // Maior duração de envio
+} ssd1306_flush_stats_t;
+
+int ssd1306_flush_add(ssd1306_t *display); // Registra um display já inicializado (ssd1306_init_display); retorna o índice ou -1 se não houver espaço
+bool ssd1306_flush_submit(ssd1306_t *display, const uint8_t *framebuffer); // Copia o buffer e agenda o envio por DMA; retorna false se o envio anterior do mesmo display ainda estiver em andamento
+bool ssd1306_flush_busy(ssd1306_t *display); // Indica se o display (ou qualquer display, com NULL) ainda tem envio agendado ou em andamento
+void ssd1306_flush_wait(ssd1306_t *display); // Espera os envios do display (ou de todos, com NULL) terminarem, antes de usar as funções bloqueantes no mesmo barramento
+void ssd1306_flush_get_stats(ssd1306_t *display, ssd1306_flush_stats_t *stats, bool reset); // Copia as estatísticas do display (e opcionalmente as reinicia)
+
+#endif // Fim da diretiva de inclusão condicional
@@ -8,6 +8,13 @@
 #include "ssd1306_font.h"
 #include "ssd1306_i2c.h"
 
+// Display alvo das funções sem handle (ssd1306_init, render_on_display, rolagem...): por padrão, o display 0x3C no i2c1
+static ssd1306_t ssd1306_default_display = {
+    .width = ssd1306_width, .height = ssd1306_height, .pages = ssd1306_n_pages,
+    .address = ssd1306_i2c_address, .i2c_port = i2c1, .port_buffer = {0x80, 0x00},
+};
+static ssd1306_t *ssd1306_selected = &ssd1306_default_display;
+
 // Calcular quanto do buffer será destinado à área de renderização
 void calculate_render_area_buffer_length(struct render_area *area) {
     area->buffer_length = (area->end_column - area->start_column + 1) * (area->end_page - area->start_page + 1);
@@ -16,7 +23,7 @@ void calculate_render_area_buffer_length(struct render_area *area) {
 // Processo de escrita do i2c espera um byte de controle, seguido por dados
 void ssd1306_send_command(uint8_t command) {
     uint8_t buffer[2] = {0x80, command};
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, 2, false);
+    i2c_write_blocking(ssd1306_selected->i2c_port, ssd1306_selected->address, buffer, 2, false);
 }
 
 // Envia uma lista de comandos ao hardware
@@ -33,7 +40,7 @@ void ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
     temp_buffer[0] = 0x40;
     memcpy(temp_buffer + 1, ssd, buffer_length);
 
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
+    i2c_write_blocking(ssd1306_selected->i2c_port, ssd1306_selected->address, temp_buffer, buffer_length + 1, false);
 
     free(temp_buffer);
 }
@@ -64,16 +71,72 @@ void ssd1306_init() {
     ssd1306_send_command_list(commands, count_of(commands));
 }
 
-// Cria a lista de comandos para configurar o scrolling
-void ssd1306_scroll(bool set) {
+// Seleciona o display usado pelas funções sem handle; com vários displays, basta selecionar cada um antes de usá-las
+void ssd1306_select(ssd1306_t *ssd) {
+    ssd1306_selected = ssd ? ssd : &ssd1306_default_display;
+}
+
+// Preenche o handle de um display 128x64 (sem alocar buffer) e o inicializa com a mesma sequência de ssd1306_init()
+// O display selecionado anteriormente continua selecionado
+void ssd1306_init_display(ssd1306_t *ssd, i2c_inst_t *i2c, uint8_t address) {
+    ssd->width = ssd1306_width;
+    ssd->height = ssd1306_height;
+    ssd->pages = ssd1306_n_pages;
+    ssd->address = address;
+    ssd->i2c_port = i2c;
+    ssd->external_vcc = false;
+    ssd->ram_buffer = NULL;
+    ssd->bufsize = 0;
+    ssd->port_buffer[0] = 0x80;
+
+    ssd1306_t *previous = ssd1306_selected;
+    ssd1306_selected = ssd;
+    ssd1306_init();
+    ssd1306_selected = previous;
+}
+
+// Rolagem horizontal contínua feita pelo próprio display (nenhum dado é reenviado pelo I2C enquanto ela está ativa)
+// A RAM do display não deve ser escrita com a rolagem ativa: chame ssd1306_scroll_stop() antes de enviar um novo buffer
+void ssd1306_scroll_horizontal(bool left, uint8_t start_page, uint8_t end_page, uint8_t interval) {
+    uint8_t commands[] = {
+        ssd1306_set_scroll | 0x00, // Desativa a rolagem atual antes de reconfigurar (exigido pelo datasheet)
+        ssd1306_set_horizontal_scroll | (left ? 0x01 : 0x00), 0x00, start_page, interval, end_page,
+        0x00, 0xFF, ssd1306_set_scroll | 0x01
+    };
+
+    ssd1306_send_command_list(commands, count_of(commands));
+}
+
+// Rolagem contínua vertical e horizontal combinadas: a cada passo o conteúdo sobe vertical_offset linhas dentro da área definida por ssd1306_scroll_vertical_area()
+// As páginas fora da faixa start_page..end_page rolam apenas na vertical; para rolagem vertical sob controle do programa, ssd1306_set_start_line() é mais barato
+void ssd1306_scroll_diagonal(bool left, uint8_t start_page, uint8_t end_page, uint8_t interval, uint8_t vertical_offset) {
     uint8_t commands[] = {
-        ssd1306_set_horizontal_scroll | 0x00, 0x00, 0x00, 0x00, 0x03,
-        0x00, 0xFF, ssd1306_set_scroll | (set ? 0x01 : 0)
+        ssd1306_set_scroll | 0x00,
+        ssd1306_set_vertical_horizontal_scroll + (left ? 1 : 0), 0x00, start_page, interval, end_page,
+        vertical_offset, ssd1306_set_scroll | 0x01
     };
 
     ssd1306_send_command_list(commands, count_of(commands));
 }
 
+// Define a área da rolagem vertical: as fixed_rows primeiras linhas ficam paradas e as scroll_rows seguintes rolam
+void ssd1306_scroll_vertical_area(uint8_t fixed_rows, uint8_t scroll_rows) {
+    uint8_t commands[] = {ssd1306_set_vertical_scroll_area, fixed_rows, scroll_rows};
+
+    ssd1306_send_command_list(commands, count_of(commands));
+}
+
+// Desativa a rolagem contínua
+void ssd1306_scroll_stop() {
+    ssd1306_send_command(ssd1306_set_scroll | 0x00);
+}
+
+// Define qual linha da RAM do display aparece no topo da tela (0 a 63)
+// Deslocar a linha inicial rola a tela verticalmente com um único byte de comando, sem reenviar o buffer
+void ssd1306_set_start_line(uint8_t line) {
+    ssd1306_send_command(ssd1306_set_display_start_line | (line & 0x3F));
+}
+
 // Atualiza uma parte do display com uma área de renderização
 void render_on_display(uint8_t *ssd, struct render_area *area) {
     uint8_t commands[] = {
@@ -85,6 +148,28 @@ void render_on_display(uint8_t *ssd, struct render_area *area) {
     ssd1306_send_buffer(ssd, area->buffer_length);
 }
 
+// Liga ou desliga a rolagem horizontal contínua da tela inteira
+void ssd1306_scroll(bool set) {
+    if (set) {
+        ssd1306_scroll_horizontal(false, 0, ssd1306_n_pages - 1, ssd1306_scroll_5_frames);
+    } else {
+        ssd1306_scroll_stop();
+    }
+}
+
+// Atualiza apenas uma página (128 bytes), em vez do buffer inteiro
+void render_page(uint8_t *ssd, uint8_t page) {
+    struct render_area area = {
+        start_column : 0,
+        end_column : ssd1306_width - 1,
+        start_page : page,
+        end_page : page,
+    };
+
+    calculate_render_area_buffer_length(&area);
+    render_on_display(ssd + page * ssd1306_width, &area);
+}
+
 // Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
 void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set) {
     assert(x >= 0 && x < ssd1306_width && y >= 0 && y < ssd1306_height);
@@ -17,7 +17,9 @@
 #define ssd1306_set_column_address _u(0x21)
 #define ssd1306_set_page_address _u(0x22)
 #define ssd1306_set_horizontal_scroll _u(0x26)
+#define ssd1306_set_vertical_horizontal_scroll _u(0x29) // 0x29 para a direita, 0x2A para a esquerda
 #define ssd1306_set_scroll _u(0x2E)
+#define ssd1306_set_vertical_scroll_area _u(0xA3)
 
 #define ssd1306_set_display_start_line _u(0x40)
 
@@ -44,6 +46,16 @@
 #define ssd1306_n_pages (ssd1306_height / ssd1306_page_height)
 #define ssd1306_buffer_length (ssd1306_n_pages * ssd1306_width)
 
+// Intervalo entre os passos da rolagem contínua, em frames do display (códigos do datasheet)
+#define ssd1306_scroll_2_frames _u(0x07)
+#define ssd1306_scroll_3_frames _u(0x04)
+#define ssd1306_scroll_4_frames _u(0x05)
+#define ssd1306_scroll_5_frames _u(0x00)
+#define ssd1306_scroll_25_frames _u(0x06)
+#define ssd1306_scroll_64_frames _u(0x01)
+#define ssd1306_scroll_128_frames _u(0x02)
+#define ssd1306_scroll_256_frames _u(0x03)
+
 #define ssd1306_write_mode _u(0xFE)
 #define ssd1306_read_mode _u(0xFF)
 
@@ -4,9 +4,26 @@
 #include "pico/rand.h" // Biblioteca voltada para manipulação de funções de geração de número aleatório
 #include "hardware/i2c.h" // Biblioteca para comunicação I2C
 #include "include/ssd1306.h" // Biblioteca para controle do display OLED
+#include "include/galton_physics.h" // Modelo físico dos choques da bola com os pinos
+#include "include/imu_tilt.h" // Leitura não bloqueante da inclinação pelo MPU6050
+#include "include/frame_scheduler.h" // Escalonador de frames com passo de tempo fixo
+#include "include/rle_bitmap.h" // Decodificador de bitmaps comprimidos em RLE
+#include "include/oled_log.h" // Log com rolagem pela linha inicial do display
+#include "include/ssd1306_flush.h" // Envio dos buffers aos displays por DMA, sem bloquear a CPU
+#include "include/galton_board_rle.h" // Bitmap da Galton Board (gerado por tools/bitmap_rle.py a partir de assets/Galton_Board_Bitmap_128_64.png)
 
 #define OLED_SDA 14 // Pino SDA do display OLED
 #define OLED_SCL 15 // Pino SCL do display OLED
+#define OLED_HIST_DISPLAY 0 // 1: um segundo display (endereço 0x3D, mesmo barramento i2c1) mostra o histograma; o i2c0 fica com o MPU6050
+#define OLED_HIST_ADDRESS 0x3D // Endereço do display do histograma (jumper de endereço do módulo na posição 0x3D)
+
+#define GALTON_TILT_MODE 1 // 1: a probabilidade de cada pino é ajustada pela inclinação medida no MPU6050; 0: sorteio 50/50 original
+#define IMU_SAMPLE_RATE_HZ 500 // Frequência de amostragem da inclinação
+#define BALL_UPDATE_HZ 100 // Passos por segundo da animação da bola (1 pixel por passo)
+#define RENDER_FPS 30 // Taxa alvo de envio do buffer ao display (um envio completo leva ~25 ms em 400 kHz)
+#define GALTON_ROWS 5 // Número de fileiras de pinos
+#define GALTON_BINS (GALTON_ROWS + 1) // Número de compartimentos na base da Galton Board
+#define BIN_CAPACITY 40 // Número de bolas que cabem em cada compartimento (colunas 88 a 127)
 
 typedef struct // Estrutura global possuindo componentes relacionadas a bola
 {
@@ -15,7 +32,31 @@ typedef struct // Estrutura global possuindo componentes relacionadas a bola
 
 }Ball;
 
+typedef enum // Etapas do percurso da bola
+{
+    BALL_FALLING, // Descida até a primeira fileira de pinos
+    BALL_BOUNCING, // Choques com os pinos
+    BALL_ROLLING, // Rolagem pelo compartimento até a pilha de bolas
+
+}BallPhase;
+
+Ball ball; // Bola em movimento
+BallPhase ball_phase; // Etapa atual do percurso
+int ball_row; // Fileira de pinos atual
+int ball_row_step; // Passo dentro da fileira (0 = choque com o pino, 1 a 6 = deslocamento até a próxima fileira)
+int ball_bin; // Número de desvios na direção 1, que identifica o compartimento final
+uint32_t balls = 0; // Número de bolas soltas desde a última limpeza dos compartimentos
+
+uint16_t bin_height[GALTON_BINS]; // Quantidade de bolas acumuladas em cada compartimento (histograma)
+
 uint8_t ssd[ssd1306_buffer_length]; // Buffer global para a configuração e manipulação do display OLED
+ssd1306_t oled_board; // Display da Galton Board (0x3C no i2c1)
+
+#if OLED_HIST_DISPLAY
+uint8_t hist_ssd[ssd1306_buffer_length]; // Buffer do display do histograma
+ssd1306_t oled_hist; // Display do histograma
+bool hist_dirty = true; // O histograma mudou e ainda não foi enviado
+#endif
 
 struct render_area frame_area = {  // Estrutura global para a configuração da área de renderização do display OLED
     start_column : 0,
@@ -38,151 +79,272 @@ void config_display_oled() // Função para configurar o display OLED
     gpio_pull_up(OLED_SDA); // Habilita um pull-up interno no pino SDA, garantindo níveis lógicos corretos na comunicação I2C
     gpio_pull_up(OLED_SCL); // Habilita um pull-up interno no pino SCL, garantindo estabilidade no sinal de clock do I2C
 
-    ssd1306_init(); // Inicializa o driver do display OLED SSD1306, preparando-o para receber comandos e exibir informações
+    ssd1306_init_display(&oled_board, i2c1, ssd1306_i2c_address); // Inicializa o driver do display OLED SSD1306, preparando-o para receber comandos e exibir informações
+    ssd1306_select(&oled_board); // As funções bloqueantes (log de inicialização) usam o display da Galton Board
 
     calculate_render_area_buffer_length(&frame_area); // Calcula o tamanho do buffer necessário para renderizar a área configurada do display
 
     clean_display_oled(); // Limpa o display OLED, garantindo que nenhuma informação residual seja exibida na inicialização
+
+#if OLED_HIST_DISPLAY
+    ssd1306_init_display(&oled_hist, i2c1, OLED_HIST_ADDRESS); // Segundo display no mesmo barramento
+    ssd1306_select(&oled_hist);
+    memset(hist_ssd, 0, ssd1306_buffer_length);
+    render_on_display(hist_ssd, &frame_area);
+    ssd1306_select(&oled_board);
+#endif
 }
 
-const uint8_t bitmap_128x64[] = { // Bitmap referente a Galton Board
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01
-};
+// Desenha a Galton Board no buffer (bitmap comprimido em RLE, descomprimido direto da flash); o envio ao display é feito por render_frame()
+void draw_board()
+{
+    rle_bitmap_draw(ssd, galton_board_rle, 0, 0);
+}
 
-// Renderiza manualmente o bitmap usando set_pixel()
-void render_bitmap_manually(const uint8_t *bitmap) {
-    for (int page = 0; page < 8; page++) { // 64px / 8 = 8 páginas
-        for (int x = 0; x < 128; x++) {
-            int idx = page * 128 + x;
-            uint8_t byte = bitmap[idx]; // Obtendo o indice específico de cada byte do bitmap
-
-            for (int bit = 0; bit < 8; bit++) {
-                if (byte & (1 << bit)) {
-                    int y = page * 8 + bit;
-                    ssd1306_set_pixel(ssd, x, y, true);
-                }
+#if OLED_HIST_DISPLAY
+// Desenha o histograma no buffer do segundo display: contagem de cada compartimento no topo e barras verticais proporcionais à capacidade
+void draw_histogram()
+{
+    const int bar_width = ssd1306_width / GALTON_BINS; // 21 colunas por compartimento
+    const int bar_top = 10; // As barras ocupam as linhas 10 a 63
+    char label[4];
+
+    memset(hist_ssd, 0, ssd1306_buffer_length);
+    for (int i = 0; i < GALTON_BINS; i++) {
+        int x = i * bar_width;
+        int height = bin_height[i] * (ssd1306_height - bar_top) / BIN_CAPACITY;
+
+        snprintf(label, sizeof(label), "%u", bin_height[i]);
+        ssd1306_draw_string(hist_ssd, x + 2, 0, label);
+
+        for (int y = ssd1306_height - height; y < ssd1306_height; y++) {
+            for (int dx = 2; dx < bar_width - 2; dx++) {
+                ssd1306_set_pixel(hist_ssd, x + dx, y, true);
             }
         }
     }
-    render_on_display(ssd, &frame_area);
+    hist_dirty = true;
 }
+#endif
 
-int main()
+// Decide para qual lado a bola segue ao colidir com um pino
+uint8_t choose_direction()
 {
-    stdio_init_all();
-    config_display_oled();
-    render_bitmap_manually(bitmap_128x64);
+#if GALTON_TILT_MODE
+    uint32_t probability = galton_tilt_probability(imu_tilt_lateral_mg()); // Probabilidade (Q16) ajustada pela inclinação medida no instante do choque
+    return galton_bounce(probability, get_rand_32());
+#else
+    return get_rand_32() & 1; // Sorteio 50/50 original
+#endif
+}
 
-    Ball new_ball; 
-    new_ball.x = 0;
-    new_ball.y = 31;
+// Limpa as bolas acumuladas nos compartimentos e redesenha a Galton Board
+void reset_bins()
+{
+    memset(bin_height, 0, sizeof(bin_height));
+    draw_board(); // O bitmap ocupa a tela inteira, então a descompressão também apaga as bolas acumuladas
+#if OLED_HIST_DISPLAY
+    draw_histogram();
+#endif
+}
 
-    uint8_t direction;
+// Move a bola uma coluna para a direita, apagando a posição anterior (o envio ao display é feito por render_frame())
+void move_ball_right(Ball *ball)
+{
+    ball->x++;
+    ssd1306_set_pixel(ssd, ball->x, ball->y, true);
+    ssd1306_set_pixel(ssd, ball->x - 1, ball->y, false);
+}
 
-    // Loop para a bola descer antes da colisão com os pinos
-    for(int i = 0; i <= 38; i++) {
-        ssd1306_set_pixel(ssd, i, new_ball.y, true);
-        if(i-1 >= 0){
-        ssd1306_set_pixel(ssd, i-1, new_ball.y, false);
+// Solta uma nova bola no topo da Galton Board
+void start_ball()
+{
+    ball.x = 0;
+    ball.y = 31;
+    ball_phase = BALL_FALLING;
+    ball_row = 0;
+    ball_row_step = 0;
+    ball_bin = 0;
+    ssd1306_set_pixel(ssd, ball.x, ball.y, true);
+}
+
+// Bola acomodada no compartimento: atualiza o histograma e solta a próxima
+void finish_ball()
+{
+    bin_height[ball_bin]++;
+    balls++;
+#if OLED_HIST_DISPLAY
+    draw_histogram();
+#endif
+
+    if (balls % 10 == 0) { // Histograma e inclinação atuais enviados pela serial para acompanhamento em tempo real
+        printf("Bolas: %lu | Inclinacao: %ld mg | Compartimentos:", (unsigned long)balls, (long)imu_tilt_lateral_mg());
+        for (int i = 0; i < GALTON_BINS; i++) {
+            printf(" %u", bin_height[i]);
         }
-        render_on_display(ssd, &frame_area);
-        sleep_ms(300);
-        new_ball.x = i;
+        printf("\n");
     }
 
-   for(int n = 0; n < 5; n++) {
-        if (new_ball.x = 38 + 6*n) {
-            direction = get_rand_32() & 1;
-            if (direction == 0 && new_ball.x > 0) {
-                new_ball.y += 6;
-                ssd1306_set_pixel(ssd, new_ball.x, new_ball.y, true);
-                render_on_display(ssd, &frame_area);
-                for(int a = 0; a <=5; a++) {
-                    new_ball.x++;
-                    ssd1306_set_pixel(ssd, new_ball.x, new_ball.y, true);
-                    ssd1306_set_pixel(ssd, new_ball.x-1, new_ball.y, false);
-                    render_on_display(ssd, &frame_area);
-                }
+    for (int i = 0; i < GALTON_BINS; i++) {
+        if (bin_height[i] >= BIN_CAPACITY) { // Um compartimento cheio reinicia o histograma
+            reset_bins();
+            balls = 0;
+            break;
+        }
+    }
+
+    start_ball();
+}
+
+// Passo de tempo fixo da animação: a bola avança um pixel por chamada, independente do tempo gasto no envio ao display
+void update_ball(void *user_data)
+{
+    switch (ball_phase) {
+    case BALL_FALLING: // Descida até o pino da primeira fileira
+        if (ball.x < 38) {
+            move_ball_right(&ball);
+        } else {
+            ball_phase = BALL_BOUNCING;
+        }
+        break;
+
+    case BALL_BOUNCING: // Choque com o pino seguido de 6 passos até a fileira seguinte
+        if (ball_row_step == 0) {
+            ssd1306_set_pixel(ssd, ball.x, ball.y, false);
+            if (choose_direction() == 0) {
+                ball.y += 6;
+            } else {
+                ball.y -= 6;
+                ball_bin++;
             }
-            else if (direction == 1 && new_ball.x < (ssd1306_width - 1)) {
-                new_ball.y -= 6;
-                ssd1306_set_pixel(ssd, new_ball.x, new_ball.y, true);
-                render_on_display(ssd, &frame_area);
-                for(int a = 0; a <=5; a++) {
-                    new_ball.x++;
-                    ssd1306_set_pixel(ssd, new_ball.x, new_ball.y, true);
-                    ssd1306_set_pixel(ssd, new_ball.x-1, new_ball.y, false);
-                    render_on_display(ssd, &frame_area);
+            ssd1306_set_pixel(ssd, ball.x, ball.y, true);
+            ball_row_step++;
+        } else {
+            move_ball_right(&ball);
+            if (++ball_row_step > 6) {
+                ball_row_step = 0;
+                if (++ball_row == GALTON_ROWS) {
+                    ball_phase = BALL_ROLLING;
                 }
             }
         }
-   }
+        break;
+
+    case BALL_ROLLING: // A bola rola pelo compartimento até encostar na pilha de bolas que já estão lá
+        if (ball.x < (ssd1306_width - 1) - bin_height[ball_bin]) {
+            move_ball_right(&ball);
+        } else {
+            finish_ball();
+        }
+        break;
+    }
+}
+
+// Agenda o envio dos buffers por DMA (chamada no máximo RENDER_FPS vezes por segundo) e retorna sem esperar o barramento
+// Se o envio anterior ainda não terminou, o frame é recusado e contado nas estatísticas; a animação segue no buffer
+void render_frame(void *user_data)
+{
+    ssd1306_flush_submit(&oled_board, ssd);
+#if OLED_HIST_DISPLAY
+    if (hist_dirty && ssd1306_flush_submit(&oled_hist, hist_ssd)) { // O histograma só muda quando uma bola chega ao compartimento
+        hist_dirty = false;
+    }
+#endif
+}
+
+// Acrescenta uma linha ao log de inicialização e espera a rolagem suave terminar (~60 passos por segundo)
+void boot_log_line(oled_log_t *log, const char *text)
+{
+    oled_log_push(log, text);
+    while (oled_log_update(log)) {
+        sleep_ms(16);
+    }
+    sleep_ms(250);
+}
+
+int main()
+{
+    stdio_init_all();
+    config_display_oled();
+
+    // Log de inicialização: cada linha nova rola a tela pela linha inicial do display e envia uma única página
+    oled_log_t boot_log;
+    char line[OLED_LOG_LINE_CHARS + 1];
+    oled_log_init(&boot_log, ssd, true);
+    boot_log_line(&boot_log, "GALTON BOARD");
+
+#if GALTON_TILT_MODE
+    imu_tilt_init(IMU_SAMPLE_RATE_HZ); // Inicia a leitura periódica e não bloqueante da inclinação
+    sleep_ms(50);
+    boot_log_line(&boot_log, imu_tilt_sample_count() > 0 ? "IMU OK" : "IMU AUSENTE");
+#else
+    boot_log_line(&boot_log, "MODO 50 50");
+#endif
+
+    snprintf(line, sizeof(line), "RLE %u BYTES", (unsigned)sizeof(galton_board_rle));
+    boot_log_line(&boot_log, line);
+    snprintf(line, sizeof(line), "BOLAS %u HZ", BALL_UPDATE_HZ);
+    boot_log_line(&boot_log, line);
+    snprintf(line, sizeof(line), "TELA %u FPS", RENDER_FPS);
+    boot_log_line(&boot_log, line);
+    snprintf(line, sizeof(line), "FILEIRAS %u", GALTON_ROWS);
+    boot_log_line(&boot_log, line);
+    snprintf(line, sizeof(line), "COMPARTIMENTOS %u", GALTON_BINS);
+    boot_log_line(&boot_log, line);
+    snprintf(line, sizeof(line), "CAPACIDADE %u", BIN_CAPACITY);
+    boot_log_line(&boot_log, line);
+    boot_log_line(&boot_log, "PRONTO"); // Nona linha: a partir daqui o log rola
+    sleep_ms(1000);
+
+    ssd1306_set_start_line(0); // Desfaz o deslocamento deixado pelo log antes de desenhar a Galton Board
+
+    uint32_t decode_start = time_us_32();
+    rle_bitmap_draw(ssd, galton_board_rle, 0, 0);
+    uint32_t decode_time = time_us_32() - decode_start;
+    render_on_display(ssd, &frame_area);
+    printf("Bitmap RLE: %u bytes na flash (%u descomprimidos), descompressao em %lu us\n",
+           (unsigned)sizeof(galton_board_rle), (unsigned)ssd1306_buffer_length, (unsigned long)decode_time);
+
+    // A partir daqui, os displays são atualizados apenas por DMA (as funções bloqueantes não podem disputar o barramento com os envios)
+    ssd1306_flush_add(&oled_board);
+#if OLED_HIST_DISPLAY
+    ssd1306_flush_add(&oled_hist);
+    draw_histogram();
+#endif
+
+    start_ball();
+
+    frame_scheduler_t scheduler;
+    frame_scheduler_init(&scheduler, BALL_UPDATE_HZ, RENDER_FPS, update_ball, render_frame, NULL);
+    frame_scheduler_set_skip(&scheduler, true); // Se o envio ao display atrasar, a animação continua no ritmo certo e os frames excedentes são pulados
+
+    absolute_time_t next_report = make_timeout_time_ms(5000);
 
     while (true) {
+        frame_scheduler_run_once(&scheduler);
+
+        if (time_reached(next_report)) { // Estatísticas de tempo dos frames a cada 5 segundos
+            frame_stats_t stats;
+            frame_scheduler_get_stats(&scheduler, &stats, true);
+            if (stats.frames > 0) {
+                printf("Frames: %lu (%.1f fps) | tempo min/med/max: %lu/%lu/%lu us | estouros: %lu | pulados: %lu\n",
+                       (unsigned long)stats.frames, stats.frames / 5.0f, (unsigned long)stats.min_us,
+                       (unsigned long)(stats.total_us / stats.frames), (unsigned long)stats.max_us,
+                       (unsigned long)stats.overruns, (unsigned long)stats.skipped_renders);
+            }
 
-        sleep_ms(1000);
+            ssd1306_flush_stats_t flush;
+            ssd1306_flush_get_stats(&oled_board, &flush, true);
+            printf("DMA (Galton Board): %lu envios, ultimo/max %lu/%lu us, recusados: %lu, abortados: %lu\n",
+                   (unsigned long)flush.flushes, (unsigned long)flush.last_us, (unsigned long)flush.max_us,
+                   (unsigned long)flush.rejected, (unsigned long)flush.aborts);
+#if OLED_HIST_DISPLAY
+            ssd1306_flush_get_stats(&oled_hist, &flush, true);
+            printf("DMA (histograma): %lu envios, ultimo/max %lu/%lu us, recusados: %lu, abortados: %lu\n",
+                   (unsigned long)flush.flushes, (unsigned long)flush.last_us, (unsigned long)flush.max_us,
+                   (unsigned long)flush.rejected, (unsigned long)flush.aborts);
+#endif
+            next_report = make_timeout_time_ms(5000);
+        }
     }
 }
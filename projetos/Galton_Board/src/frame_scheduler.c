@@ -0,0 +1,92 @@
+#include <string.h> // Para memset()
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "include/frame_scheduler.h" // Declarações do escalonador de frames
+
+// Interrupção do temporizador: apenas contabiliza o passo de tempo, todo o trabalho é feito no laço principal
+static bool frame_timer_callback(repeating_timer_t *t) {
+    frame_scheduler_t *scheduler = (frame_scheduler_t *)t->user_data;
+    scheduler->pending_ticks++;
+    return true; // Mantém o temporizador ativo
+}
+
+// Zera as estatísticas, deixando o mínimo no maior valor possível para que o primeiro frame o substitua
+static void frame_stats_reset(frame_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->min_us = UINT32_MAX;
+}
+
+// Configura o escalonador e inicia o temporizador dos passos de tempo fixo
+bool frame_scheduler_init(frame_scheduler_t *scheduler, uint update_hz, uint render_fps, frame_callback_t update, frame_callback_t render, void *user_data) {
+    memset(scheduler, 0, sizeof(*scheduler));
+    scheduler->update = update;
+    scheduler->render = render;
+    scheduler->user_data = user_data;
+    scheduler->tick_us = 1000000 / update_hz;
+    scheduler->frame_us = 1000000 / render_fps;
+    scheduler->next_render_us = time_us_64();
+    frame_stats_reset(&scheduler->stats);
+
+    // Intervalo negativo: o temporizador dispara em taxa fixa, independente do tempo gasto no laço principal
+    return add_repeating_timer_us(-(int64_t)scheduler->tick_us, frame_timer_callback, scheduler, &scheduler->timer);
+}
+
+// Habilita ou desabilita o descarte de renderizações quando o laço estiver atrasado
+void frame_scheduler_set_skip(frame_scheduler_t *scheduler, bool skip_when_behind) {
+    scheduler->skip_when_behind = skip_when_behind;
+}
+
+// Executa as atualizações pendentes, renderiza se chegou a hora e dorme até o próximo evento
+void frame_scheduler_run_once(frame_scheduler_t *scheduler) {
+    uint64_t start = time_us_64();
+
+    // Retira os passos pendentes com as interrupções desabilitadas (o M0+ não possui incremento atômico)
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t ticks = scheduler->pending_ticks;
+    scheduler->pending_ticks = 0;
+    restore_interrupts(irq_state);
+
+    if (ticks > FRAME_SCHEDULER_MAX_CATCH_UP) { // Atraso grande demais: descarta o excedente para não entrar em espiral de atraso
+        scheduler->stats.dropped_ticks += ticks - FRAME_SCHEDULER_MAX_CATCH_UP;
+        ticks = FRAME_SCHEDULER_MAX_CATCH_UP;
+    }
+
+    for (uint32_t i = 0; i < ticks; i++) {
+        scheduler->update(scheduler->user_data);
+    }
+    scheduler->stats.updates += ticks;
+
+    uint64_t now = time_us_64();
+
+    if (now >= scheduler->next_render_us) {
+        if (scheduler->skip_when_behind && scheduler->pending_ticks > 0) {
+            // Novos passos chegaram durante as atualizações: a renderização fica para quando a lógica estiver em dia
+            scheduler->stats.skipped_renders++;
+        } else {
+            scheduler->render(scheduler->user_data);
+
+            uint32_t frame_time = (uint32_t)(time_us_64() - start);
+            scheduler->stats.frames++;
+            scheduler->stats.total_us += frame_time;
+            if (frame_time < scheduler->stats.min_us) scheduler->stats.min_us = frame_time;
+            if (frame_time > scheduler->stats.max_us) scheduler->stats.max_us = frame_time;
+            if (frame_time > scheduler->frame_us) scheduler->stats.overruns++;
+
+            scheduler->next_render_us += scheduler->frame_us;
+            if (scheduler->next_render_us <= now) { // Perdeu frames inteiros: realinha em vez de renderizar várias vezes seguidas
+                scheduler->next_render_us = now + scheduler->frame_us;
+            }
+        }
+    }
+
+    if (scheduler->pending_ticks == 0) {
+        __wfe(); // Dorme até a próxima interrupção (o temporizador acorda o núcleo a cada passo de tempo)
+    }
+}
+
+// Copia as estatísticas e, se solicitado, reinicia a contagem
+void frame_scheduler_get_stats(frame_scheduler_t *scheduler, frame_stats_t *stats, bool reset) {
+    *stats = scheduler->stats;
+    if (reset) {
+        frame_stats_reset(&scheduler->stats);
+    }
+}
@@ -0,0 +1,39 @@
+#include "include/galton_physics.h" // Declarações do modelo físico da Galton Board
+
+// Este arquivo não depende do SDK do Pico, podendo ser compilado e testado diretamente no computador (ver tests/teste_galton_tilt.c)
+
+// Reinicia o filtro passa-baixa da inclinação
+void galton_tilt_filter_reset(galton_tilt_filter_t *filter) {
+    filter->state = 0;
+    filter->primed = false;
+}
+
+// Média móvel exponencial: y += (x - y) / 2^shift, mantendo y escalado para não perder resolução nas divisões inteiras
+int32_t galton_tilt_filter_update(galton_tilt_filter_t *filter, int32_t lateral_mg) {
+    if (!filter->primed) { // A primeira amostra inicializa o filtro diretamente, evitando a rampa a partir de zero
+        filter->state = lateral_mg * (1 << GALTON_TILT_FILTER_SHIFT);
+        filter->primed = true;
+    } else {
+        filter->state += lateral_mg - (filter->state >> GALTON_TILT_FILTER_SHIFT);
+    }
+    return filter->state >> GALTON_TILT_FILTER_SHIFT;
+}
+
+// Modelo da bola em um plano inclinado: a componente lateral da gravidade (g * sen(ângulo)) empurra a bola para um dos lados a cada pino
+// Com a placa nivelada a probabilidade é 50%, e cada 1 g de aceleração lateral desloca a probabilidade em 50 pontos percentuais:
+// p = 0,5 + 0,5 * a_lateral / 1 g, limitada ao intervalo [GALTON_PROB_MIN, GALTON_PROB_MAX]
+uint32_t galton_tilt_probability(int32_t lateral_mg) {
+    int32_t probability = (int32_t)GALTON_PROB_HALF + (lateral_mg * (int32_t)GALTON_PROB_HALF) / 1000;
+
+    if (probability < (int32_t)GALTON_PROB_MIN) {
+        probability = GALTON_PROB_MIN;
+    } else if (probability > (int32_t)GALTON_PROB_MAX) {
+        probability = GALTON_PROB_MAX;
+    }
+    return (uint32_t)probability;
+}
+
+// Compara os 16 bits mais significativos do número aleatório com a probabilidade Q16 (os bits altos do gerador são os de melhor qualidade)
+uint8_t galton_bounce(uint32_t probability, uint32_t random_32) {
+    return (random_32 >> 16) < probability ? 1 : 0;
+}
@@ -0,0 +1,108 @@
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "hardware/i2c.h" // Biblioteca para comunicação I2C (inclui o acesso direto aos registradores do bloco I2C)
+#include "include/imu_tilt.h" // Declarações do leitor de inclinação
+#include "include/galton_physics.h" // Filtro passa-baixa da inclinação
+
+#define IMU_I2C i2c0 // Barramento I2C do MPU6050 (o display OLED usa o i2c1, então os dois nunca disputam o barramento)
+#define IMU_ADDRESS 0x68 // Endereço I2C do MPU6050
+#define IMU_REG_CONFIG 0x1A // Registrador de configuração do filtro passa-baixa digital (DLPF)
+#define IMU_REG_ACCEL_XOUT_H 0x3B // Primeiro registrador de aceleração (X, Y e Z ocupam 0x3B a 0x40)
+#define IMU_REG_PWR_MGMT_1 0x6B // Registrador de gerenciamento de energia
+#define IMU_ACCEL_BYTES 6 // Quantidade de bytes lidos em cada amostra (3 eixos de 16 bits)
+
+static repeating_timer_t imu_timer; // Temporizador responsável pela amostragem periódica
+static galton_tilt_filter_t tilt_filter; // Filtro passa-baixa da aceleração lateral
+static volatile int32_t lateral_mg = 0; // Última aceleração lateral filtrada (escrita na interrupção do temporizador, lida no laço principal)
+static volatile uint32_t sample_count = 0; // Número de amostras lidas com sucesso
+static volatile uint32_t error_count = 0; // Número de transferências abortadas
+static bool transfer_pending = false; // Indica que existe uma leitura em andamento no barramento
+
+// Escreve um registrador do MPU6050 (usado apenas na inicialização, onde o bloqueio não é um problema)
+static void imu_write_register(uint8_t reg, uint8_t value) {
+    uint8_t buf[] = {reg, value};
+    i2c_write_blocking(IMU_I2C, IMU_ADDRESS, buf, 2, false);
+}
+
+// Enfileira uma leitura completa (endereço do registrador + 6 leituras) diretamente no FIFO de transmissão do I2C
+// O hardware executa a transferência sozinho: a CPU não espera pelo barramento, e os bytes são recolhidos na próxima chamada do temporizador
+static void imu_start_read() {
+    i2c_hw_t *hw = i2c_get_hw(IMU_I2C);
+
+    hw->enable = 0; // O endereço do escravo só pode ser alterado com o bloco I2C desabilitado
+    hw->tar = IMU_ADDRESS;
+    hw->enable = 1;
+
+    hw->data_cmd = IMU_REG_ACCEL_XOUT_H; // Escrita do registrador inicial (sem STOP, a leitura vem em seguida com RESTART)
+
+    for (int i = 0; i < IMU_ACCEL_BYTES; i++) {
+        hw->data_cmd = I2C_IC_DATA_CMD_CMD_BITS | // Comando de leitura
+                       (i == 0 ? I2C_IC_DATA_CMD_RESTART_BITS : 0) | // RESTART antes do primeiro byte lido
+                       (i == IMU_ACCEL_BYTES - 1 ? I2C_IC_DATA_CMD_STOP_BITS : 0); // STOP após o último byte
+    }
+    transfer_pending = true;
+}
+
+// Recolhe os bytes da leitura anterior (se já estiverem disponíveis) e enfileira a próxima
+static bool imu_timer_callback(repeating_timer_t *t) {
+    i2c_hw_t *hw = i2c_get_hw(IMU_I2C);
+
+    if (transfer_pending) {
+        if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) { // Transferência abortada (NACK), o FIFO é descartado pelo hardware
+            (void)hw->clr_tx_abrt; // A leitura do registrador limpa a condição de abort
+            error_count++;
+            transfer_pending = false;
+        } else if (hw->rxflr < IMU_ACCEL_BYTES) { // A leitura ainda não terminou: tenta novamente no próximo disparo
+            return true;
+        } else {
+            uint8_t buffer[IMU_ACCEL_BYTES];
+            for (int i = 0; i < IMU_ACCEL_BYTES; i++) {
+                buffer[i] = (uint8_t)hw->data_cmd;
+            }
+
+            int16_t raw = (int16_t)(buffer[IMU_TILT_AXIS * 2] << 8 | buffer[IMU_TILT_AXIS * 2 + 1]);
+            int32_t sample_mg = (IMU_TILT_SIGN * (int32_t)raw * 125) / 2048; // Escala de ±2 g: 16384 LSB/g, ou seja, mg = raw * 1000 / 16384
+
+            lateral_mg = galton_tilt_filter_update(&tilt_filter, sample_mg);
+            sample_count++;
+            transfer_pending = false;
+        }
+    }
+
+    imu_start_read();
+    return true; // Mantém o temporizador ativo
+}
+
+// Configura o barramento, acorda o MPU6050 e inicia a amostragem periódica
+void imu_tilt_init(uint sample_rate_hz) {
+    i2c_init(IMU_I2C, 400 * 1000); // Inicializa o i2c0 em 400 kHz
+    gpio_set_function(IMU_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(IMU_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(IMU_SDA);
+    gpio_pull_up(IMU_SCL);
+
+    imu_write_register(IMU_REG_PWR_MGMT_1, 0x80); // Reset do dispositivo
+    sleep_ms(100);
+    imu_write_register(IMU_REG_PWR_MGMT_1, 0x00); // Sai do modo de baixo consumo
+    sleep_ms(10);
+    imu_write_register(IMU_REG_CONFIG, 0x03); // DLPF em 44 Hz, eliminando a vibração do choque das bolas antes da amostragem
+
+    galton_tilt_filter_reset(&tilt_filter);
+
+    // Intervalo negativo: o temporizador dispara em taxa fixa, independente do tempo gasto dentro da callback
+    add_repeating_timer_us(-(int64_t)(1000000 / sample_rate_hz), imu_timer_callback, NULL, &imu_timer);
+}
+
+// Retorna a última aceleração lateral filtrada, em mg
+int32_t imu_tilt_lateral_mg() {
+    return lateral_mg;
+}
+
+// Retorna o número de amostras lidas com sucesso
+uint32_t imu_tilt_sample_count() {
+    return sample_count;
+}
+
+// Retorna o número de transferências abortadas
+uint32_t imu_tilt_error_count() {
+    return error_count;
+}
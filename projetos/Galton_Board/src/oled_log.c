@@ -0,0 +1,82 @@
+#include <string.h> // Para memset() e strncpy()
+#include "include/ssd1306.h" // Biblioteca para controle do display OLED
+#include "include/oled_log.h" // Declarações da visualização de log
+
+// Apaga uma página do buffer, escreve o texto (truncado em OLED_LOG_LINE_CHARS) e envia somente essa página ao display
+static void oled_log_write_page(oled_log_t *log, uint8_t page, const char *text) {
+    char line[OLED_LOG_LINE_CHARS + 1];
+    strncpy(line, text, OLED_LOG_LINE_CHARS);
+    line[OLED_LOG_LINE_CHARS] = '\0';
+
+    memset(log->ssd + page * ssd1306_width, 0, ssd1306_width);
+    ssd1306_draw_string(log->ssd, 0, page * ssd1306_page_height, line);
+    render_page(log->ssd, page);
+}
+
+// Conclui imediatamente uma rolagem suave em andamento (usado quando uma nova linha chega antes do fim da animação)
+static void oled_log_finish_scroll(oled_log_t *log) {
+    if (!log->has_pending) {
+        return;
+    }
+    log->start_line = log->target_line;
+    ssd1306_set_start_line(log->start_line);
+    oled_log_write_page(log, (log->top_page + ssd1306_n_pages - 1) % ssd1306_n_pages, log->pending);
+    log->has_pending = false;
+}
+
+// Limpa a tela e prepara o log, com a linha inicial do display voltando a 0
+void oled_log_init(oled_log_t *log, uint8_t *ssd, bool smooth) {
+    memset(log, 0, sizeof(*log));
+    log->ssd = ssd;
+    log->smooth = smooth;
+
+    ssd1306_set_start_line(0);
+    for (uint8_t page = 0; page < ssd1306_n_pages; page++) {
+        oled_log_write_page(log, page, "");
+    }
+}
+
+// Acrescenta uma linha no fim do log
+void oled_log_push(oled_log_t *log, const char *text) {
+    if (log->lines_used < ssd1306_n_pages) { // Tela ainda não está cheia: basta escrever na próxima página livre
+        oled_log_write_page(log, log->lines_used++, text);
+        return;
+    }
+
+    oled_log_finish_scroll(log);
+
+    // A página do topo sai da tela e é reaproveitada como última linha (a RAM do display funciona como um buffer circular)
+    uint8_t recycled = log->top_page;
+    log->top_page = (log->top_page + 1) % ssd1306_n_pages;
+    log->target_line = log->top_page * ssd1306_page_height;
+
+    if (!log->smooth) {
+        oled_log_write_page(log, recycled, text);
+        log->start_line = log->target_line;
+        ssd1306_set_start_line(log->start_line);
+        return;
+    }
+
+    // Rolagem suave: a página reaproveitada é apagada antes de rolar (para o texto novo não aparecer no topo enquanto ela sai da tela)
+    // e o texto só é desenhado quando a rolagem termina
+    oled_log_write_page(log, recycled, "");
+    strncpy(log->pending, text, OLED_LOG_LINE_CHARS);
+    log->pending[OLED_LOG_LINE_CHARS] = '\0';
+    log->has_pending = true;
+}
+
+// Avança a rolagem suave em 1 pixel (um único byte de comando pelo I2C)
+bool oled_log_update(oled_log_t *log) {
+    if (!log->has_pending) {
+        return false;
+    }
+
+    log->start_line = (log->start_line + 1) % ssd1306_height;
+    ssd1306_set_start_line(log->start_line);
+
+    if (log->start_line == log->target_line) {
+        oled_log_finish_scroll(log);
+        return false;
+    }
+    return true;
+}
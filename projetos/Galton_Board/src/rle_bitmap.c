@@ -0,0 +1,94 @@
+#include <string.h> // Para memset() e memcpy()
+#include "include/ssd1306_i2c.h" // Dimensões do display (ssd1306_width, ssd1306_n_pages)
+#include "include/rle_bitmap.h" // Declarações do decodificador RLE
+
+// Estado da escrita no buffer: posição atual dentro do bitmap e deslocamento vertical em relação às páginas do display
+typedef struct {
+    uint8_t *ssd; // Buffer do display
+    int x; // Coluna do display onde o bitmap começa
+    int page; // Página do display onde o bitmap começa
+    int shift; // Deslocamento vertical dentro da página (y % 8)
+    int width; // Largura do bitmap
+    int column; // Coluna atual dentro do bitmap
+    int row; // Página atual dentro do bitmap
+} rle_cursor_t;
+
+// Grava um byte descomprimido (8 pixels verticais) na posição atual e avança o cursor
+static inline void rle_put(rle_cursor_t *cursor, uint8_t byte) {
+    int x = cursor->x + cursor->column;
+    int page = cursor->page + cursor->row;
+
+    if (x >= 0 && x < ssd1306_width) {
+        if (cursor->shift == 0) {
+            if (page >= 0 && page < ssd1306_n_pages) {
+                cursor->ssd[page * ssd1306_width + x] = byte;
+            }
+        } else { // Bitmap desalinhado das páginas: cada byte ocupa a parte de baixo de uma página e a parte de cima da seguinte
+            if (page >= 0 && page < ssd1306_n_pages) {
+                cursor->ssd[page * ssd1306_width + x] |= (uint8_t)(byte << cursor->shift);
+            }
+            if (page + 1 >= 0 && page + 1 < ssd1306_n_pages) {
+                cursor->ssd[(page + 1) * ssd1306_width + x] |= (uint8_t)(byte >> (8 - cursor->shift));
+            }
+        }
+    }
+
+    if (++cursor->column == cursor->width) {
+        cursor->column = 0;
+        cursor->row++;
+    }
+}
+
+// Descomprime o bitmap diretamente no buffer do display, com o canto superior esquerdo em (x, y)
+void rle_bitmap_draw(uint8_t *ssd, const uint8_t *asset, int x, int y) {
+    rle_cursor_t cursor = {
+        .ssd = ssd,
+        .x = x,
+        .page = y >> 3, // Deslocamento aritmético: arredonda para baixo também com y negativo
+        .shift = y & 7,
+        .width = rle_bitmap_width(asset),
+    };
+    int total = rle_bitmap_width(asset) * (rle_bitmap_height(asset) / 8); // Número de bytes do bitmap descomprimido
+    const uint8_t *src = asset + 2;
+
+    // Caso mais comum (tela cheia, alinhada às páginas): a área de destino é contínua no buffer, então cada bloco vira um único memset/memcpy
+    if (x == 0 && cursor.shift == 0 && cursor.width == ssd1306_width && cursor.page >= 0 &&
+        cursor.page + rle_bitmap_height(asset) / 8 <= ssd1306_n_pages) {
+        uint8_t *dst = ssd + cursor.page * ssd1306_width;
+        while (total > 0) {
+            uint8_t control = *src++;
+            int count = (control & 0x80) ? (control & 0x7F) + 2 : control + 1;
+            if (count > total) count = total;
+            if (control & 0x80) {
+                memset(dst, *src++, count);
+            } else {
+                memcpy(dst, src, count);
+                src += control + 1;
+            }
+            dst += count;
+            total -= count;
+        }
+        return;
+    }
+
+    while (total > 0) {
+        uint8_t control = *src++;
+
+        if (control & 0x80) { // Repetição: um único byte lido da flash gera vários bytes no buffer
+            int count = (control & 0x7F) + 2;
+            uint8_t value = *src++;
+            if (count > total) count = total;
+            total -= count;
+            while (count--) {
+                rle_put(&cursor, value);
+            }
+        } else { // Bloco literal
+            int count = control + 1;
+            if (count > total) count = total;
+            total -= count;
+            while (count--) {
+                rle_put(&cursor, *src++);
+            }
+        }
+    }
+}
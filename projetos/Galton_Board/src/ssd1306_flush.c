@@ -0,0 +1,243 @@
+#include <string.h> // Para memset()
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "hardware/i2c.h" // Acesso direto aos registradores do bloco I2C
+#include "hardware/dma.h" // Canais de DMA que alimentam o FIFO de transmissão do I2C
+#include "hardware/irq.h" // Interrupções dos blocos I2C
+#include "include/ssd1306_flush.h" // Declarações do agendador de envios
+
+// Cada envio é uma sequência de palavras escritas no registrador IC_DATA_CMD: os 8 bits de dado e, na última palavra de cada transação, o bit de STOP
+// Transação 1: 0x00 (controle: só comandos) + endereçamento de colunas e páginas; transação 2: 0x40 (controle: só dados) + 1024 bytes do buffer
+// Depois de um STOP, a próxima palavra no FIFO inicia sozinha uma nova transação para o mesmo endereço, então o DMA envia as duas sem intervenção da CPU
+
+typedef enum { // Situação do envio de um display
+    FLUSH_IDLE, // Nenhum envio pendente: o buffer de palavras pode ser reescrito
+    FLUSH_QUEUED, // Aguardando o barramento (outro display do mesmo barramento está enviando)
+    FLUSH_SENDING, // DMA e barramento ocupados com este display
+} flush_state_t;
+
+typedef struct { // Display registrado
+    ssd1306_t *display; // Handle do display (barramento e endereço)
+    uint bus; // Índice do barramento (0 = i2c0, 1 = i2c1)
+    volatile flush_state_t state; // Situação do envio
+    uint32_t start_us; // Instante de início do envio em andamento
+    ssd1306_flush_stats_t stats; // Estatísticas acumuladas
+    uint16_t words[SSD1306_FLUSH_WORDS]; // Sequência completa escrita pelo DMA (cópia do buffer: o programa pode desenhar o próximo frame durante o envio)
+} flush_slot_t;
+
+typedef struct { // Barramento I2C
+    i2c_inst_t *i2c; // Instância do SDK (NULL enquanto nenhum display usa o barramento)
+    int dma_channel; // Canal de DMA exclusivo do barramento
+    volatile int current; // Display enviando neste barramento (-1 se livre)
+    int last; // Último display atendido, para revezar os displays do mesmo barramento
+} flush_bus_t;
+
+static flush_slot_t slots[SSD1306_FLUSH_MAX_DISPLAYS]; // Displays registrados
+static int slot_count = 0; // Número de displays registrados
+static flush_bus_t buses[2] = {{NULL, -1, -1, -1}, {NULL, -1, -1, -1}}; // i2c0 e i2c1: os dois barramentos transmitem em paralelo
+
+// Procura o registro de um display
+static flush_slot_t *flush_find(ssd1306_t *display) {
+    for (int i = 0; i < slot_count; i++) {
+        if (slots[i].display == display) {
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+// Inicia o envio de um display (barramento livre, chamada com as interrupções desabilitadas ou dentro da interrupção do I2C)
+static void flush_start(flush_bus_t *bus, int index) {
+    flush_slot_t *slot = &slots[index];
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+
+    hw->enable = 0; // O endereço do escravo só pode ser alterado com o bloco I2C desabilitado
+    hw->tar = slot->display->address;
+    hw->enable = 1;
+
+    (void)hw->clr_stop_det; // Descarta STOPs de transações anteriores (por exemplo, das funções bloqueantes)
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+
+    bus->current = index;
+    bus->last = index;
+    slot->state = FLUSH_SENDING;
+    slot->start_us = time_us_32();
+
+    dma_channel_set_read_addr(bus->dma_channel, slot->words, false);
+    dma_channel_set_trans_count(bus->dma_channel, SSD1306_FLUSH_WORDS, true); // Dispara o DMA, que segue o ritmo do FIFO pelo DREQ do I2C
+}
+
+// Procura, a partir do último atendido, o próximo display do barramento com envio agendado (revezamento entre 0x3C e 0x3D)
+static void flush_start_next(flush_bus_t *bus, uint bus_index) {
+    for (int n = 1; n <= slot_count; n++) {
+        int index = (bus->last + n + slot_count) % slot_count;
+        if (slots[index].bus == bus_index && slots[index].state == FLUSH_QUEUED) {
+            flush_start(bus, index);
+            return;
+        }
+    }
+    i2c_get_hw(bus->i2c)->intr_mask = 0; // Barramento ocioso: as funções bloqueantes voltam a usá-lo sem gerar interrupções
+}
+
+// Interrupção do I2C: STOP detectado ou transferência abortada
+static void flush_irq(uint bus_index) {
+    flush_bus_t *bus = &buses[bus_index];
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+
+    if (bus->current < 0) { // Nenhum envio deste módulo em andamento
+        (void)hw->clr_stop_det;
+        hw->intr_mask = 0;
+        return;
+    }
+
+    flush_slot_t *slot = &slots[bus->current];
+
+    if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+        dma_channel_abort(bus->dma_channel); // Interrompe o DMA antes de liberar o FIFO, para que o restante do frame não inicie outra transação
+        (void)hw->clr_tx_abrt;
+        (void)hw->clr_stop_det;
+        slot->stats.aborts++;
+    } else {
+        (void)hw->clr_stop_det;
+        // O primeiro STOP (fim dos comandos) chega com o DMA ainda ocupado; o envio só termina no STOP do último byte de dados
+        if (dma_channel_is_busy(bus->dma_channel) || !(hw->status & I2C_IC_STATUS_TFE_BITS)) {
+            return;
+        }
+        uint32_t elapsed = time_us_32() - slot->start_us;
+        slot->stats.flushes++;
+        slot->stats.last_us = elapsed;
+        if (elapsed > slot->stats.max_us) slot->stats.max_us = elapsed;
+    }
+
+    slot->state = FLUSH_IDLE;
+    bus->current = -1;
+    flush_start_next(bus, bus_index);
+}
+
+static void flush_i2c0_irq() {
+    flush_irq(0);
+}
+
+static void flush_i2c1_irq() {
+    flush_irq(1);
+}
+
+// Prepara o barramento no primeiro display registrado: canal de DMA com DREQ do I2C e interrupção de STOP/abort
+static bool flush_bus_setup(uint bus_index, i2c_inst_t *i2c) {
+    flush_bus_t *bus = &buses[bus_index];
+    if (bus->i2c) {
+        return true;
+    }
+
+    int channel = dma_claim_unused_channel(false);
+    if (channel < 0) {
+        return false;
+    }
+
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS; // Habilita o DREQ de transmissão (i2c_init já o habilita; repetido por clareza)
+    hw->intr_mask = 0;
+
+    dma_channel_config config = dma_channel_get_default_config(channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16); // IC_DATA_CMD usa 11 bits: dado, comando de leitura, STOP e RESTART
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, i2c_get_dreq(i2c, true)); // Uma palavra por vaga no FIFO de transmissão
+    dma_channel_configure(channel, &config, &hw->data_cmd, NULL, 0, false);
+
+    bus->i2c = i2c;
+    bus->dma_channel = channel;
+    bus->current = -1;
+
+    uint irq = I2C0_IRQ + bus_index;
+    irq_set_exclusive_handler(irq, bus_index == 0 ? flush_i2c0_irq : flush_i2c1_irq);
+    irq_set_enabled(irq, true);
+    return true;
+}
+
+// Registra um display e monta a parte fixa da sequência de envio
+int ssd1306_flush_add(ssd1306_t *display) {
+    if (slot_count >= SSD1306_FLUSH_MAX_DISPLAYS) {
+        return -1;
+    }
+
+    uint bus_index = i2c_hw_index(display->i2c_port);
+    if (!flush_bus_setup(bus_index, display->i2c_port)) {
+        return -1;
+    }
+
+    flush_slot_t *slot = &slots[slot_count];
+    memset(slot, 0, sizeof(*slot));
+    slot->display = display;
+    slot->bus = bus_index;
+    slot->state = FLUSH_IDLE;
+
+    const uint16_t header[SSD1306_FLUSH_HEADER_WORDS] = {
+        0x00, // Controle: os bytes seguintes são comandos
+        ssd1306_set_column_address, 0, ssd1306_width - 1,
+        ssd1306_set_page_address, 0, (ssd1306_n_pages - 1) | I2C_IC_DATA_CMD_STOP_BITS, // Fim da transação de comandos
+        0x40, // Controle: os bytes seguintes são dados da RAM do display
+    };
+    memcpy(slot->words, header, sizeof(header));
+
+    return slot_count++;
+}
+
+// Copia o buffer para a sequência do display e agenda o envio (inicia na hora se o barramento estiver livre)
+bool ssd1306_flush_submit(ssd1306_t *display, const uint8_t *framebuffer) {
+    flush_slot_t *slot = flush_find(display);
+    if (!slot) {
+        return false;
+    }
+    if (slot->state != FLUSH_IDLE) { // O DMA ainda lê a sequência anterior
+        slot->stats.rejected++;
+        return false;
+    }
+
+    uint16_t *data = &slot->words[SSD1306_FLUSH_HEADER_WORDS];
+    for (int i = 0; i < ssd1306_buffer_length; i++) {
+        data[i] = framebuffer[i];
+    }
+    data[ssd1306_buffer_length - 1] |= I2C_IC_DATA_CMD_STOP_BITS; // Fim da transação de dados
+
+    flush_bus_t *bus = &buses[slot->bus];
+    uint32_t irq_state = save_and_disable_interrupts(); // A interrupção do I2C também inicia envios ao liberar o barramento
+    slot->state = FLUSH_QUEUED;
+    if (bus->current < 0) {
+        flush_start(bus, (int)(slot - slots));
+    }
+    restore_interrupts(irq_state);
+    return true;
+}
+
+// Indica se o display (ou qualquer display, com NULL) ainda tem envio agendado ou em andamento
+bool ssd1306_flush_busy(ssd1306_t *display) {
+    for (int i = 0; i < slot_count; i++) {
+        if ((display == NULL || slots[i].display == display) && slots[i].state != FLUSH_IDLE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Espera os envios terminarem (a CPU dorme entre as interrupções)
+void ssd1306_flush_wait(ssd1306_t *display) {
+    while (ssd1306_flush_busy(display)) {
+        __wfe();
+    }
+}
+
+// Copia as estatísticas do display e, se solicitado, reinicia a contagem
+void ssd1306_flush_get_stats(ssd1306_t *display, ssd1306_flush_stats_t *stats, bool reset) {
+    flush_slot_t *slot = flush_find(display);
+    if (!slot) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    *stats = slot->stats;
+    if (reset) {
+        memset(&slot->stats, 0, sizeof(slot->stats));
+    }
+    restore_interrupts(irq_state);
+}
@@ -0,0 +1,14 @@
+// Substituto mínimo de hardware/i2c.h: o teste guarda as transações escritas no barramento
+#ifndef MOCK_HARDWARE_I2C_H
+#define MOCK_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+typedef struct i2c_inst i2c_inst_t; // Definido pelo teste, que só compara ponteiros
+extern i2c_inst_t i2c0_inst, i2c1_inst;
+#define i2c0 (&i2c0_inst) // Constantes, como no SDK (usadas em inicializadores estáticos)
+#define i2c1 (&i2c1_inst)
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+#endif
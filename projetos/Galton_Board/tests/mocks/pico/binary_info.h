@@ -0,0 +1,4 @@
+// Substituto vazio de pico/binary_info.h (o driver do SSD1306 só o inclui)
+#ifndef MOCK_PICO_BINARY_INFO_H
+#define MOCK_PICO_BINARY_INFO_H
+#endif
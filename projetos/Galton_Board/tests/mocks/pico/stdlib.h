@@ -0,0 +1,15 @@
+// Substituto mínimo de pico/stdlib.h para compilar o driver do SSD1306 no computador (host)
+#ifndef MOCK_PICO_STDLIB_H
+#define MOCK_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h> // O pico/stdlib.h do SDK também traz o assert()
+
+typedef unsigned int uint;
+
+#define _u(x) x##u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#endif
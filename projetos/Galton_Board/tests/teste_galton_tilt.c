@@ -0,0 +1,104 @@
+// Simulação no computador (host) do modo de física por inclinação da Galton Board
+// Um traçado de inclinação roteirizado é amostrado a 500 Hz, passa pelo mesmo filtro e pelo mesmo modelo de probabilidade usados no firmware,
+// e as bolas soltas em cada trecho do traçado devem formar um histograma com a inclinação esperada
+//
+// Compilação e execução (a partir da pasta projetos/Galton_Board):
+//   gcc -std=c11 -O2 -I. tests/teste_galton_tilt.c src/galton_physics.c -lm -o teste_galton_tilt && ./teste_galton_tilt
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include "include/galton_physics.h"
+
+#define ROWS 5 // Fileiras de pinos (igual a GALTON_ROWS no firmware)
+#define BINS (ROWS + 1) // Compartimentos
+#define BALLS_PER_SEGMENT 20000 // Bolas soltas em cada trecho do traçado
+#define SAMPLES_PER_BALL 4 // Amostras do IMU entre duas bolas consecutivas (500 Hz de amostragem)
+
+typedef struct { // Trecho do traçado de inclinação
+    int32_t lateral_mg; // Aceleração lateral aplicada durante o trecho
+    double expected_p; // Probabilidade esperada de desvio para a direção 1
+} tilt_segment_t;
+
+static const tilt_segment_t trace[] = {
+    {0, 0.50}, // Placa nivelada
+    {200, 0.60}, // Inclinação leve (~11,5°)
+    {-400, 0.30}, // Inclinação para o lado oposto (~23,6°)
+    {700, 0.85}, // Inclinação forte (~44°)
+    {1000, 0.95}, // Placa na vertical: probabilidade limitada em GALTON_PROB_MAX
+};
+
+static uint32_t rng_state = 0x12345678u; // Estado do gerador xorshift32 (substitui o get_rand_32() do firmware)
+
+static uint32_t rand_32() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static int failures = 0;
+
+static void check(int condition, const char *message) {
+    if (!condition) {
+        printf("FALHA: %s\n", message);
+        failures++;
+    }
+}
+
+int main() {
+    galton_tilt_filter_t filter;
+    galton_tilt_filter_reset(&filter);
+
+    for (size_t s = 0; s < sizeof(trace) / sizeof(trace[0]); s++) {
+        uint32_t histogram[BINS] = {0};
+        uint32_t bounces_1 = 0;
+        int32_t filtered = 0;
+
+        // A transição do trecho anterior é descartada: as primeiras amostras apenas acomodam o filtro
+        for (int i = 0; i < 64; i++) {
+            filtered = galton_tilt_filter_update(&filter, trace[s].lateral_mg + (int32_t)(rand_32() % 41) - 20);
+        }
+
+        for (int ball = 0; ball < BALLS_PER_SEGMENT; ball++) {
+            int bin = 0;
+            for (int row = 0; row < ROWS; row++) {
+                // Ruído de ±20 mg nas amostras, como a vibração medida com a placa parada
+                for (int k = 0; k < SAMPLES_PER_BALL; k++) {
+                    filtered = galton_tilt_filter_update(&filter, trace[s].lateral_mg + (int32_t)(rand_32() % 41) - 20);
+                }
+                bin += galton_bounce(galton_tilt_probability(filtered), rand_32());
+            }
+            histogram[bin]++;
+            bounces_1 += bin;
+        }
+
+        double n = (double)BALLS_PER_SEGMENT * ROWS;
+        double p = bounces_1 / n;
+        double sigma = sqrt(trace[s].expected_p * (1.0 - trace[s].expected_p) / n);
+
+        printf("Inclinacao %5ld mg: p = %.4f (esperado %.2f) | histograma:", (long)trace[s].lateral_mg, p, trace[s].expected_p);
+        for (int b = 0; b < BINS; b++) {
+            printf(" %5u", histogram[b]);
+        }
+        printf("\n");
+
+        // A taxa de desvios deve coincidir com a probabilidade esperada (tolerância de 4 desvios padrão mais o erro do ruído)
+        check(fabs(p - trace[s].expected_p) < 4.0 * sigma + 0.005, "taxa de desvio diferente da probabilidade esperada");
+
+        // Cada compartimento deve seguir a distribuição binomial B(ROWS, p)
+        for (int b = 0; b < BINS; b++) {
+            double expected = BALLS_PER_SEGMENT * tgamma(ROWS + 1) / (tgamma(b + 1) * tgamma(ROWS - b + 1)) *
+                              pow(trace[s].expected_p, b) * pow(1.0 - trace[s].expected_p, ROWS - b);
+            check(fabs(histogram[b] - expected) < 5.0 * sqrt(expected + 1.0) + 0.01 * BALLS_PER_SEGMENT, "histograma fora da distribuição binomial");
+        }
+    }
+
+    // Limites do modelo: saturação em 5%/95% e placa nivelada em 50%
+    check(galton_tilt_probability(0) == GALTON_PROB_HALF, "placa nivelada deveria ter probabilidade de 50%");
+    check(galton_tilt_probability(5000) == GALTON_PROB_MAX, "probabilidade deveria saturar em GALTON_PROB_MAX");
+    check(galton_tilt_probability(-5000) == GALTON_PROB_MIN, "probabilidade deveria saturar em GALTON_PROB_MIN");
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
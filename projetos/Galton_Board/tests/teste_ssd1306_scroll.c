@@ -0,0 +1,76 @@
+// Teste no computador (host) dos comandos de rolagem do SSD1306 (include/ssd1306_i2c.c)
+// O barramento I2C é substituído por um registro dos bytes de comando enviados, comparados com a sequência do datasheet
+// (seção 10.1: 0x26/0x27 rolagem horizontal, 0x29/0x2A vertical e horizontal, 0xA3 área vertical, 0x2E/0x2F parar/iniciar)
+//
+// Compilação e execução (a partir da pasta projetos/Galton_Board):
+//   gcc -std=c11 -O2 -Itests/mocks -Iinclude tests/teste_ssd1306_scroll.c include/ssd1306_i2c.c -o teste_ssd1306_scroll && ./teste_ssd1306_scroll
+
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FALHA: %s\n", what);
+        failures++;
+    }
+}
+
+// Barramento simulado: cada comando chega como {0x80, comando}
+struct i2c_inst {
+    int unused;
+};
+i2c_inst_t i2c0_inst, i2c1_inst;
+
+static uint8_t sent[64];
+static size_t sent_count;
+static bool bad_transfer;
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    if (i2c != i2c1 || addr != ssd1306_i2c_address || len != 2 || src[0] != 0x80 || sent_count >= sizeof(sent)) {
+        bad_transfer = true;
+        return -1;
+    }
+    sent[sent_count++] = src[1];
+    return (int)len;
+}
+
+static void check_sent(const uint8_t *expected, size_t count, const char *what) {
+    bool same = !bad_transfer && sent_count == count && memcmp(sent, expected, count) == 0;
+    if (!same) {
+        printf("%s:", what);
+        for (size_t i = 0; i < sent_count; i++) printf(" %02X", sent[i]);
+        printf("\n");
+    }
+    check(same, what);
+    sent_count = 0;
+    bad_transfer = false;
+}
+
+int main(void) {
+    ssd1306_scroll_horizontal(false, 0, 7, ssd1306_scroll_5_frames);
+    check_sent((const uint8_t[]){0x2E, 0x26, 0x00, 0x00, 0x00, 0x07, 0x00, 0xFF, 0x2F}, 9, "rolagem horizontal para a direita");
+
+    ssd1306_scroll_horizontal(true, 2, 5, ssd1306_scroll_2_frames);
+    check_sent((const uint8_t[]){0x2E, 0x27, 0x00, 0x02, 0x07, 0x05, 0x00, 0xFF, 0x2F}, 9, "rolagem horizontal para a esquerda");
+
+    ssd1306_scroll_diagonal(false, 0, 7, ssd1306_scroll_3_frames, 1);
+    check_sent((const uint8_t[]){0x2E, 0x29, 0x00, 0x00, 0x04, 0x07, 0x01, 0x2F}, 8, "rolagem diagonal para a direita");
+
+    ssd1306_scroll_diagonal(true, 1, 6, ssd1306_scroll_64_frames, 63);
+    check_sent((const uint8_t[]){0x2E, 0x2A, 0x00, 0x01, 0x01, 0x06, 0x3F, 0x2F}, 8, "rolagem diagonal para a esquerda");
+
+    ssd1306_scroll_vertical_area(16, 48);
+    check_sent((const uint8_t[]){0xA3, 16, 48}, 3, "area da rolagem vertical");
+
+    ssd1306_scroll_stop();
+    check_sent((const uint8_t[]){0x2E}, 1, "parar a rolagem");
+
+    ssd1306_set_start_line(70); // Só 6 bits: 70 & 0x3F = 6
+    check_sent((const uint8_t[]){0x46}, 1, "linha inicial");
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+"""Conversor de imagens monocromáticas (PNG ou PBM) em bitmaps RLE para o display SSD1306.
+
+A imagem é organizada em páginas (8 linhas por byte, bit 0 no topo), na mesma ordem do
+buffer do display, e comprimida com o formato decodificado por src/rle_bitmap.c:
+
+    byte 0: largura em pixels
+    byte 1: altura em pixels (múltiplo de 8)
+    blocos: c < 0x80  -> c + 1 bytes literais em seguida
+            c >= 0x80 -> o byte seguinte repetido (c & 0x7F) + 2 vezes
+
+Uso:
+    python3 tools/bitmap_rle.py assets/imagem.png include/imagem_rle.h --name imagem
+
+Em imagens com transparência, cada pixel opaco é aceso; nas demais, são acesos os pixels com
+luminância acima de --threshold (padrão 127). --invert inverte o resultado.
+Apenas a biblioteca padrão do Python é necessária.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+RLE_MAX_LITERAL = 128
+RLE_MAX_RUN = 129
+RLE_MIN_RUN = 2
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(data, threshold, invert):
+    """Decodifica PNG não entrelaçado (tons de cinza, RGB, paleta, com ou sem alfa) em uma matriz de bits."""
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("arquivo não é PNG")
+    pos, idat, palette = 8, b"", None
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif kind == b"PLTE":
+            palette = [tuple(chunk[i:i + 3]) for i in range(0, len(chunk), 3)]
+        elif kind == b"IDAT":
+            idat += chunk
+        pos += 12 + length
+    if interlace:
+        raise ValueError("PNG entrelaçado não suportado")
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color]
+    bits_per_pixel = channels * depth
+    stride = (width * bits_per_pixel + 7) // 8
+    bpp = max(1, bits_per_pixel // 8)
+    raw = zlib.decompress(idat)
+
+    rows, previous = [], bytearray(stride)
+    for y in range(height):
+        filter_type = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            left = line[i - bpp] if i >= bpp else 0
+            up = previous[i]
+            up_left = previous[i - bpp] if i >= bpp else 0
+            if filter_type == 1:
+                line[i] = (line[i] + left) & 0xFF
+            elif filter_type == 2:
+                line[i] = (line[i] + up) & 0xFF
+            elif filter_type == 3:
+                line[i] = (line[i] + ((left + up) >> 1)) & 0xFF
+            elif filter_type == 4:
+                line[i] = (line[i] + paeth(left, up, up_left)) & 0xFF
+        rows.append(line)
+        previous = line
+
+    def sample(line, index):
+        bit_offset = index * depth
+        value = (line[bit_offset // 8] >> (8 - depth - bit_offset % 8)) & ((1 << depth) - 1)
+        return value * 255 // ((1 << depth) - 1) if color != 3 else value
+
+    pixels = []
+    for line in rows:
+        out = []
+        for x in range(width):
+            values = [sample(line, x * channels + c) for c in range(channels)]
+            if color == 3:
+                lit = sum(palette[values[0]]) // 3 > threshold
+            elif color == 0:
+                lit = values[0] > threshold
+            elif color == 2:
+                lit = sum(values) // 3 > threshold
+            else:  # Com canal alfa (4 ou 6): a forma é dada pela opacidade
+                lit = values[-1] > 127
+            out.append(int(lit != invert))
+        pixels.append(out)
+    return width, height, pixels
+
+
+def read_pbm(data, invert):
+    """Decodifica PBM ASCII (P1) ou binário (P4). No PBM, 1 é preto; aqui 1 é pixel aceso, então os valores são invertidos."""
+    magic = data[:2]
+    tokens, pos = [], 2
+    while len(tokens) < 2:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        tokens.append(int(data[start:pos]))
+    width, height = tokens
+    pos += 1
+    if magic == b"P4":
+        stride = (width + 7) // 8
+        return width, height, [[int((data[pos + y * stride + x // 8] >> (7 - x % 8) & 1 == 0) != invert)
+                                for x in range(width)] for y in range(height)]
+    if magic == b"P1":
+        bits = [int((c == ord("0")) != invert) for c in data[pos:] if c in b"01"]
+        return width, height, [bits[y * width:(y + 1) * width] for y in range(height)]
+    raise ValueError("PBM deve ser P1 ou P4")
+
+
+def to_pages(width, height, pixels):
+    """Reorganiza os pixels em bytes verticais, página por página (mesmo layout do buffer do SSD1306)."""
+    if height % 8:
+        raise ValueError("a altura deve ser múltiplo de 8")
+    out = bytearray()
+    for page in range(height // 8):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                byte |= pixels[page * 8 + bit][x] << bit
+            out.append(byte)
+    return bytes(out)
+
+
+def rle_encode(data):
+    out, literal, i = bytearray(), bytearray(), 0
+
+    def flush_literal():
+        for start in range(0, len(literal), RLE_MAX_LITERAL):
+            block = literal[start:start + RLE_MAX_LITERAL]
+            out.append(len(block) - 1)
+            out.extend(block)
+        literal.clear()
+
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < RLE_MAX_RUN:
+            run += 1
+        # Uma repetição de 2 bytes só compensa se não interromper um bloco literal
+        if run >= 3 or (run == RLE_MIN_RUN and not literal):
+            flush_literal()
+            out.append(0x80 | (run - RLE_MIN_RUN))
+            out.append(data[i])
+            i += run
+        else:
+            literal.append(data[i])
+            i += 1
+    flush_literal()
+    return bytes(out)
+
+
+def rle_decode(width, height, stream):
+    out, i = bytearray(), 0
+    while len(out) < width * height // 8:
+        c = stream[i]
+        if c & 0x80:
+            out.extend(bytes([stream[i + 1]]) * ((c & 0x7F) + RLE_MIN_RUN))
+            i += 2
+        else:
+            out.extend(stream[i + 1:i + 2 + c])
+            i += c + 2
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="imagem PNG ou PBM")
+    parser.add_argument("output", help="cabeçalho C gerado")
+    parser.add_argument("--name", required=True, help="nome do array no cabeçalho")
+    parser.add_argument("--threshold", type=int, default=127, help="limiar de luminância para acender o pixel")
+    parser.add_argument("--invert", action="store_true", help="inverte os pixels acesos e apagados")
+    args = parser.parse_args()
+
+    data = open(args.input, "rb").read()
+    width, height, pixels = read_pbm(data, args.invert) if data[:1] == b"P" else read_png(data, args.threshold, args.invert)
+    pages = to_pages(width, height, pixels)
+    stream = bytes([width, height]) + rle_encode(pages)
+    assert rle_decode(width, height, stream[2:]) == pages
+
+    guard = args.name.upper() + "_H"
+    with open(args.output, "w") as f:
+        f.write("// Arquivo gerado por tools/bitmap_rle.py a partir de %s - não edite manualmente\n" % args.input)
+        f.write("// %dx%d pixels: %d bytes sem compressão, %d bytes em RLE\n" % (width, height, len(pages), len(stream)))
+        f.write("#ifndef %s\n#define %s\n\n#include <stdint.h>\n\n" % (guard, guard))
+        f.write("static const uint8_t %s[%d] = {\n" % (args.name, len(stream)))
+        for start in range(0, len(stream), 16):
+            f.write("    " + ", ".join("0x%02X" % b for b in stream[start:start + 16]) + ",\n")
+        f.write("};\n\n#endif\n")
+
+    print("%s: %dx%d, %d -> %d bytes (%.1f%%)" % (args.output, width, height, len(pages), len(stream),
+                                                  100.0 * len(stream) / len(pages)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
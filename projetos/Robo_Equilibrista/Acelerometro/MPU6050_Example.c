@@ -3,87 +3,174 @@
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
- 
-static int addr = 0x68;
- 
-static void mpu6050_reset() {
+#include "hardware/structs/systick.h"
+#include "include/mpu6050.h"
+#include "include/mpu6050_fifo.h"
+#include "include/attitude.h"
 
-    uint8_t buf[] = {0x6B, 0x80};
-    i2c_write_blocking(i2c0, addr, buf, 2, false);
-    sleep_ms(100); 
- 
-    
-    buf[1] = 0x00;  
-    i2c_write_blocking(i2c0, addr, buf, 2, false); 
-    sleep_ms(10); 
- }
- 
-static void mpu6050_read_raw(int16_t accel[3], int16_t gyro_raw[3], int16_t *temp) {
- 
-    uint8_t buffer[6];
- 
-    
-    uint8_t val = 0x3B;
-    i2c_write_blocking(i2c0, addr, &val, 1, true);
-    i2c_read_blocking(i2c0, addr, buffer, 6, false);
- 
-    for (int i = 0; i < 3; i++) {
-        accel[i] = (buffer[i * 2] << 8 | buffer[(i * 2) + 1]);
+#define MPU6050_SDA 0
+#define MPU6050_SCL 1
+#define MPU6050_INT_PIN 28 // Pino ligado ao INT do MPU6050 (usado no modo de aquisição por FIFO)
+
+#define IMU_STREAM_MODE 1 // 1: aquisição por FIFO, interrupção de dado pronto e DMA; 0: leitura periódica com impressão de cada amostra
+#define IMU_RATE_HZ 1000 // Taxa de amostragem no modo por FIFO
+#define IMU_BURST 4 // Quadros lidos por transferência DMA (uma leitura a cada 4 ms em 1 kHz)
+#define IMU_CAL_AT_BOOT 1 // 1: mede os desvios na inicialização (sensor parado e nivelado) e grava a correção nos registradores do MPU6050
+
+#define ACCEL_RANGE MPU6050_ACCEL_2G // Fundo de escala do acelerômetro
+#define GYRO_RANGE MPU6050_GYRO_250DPS // Fundo de escala do giroscópio
+#define DLPF_BAND MPU6050_DLPF_44HZ // Banda do filtro passa-baixa digital
+
+#define PITCH_ACCEL_H 0 // Eixo do acelerômetro ao longo do robô (X)
+#define PITCH_ACCEL_V 2 // Eixo do acelerômetro na vertical com o robô em pé (Z)
+#define PITCH_GYRO 1 // Eixo do giroscópio em torno do qual o robô tomba (Y)
+
+// Mede os desvios com leituras a ~1 kHz e grava a correção nos registradores do sensor: as leituras seguintes, inclusive pelo FIFO,
+// já chegam corrigidas, sem nenhuma conta a mais por amostra
+static void calibrate_offsets(mpu6050_t *imu) {
+    mpu6050_cal_t cal;
+    mpu6050_sample_t sample;
+    mpu6050_offsets_t offsets;
+
+    printf("Calibrando os desvios: mantenha o sensor parado e nivelado...\n");
+    mpu6050_cal_reset(&cal);
+    while (1) {
+        sleep_ms(1);
+        if (mpu6050_read(imu, &sample) && mpu6050_cal_add(&cal, imu, &sample, MPU6050_CAL_SAMPLES_DEFAULT)) {
+            break;
+        }
     }
- 
-    val = 0x43;
-    i2c_write_blocking(i2c0, addr, &val, 1, true);
-    i2c_read_blocking(i2c0, addr, buffer, 6, false); 
- 
-    for (int i = 0; i < 3; i++) {
-        gyro_raw[i] = (buffer[i * 2] << 8 | buffer[(i * 2) + 1]);;
+    if (!mpu6050_cal_finish(&cal, imu, &offsets) || !mpu6050_set_offsets(imu, &offsets, true)) {
+        printf("Calibracao falhou: nenhum eixo na vertical ou erro de barramento\n");
+        return;
     }
- 
-    val = 0x41;
-    i2c_write_blocking(i2c0, addr, &val, 1, true);
-    i2c_read_blocking(i2c0, addr, buffer, 2, false); 
- 
-    *temp = buffer[0] << 8 | buffer[1];
- }
+    printf("Desvios: aceleracao %d %d %d | giroscopio %d %d %d (LSB de +-2 g e +-250 graus/s, %lu reinicios por movimento)\n",
+           offsets.accel[0], offsets.accel[1], offsets.accel[2], offsets.gyro[0], offsets.gyro[1], offsets.gyro[2],
+           (unsigned long)cal.restarts);
+}
 
 int main() {
 
     stdio_init_all();
-    float accel_gravity = 16384.f;
-    float gyro_constant = 131.07f;
 
     printf("Hello, MPU6050! Reading raw data from registers...\n");
  
     i2c_init(i2c0, 400 * 1000);
-    gpio_set_function(0, GPIO_FUNC_I2C);
-    gpio_set_function(1, GPIO_FUNC_I2C);
-    gpio_pull_up(0);
-    gpio_pull_up(1);
+    gpio_set_function(MPU6050_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(MPU6050_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(MPU6050_SDA);
+    gpio_pull_up(MPU6050_SCL);
 
-    bi_decl(bi_2pins_with_func(0, 1, GPIO_FUNC_I2C));
- 
-    mpu6050_reset();
+    bi_decl(bi_2pins_with_func(MPU6050_SDA, MPU6050_SCL, GPIO_FUNC_I2C));
  
-    int16_t acceleration[3], gyro_raw[3], temp;
-    float acceleration_g[3], gyro[3];
+    mpu6050_t imu;
+    while (!mpu6050_init(&imu, i2c0, MPU6050_ADDRESS)) {
+        printf("MPU6050 nao encontrado, tentando novamente...\n");
+        sleep_ms(1000);
+    }
+    mpu6050_configure(&imu, ACCEL_RANGE, GYRO_RANGE, DLPF_BAND);
+#if IMU_CAL_AT_BOOT
+    calibrate_offsets(&imu);
+#endif
  
+    mpu6050_sample_t sample;
+
+#if IMU_STREAM_MODE
+    if (!mpu6050_fifo_start(&imu, MPU6050_INT_PIN, IMU_RATE_HZ, IMU_BURST)) {
+        printf("Falha ao configurar o FIFO do MPU6050\n");
+    }
+
+    // Estimativa da inclinação: o primeiro segundo com o robô parado calibra o bias do giroscópio
+    attitude_gyro_cal_t gyro_cal;
+    attitude_complementary_t complementary;
+    attitude_kalman_t kalman;
+    bool calibrated = false;
+    attitude_gyro_cal_reset(&gyro_cal);
+    attitude_complementary_init(&complementary, ATTITUDE_Q16(0.998)); // Constante de tempo de 0,5 s em 1 kHz
+    attitude_kalman_init(&kalman, ATTITUDE_Q24(0.001), ATTITUDE_Q24(0.003), ATTITUDE_Q24(1.0));
+    int32_t angle_complementary = 0, angle_kalman = 0;
+    uint32_t cycles_complementary = 0, cycles_kalman = 0, updates = 0; // Ciclos de clock gastos nas atualizações do último segundo
+
+    systick_hw->rvr = 0x00FFFFFF; // SysTick livre, decrementando a cada ciclo do processador: mede ciclos exatos por atualização
+    systick_hw->csr = 0x5;
+
+    uint32_t received = 0; // Amostras retiradas do buffer circular no último segundo
+    uint32_t max_gap_us = 0; // Maior intervalo entre os instantes de duas amostras consecutivas
+    uint32_t last_timestamp = 0;
+    absolute_time_t next_report = make_timeout_time_ms(1000);
+
     while (1) {
+        mpu6050_fifo_service(); // Ressincroniza o FIFO se houve transbordo ou erro de barramento
+
+        while (mpu6050_fifo_pop(&sample)) {
+            if (received > 0 && sample.timestamp_us - last_timestamp > max_gap_us) {
+                max_gap_us = sample.timestamp_us - last_timestamp;
+            }
+            uint32_t dt_us = received > 0 ? sample.timestamp_us - last_timestamp : 1000000 / IMU_RATE_HZ;
+            last_timestamp = sample.timestamp_us;
+            received++;
+
+            if (!calibrated) {
+                if (attitude_gyro_cal_add(&gyro_cal, sample.gyro_mdps, IMU_RATE_HZ)) {
+                    calibrated = true;
+                    printf("Bias do giroscopio: %ld %ld %ld mdps (%lu reinicios por movimento)\n", (long)gyro_cal.bias_mdps[0],
+                           (long)gyro_cal.bias_mdps[1], (long)gyro_cal.bias_mdps[2], (unsigned long)gyro_cal.restarts);
+                }
+                continue;
+            }
+
+            int32_t accel_angle = attitude_accel_angle(sample.accel_mg[PITCH_ACCEL_H], sample.accel_mg[PITCH_ACCEL_V]);
+            int32_t rate = sample.gyro_mdps[PITCH_GYRO] - gyro_cal.bias_mdps[PITCH_GYRO];
 
-        mpu6050_read_raw(acceleration, gyro_raw, &temp);
+            uint32_t t0 = systick_hw->cvr;
+            angle_complementary = attitude_complementary_update(&complementary, accel_angle, rate, dt_us);
+            uint32_t t1 = systick_hw->cvr;
+            angle_kalman = attitude_kalman_update(&kalman, accel_angle, rate, dt_us);
+            uint32_t t2 = systick_hw->cvr;
+            cycles_complementary += (t0 - t1) & 0x00FFFFFF; // O contador é decrescente e tem 24 bits
+            cycles_kalman += (t1 - t2) & 0x00FFFFFF;
+            updates++;
+        }
 
-        for (int i = 0; i < 3; i++) {
-            acceleration_g[i] = ((acceleration[i])/accel_gravity);
+        if (time_reached(next_report)) { // Um relatório por segundo: taxa efetiva, contadores de perda e a última amostra
+            mpu6050_fifo_stats_t stats;
+            mpu6050_fifo_get_stats(&stats, true);
+            printf("Amostras: %lu/s | maior intervalo: %lu us | pulsos: %lu | perdas buffer/FIFO: %lu/%lu | ressincronizacoes: %lu | erros I2C: %lu | atrasos: %lu | fila max: %lu\n",
+                   (unsigned long)received, (unsigned long)max_gap_us, (unsigned long)stats.interrupts,
+                   (unsigned long)stats.ring_drops, (unsigned long)stats.fifo_drops, (unsigned long)stats.resyncs,
+                   (unsigned long)stats.bus_errors, (unsigned long)stats.late_interrupts, (unsigned long)stats.max_backlog);
+            printf("Acc. X = %.2f g, Y = %.2f g, Z = %.2f g | gyro X = %.2f °/s, Y = %.2f °/s, Z = %.2f °/s\n",
+                   sample.accel_mg[0] / 1000.f, sample.accel_mg[1] / 1000.f, sample.accel_mg[2] / 1000.f,
+                   sample.gyro_mdps[0] / 1000.f, sample.gyro_mdps[1] / 1000.f, sample.gyro_mdps[2] / 1000.f);
+            if (updates > 0) {
+                printf("Inclinacao: complementar %.2f graus, Kalman %.2f graus (bias %.2f graus/s) | ciclos por atualizacao: %lu / %lu\n",
+                       angle_complementary / 65536.f, angle_kalman / 65536.f, kalman.bias / 65536.f,
+                       (unsigned long)(cycles_complementary / updates), (unsigned long)(cycles_kalman / updates));
+            }
+            received = 0;
+            max_gap_us = 0;
+            cycles_complementary = cycles_kalman = updates = 0;
+            next_report = make_timeout_time_ms(1000);
         }
 
-        for (int i = 0; i < 3; i++) {
-            gyro[i] = ((gyro_raw[i])/gyro_constant);
+        sleep_ms(5); // O buffer circular guarda 64 ms de amostras em 1 kHz
+    }
+#else
+    while (1) {
+
+        if (!mpu6050_read(&imu, &sample)) { // Uma única transação de 14 bytes: aceleração, temperatura e giroscópio do mesmo instante
+            printf("Falha na leitura do MPU6050\n");
+            sleep_ms(500);
+            continue;
         }
 
-        //printf("Acc. X = %d, Y = %d, Z = %d\n", acceleration[0], acceleration[1], acceleration[2]);
-        printf("Acc. X = %.2f g, Y = %.2f g, Z = %.2f g\n", acceleration_g[0], acceleration_g[1],(acceleration_g[2] - 0.15f));
-        //printf("gyro_raw. X = %d, Y = %d, Z = %d\n", gyro_raw[0], gyro_raw[1], gyro_raw[2]);
-        printf("gyro X = %.2f °/s, Y = %.2f °/s, Z = %.2f °/s\n", gyro[0], gyro[1], gyro[2]);
+        //printf("Acc. X = %d, Y = %d, Z = %d\n", sample.accel_raw[0], sample.accel_raw[1], sample.accel_raw[2]);
+        printf("Acc. X = %.2f g, Y = %.2f g, Z = %.2f g\n", sample.accel_mg[0] / 1000.f, sample.accel_mg[1] / 1000.f, sample.accel_mg[2] / 1000.f);
+        //printf("gyro_raw. X = %d, Y = %d, Z = %d\n", sample.gyro_raw[0], sample.gyro_raw[1], sample.gyro_raw[2]);
+        printf("gyro X = %.2f °/s, Y = %.2f °/s, Z = %.2f °/s\n", sample.gyro_mdps[0] / 1000.f, sample.gyro_mdps[1] / 1000.f, sample.gyro_mdps[2] / 1000.f);
+        printf("Temp. = %.2f °C\n", sample.temp_centi_c / 100.f);
  
         sleep_ms(500);
     }
-}
\ No newline at end of file
+#endif
+}
@@ -0,0 +1,58 @@
+// Verifica se a macro ATTITUDE_H já foi definida
+#ifndef ATTITUDE_H
+// Define a macro ATTITUDE_H para evitar múltiplas inclusões
+#define ATTITUDE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Estimativa do ângulo de inclinação (pitch) em ponto fixo, sem ponto flutuante (o M0+ não possui FPU)
+// Ângulos e velocidades angulares em Q16: 1° = 65536, 1 °/s = 65536
+// Covariâncias e ganhos do filtro de Kalman em Q24 (1,0 = 16777216), para representar valores pequenos como 0,001 com precisão
+
+#define ATTITUDE_Q16(x) ((int32_t)((x) * 65536.0)) // Converte uma constante para Q16 (em tempo de compilação)
+#define ATTITUDE_Q24(x) ((int32_t)((x) * 16777216.0)) // Converte uma constante para Q24 (em tempo de compilação)
+
+#define ATTITUDE_CAL_MAX_SPREAD_MDPS 3000 // Variação máxima do giroscópio durante a calibração (3 °/s): acima disso o robô foi movido e a média recomeça
+
+// Filtro complementar: integra o giroscópio e corrige a deriva lentamente com o ângulo do acelerômetro
+typedef struct {
+    int32_t angle; // Ângulo estimado (Q16 graus)
+    int32_t alpha; // Peso do giroscópio (Q16, ex.: 0,98)
+    bool primed; // A primeira atualização usa o ângulo do acelerômetro diretamente
+} attitude_complementary_t;
+
+// Filtro de Kalman de dois estados (ângulo e bias do giroscópio)
+typedef struct {
+    int32_t angle; // Ângulo estimado (Q16 graus)
+    int32_t bias; // Bias estimado do giroscópio (Q16 °/s)
+    int32_t p[2][2]; // Covariância do erro (Q24)
+    int32_t q_angle; // Ruído de processo do ângulo (Q24, por segundo)
+    int32_t q_bias; // Ruído de processo do bias (Q24, por segundo)
+    int32_t r_measure; // Ruído de medição do ângulo do acelerômetro (Q24, graus²)
+    bool primed; // A primeira atualização usa o ângulo do acelerômetro diretamente
+} attitude_kalman_t;
+
+// Calibração do bias do giroscópio com o robô parado
+typedef struct {
+    int64_t sum[3]; // Soma das leituras de cada eixo
+    int32_t min[3]; // Menor leitura de cada eixo desde o início da média
+    int32_t max[3]; // Maior leitura de cada eixo desde o início da média
+    uint32_t count; // Leituras acumuladas
+    uint32_t restarts; // Vezes em que a média recomeçou porque o robô se moveu
+    int32_t bias_mdps[3]; // Bias resultante (m°/s), válido quando count atinge o número desejado
+} attitude_gyro_cal_t;
+
+int32_t attitude_atan2(int32_t y, int32_t x); // atan2 em Q16 graus (-180° a 180°), erro máximo de ~0,1°
+int32_t attitude_accel_angle(int32_t horizontal_mg, int32_t vertical_mg); // Inclinação medida pelo acelerômetro: atan2 entre a componente ao longo do robô e a vertical
+
+void attitude_complementary_init(attitude_complementary_t *filter, int32_t alpha_q16); // Configura o filtro complementar
+int32_t attitude_complementary_update(attitude_complementary_t *filter, int32_t accel_angle, int32_t rate_mdps, uint32_t dt_us); // Atualiza com o ângulo do acelerômetro (Q16) e a velocidade angular (m°/s); retorna o ângulo (Q16)
+
+void attitude_kalman_init(attitude_kalman_t *filter, int32_t q_angle_q24, int32_t q_bias_q24, int32_t r_measure_q24); // Configura o filtro de Kalman
+int32_t attitude_kalman_update(attitude_kalman_t *filter, int32_t accel_angle, int32_t rate_mdps, uint32_t dt_us); // Atualiza com o ângulo do acelerômetro (Q16) e a velocidade angular (m°/s); retorna o ângulo (Q16)
+
+void attitude_gyro_cal_reset(attitude_gyro_cal_t *cal); // Reinicia a calibração
+bool attitude_gyro_cal_add(attitude_gyro_cal_t *cal, const int32_t gyro_mdps[3], uint32_t samples); // Acumula uma leitura; retorna true quando "samples" leituras consecutivas sem movimento foram acumuladas (bias em bias_mdps)
+
+#endif // Fim da diretiva de inclusão condicional
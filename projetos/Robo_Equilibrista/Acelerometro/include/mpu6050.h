@@ -0,0 +1,112 @@
+// Verifica se a macro MPU6050_H já foi definida
+#ifndef MPU6050_H
+// Define a macro MPU6050_H para evitar múltiplas inclusões
+#define MPU6050_H
+
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "hardware/i2c.h" // Biblioteca para comunicação I2C
+
+#define MPU6050_ADDRESS 0x68 // Endereço I2C com o pino AD0 em nível baixo (0x69 com AD0 em nível alto)
+#define MPU6050_WHO_AM_I_VALUE 0x68 // Conteúdo esperado do registrador WHO_AM_I
+
+// Registradores usados pelo driver
+#define MPU6050_REG_SMPLRT_DIV 0x19 // Divisor da taxa de amostragem
+#define MPU6050_REG_CONFIG 0x1A // Filtro passa-baixa digital (DLPF)
+#define MPU6050_REG_GYRO_CONFIG 0x1B // Fundo de escala do giroscópio (bits 4:3)
+#define MPU6050_REG_ACCEL_CONFIG 0x1C // Fundo de escala do acelerômetro (bits 4:3)
+#define MPU6050_REG_ACCEL_XOUT_H 0x3B // Início do bloco contínuo aceleração (0x3B) / temperatura (0x41) / giroscópio (0x43 a 0x48)
+#define MPU6050_REG_PWR_MGMT_1 0x6B // Gerenciamento de energia e fonte de clock
+#define MPU6050_REG_WHO_AM_I 0x75 // Identificação do dispositivo
+#define MPU6050_REG_XA_OFFS_H 0x06 // Desvios do acelerômetro X/Y/Z (0x06 a 0x0B): contêm o ajuste de fábrica, em LSB de ±16 g; o bit 0 de cada valor é reservado
+#define MPU6050_REG_XG_OFFS_USRH 0x13 // Desvios do giroscópio X/Y/Z (0x13 a 0x18), em LSB de ±1000 °/s; zerados no reset
+
+#define MPU6050_BURST_BYTES 14 // Aceleração (6) + temperatura (2) + giroscópio (6), lidos em uma única transação
+
+#define MPU6050_CAL_SAMPLES_DEFAULT 4000 // Amostras da calibração (4 s em 1 kHz)
+#define MPU6050_CAL_MAX_ACCEL_SPREAD 1638 // Variação máxima da aceleração durante a calibração (0,1 g em LSB de ±2 g): acima disso o sensor foi movido
+#define MPU6050_CAL_MAX_GYRO_SPREAD 393 // Variação máxima do giroscópio durante a calibração (3 °/s em LSB de ±250 °/s)
+
+// Fundo de escala do acelerômetro (valor do campo AFS_SEL)
+typedef enum {
+    MPU6050_ACCEL_2G = 0, // ±2 g, 16384 LSB/g
+    MPU6050_ACCEL_4G, // ±4 g, 8192 LSB/g
+    MPU6050_ACCEL_8G, // ±8 g, 4096 LSB/g
+    MPU6050_ACCEL_16G, // ±16 g, 2048 LSB/g
+} mpu6050_accel_range_t;
+
+// Fundo de escala do giroscópio (valor do campo FS_SEL)
+typedef enum {
+    MPU6050_GYRO_250DPS = 0, // ±250 °/s, 131 LSB/(°/s)
+    MPU6050_GYRO_500DPS, // ±500 °/s, 65,5 LSB/(°/s)
+    MPU6050_GYRO_1000DPS, // ±1000 °/s, 32,8 LSB/(°/s)
+    MPU6050_GYRO_2000DPS, // ±2000 °/s, 16,4 LSB/(°/s)
+} mpu6050_gyro_range_t;
+
+// Banda do filtro passa-baixa digital (valor do campo DLPF_CFG, banda do acelerômetro)
+typedef enum {
+    MPU6050_DLPF_260HZ = 0, // Sem filtro: giroscópio amostrado a 8 kHz
+    MPU6050_DLPF_184HZ, // A partir daqui o giroscópio é amostrado a 1 kHz
+    MPU6050_DLPF_94HZ,
+    MPU6050_DLPF_44HZ,
+    MPU6050_DLPF_21HZ,
+    MPU6050_DLPF_10HZ,
+    MPU6050_DLPF_5HZ,
+} mpu6050_dlpf_t;
+
+// Desvios (bias) do sensor em LSB dos fundos de escala mais sensíveis (±2 g e ±250 °/s), independentes da configuração atual
+// Na aceleração, o desvio é a leitura parada menos a gravidade esperada no eixo vertical
+typedef struct {
+    int16_t accel[3];
+    int16_t gyro[3];
+} mpu6050_offsets_t;
+
+// Handle de um MPU6050
+typedef struct {
+    i2c_inst_t *i2c; // Barramento I2C
+    uint8_t address; // Endereço I2C
+    mpu6050_accel_range_t accel_range; // Fundo de escala atual do acelerômetro
+    mpu6050_gyro_range_t gyro_range; // Fundo de escala atual do giroscópio
+    mpu6050_dlpf_t dlpf; // Filtro passa-baixa atual
+    mpu6050_offsets_t offsets; // Correção total em vigor
+    mpu6050_offsets_t hw_offsets; // Parte da correção feita pelos registradores de desvio do sensor (arredondada à resolução deles)
+    int16_t accel_trim[3]; // Ajuste de fábrica dos registradores de desvio do acelerômetro, lido na primeira escrita após o reset
+    bool trim_valid;
+    int32_t accel_offset_lsb[3]; // Restante da correção, subtraído na decodificação (LSB do fundo de escala atual)
+    int32_t gyro_offset_lsb[3];
+} mpu6050_t;
+
+// Amostra decodificada: valores brutos e convertidos para unidades inteiras (sem ponto flutuante, o M0+ não possui FPU)
+typedef struct {
+    uint32_t timestamp_us; // Instante da leitura (time_us_32)
+    int16_t accel_raw[3]; // Aceleração bruta X, Y, Z
+    int16_t temp_raw; // Temperatura bruta
+    int16_t gyro_raw[3]; // Velocidade angular bruta X, Y, Z
+    int32_t accel_mg[3]; // Aceleração em mg (1 g = 1000)
+    int32_t gyro_mdps[3]; // Velocidade angular em milésimos de grau por segundo
+    int32_t temp_centi_c; // Temperatura em centésimos de °C
+} mpu6050_sample_t;
+
+// Calibração dos desvios com o sensor parado: médias das leituras, na unidade de mpu6050_offsets_t
+typedef struct {
+    int64_t sum[6]; // Soma de cada eixo (aceleração X/Y/Z, giroscópio X/Y/Z)
+    int32_t min[6]; // Menor leitura de cada eixo desde o início da média
+    int32_t max[6]; // Maior leitura de cada eixo desde o início da média
+    uint32_t count; // Leituras acumuladas
+    uint32_t restarts; // Vezes em que a média recomeçou porque o sensor se moveu
+} mpu6050_cal_t;
+
+bool mpu6050_init(mpu6050_t *dev, i2c_inst_t *i2c, uint8_t address); // Reinicia o sensor, confere o WHO_AM_I e aplica ±2 g, ±250 °/s e DLPF de 44 Hz (o barramento já deve estar inicializado)
+bool mpu6050_configure(mpu6050_t *dev, mpu6050_accel_range_t accel_range, mpu6050_gyro_range_t gyro_range, mpu6050_dlpf_t dlpf); // Altera fundos de escala e filtro
+bool mpu6050_write_register(mpu6050_t *dev, uint8_t reg, uint8_t value); // Escreve um registrador
+bool mpu6050_read_registers(mpu6050_t *dev, uint8_t reg, uint8_t *buffer, size_t length); // Lê registradores consecutivos em uma única transação (escrita do endereço + RESTART + leitura)
+bool mpu6050_read(mpu6050_t *dev, mpu6050_sample_t *sample); // Lê os 14 bytes de 0x3B a 0x48 em uma única transação e decodifica
+void mpu6050_decode(const mpu6050_t *dev, const uint8_t raw[MPU6050_BURST_BYTES], mpu6050_sample_t *sample); // Decodifica um bloco de 14 bytes (big-endian) com os fundos de escala e a correção de desvios do handle
+int32_t mpu6050_accel_lsb_per_g(mpu6050_accel_range_t range); // Sensibilidade do acelerômetro em LSB/g
+int32_t mpu6050_gyro_lsb_per_10dps(mpu6050_gyro_range_t range); // Sensibilidade do giroscópio em LSB por 10 °/s (1310, 655, 328 ou 164)
+
+bool mpu6050_set_offsets(mpu6050_t *dev, const mpu6050_offsets_t *offsets, bool hardware); // Aplica a correção; com "hardware", grava os registradores de desvio (barramento livre, fora do modo FIFO) e o arredondamento fica em software; sem, mantém os registradores e corrige o restante na decodificação
+void mpu6050_cal_reset(mpu6050_cal_t *cal); // Reinicia a calibração
+bool mpu6050_cal_add(mpu6050_cal_t *cal, const mpu6050_t *dev, const mpu6050_sample_t *sample, uint32_t samples); // Acumula uma amostra; retorna true quando "samples" amostras consecutivas sem movimento foram acumuladas
+bool mpu6050_cal_finish(const mpu6050_cal_t *cal, const mpu6050_t *dev, mpu6050_offsets_t *offsets); // Desvios totais (correção atual + resíduo medido); false sem um eixo claramente na vertical
+
+#endif // Fim da diretiva de inclusão condicional
@@ -0,0 +1,42 @@
+// Verifica se a macro MPU6050_FIFO_H já foi definida
+#ifndef MPU6050_FIFO_H
+// Define a macro MPU6050_FIFO_H para evitar múltiplas inclusões
+#define MPU6050_FIFO_H
+
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "include/mpu6050.h" // Handle e decodificação das amostras
+
+#define MPU6050_REG_FIFO_EN 0x23 // Seleção dos dados gravados no FIFO
+#define MPU6050_REG_INT_PIN_CFG 0x37 // Configuração elétrica do pino INT
+#define MPU6050_REG_INT_ENABLE 0x38 // Fontes de interrupção
+#define MPU6050_REG_INT_STATUS 0x3A // Estado das interrupções
+#define MPU6050_REG_USER_CTRL 0x6A // Habilitação e reset do FIFO
+#define MPU6050_REG_FIFO_COUNT_H 0x72 // Bytes armazenados no FIFO (0x72 e 0x73)
+#define MPU6050_REG_FIFO_R_W 0x74 // Leitura do FIFO
+
+#define MPU6050_FIFO_FRAME_BYTES MPU6050_BURST_BYTES // Cada quadro do FIFO tem o mesmo layout do bloco 0x3B..0x48 (aceleração, temperatura, giroscópio)
+#define MPU6050_FIFO_CAPACITY_FRAMES (1024 / MPU6050_FIFO_FRAME_BYTES) // O FIFO de 1 KB do sensor guarda 73 quadros completos
+#define MPU6050_FIFO_MAX_BURST 16 // Máximo de quadros lidos por transferência DMA
+#define MPU6050_FIFO_RING_SIZE 64 // Amostras no buffer circular (potência de 2)
+#define MPU6050_FIFO_BUS_TIMEOUT_US 5000 // Uma leitura DMA mais longa que isso é considerada travada e o FIFO é ressincronizado
+
+// Contadores da aquisição
+typedef struct {
+    uint32_t interrupts; // Pulsos de dado pronto recebidos
+    uint32_t samples; // Amostras gravadas no buffer circular
+    uint32_t ring_drops; // Amostras descartadas porque o consumidor não esvaziou o buffer a tempo
+    uint32_t fifo_drops; // Amostras perdidas em ressincronizações (atraso maior que o FIFO do sensor, erro de barramento)
+    uint32_t resyncs; // Ressincronizações do FIFO
+    uint32_t bus_errors; // Transferências abortadas (NACK) ou travadas
+    uint32_t late_interrupts; // Intervalos entre pulsos maiores que 1,5 período (pulso perdido)
+    uint32_t max_backlog; // Maior número de quadros aguardando leitura no FIFO do sensor
+} mpu6050_fifo_stats_t;
+
+bool mpu6050_fifo_start(mpu6050_t *dev, uint int_pin, uint rate_hz, uint burst); // Configura taxa, FIFO e pino INT e inicia a aquisição (lê "burst" quadros a cada "burst" pulsos); a partir daqui o barramento pertence ao módulo
+void mpu6050_fifo_stop(); // Desabilita a interrupção e espera a transferência em andamento
+bool mpu6050_fifo_pop(mpu6050_sample_t *sample); // Retira a amostra mais antiga do buffer circular (false se vazio); seguro para um único consumidor, mesmo em outro núcleo
+uint mpu6050_fifo_available(); // Amostras aguardando no buffer circular
+void mpu6050_fifo_service(); // Deve ser chamada periodicamente fora de interrupções: detecta transferências travadas e ressincroniza o FIFO quando necessário
+void mpu6050_fifo_get_stats(mpu6050_fifo_stats_t *stats, bool reset); // Copia os contadores (e opcionalmente os reinicia)
+
+#endif // Fim da diretiva de inclusão condicional
@@ -0,0 +1,164 @@
+#include <string.h> // Para memset()
+#include "include/attitude.h" // Declarações do estimador de inclinação
+
+// Todas as multiplicações que podem passar de 32 bits usam intermediários de 64 bits; as divisões por constantes viram multiplicação e deslocamento
+
+#define ONE_Q16 65536 // 1,0 em Q16
+#define ATAN_C1 ATTITUDE_Q16(14.0203) // 0,2447 rad em graus (aproximação polinomial do arco tangente)
+#define ATAN_C2 ATTITUDE_Q16(3.7987) // 0,0663 rad em graus
+
+// m°/s para Q16 °/s: x * 65536 / 1000 = (x * 4294967) >> 16
+static int32_t rate_to_q16(int32_t rate_mdps) {
+    return (int32_t)(((int64_t)rate_mdps * 4294967) >> 16);
+}
+
+// Microssegundos para segundos em Q24: x * 16777216 / 1000000 = (x * 1099512) >> 16
+static int32_t dt_to_q24(uint32_t dt_us) {
+    return (int32_t)(((int64_t)dt_us * 1099512) >> 16);
+}
+
+// Arco tangente de r (Q16, entre 0 e 1) em Q16 graus: atan(x) ≈ 45·x − x·(|x| − 1)·(14,02 + 3,80·|x|), erro máximo de ~0,1°
+static int32_t atan_unit(int32_t r) {
+    int32_t term = (int32_t)(((int64_t)r * (r - ONE_Q16)) >> 16); // x·(x − 1), negativo no intervalo
+    int32_t poly = ATAN_C1 + (int32_t)(((int64_t)ATAN_C2 * r) >> 16);
+    return 45 * r - (int32_t)(((int64_t)term * poly) >> 16);
+}
+
+// atan2 por octantes: a razão entre o menor e o maior módulo fica sempre entre 0 e 1
+int32_t attitude_atan2(int32_t y, int32_t x) {
+    uint32_t ax = x < 0 ? -(uint32_t)x : (uint32_t)x;
+    uint32_t ay = y < 0 ? -(uint32_t)y : (uint32_t)y;
+
+    if (ax == 0 && ay == 0) {
+        return 0;
+    }
+    while (ax > 0x7FFF || ay > 0x7FFF) { // Mantém (menor << 16) em 32 bits, para usar a divisão de 32 bits (divisor por hardware do RP2040)
+        ax >>= 1;
+        ay >>= 1;
+    }
+
+    int32_t angle;
+    if (ax >= ay) {
+        angle = atan_unit((int32_t)((ay << 16) / ax));
+    } else {
+        angle = ATTITUDE_Q16(90) - atan_unit((int32_t)((ax << 16) / ay));
+    }
+
+    if (x < 0) {
+        angle = ATTITUDE_Q16(180) - angle;
+    }
+    return y < 0 ? -angle : angle;
+}
+
+// Inclinação medida pelo acelerômetro (só é confiável com o robô sem aceleração linear)
+int32_t attitude_accel_angle(int32_t horizontal_mg, int32_t vertical_mg) {
+    return attitude_atan2(horizontal_mg, vertical_mg);
+}
+
+// Configura o filtro complementar; alpha = tau / (tau + dt) para uma constante de tempo tau (ex.: 0,998 para 0,5 s em 1 kHz)
+void attitude_complementary_init(attitude_complementary_t *filter, int32_t alpha_q16) {
+    filter->angle = 0;
+    filter->alpha = alpha_q16;
+    filter->primed = false;
+}
+
+// angle = alpha · (angle + rate · dt) + (1 − alpha) · ângulo do acelerômetro
+int32_t attitude_complementary_update(attitude_complementary_t *filter, int32_t accel_angle, int32_t rate_mdps, uint32_t dt_us) {
+    if (!filter->primed) {
+        filter->angle = accel_angle;
+        filter->primed = true;
+        return filter->angle;
+    }
+
+    int32_t gyro_angle = filter->angle + (int32_t)(((int64_t)rate_to_q16(rate_mdps) * dt_to_q24(dt_us)) >> 24);
+    filter->angle = gyro_angle + (int32_t)(((int64_t)(ONE_Q16 - filter->alpha) * (accel_angle - gyro_angle)) >> 16);
+    return filter->angle;
+}
+
+// Configura o filtro de Kalman (ponto de partida: q_angle = 0,001, q_bias = 0,003 e r_measure igual à variância do ângulo do acelerômetro, ~1,0 com o DLPF em 44 Hz)
+void attitude_kalman_init(attitude_kalman_t *filter, int32_t q_angle_q24, int32_t q_bias_q24, int32_t r_measure_q24) {
+    memset(filter, 0, sizeof(*filter));
+    filter->q_angle = q_angle_q24;
+    filter->q_bias = q_bias_q24;
+    filter->r_measure = r_measure_q24;
+}
+
+// Predição com o giroscópio (sem o bias estimado) e correção com o ângulo do acelerômetro
+int32_t attitude_kalman_update(attitude_kalman_t *filter, int32_t accel_angle, int32_t rate_mdps, uint32_t dt_us) {
+    if (!filter->primed) {
+        filter->angle = accel_angle;
+        filter->primed = true;
+        return filter->angle;
+    }
+
+    int32_t dt = dt_to_q24(dt_us);
+    int32_t (*p)[2] = filter->p;
+
+    // Predição do estado: angle += dt · (rate − bias)
+    int32_t rate = rate_to_q16(rate_mdps) - filter->bias;
+    filter->angle += (int32_t)(((int64_t)rate * dt) >> 24);
+
+    // Predição da covariância: P = F·P·Fᵀ + Q·dt
+    int32_t dt_p11 = (int32_t)(((int64_t)dt * p[1][1]) >> 24);
+    p[0][0] += (int32_t)(((int64_t)dt * (dt_p11 - p[0][1] - p[1][0] + filter->q_angle)) >> 24);
+    p[0][1] -= dt_p11;
+    p[1][0] -= dt_p11;
+    p[1][1] += (int32_t)(((int64_t)filter->q_bias * dt) >> 24);
+
+    // Ganho: K = P·Hᵀ / (H·P·Hᵀ + R), com H = [1 0]
+    int32_t s = p[0][0] + filter->r_measure;
+    int32_t k0 = (int32_t)(((int64_t)p[0][0] << 24) / s);
+    int32_t k1 = (int32_t)(((int64_t)p[1][0] << 24) / s);
+
+    // Correção do estado com a inovação (ângulo do acelerômetro menos o ângulo previsto)
+    int32_t innovation = accel_angle - filter->angle;
+    filter->angle += (int32_t)(((int64_t)k0 * innovation) >> 24);
+    filter->bias += (int32_t)(((int64_t)k1 * innovation) >> 24);
+
+    // Correção da covariância: P = (I − K·H)·P
+    int32_t p00 = p[0][0];
+    int32_t p01 = p[0][1];
+    p[0][0] -= (int32_t)(((int64_t)k0 * p00) >> 24);
+    p[0][1] -= (int32_t)(((int64_t)k0 * p01) >> 24);
+    p[1][0] -= (int32_t)(((int64_t)k1 * p00) >> 24);
+    p[1][1] -= (int32_t)(((int64_t)k1 * p01) >> 24);
+
+    return filter->angle;
+}
+
+// Reinicia a calibração
+void attitude_gyro_cal_reset(attitude_gyro_cal_t *cal) {
+    memset(cal, 0, sizeof(*cal));
+    for (int i = 0; i < 3; i++) {
+        cal->min[i] = INT32_MAX;
+        cal->max[i] = INT32_MIN;
+    }
+}
+
+// Acumula uma leitura com o robô parado; se a variação passar do limite, o robô foi movido e a média recomeça a partir desta leitura
+bool attitude_gyro_cal_add(attitude_gyro_cal_t *cal, const int32_t gyro_mdps[3], uint32_t samples) {
+    for (int i = 0; i < 3; i++) {
+        int32_t min = gyro_mdps[i] < cal->min[i] ? gyro_mdps[i] : cal->min[i];
+        int32_t max = gyro_mdps[i] > cal->max[i] ? gyro_mdps[i] : cal->max[i];
+        if (max - min > ATTITUDE_CAL_MAX_SPREAD_MDPS) {
+            uint32_t restarts = cal->restarts + 1; // Preservado para diagnóstico
+            attitude_gyro_cal_reset(cal);
+            cal->restarts = restarts;
+            return attitude_gyro_cal_add(cal, gyro_mdps, samples);
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (gyro_mdps[i] < cal->min[i]) cal->min[i] = gyro_mdps[i];
+        if (gyro_mdps[i] > cal->max[i]) cal->max[i] = gyro_mdps[i];
+        cal->sum[i] += gyro_mdps[i];
+    }
+
+    if (++cal->count < samples) {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        cal->bias_mdps[i] = (int32_t)(cal->sum[i] / (int64_t)cal->count);
+    }
+    return true;
+}
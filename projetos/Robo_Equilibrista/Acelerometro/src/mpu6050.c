@@ -0,0 +1,235 @@
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "hardware/i2c.h" // Biblioteca para comunicação I2C
+#include <stdlib.h> // Para abs()
+#include <string.h> // Para memset()
+#include "include/mpu6050.h" // Declarações do driver
+
+static const int32_t gyro_lsb_per_10dps[] = {1310, 655, 328, 164}; // Sensibilidade do giroscópio (datasheet) multiplicada por 10 para ficar inteira
+
+// Sensibilidade do acelerômetro em LSB/g: 16384 dividido por 2 a cada fundo de escala
+int32_t mpu6050_accel_lsb_per_g(mpu6050_accel_range_t range) {
+    return 16384 >> range;
+}
+
+// Sensibilidade do giroscópio em LSB por 10 °/s
+int32_t mpu6050_gyro_lsb_per_10dps(mpu6050_gyro_range_t range) {
+    return gyro_lsb_per_10dps[range];
+}
+
+// Divisão inteira arredondada para o mais próximo (com sinal)
+static int32_t divide_rounded(int64_t value, int64_t divisor) {
+    return (int32_t)(value >= 0 ? (value + divisor / 2) / divisor : -((-value + divisor / 2) / divisor));
+}
+
+static int16_t saturate_16(int32_t value) {
+    return (int16_t)(value > INT16_MAX ? INT16_MAX : (value < INT16_MIN ? INT16_MIN : value));
+}
+
+// Escreve um registrador
+bool mpu6050_write_register(mpu6050_t *dev, uint8_t reg, uint8_t value) {
+    uint8_t buf[] = {reg, value};
+    return i2c_write_blocking(dev->i2c, dev->address, buf, 2, false) == 2;
+}
+
+// Lê registradores consecutivos: o MPU6050 incrementa o endereço a cada byte, então um bloco contíguo custa uma única transação
+bool mpu6050_read_registers(mpu6050_t *dev, uint8_t reg, uint8_t *buffer, size_t length) {
+    if (i2c_write_blocking(dev->i2c, dev->address, &reg, 1, true) != 1) { // Sem STOP: a leitura segue com RESTART
+        return false;
+    }
+    return i2c_read_blocking(dev->i2c, dev->address, buffer, length, false) == (int)length;
+}
+
+// Decodifica o bloco 0x3B..0x48: aceleração, temperatura e giroscópio, todos big-endian e com sinal
+// Os valores brutos ficam como vieram do sensor; a correção dos desvios é uma subtração dentro da conversão que já existe
+void mpu6050_decode(const mpu6050_t *dev, const uint8_t raw[MPU6050_BURST_BYTES], mpu6050_sample_t *sample) {
+    int32_t accel_lsb = mpu6050_accel_lsb_per_g(dev->accel_range);
+    int32_t gyro_lsb = mpu6050_gyro_lsb_per_10dps(dev->gyro_range);
+
+    for (int i = 0; i < 3; i++) {
+        sample->accel_raw[i] = (int16_t)(raw[i * 2] << 8 | raw[i * 2 + 1]);
+        sample->gyro_raw[i] = (int16_t)(raw[8 + i * 2] << 8 | raw[8 + i * 2 + 1]);
+
+        sample->accel_mg[i] = (sample->accel_raw[i] - dev->accel_offset_lsb[i]) * 1000 / accel_lsb;
+        sample->gyro_mdps[i] = (sample->gyro_raw[i] - dev->gyro_offset_lsb[i]) * 10000 / gyro_lsb; // Cabe em 32 bits: 65535 * 10000 < 2^31
+    }
+
+    sample->temp_raw = (int16_t)(raw[6] << 8 | raw[7]);
+    sample->temp_centi_c = sample->temp_raw * 100 / 340 + 3653; // Datasheet: T(°C) = raw / 340 + 36,53
+}
+
+// Lê aceleração, temperatura e giroscópio em uma única transação: os três vêm do mesmo instante de amostragem
+bool mpu6050_read(mpu6050_t *dev, mpu6050_sample_t *sample) {
+    uint8_t raw[MPU6050_BURST_BYTES];
+
+    sample->timestamp_us = time_us_32();
+    if (!mpu6050_read_registers(dev, MPU6050_REG_ACCEL_XOUT_H, raw, sizeof(raw))) {
+        return false;
+    }
+    mpu6050_decode(dev, raw, sample);
+    return true;
+}
+
+// Parte da correção que não está nos registradores do sensor, convertida para o fundo de escala atual
+static void update_software_offsets(mpu6050_t *dev) {
+    int32_t gyro_lsb = mpu6050_gyro_lsb_per_10dps(dev->gyro_range);
+    for (int i = 0; i < 3; i++) {
+        dev->accel_offset_lsb[i] = divide_rounded(dev->offsets.accel[i] - dev->hw_offsets.accel[i], 1 << dev->accel_range);
+        dev->gyro_offset_lsb[i] = divide_rounded((int64_t)(dev->offsets.gyro[i] - dev->hw_offsets.gyro[i]) * gyro_lsb, 1310);
+    }
+}
+
+// Altera fundos de escala e filtro; o handle só é atualizado se as escritas forem confirmadas, para que a decodificação continue coerente com o sensor
+bool mpu6050_configure(mpu6050_t *dev, mpu6050_accel_range_t accel_range, mpu6050_gyro_range_t gyro_range, mpu6050_dlpf_t dlpf) {
+    if (!mpu6050_write_register(dev, MPU6050_REG_CONFIG, dlpf) ||
+        !mpu6050_write_register(dev, MPU6050_REG_GYRO_CONFIG, gyro_range << 3) ||
+        !mpu6050_write_register(dev, MPU6050_REG_ACCEL_CONFIG, accel_range << 3)) {
+        return false;
+    }
+
+    dev->accel_range = accel_range;
+    dev->gyro_range = gyro_range;
+    dev->dlpf = dlpf;
+    update_software_offsets(dev);
+    return true;
+}
+
+// Reinicia o sensor, confere a identificação e aplica a configuração padrão
+bool mpu6050_init(mpu6050_t *dev, i2c_inst_t *i2c, uint8_t address) {
+    dev->i2c = i2c;
+    dev->address = address;
+    dev->accel_range = MPU6050_ACCEL_2G; // Valores após o reset
+    dev->gyro_range = MPU6050_GYRO_250DPS;
+    dev->dlpf = MPU6050_DLPF_260HZ;
+    memset(&dev->offsets, 0, sizeof(dev->offsets)); // O reset também zera os registradores de desvio do giroscópio e restaura o ajuste de fábrica do acelerômetro
+    memset(&dev->hw_offsets, 0, sizeof(dev->hw_offsets));
+    dev->trim_valid = false;
+    update_software_offsets(dev);
+
+    if (!mpu6050_write_register(dev, MPU6050_REG_PWR_MGMT_1, 0x80)) { // Reset do dispositivo
+        return false;
+    }
+    sleep_ms(100);
+    mpu6050_write_register(dev, MPU6050_REG_PWR_MGMT_1, 0x01); // Sai do modo de baixo consumo usando o PLL do giroscópio X como clock (mais estável que o oscilador interno)
+    sleep_ms(10);
+
+    uint8_t who_am_i = 0;
+    if (!mpu6050_read_registers(dev, MPU6050_REG_WHO_AM_I, &who_am_i, 1) || who_am_i != MPU6050_WHO_AM_I_VALUE) {
+        return false;
+    }
+
+    return mpu6050_configure(dev, MPU6050_ACCEL_2G, MPU6050_GYRO_250DPS, MPU6050_DLPF_44HZ);
+}
+
+// Escreve três valores de 16 bits (big-endian) em registradores consecutivos, em uma única transação
+static bool write_triplet(mpu6050_t *dev, uint8_t reg, const int16_t values[3]) {
+    uint8_t buf[7] = {reg};
+    for (int i = 0; i < 3; i++) {
+        buf[1 + i * 2] = (uint8_t)((uint16_t)values[i] >> 8);
+        buf[2 + i * 2] = (uint8_t)values[i];
+    }
+    return i2c_write_blocking(dev->i2c, dev->address, buf, sizeof(buf), false) == (int)sizeof(buf);
+}
+
+// Aplica a correção dos desvios
+// Nos registradores do sensor, a correção não custa nada por amostra, mas só pode ser gravada com o barramento livre; o que não cabe na
+// resolução deles (16 LSB de ±2 g no acelerômetro, com o bit 0 reservado, e 4 LSB de ±250 °/s no giroscópio) fica para a decodificação
+bool mpu6050_set_offsets(mpu6050_t *dev, const mpu6050_offsets_t *offsets, bool hardware) {
+    if (hardware) {
+        if (!dev->trim_valid) { // O ajuste de fábrica é a base dos desvios do acelerômetro
+            uint8_t raw[6];
+            if (!mpu6050_read_registers(dev, MPU6050_REG_XA_OFFS_H, raw, sizeof(raw))) {
+                return false;
+            }
+            for (int i = 0; i < 3; i++) {
+                dev->accel_trim[i] = (int16_t)(raw[i * 2] << 8 | raw[i * 2 + 1]);
+            }
+            dev->trim_valid = true;
+        }
+
+        mpu6050_offsets_t applied;
+        int16_t accel_regs[3], gyro_regs[3];
+        for (int i = 0; i < 3; i++) {
+            int32_t accel_steps = divide_rounded(offsets->accel[i], 16) * 2; // Passos pares de ±16 g: o bit 0 do ajuste de fábrica é preservado
+            accel_regs[i] = saturate_16(dev->accel_trim[i] - accel_steps); // Os registradores somam o valor à leitura
+            applied.accel[i] = (int16_t)((dev->accel_trim[i] - accel_regs[i]) * 8);
+            gyro_regs[i] = saturate_16(-divide_rounded(offsets->gyro[i], 4));
+            applied.gyro[i] = (int16_t)(-gyro_regs[i] * 4);
+        }
+        if (!write_triplet(dev, MPU6050_REG_XA_OFFS_H, accel_regs) || !write_triplet(dev, MPU6050_REG_XG_OFFS_USRH, gyro_regs)) {
+            return false;
+        }
+        dev->hw_offsets = applied;
+    }
+
+    dev->offsets = *offsets;
+    update_software_offsets(dev);
+    return true;
+}
+
+// Reinicia a calibração
+void mpu6050_cal_reset(mpu6050_cal_t *cal) {
+    for (int i = 0; i < 6; i++) {
+        cal->sum[i] = 0;
+        cal->min[i] = INT32_MAX;
+        cal->max[i] = INT32_MIN;
+    }
+    cal->count = 0;
+    cal->restarts = 0;
+}
+
+// Acumula a leitura já corrigida pelos registradores do sensor, sem a correção feita em software, na escala de ±2 g e ±250 °/s
+bool mpu6050_cal_add(mpu6050_cal_t *cal, const mpu6050_t *dev, const mpu6050_sample_t *sample, uint32_t samples) {
+    int32_t gyro_lsb = mpu6050_gyro_lsb_per_10dps(dev->gyro_range);
+    int32_t value[6];
+    for (int i = 0; i < 3; i++) {
+        value[i] = (int32_t)sample->accel_raw[i] * (1 << dev->accel_range);
+        value[3 + i] = divide_rounded((int64_t)sample->gyro_raw[i] * 1310, gyro_lsb);
+    }
+
+    for (int i = 0; i < 6; i++) {
+        int32_t min = value[i] < cal->min[i] ? value[i] : cal->min[i];
+        int32_t max = value[i] > cal->max[i] ? value[i] : cal->max[i];
+        if (max - min > (i < 3 ? MPU6050_CAL_MAX_ACCEL_SPREAD : MPU6050_CAL_MAX_GYRO_SPREAD)) {
+            uint32_t restarts = cal->restarts + 1; // Preservado para diagnóstico
+            mpu6050_cal_reset(cal);
+            cal->restarts = restarts;
+            return mpu6050_cal_add(cal, dev, sample, samples);
+        }
+    }
+
+    for (int i = 0; i < 6; i++) {
+        if (value[i] < cal->min[i]) cal->min[i] = value[i];
+        if (value[i] > cal->max[i]) cal->max[i] = value[i];
+        cal->sum[i] += value[i];
+    }
+    return ++cal->count >= samples;
+}
+
+// O eixo com a maior aceleração média está na vertical e deve medir 1 g; os outros dois, zero
+// A média mede o desvio que ainda resta depois dos registradores do sensor, então o resultado soma a parte já aplicada por eles
+bool mpu6050_cal_finish(const mpu6050_cal_t *cal, const mpu6050_t *dev, mpu6050_offsets_t *offsets) {
+    if (cal->count == 0) {
+        return false;
+    }
+
+    int32_t mean[6];
+    for (int i = 0; i < 6; i++) {
+        mean[i] = divide_rounded(cal->sum[i], cal->count);
+    }
+
+    int vertical = 0;
+    for (int i = 1; i < 3; i++) {
+        if (abs(mean[i]) > abs(mean[vertical])) vertical = i;
+    }
+    int32_t one_g = mpu6050_accel_lsb_per_g(MPU6050_ACCEL_2G);
+    if (abs(mean[vertical]) < one_g / 2) { // Nenhum eixo perto da vertical: sensor inclinado demais ou em queda
+        return false;
+    }
+    mean[vertical] -= mean[vertical] > 0 ? one_g : -one_g;
+
+    for (int i = 0; i < 3; i++) {
+        offsets->accel[i] = saturate_16(dev->hw_offsets.accel[i] + mean[i]);
+        offsets->gyro[i] = saturate_16(dev->hw_offsets.gyro[i] + mean[3 + i]);
+    }
+    return true;
+}
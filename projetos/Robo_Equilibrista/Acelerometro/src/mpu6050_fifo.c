@@ -0,0 +1,297 @@
+#include <string.h> // Para memset()
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "hardware/i2c.h" // Acesso direto aos registradores do bloco I2C
+#include "hardware/dma.h" // Canais de DMA de comando e de recepção
+#include "hardware/irq.h" // Interrupções do GPIO e do DMA
+#include "hardware/sync.h" // Barreiras de memória do buffer circular
+#include "include/mpu6050_fifo.h" // Declarações do modo de aquisição por FIFO
+
+// Funcionamento:
+// - o MPU6050 grava um quadro de 14 bytes no seu FIFO a cada amostra e pulsa o pino INT (dado pronto);
+// - a interrupção do GPIO só registra o instante do pulso; a cada "burst" pulsos, dispara uma leitura de burst * 14 bytes do registrador FIFO_R_W;
+// - a leitura é feita por dois canais de DMA: um escreve no IC_DATA_CMD o endereço do registrador e os comandos de leitura, o outro recolhe os bytes recebidos;
+// - a interrupção do DMA de recepção decodifica os quadros e os grava, com o instante do pulso correspondente, no buffer circular lido pelo programa.
+// Cada quadro do FIFO corresponde a um pulso, na mesma ordem, então o n-ésimo quadro lido recebe o instante do n-ésimo pulso.
+
+#define TIMESTAMP_QUEUE_SIZE 128 // Instantes de pulsos guardados (maior que a capacidade do FIFO do sensor, potência de 2)
+
+static mpu6050_t *imu; // Sensor em aquisição
+static uint int_pin; // Pino ligado ao INT do sensor
+static uint burst_frames; // Quadros lidos por transferência
+static uint32_t period_us; // Período de amostragem configurado
+static int tx_channel = -1; // Canal de DMA que escreve os comandos no IC_DATA_CMD
+static int rx_channel = -1; // Canal de DMA que lê os bytes recebidos
+
+static uint16_t tx_commands[1 + MPU6050_FIFO_MAX_BURST * MPU6050_FIFO_FRAME_BYTES]; // Endereço do FIFO_R_W + um comando de leitura por byte
+static uint8_t rx_buffer[MPU6050_FIFO_MAX_BURST * MPU6050_FIFO_FRAME_BYTES]; // Quadros recebidos na última transferência
+
+static uint32_t timestamps[TIMESTAMP_QUEUE_SIZE]; // Instante de cada pulso, indexado pelo número de sequência do quadro
+static volatile uint32_t irq_sequence = 0; // Quadros sinalizados pelo pino INT
+static volatile uint32_t read_sequence = 0; // Quadros já solicitados ao sensor
+static volatile bool transfer_busy = false; // Existe uma leitura DMA em andamento
+static volatile bool resync_needed = false; // O alinhamento entre pulsos e quadros foi perdido: o FIFO deve ser reiniciado
+static volatile uint32_t transfer_start_us; // Início da leitura em andamento
+static uint32_t last_irq_us; // Instante do último pulso
+
+static mpu6050_sample_t ring[MPU6050_FIFO_RING_SIZE]; // Buffer circular de amostras (produtor: interrupção do DMA; consumidor: programa)
+static volatile uint32_t ring_head = 0; // Próxima posição de escrita (só o produtor altera)
+static volatile uint32_t ring_tail = 0; // Próxima posição de leitura (só o consumidor altera)
+
+static mpu6050_fifo_stats_t stats; // Contadores da aquisição
+
+// Inicia a leitura de burst_frames quadros (chamada dentro das interrupções do GPIO ou do DMA)
+static void fifo_start_transfer(uint32_t now) {
+    i2c_hw_t *hw = i2c_get_hw(imu->i2c);
+
+    read_sequence += burst_frames;
+    transfer_busy = true;
+    transfer_start_us = now;
+
+    (void)hw->clr_tx_abrt;
+    dma_channel_set_write_addr(rx_channel, rx_buffer, false);
+    dma_channel_set_trans_count(rx_channel, burst_frames * MPU6050_FIFO_FRAME_BYTES, true); // A recepção é armada primeiro: ela só avança quando chegam bytes
+    dma_channel_set_read_addr(tx_channel, tx_commands, false);
+    dma_channel_set_trans_count(tx_channel, 1 + burst_frames * MPU6050_FIFO_FRAME_BYTES, true);
+}
+
+// Pulso de dado pronto: registra o instante e dispara a leitura quando houver quadros suficientes
+static void fifo_int_irq() {
+    if (!(gpio_get_irq_event_mask(int_pin) & GPIO_IRQ_EDGE_RISE)) {
+        return; // Evento de outro pino do mesmo banco
+    }
+    gpio_acknowledge_irq(int_pin, GPIO_IRQ_EDGE_RISE);
+
+    uint32_t now = time_us_32();
+    if (stats.interrupts > 0 && now - last_irq_us > period_us + period_us / 2) {
+        stats.late_interrupts++;
+    }
+    last_irq_us = now;
+    stats.interrupts++;
+
+    if (resync_needed) {
+        stats.fifo_drops++; // Quadro descartado pela ressincronização pendente
+        return;
+    }
+
+    timestamps[irq_sequence % TIMESTAMP_QUEUE_SIZE] = now;
+    irq_sequence++;
+
+    uint32_t backlog = irq_sequence - read_sequence;
+    if (backlog > stats.max_backlog) {
+        stats.max_backlog = backlog;
+    }
+    if (backlog > MPU6050_FIFO_CAPACITY_FRAMES) { // O FIFO do sensor transbordou: os quadros perderam o alinhamento de 14 bytes
+        resync_needed = true;
+        return;
+    }
+
+    if (!transfer_busy && backlog >= burst_frames) {
+        fifo_start_transfer(now);
+    }
+}
+
+// Fim da leitura DMA: decodifica os quadros, grava no buffer circular e encadeia a próxima leitura se já houver quadros pendentes
+static void fifo_dma_irq() {
+    if (!dma_channel_get_irq0_status(rx_channel)) {
+        return; // Interrupção de outro canal (o handler é compartilhado)
+    }
+    dma_channel_acknowledge_irq0(rx_channel);
+
+    uint32_t first = read_sequence - burst_frames;
+    for (uint i = 0; i < burst_frames; i++) {
+        uint32_t head = ring_head;
+        if (head - ring_tail >= MPU6050_FIFO_RING_SIZE) {
+            stats.ring_drops++;
+            continue;
+        }
+
+        mpu6050_sample_t *sample = &ring[head % MPU6050_FIFO_RING_SIZE];
+        mpu6050_decode(imu, &rx_buffer[i * MPU6050_FIFO_FRAME_BYTES], sample);
+        sample->timestamp_us = timestamps[(first + i) % TIMESTAMP_QUEUE_SIZE];
+
+        __dmb(); // A amostra fica visível antes do novo índice (o consumidor pode estar no outro núcleo)
+        ring_head = head + 1;
+        stats.samples++;
+    }
+
+    transfer_busy = false;
+    if (!resync_needed && irq_sequence - read_sequence >= burst_frames) {
+        fifo_start_transfer(time_us_32());
+    }
+}
+
+// Reinicia o FIFO do sensor e os contadores de sequência (fora de interrupções: usa as funções bloqueantes do I2C)
+static void fifo_resync() {
+    i2c_hw_t *hw = i2c_get_hw(imu->i2c);
+
+    gpio_set_irq_enabled(int_pin, GPIO_IRQ_EDGE_RISE, false);
+
+    // Errata RP2040-E13: a interrupção do canal é desabilitada durante o abort para não gerar um fim de transferência falso
+    dma_channel_set_irq0_enabled(rx_channel, false);
+    dma_channel_abort(tx_channel);
+    dma_channel_abort(rx_channel);
+    dma_channel_acknowledge_irq0(rx_channel);
+    dma_channel_set_irq0_enabled(rx_channel, true);
+
+    (void)hw->clr_tx_abrt;
+    uint32_t start = time_us_32();
+    while ((!(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS)) &&
+           time_us_32() - start < MPU6050_FIFO_BUS_TIMEOUT_US) {
+        tight_loop_contents(); // Espera o fim de uma transação interrompida
+    }
+    while (i2c_get_read_available(imu->i2c)) {
+        (void)hw->data_cmd; // Descarta bytes que sobraram da leitura abortada
+    }
+
+    mpu6050_write_register(imu, MPU6050_REG_USER_CTRL, 0x04); // FIFO_RESET com FIFO_EN desligado
+    mpu6050_write_register(imu, MPU6050_REG_USER_CTRL, 0x40); // FIFO_EN: os próximos quadros começam alinhados
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    stats.fifo_drops += irq_sequence - (read_sequence - (transfer_busy ? burst_frames : 0)); // Quadros sinalizados que nunca chegaram ao buffer
+    stats.resyncs++;
+    irq_sequence = 0;
+    read_sequence = 0;
+    transfer_busy = false;
+    resync_needed = false;
+    restore_interrupts(irq_state);
+
+    gpio_acknowledge_irq(int_pin, GPIO_IRQ_EDGE_RISE); // Um pulso anterior ao reset não corresponde a nenhum quadro
+    gpio_set_irq_enabled(int_pin, GPIO_IRQ_EDGE_RISE, true);
+}
+
+// Configura o sensor, os canais de DMA e as interrupções e inicia a aquisição
+bool mpu6050_fifo_start(mpu6050_t *dev, uint pin, uint rate_hz, uint burst) {
+    imu = dev;
+    int_pin = pin;
+    burst_frames = burst < 1 ? 1 : (burst > MPU6050_FIFO_MAX_BURST ? MPU6050_FIFO_MAX_BURST : burst);
+
+    // Taxa = taxa interna / (1 + SMPLRT_DIV); a taxa interna é 1 kHz com o DLPF ligado e 8 kHz sem ele
+    uint32_t internal_hz = dev->dlpf == MPU6050_DLPF_260HZ ? 8000 : 1000;
+    uint32_t divider = internal_hz / rate_hz;
+    divider = divider < 1 ? 1 : (divider > 256 ? 256 : divider);
+    period_us = 1000000 * divider / internal_hz;
+
+    if (!mpu6050_write_register(dev, MPU6050_REG_INT_ENABLE, 0x00) || // Interrupção desligada durante a configuração
+        !mpu6050_write_register(dev, MPU6050_REG_USER_CTRL, 0x04) || // FIFO_RESET
+        !mpu6050_write_register(dev, MPU6050_REG_SMPLRT_DIV, divider - 1) ||
+        !mpu6050_write_register(dev, MPU6050_REG_FIFO_EN, 0xF8) || // Temperatura, giroscópio X/Y/Z e acelerômetro: mesmo layout do bloco 0x3B..0x48
+        !mpu6050_write_register(dev, MPU6050_REG_INT_PIN_CFG, 0x10) || // Ativo em nível alto, push-pull, pulso de 50 us, limpo por qualquer leitura
+        !mpu6050_write_register(dev, MPU6050_REG_USER_CTRL, 0x40)) { // FIFO_EN
+        return false;
+    }
+
+    // Sequência fixa de comandos: endereço do FIFO_R_W sem STOP, depois uma leitura por byte (RESTART na primeira, STOP na última)
+    uint count = burst_frames * MPU6050_FIFO_FRAME_BYTES;
+    tx_commands[0] = MPU6050_REG_FIFO_R_W;
+    for (uint i = 0; i < count; i++) {
+        tx_commands[1 + i] = I2C_IC_DATA_CMD_CMD_BITS |
+                             (i == 0 ? I2C_IC_DATA_CMD_RESTART_BITS : 0) |
+                             (i == count - 1 ? I2C_IC_DATA_CMD_STOP_BITS : 0);
+    }
+
+    i2c_hw_t *hw = i2c_get_hw(dev->i2c);
+    hw->enable = 0; // O endereço do escravo só pode ser alterado com o bloco I2C desabilitado
+    hw->tar = dev->address;
+    hw->enable = 1;
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+
+    if (tx_channel < 0) {
+        tx_channel = dma_claim_unused_channel(true);
+        rx_channel = dma_claim_unused_channel(true);
+    }
+
+    dma_channel_config tx_config = dma_channel_get_default_config(tx_channel);
+    channel_config_set_transfer_data_size(&tx_config, DMA_SIZE_16); // Dado + bits de comando do IC_DATA_CMD
+    channel_config_set_read_increment(&tx_config, true);
+    channel_config_set_write_increment(&tx_config, false);
+    channel_config_set_dreq(&tx_config, i2c_get_dreq(dev->i2c, true));
+    dma_channel_configure(tx_channel, &tx_config, &hw->data_cmd, tx_commands, 0, false);
+
+    dma_channel_config rx_config = dma_channel_get_default_config(rx_channel);
+    channel_config_set_transfer_data_size(&rx_config, DMA_SIZE_8); // Apenas o byte recebido
+    channel_config_set_read_increment(&rx_config, false);
+    channel_config_set_write_increment(&rx_config, true);
+    channel_config_set_dreq(&rx_config, i2c_get_dreq(dev->i2c, false));
+    dma_channel_configure(rx_channel, &rx_config, rx_buffer, &hw->data_cmd, 0, false);
+
+    dma_channel_set_irq0_enabled(rx_channel, true);
+    irq_add_shared_handler(DMA_IRQ_0, fifo_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    memset(&stats, 0, sizeof(stats));
+    irq_sequence = 0;
+    read_sequence = 0;
+    transfer_busy = false;
+    resync_needed = false;
+    ring_head = ring_tail = 0;
+
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_IN);
+    gpio_pull_down(pin); // Mantém o pino em nível baixo se o sensor estiver desconectado
+    gpio_add_raw_irq_handler(pin, fifo_int_irq); // Handler próprio do pino: convive com callbacks de outros pinos (botões)
+    gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_RISE, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    return mpu6050_write_register(dev, MPU6050_REG_INT_ENABLE, 0x01); // DATA_RDY_EN: a partir daqui o barramento pertence ao DMA
+}
+
+// Desabilita a interrupção e espera a transferência em andamento terminar
+void mpu6050_fifo_stop() {
+    gpio_set_irq_enabled(int_pin, GPIO_IRQ_EDGE_RISE, false);
+
+    uint32_t start = time_us_32();
+    while (transfer_busy && time_us_32() - start < MPU6050_FIFO_BUS_TIMEOUT_US) {
+        tight_loop_contents();
+    }
+    if (transfer_busy) {
+        fifo_resync(); // Transferência travada: aborta os canais
+        gpio_set_irq_enabled(int_pin, GPIO_IRQ_EDGE_RISE, false);
+    }
+
+    mpu6050_write_register(imu, MPU6050_REG_INT_ENABLE, 0x00);
+    mpu6050_write_register(imu, MPU6050_REG_USER_CTRL, 0x00);
+}
+
+// Retira a amostra mais antiga do buffer circular
+bool mpu6050_fifo_pop(mpu6050_sample_t *sample) {
+    uint32_t tail = ring_tail;
+    if (tail == ring_head) {
+        return false;
+    }
+
+    __dmb(); // Lê a amostra somente depois de ver o índice atualizado pelo produtor
+    *sample = ring[tail % MPU6050_FIFO_RING_SIZE];
+    __dmb(); // Termina a cópia antes de liberar a posição
+    ring_tail = tail + 1;
+    return true;
+}
+
+// Amostras aguardando no buffer circular
+uint mpu6050_fifo_available() {
+    return ring_head - ring_tail;
+}
+
+// Detecta leituras abortadas (NACK) ou travadas e executa a ressincronização pendente
+void mpu6050_fifo_service() {
+    if (!resync_needed && transfer_busy) {
+        i2c_hw_t *hw = i2c_get_hw(imu->i2c);
+        if ((hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) || time_us_32() - transfer_start_us > MPU6050_FIFO_BUS_TIMEOUT_US) {
+            stats.bus_errors++;
+            resync_needed = true;
+        }
+    }
+
+    if (resync_needed) {
+        fifo_resync();
+    }
+}
+
+// Copia os contadores e, se solicitado, reinicia a contagem
+void mpu6050_fifo_get_stats(mpu6050_fifo_stats_t *stats_out, bool reset) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    *stats_out = stats;
+    if (reset) {
+        memset(&stats, 0, sizeof(stats));
+    }
+    restore_interrupts(irq_state);
+}
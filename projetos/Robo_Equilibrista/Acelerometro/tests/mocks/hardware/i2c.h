@@ -0,0 +1,16 @@
+// Substituto mínimo de hardware/i2c.h: os testes implementam as transações sobre um MPU6050 simulado
+#ifndef MOCK_HARDWARE_I2C_H
+#define MOCK_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+typedef struct i2c_inst i2c_inst_t; // Tipo opaco: o teste só compara ponteiros
+extern i2c_inst_t *const i2c0;
+extern i2c_inst_t *const i2c1;
+
+#define PICO_ERROR_GENERIC -1
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+#endif
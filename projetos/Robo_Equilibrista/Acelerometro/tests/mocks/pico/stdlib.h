@@ -0,0 +1,19 @@
+// Substituto mínimo de pico/stdlib.h para compilar os módulos do robô no computador (host)
+// As funções de tempo são implementadas por cada teste
+#ifndef MOCK_PICO_STDLIB_H
+#define MOCK_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+
+#endif
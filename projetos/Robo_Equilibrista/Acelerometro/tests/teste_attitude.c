@@ -0,0 +1,189 @@
+// Teste no computador (host) do estimador de inclinação em ponto fixo
+// Um traçado sintético de 20 s a 1 kHz (repouso, oscilação, degraus e vibração com aceleração linear) gera leituras de giroscópio com bias e ruído
+// e de acelerômetro com ruído; os filtros complementar e de Kalman devem acompanhar o ângulo verdadeiro dentro das tolerâncias
+//
+// Compilação e execução (a partir da pasta projetos/Robo_Equilibrista/Acelerometro):
+//   gcc -std=c11 -O2 -I. tests/teste_attitude.c src/attitude.c -lm -o teste_attitude && ./teste_attitude
+
+#define _GNU_SOURCE // M_PI e clock_gettime
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+#include "include/attitude.h"
+
+#define RATE_HZ 1000 // Taxa de amostragem do traçado
+#define DT_US (1000000 / RATE_HZ)
+#define DURATION_S 20 // Duração do traçado
+#define SAMPLES (RATE_HZ * DURATION_S)
+#define CAL_SAMPLES 1000 // Primeiro segundo (robô parado) usado na calibração do giroscópio
+#define SETTLE_SAMPLES 2000 // O erro só é medido depois de 2 s, quando os filtros já convergiram
+#define GYRO_BIAS_MDPS 1800 // Bias do giroscópio simulado (1,8 °/s)
+#define GYRO_NOISE_MDPS 300 // Desvio padrão do ruído do giroscópio
+#define ACCEL_NOISE_MG 20 // Desvio padrão do ruído do acelerômetro
+
+static uint32_t rng_state = 0x2545F491u; // Estado do gerador xorshift32
+
+static uint32_t rand_32() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Ruído gaussiano (Box-Muller)
+static double gaussian() {
+    double u1 = (rand_32() + 1.0) / 4294967297.0;
+    double u2 = (rand_32() + 1.0) / 4294967297.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// Ângulo verdadeiro (graus) e aceleração linear ao longo do robô (mg) no instante t
+static double true_angle(double t, double *linear_mg) {
+    *linear_mg = 0.0;
+    if (t < 2.0) return 0.0; // Repouso
+    if (t < 10.0) return 15.0 * sin(2.0 * M_PI * 0.5 * (t - 2.0)); // Oscilação de ±15° em 0,5 Hz
+    if (t < 15.0) { // Degraus de ±5° a cada segundo, com transição de 100 ms
+        double phase = fmod(t - 10.0, 2.0);
+        double ramp = phase < 1.0 ? fmin(phase / 0.1, 1.0) : 1.0 - fmin((phase - 1.0) / 0.1, 1.0);
+        return -5.0 + 10.0 * ramp;
+    }
+    // Vibração de ±3° em 2 Hz com trancos a cada 0,5 s: 50 ms acelerando a 300 mg e 50 ms freando (aceleração linear que engana o acelerômetro)
+    double pulse = fmod(t - 15.0, 0.5);
+    if (pulse < 0.05) *linear_mg = 300.0;
+    else if (pulse < 0.1) *linear_mg = -300.0;
+    return 3.0 * sin(2.0 * M_PI * 2.0 * (t - 15.0));
+}
+
+static int failures = 0;
+
+static void check(int condition, const char *message) {
+    if (!condition) {
+        printf("FALHA: %s\n", message);
+        failures++;
+    }
+}
+
+static double seconds_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int32_t accel_h[SAMPLES], accel_v[SAMPLES], gyro[SAMPLES][3];
+static double truth[SAMPLES];
+
+int main() {
+    // ---- atan2 em ponto fixo contra a biblioteca matemática ----
+    double atan_max_error = 0.0;
+    for (int i = 0; i < 3600; i++) {
+        double a = (i / 10.0 - 180.0) * M_PI / 180.0;
+        for (int magnitude = 50; magnitude <= 32000; magnitude *= 4) {
+            int32_t y = (int32_t)lround(magnitude * sin(a)), x = (int32_t)lround(magnitude * cos(a));
+            double error = fabs(attitude_atan2(y, x) / 65536.0 - atan2(y, x) * 180.0 / M_PI);
+            if (error > 180.0) error = 360.0 - error; // -180° e 180° são o mesmo ângulo
+            if (error > atan_max_error) atan_max_error = error;
+        }
+    }
+    printf("atan2: erro maximo %.3f graus\n", atan_max_error);
+    check(atan_max_error < 0.1, "erro do atan2 acima de 0,1 grau");
+    check(attitude_atan2(0, 0) == 0, "atan2(0, 0) deveria ser 0");
+
+    // ---- Traçado sintético ----
+    double previous = 0.0;
+    for (int n = 0; n < SAMPLES; n++) {
+        double t = (double)n / RATE_HZ, linear;
+        truth[n] = true_angle(t, &linear);
+        double rate = n == 0 ? 0.0 : (truth[n] - previous) * RATE_HZ; // °/s
+        previous = truth[n];
+
+        double rad = truth[n] * M_PI / 180.0;
+        accel_h[n] = (int32_t)lround(1000.0 * sin(rad) + linear * cos(rad) + ACCEL_NOISE_MG * gaussian());
+        accel_v[n] = (int32_t)lround(1000.0 * cos(rad) - linear * sin(rad) + ACCEL_NOISE_MG * gaussian());
+        gyro[n][0] = (int32_t)lround(-400 + GYRO_NOISE_MDPS * gaussian()); // Eixos que não participam (só para a calibração)
+        gyro[n][1] = (int32_t)lround(rate * 1000.0 + GYRO_BIAS_MDPS + GYRO_NOISE_MDPS * gaussian());
+        gyro[n][2] = (int32_t)lround(250 + GYRO_NOISE_MDPS * gaussian());
+    }
+
+    // ---- Calibração do bias com o robô parado ----
+    attitude_gyro_cal_t cal;
+    attitude_gyro_cal_reset(&cal);
+    int n_cal = 0;
+    while (!attitude_gyro_cal_add(&cal, gyro[n_cal], CAL_SAMPLES)) {
+        n_cal++;
+    }
+    printf("Calibracao: bias %ld mdps (real %d), %lu reinicios\n", (long)cal.bias_mdps[1], GYRO_BIAS_MDPS, (unsigned long)cal.restarts);
+    check(labs(cal.bias_mdps[1] - GYRO_BIAS_MDPS) < 50, "bias calibrado longe do real");
+    check(cal.restarts == 0, "calibracao nao deveria reiniciar com o robo parado");
+
+    attitude_gyro_cal_t moving;
+    attitude_gyro_cal_reset(&moving);
+    int32_t bump[3] = {0, 20000, 0}; // Robô empurrado no meio da calibração
+    for (int n = 0; n < 600; n++) attitude_gyro_cal_add(&moving, gyro[n], CAL_SAMPLES);
+    attitude_gyro_cal_add(&moving, bump, CAL_SAMPLES);
+    check(moving.restarts == 1 && moving.count == 1, "calibracao deveria recomecar quando o robo se move");
+
+    // ---- Filtros ----
+    attitude_complementary_t comp;
+    attitude_kalman_t kalman, kalman_raw;
+    attitude_complementary_init(&comp, ATTITUDE_Q16(0.998)); // Constante de tempo de 0,5 s
+    // R = variância do ângulo do acelerômetro: 20 mg de ruído equivalem a ~1,15°, ou ~1,3 graus²
+    attitude_kalman_init(&kalman, ATTITUDE_Q24(0.001), ATTITUDE_Q24(0.003), ATTITUDE_Q24(1.0));
+    attitude_kalman_init(&kalman_raw, ATTITUDE_Q24(0.001), ATTITUDE_Q24(0.003), ATTITUDE_Q24(1.0));
+
+    double comp_sq = 0, kalman_sq = 0, raw_sq = 0, accel_sq = 0, comp_max = 0, kalman_max = 0, float_max = 0;
+    double float_angle = 0.0; // Filtro complementar em ponto flutuante, referência para o erro de quantização
+    int measured = 0;
+
+    for (int n = 0; n < SAMPLES; n++) {
+        int32_t accel_angle = attitude_accel_angle(accel_h[n], accel_v[n]);
+        int32_t rate = gyro[n][1] - cal.bias_mdps[1];
+
+        double c = attitude_complementary_update(&comp, accel_angle, rate, DT_US) / 65536.0;
+        double k = attitude_kalman_update(&kalman, accel_angle, rate, DT_US) / 65536.0;
+        double r = attitude_kalman_update(&kalman_raw, accel_angle, gyro[n][1], DT_US) / 65536.0; // Sem calibração: o Kalman estima o bias
+
+        float_angle = n == 0 ? accel_angle / 65536.0 : 0.998 * (float_angle + rate / 1000.0 / RATE_HZ) + 0.002 * (accel_angle / 65536.0);
+
+        if (n >= SETTLE_SAMPLES) {
+            comp_sq += (c - truth[n]) * (c - truth[n]);
+            kalman_sq += (k - truth[n]) * (k - truth[n]);
+            raw_sq += (r - truth[n]) * (r - truth[n]);
+            accel_sq += (accel_angle / 65536.0 - truth[n]) * (accel_angle / 65536.0 - truth[n]);
+            comp_max = fmax(comp_max, fabs(c - truth[n]));
+            kalman_max = fmax(kalman_max, fabs(k - truth[n]));
+            float_max = fmax(float_max, fabs(c - float_angle));
+            measured++;
+        }
+    }
+
+    double comp_rms = sqrt(comp_sq / measured), kalman_rms = sqrt(kalman_sq / measured), raw_rms = sqrt(raw_sq / measured), accel_rms = sqrt(accel_sq / measured);
+    printf("Erro RMS / maximo: acelerometro %.2f | complementar %.2f / %.2f | Kalman %.2f / %.2f | Kalman sem calibracao %.2f (graus)\n",
+           accel_rms, comp_rms, comp_max, kalman_rms, kalman_max, raw_rms);
+    printf("Kalman sem calibracao: bias estimado %.0f mdps (real %d)\n", kalman_raw.bias / 65.536, GYRO_BIAS_MDPS);
+    printf("Complementar em ponto fixo x ponto flutuante: diferenca maxima %.4f graus\n", float_max);
+
+    check(comp_rms < 0.5 && comp_max < 2.5, "erro do filtro complementar acima da tolerancia");
+    check(kalman_rms < 0.5 && kalman_max < 2.5, "erro do filtro de Kalman acima da tolerancia");
+    check(comp_rms < accel_rms / 2 && kalman_rms < accel_rms / 2, "filtros deveriam reduzir bem o erro do acelerometro");
+    check(raw_rms < 0.5, "Kalman sem calibracao deveria compensar o bias");
+    check(fabs(kalman_raw.bias / 65.536 - GYRO_BIAS_MDPS) < 300, "bias estimado pelo Kalman longe do real");
+    check(float_max < 0.05, "ponto fixo deveria coincidir com o ponto flutuante");
+
+    // ---- Tempo por atualização (no computador; no RP2040 o exemplo mede com time_us_32) ----
+    const int rounds = 50;
+    volatile int32_t sink = 0;
+    double start = seconds_now();
+    for (int r = 0; r < rounds; r++)
+        for (int n = 0; n < SAMPLES; n++) sink += attitude_complementary_update(&comp, attitude_accel_angle(accel_h[n], accel_v[n]), gyro[n][1], DT_US);
+    double comp_ns = (seconds_now() - start) * 1e9 / (rounds * (double)SAMPLES);
+    start = seconds_now();
+    for (int r = 0; r < rounds; r++)
+        for (int n = 0; n < SAMPLES; n++) sink += attitude_kalman_update(&kalman, attitude_accel_angle(accel_h[n], accel_v[n]), gyro[n][1], DT_US);
+    double kalman_ns = (seconds_now() - start) * 1e9 / (rounds * (double)SAMPLES);
+    printf("Tempo por atualizacao (host, incluindo atan2): complementar %.1f ns | Kalman %.1f ns\n", comp_ns, kalman_ns);
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,248 @@
+// Teste no computador (host) da calibração dos desvios do MPU6050
+// Um sensor simulado no barramento I2C falso gera leituras paradas com bias e ruído em todos os eixos e soma os registradores de desvio
+// (ajuste de fábrica do acelerômetro e desvios do giroscópio) como o MPU6050. O teste calibra, aplica a correção em software e nos
+// registradores, e confere que as leituras corrigidas ficam centradas em zero (e em 1 g no eixo vertical) em vários fundos de escala
+//
+// Compilação e execução (a partir da pasta projetos/Robo_Equilibrista/Acelerometro):
+//   gcc -std=c11 -O2 -Itests/mocks -I. tests/teste_calibracao.c src/mpu6050.c -lm -o teste_calibracao && ./teste_calibracao
+
+#define _GNU_SOURCE // M_PI
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "include/mpu6050.h"
+
+#define SAMPLES 4000 // Amostras por calibração
+#define CHECK_SAMPLES 2000 // Amostras usadas para conferir a média corrigida
+
+// ---- MPU6050 simulado ----
+
+static struct i2c_inst { int id; } bus0 = {0}, bus1 = {1};
+i2c_inst_t *const i2c0 = &bus0;
+i2c_inst_t *const i2c1 = &bus1;
+
+static uint8_t regs[128]; // Banco de registradores
+static uint8_t reg_pointer;
+static uint32_t fake_time_us;
+
+static const int16_t factory_trim[3] = {-1493, 2251, 1105}; // Ajuste de fábrica do acelerômetro (X e Y com o bit 0 em 1)
+static double bias_accel[3] = {250.0, -410.0, 600.0}; // Bias em LSB de ±2 g (15, -25 e 37 mg)
+static double bias_gyro[3] = {300.0, -180.0, 95.0}; // Bias em LSB de ±250 °/s (2,3, -1,4 e 0,7 °/s)
+static double gravity[3] = {0.0, 0.0, 1.0}; // Gravidade no sensor (g)
+static double noise_accel = 60.0, noise_gyro = 8.0; // Desvio padrão do ruído (LSB de ±2 g e ±250 °/s)
+static double spike_gyro = 0.0; // Movimento somado à próxima leitura
+
+void sleep_ms(uint32_t ms) { fake_time_us += ms * 1000; }
+void sleep_us(uint64_t us) { fake_time_us += (uint32_t)us; }
+uint32_t time_us_32(void) { return fake_time_us; }
+uint64_t time_us_64(void) { return fake_time_us; }
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint32_t rand_32() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Ruído gaussiano (Box-Muller)
+static double gaussian() {
+    double u1 = (rand_32() + 1.0) / 4294967297.0;
+    double u2 = (rand_32() + 1.0) / 4294967297.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static int16_t reg16(uint8_t reg) {
+    return (int16_t)(regs[reg] << 8 | regs[reg + 1]);
+}
+
+static void set_reg16(uint8_t reg, double value) {
+    long rounded = lround(value);
+    int16_t saturated = (int16_t)(rounded > INT16_MAX ? INT16_MAX : (rounded < INT16_MIN ? INT16_MIN : rounded));
+    regs[reg] = (uint8_t)((uint16_t)saturated >> 8);
+    regs[reg + 1] = (uint8_t)saturated;
+}
+
+// Nova amostra no bloco 0x3B..0x48: valor verdadeiro + bias + ruído + registradores de desvio, no fundo de escala configurado
+static void generate_sample() {
+    int accel_range = (regs[MPU6050_REG_ACCEL_CONFIG] >> 3) & 3;
+    int gyro_range = (regs[MPU6050_REG_GYRO_CONFIG] >> 3) & 3;
+    double gyro_scale = mpu6050_gyro_lsb_per_10dps(gyro_range) / 1310.0;
+    for (int i = 0; i < 3; i++) {
+        double accel = gravity[i] * 16384.0 + bias_accel[i] + noise_accel * gaussian() + (reg16(MPU6050_REG_XA_OFFS_H + 2 * i) - factory_trim[i]) * 8.0;
+        double gyro = bias_gyro[i] + noise_gyro * gaussian() + spike_gyro + reg16(MPU6050_REG_XG_OFFS_USRH + 2 * i) * 4.0;
+        set_reg16(MPU6050_REG_ACCEL_XOUT_H + 2 * i, accel / (1 << accel_range));
+        set_reg16(MPU6050_REG_ACCEL_XOUT_H + 8 + 2 * i, gyro * gyro_scale);
+    }
+    set_reg16(MPU6050_REG_ACCEL_XOUT_H + 6, (25.0 - 36.53) * 340.0);
+    spike_gyro = 0.0;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    if (i2c != i2c0 || addr != MPU6050_ADDRESS) return PICO_ERROR_GENERIC;
+    reg_pointer = src[0];
+    for (size_t i = 1; i < len; i++) {
+        regs[reg_pointer++ & 0x7F] = src[i];
+    }
+    if (reg_pointer == MPU6050_REG_PWR_MGMT_1 + 1 && len == 2 && src[1] & 0x80) { // Reset: ajuste de fábrica restaurado, desvios do giroscópio zerados
+        memset(regs, 0, sizeof(regs));
+        regs[MPU6050_REG_WHO_AM_I] = MPU6050_WHO_AM_I_VALUE;
+        for (int i = 0; i < 3; i++) {
+            set_reg16(MPU6050_REG_XA_OFFS_H + 2 * i, factory_trim[i]);
+        }
+    }
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)nostop;
+    if (i2c != i2c0 || addr != MPU6050_ADDRESS) return PICO_ERROR_GENERIC;
+    if (reg_pointer == MPU6050_REG_ACCEL_XOUT_H) {
+        generate_sample();
+    }
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = regs[reg_pointer++ & 0x7F];
+    }
+    return (int)len;
+}
+
+// ---- Verificações ----
+
+static int failures = 0;
+
+static void check(int condition, const char *message) {
+    if (!condition) {
+        printf("FALHA: %s\n", message);
+        failures++;
+    }
+}
+
+// Calibra com o sensor parado; retorna o número de amostras lidas
+static int calibrate(mpu6050_t *imu, mpu6050_cal_t *cal, mpu6050_offsets_t *offsets, int spike_at) {
+    mpu6050_sample_t sample;
+    mpu6050_cal_reset(cal);
+    for (int n = 1; n < 3 * SAMPLES; n++) {
+        if (n == spike_at) spike_gyro = 2000.0; // Pancada de ~15 °/s no meio da média
+        mpu6050_read(imu, &sample);
+        if (mpu6050_cal_add(cal, imu, &sample, SAMPLES)) {
+            check(mpu6050_cal_finish(cal, imu, offsets), "calibracao deveria encontrar o eixo vertical");
+            return n;
+        }
+    }
+    check(0, "calibracao deveria terminar");
+    return 0;
+}
+
+// Média das leituras corrigidas (mg e m°/s)
+static void corrected_mean(mpu6050_t *imu, double accel_mg[3], double gyro_mdps[3]) {
+    mpu6050_sample_t sample;
+    for (int i = 0; i < 3; i++) accel_mg[i] = gyro_mdps[i] = 0.0;
+    for (int n = 0; n < CHECK_SAMPLES; n++) {
+        mpu6050_read(imu, &sample);
+        for (int i = 0; i < 3; i++) {
+            accel_mg[i] += sample.accel_mg[i] / (double)CHECK_SAMPLES;
+            gyro_mdps[i] += sample.gyro_mdps[i] / (double)CHECK_SAMPLES;
+        }
+    }
+}
+
+// A média corrigida deve ser a gravidade no acelerômetro e zero no giroscópio
+static void check_corrected(mpu6050_t *imu, double accel_tol_mg, double gyro_tol_mdps, const char *label) {
+    double accel[3], gyro[3];
+    corrected_mean(imu, accel, gyro);
+    double accel_error = 0.0, gyro_error = 0.0;
+    for (int i = 0; i < 3; i++) {
+        accel_error = fmax(accel_error, fabs(accel[i] - gravity[i] * 1000.0));
+        gyro_error = fmax(gyro_error, fabs(gyro[i]));
+    }
+    printf("%-42s aceleracao %7.2f %7.2f %8.2f mg | giroscopio %7.1f %7.1f %7.1f mdps\n", label, accel[0], accel[1], accel[2], gyro[0], gyro[1], gyro[2]);
+    char message[96];
+    snprintf(message, sizeof(message), "%s: erro da aceleracao corrigida (%.2f mg)", label, accel_error);
+    check(accel_error < accel_tol_mg, message);
+    snprintf(message, sizeof(message), "%s: erro do giroscopio corrigido (%.1f mdps)", label, gyro_error);
+    check(gyro_error < gyro_tol_mdps, message);
+}
+
+static bool offsets_close(const mpu6050_offsets_t *offsets, int tolerance) {
+    for (int i = 0; i < 3; i++) {
+        if (fabs(offsets->accel[i] - bias_accel[i]) > tolerance || fabs(offsets->gyro[i] - bias_gyro[i]) > tolerance) return false;
+    }
+    return true;
+}
+
+int main() {
+    mpu6050_t imu;
+    mpu6050_cal_t cal;
+    mpu6050_offsets_t offsets;
+
+    check(mpu6050_init(&imu, i2c0, MPU6050_ADDRESS), "inicializacao deveria funcionar");
+    check_corrected(&imu, 1e9, 1e9, "Sem calibracao");
+    double accel[3], gyro[3];
+    corrected_mean(&imu, accel, gyro);
+    check(fabs(accel[2] - 1000.0) > 30.0 && fabs(gyro[0]) > 2000.0, "sem calibracao as leituras deveriam mostrar o bias");
+
+    // Calibração e correção em software (caminho usado durante a aquisição por FIFO, com o barramento ocupado pelo DMA)
+    int used = calibrate(&imu, &cal, &offsets, -1);
+    printf("Desvios medidos: aceleracao %d %d %d | giroscopio %d %d %d (LSB de +-2 g e +-250 graus/s, %d amostras)\n", offsets.accel[0],
+           offsets.accel[1], offsets.accel[2], offsets.gyro[0], offsets.gyro[1], offsets.gyro[2], used);
+    check(used == SAMPLES && cal.restarts == 0, "sensor parado deveria calibrar sem recomecar");
+    check(offsets_close(&offsets, 3), "desvios medidos deveriam coincidir com o bias simulado");
+    check(mpu6050_set_offsets(&imu, &offsets, false), "correcao em software deveria funcionar");
+    check(reg16(MPU6050_REG_XG_OFFS_USRH) == 0 && reg16(MPU6050_REG_XA_OFFS_H) == factory_trim[0], "correcao em software nao deveria escrever no sensor");
+    check_corrected(&imu, 1.0, 20.0, "Correcao em software (+-2 g, +-250 graus/s)");
+
+    // Outro fundo de escala: a correção acompanha a configuração
+    check(mpu6050_configure(&imu, MPU6050_ACCEL_8G, MPU6050_GYRO_1000DPS, MPU6050_DLPF_44HZ), "configuracao deveria funcionar");
+    check_corrected(&imu, 1.5, 40.0, "Correcao em software (+-8 g, +-1000 graus/s)");
+    check(mpu6050_configure(&imu, MPU6050_ACCEL_2G, MPU6050_GYRO_250DPS, MPU6050_DLPF_44HZ), "configuracao deveria funcionar");
+
+    // Registradores de desvio do sensor: preservam o bit 0 do ajuste de fábrica e deixam só o arredondamento para o software
+    check(mpu6050_set_offsets(&imu, &offsets, true), "gravacao dos registradores deveria funcionar");
+    for (int i = 0; i < 3; i++) {
+        check((reg16(MPU6050_REG_XA_OFFS_H + 2 * i) & 1) == (factory_trim[i] & 1), "bit 0 do ajuste de fabrica deveria ser preservado");
+        check(abs(imu.accel_offset_lsb[i]) <= 8 && abs(imu.gyro_offset_lsb[i]) <= 2, "so o arredondamento deveria ficar em software");
+    }
+    printf("Registradores: aceleracao %d %d %d (fabrica %d %d %d) | giroscopio %d %d %d | restante em software: %ld %ld %ld / %ld %ld %ld LSB\n",
+           reg16(0x06), reg16(0x08), reg16(0x0A), factory_trim[0], factory_trim[1], factory_trim[2], reg16(0x13), reg16(0x15), reg16(0x17),
+           (long)imu.accel_offset_lsb[0], (long)imu.accel_offset_lsb[1], (long)imu.accel_offset_lsb[2],
+           (long)imu.gyro_offset_lsb[0], (long)imu.gyro_offset_lsb[1], (long)imu.gyro_offset_lsb[2]);
+    check_corrected(&imu, 1.0, 20.0, "Registradores do sensor + arredondamento");
+
+    // Nova calibração com a correção em vigor: mede o resíduo e devolve o desvio total
+    mpu6050_offsets_t again;
+    calibrate(&imu, &cal, &again, -1);
+    check(offsets_close(&again, 3), "recalibrar com os registradores gravados deveria dar o mesmo desvio total");
+
+    // Movimento no meio da média: a calibração recomeça
+    calibrate(&imu, &cal, &again, SAMPLES / 2);
+    check(cal.restarts >= 1, "movimento deveria reiniciar a media"); // A amostra da pancada abre a média nova e a reinicia mais uma vez
+    check(offsets_close(&again, 3), "desvios apos o recomeco deveriam coincidir com o bias simulado");
+
+    // O reset volta o sensor aos valores de fábrica e o handle esquece a correção
+    check(mpu6050_init(&imu, i2c0, MPU6050_ADDRESS), "reinicializacao deveria funcionar");
+    check(imu.accel_offset_lsb[2] == 0 && imu.hw_offsets.gyro[0] == 0, "reset deveria zerar a correcao do handle");
+
+    // Sensor de cabeça para baixo: o eixo vertical mede -1 g
+    gravity[2] = -1.0;
+    calibrate(&imu, &cal, &offsets, -1);
+    check(offsets_close(&offsets, 3), "calibracao de cabeca para baixo deveria medir o mesmo bias");
+    check(mpu6050_set_offsets(&imu, &offsets, true), "gravacao dos registradores deveria funcionar");
+    check_corrected(&imu, 1.0, 20.0, "De cabeca para baixo, nos registradores");
+
+    // Sem eixo na vertical (queda livre): a calibração é recusada
+    gravity[2] = 0.0;
+    mpu6050_sample_t sample;
+    mpu6050_cal_reset(&cal);
+    bool done = false;
+    while (!done) {
+        mpu6050_read(&imu, &sample);
+        done = mpu6050_cal_add(&cal, &imu, &sample, SAMPLES);
+    }
+    check(!mpu6050_cal_finish(&cal, &imu, &offsets), "sem eixo vertical a calibracao deveria falhar");
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,149 @@
+// Teste no computador (host) do driver do MPU6050 com um barramento I2C simulado
+// O mock mantém o banco de registradores do sensor, conta as transações e confere que a amostra completa é lida em uma única transação
+//
+// Compilação e execução (a partir da pasta projetos/Robo_Equilibrista/Acelerometro):
+//   gcc -std=c11 -O2 -Itests/mocks -I. tests/teste_mpu6050.c src/mpu6050.c -o teste_mpu6050 && ./teste_mpu6050
+
+#include <stdio.h>
+#include <string.h>
+#include "include/mpu6050.h"
+
+// ---- MPU6050 simulado ----
+
+static struct i2c_inst { int id; } bus0 = {0}, bus1 = {1};
+i2c_inst_t *const i2c0 = &bus0;
+i2c_inst_t *const i2c1 = &bus1;
+
+static uint8_t regs[128]; // Banco de registradores do sensor
+static uint8_t reg_pointer; // Registrador apontado pela última escrita
+static bool present = true; // false: o sensor não responde (NACK)
+static int writes, reads, transactions; // Chamadas de escrita, de leitura e transações completas (terminadas em STOP)
+static uint32_t fake_time_us;
+
+void sleep_ms(uint32_t ms) { fake_time_us += ms * 1000; }
+void sleep_us(uint64_t us) { fake_time_us += (uint32_t)us; }
+uint32_t time_us_32(void) { return fake_time_us; }
+uint64_t time_us_64(void) { return fake_time_us; }
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    writes++;
+    if (!nostop) transactions++;
+    if (!present || i2c != i2c0 || addr != MPU6050_ADDRESS) return PICO_ERROR_GENERIC;
+
+    reg_pointer = src[0];
+    for (size_t i = 1; i < len; i++) { // Escritas seguintes vão para registradores consecutivos
+        regs[reg_pointer++ & 0x7F] = src[i];
+    }
+    if (reg_pointer == MPU6050_REG_PWR_MGMT_1 + 1 && len == 2 && src[1] & 0x80) { // Reset: restaura os valores padrão
+        memset(regs, 0, sizeof(regs));
+        regs[MPU6050_REG_PWR_MGMT_1] = 0x40;
+        regs[MPU6050_REG_WHO_AM_I] = MPU6050_WHO_AM_I_VALUE;
+    }
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    reads++;
+    if (!nostop) transactions++;
+    if (!present || i2c != i2c0 || addr != MPU6050_ADDRESS) return PICO_ERROR_GENERIC;
+
+    for (size_t i = 0; i < len; i++) { // Leitura em rajada: o ponteiro de registrador avança sozinho
+        dst[i] = regs[reg_pointer++ & 0x7F];
+    }
+    return (int)len;
+}
+
+// Grava um valor de 16 bits big-endian no banco de registradores
+static void set_reg16(uint8_t reg, int16_t value) {
+    regs[reg] = (uint8_t)((uint16_t)value >> 8);
+    regs[reg + 1] = (uint8_t)value;
+}
+
+static void reset_counters() {
+    writes = reads = transactions = 0;
+}
+
+// ---- Verificações ----
+
+static int failures = 0;
+
+static void check(int condition, const char *message) {
+    if (!condition) {
+        printf("FALHA: %s\n", message);
+        failures++;
+    }
+}
+
+int main() {
+    mpu6050_t imu;
+    mpu6050_sample_t sample;
+
+    // Inicialização: reset, WHO_AM_I e configuração padrão
+    check(mpu6050_init(&imu, i2c0, MPU6050_ADDRESS), "inicializacao deveria funcionar");
+    check(regs[MPU6050_REG_CONFIG] == MPU6050_DLPF_44HZ, "DLPF padrao deveria ser 44 Hz");
+    check(regs[MPU6050_REG_ACCEL_CONFIG] == 0x00 && regs[MPU6050_REG_GYRO_CONFIG] == 0x00, "fundos de escala padrao deveriam ser 2 g e 250 graus/s");
+    check(regs[MPU6050_REG_PWR_MGMT_1] == 0x01, "sensor deveria sair do modo de baixo consumo com o PLL do giroscopio");
+
+    // Leitura completa em ±2 g / ±250 °/s
+    set_reg16(0x3B, 16384); // 1 g
+    set_reg16(0x3D, -8192); // -0,5 g
+    set_reg16(0x3F, 32767); // ~2 g
+    set_reg16(0x41, -521); // 35,00 °C
+    set_reg16(0x43, 1310); // 10 °/s
+    set_reg16(0x45, -131); // -1 °/s
+    set_reg16(0x47, 0);
+
+    reset_counters();
+    fake_time_us = 123456;
+    check(mpu6050_read(&imu, &sample), "leitura deveria funcionar");
+    printf("Leitura: %d escrita(s), %d leitura(s), %d transacao(oes) terminada(s) em STOP\n", writes, reads, transactions);
+    check(writes == 1 && reads == 1 && transactions == 1, "amostra completa deveria custar uma unica transacao (o exemplo original usava tres)");
+    check(sample.timestamp_us == 123456, "amostra deveria registrar o instante da leitura");
+
+    check(sample.accel_raw[0] == 16384 && sample.accel_raw[1] == -8192 && sample.accel_raw[2] == 32767, "aceleracao bruta incorreta");
+    check(sample.accel_mg[0] == 1000 && sample.accel_mg[1] == -500 && sample.accel_mg[2] == 1999, "aceleracao em mg incorreta");
+    check(sample.temp_raw == -521 && sample.temp_centi_c == 3500, "temperatura incorreta");
+    check(sample.gyro_raw[0] == 1310 && sample.gyro_mdps[0] == 10000, "giroscopio X incorreto");
+    check(sample.gyro_raw[1] == -131 && sample.gyro_mdps[1] == -1000, "giroscopio Y incorreto");
+    check(sample.gyro_mdps[2] == 0, "giroscopio Z incorreto");
+    printf("Aceleracao: %ld %ld %ld mg | temperatura: %ld centesimos de C | giroscopio: %ld %ld %ld mdps\n",
+           (long)sample.accel_mg[0], (long)sample.accel_mg[1], (long)sample.accel_mg[2], (long)sample.temp_centi_c,
+           (long)sample.gyro_mdps[0], (long)sample.gyro_mdps[1], (long)sample.gyro_mdps[2]);
+
+    // Troca de fundo de escala: registradores e decodificação devem acompanhar
+    reset_counters();
+    check(mpu6050_configure(&imu, MPU6050_ACCEL_8G, MPU6050_GYRO_2000DPS, MPU6050_DLPF_94HZ), "configuracao deveria funcionar");
+    check(transactions == 3, "configuracao deveria escrever tres registradores");
+    check(regs[MPU6050_REG_ACCEL_CONFIG] == 0x10 && regs[MPU6050_REG_GYRO_CONFIG] == 0x18 && regs[MPU6050_REG_CONFIG] == 2, "registradores de configuracao incorretos");
+
+    set_reg16(0x3B, 4096); // 1 g em ±8 g
+    set_reg16(0x43, -164); // -10 °/s em ±2000 °/s
+    check(mpu6050_read(&imu, &sample), "leitura deveria funcionar");
+    check(sample.accel_mg[0] == 1000, "aceleracao em +-8 g incorreta");
+    check(sample.gyro_mdps[0] == -10000, "giroscopio em +-2000 graus/s incorreto");
+
+    for (int r = MPU6050_ACCEL_2G; r <= MPU6050_ACCEL_16G; r++) { // Tabela de sensibilidade do datasheet
+        static const int32_t expected[] = {16384, 8192, 4096, 2048};
+        check(mpu6050_accel_lsb_per_g(r) == expected[r], "sensibilidade do acelerometro incorreta");
+    }
+
+    // Decodificação pura (usada também por quem recebe os bytes por DMA): extremos negativos sem estouro
+    uint8_t raw[MPU6050_BURST_BYTES];
+    memset(raw, 0, sizeof(raw));
+    raw[8] = 0x80; raw[9] = 0x00; // Giroscópio X = -32768
+    raw[0] = 0x80; raw[1] = 0x00; // Aceleração X = -32768
+    mpu6050_decode(&imu, raw, &sample);
+    check(sample.gyro_mdps[0] == -32768L * 10000 / 164, "decodificacao do extremo negativo do giroscopio incorreta");
+    check(sample.accel_mg[0] == -8000, "decodificacao do extremo negativo do acelerometro incorreta");
+
+    // Sensor ausente: a leitura falha e a configuração do handle não muda
+    present = false;
+    check(!mpu6050_read(&imu, &sample), "leitura sem sensor deveria falhar");
+    check(!mpu6050_configure(&imu, MPU6050_ACCEL_2G, MPU6050_GYRO_250DPS, MPU6050_DLPF_44HZ), "configuracao sem sensor deveria falhar");
+    check(imu.accel_range == MPU6050_ACCEL_8G && imu.gyro_range == MPU6050_GYRO_2000DPS, "handle nao deveria mudar quando a configuracao falha");
+    check(!mpu6050_init(&imu, i2c0, MPU6050_ADDRESS), "inicializacao sem sensor deveria falhar");
+    present = true;
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,554 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "pico/binary_info.h"
+#include "hardware/i2c.h"
+#include "hardware/sync.h"
+#include "include/mpu6050.h"
+#include "include/mpu6050_fifo.h"
+#include "include/estimador.h"
+#include "include/controle.h"
+#include "include/motor.h"
+#include "include/encoder.h"
+#include "include/velocidade.h"
+#include "include/telemetria.h"
+#include "include/parametros.h"
+#include "pico/flash.h"
+
+// Núcleo 1: laço de controle disparado por temporizador (IMU e encoders → estimativa do ângulo → PID em cascata → PWM), sem printf nem USB
+// Núcleo 0: telemetria pela serial, botão de armar e ajuste dos ganhos em tempo de execução
+
+#define BUTTON_A 5 // Arma / desarma
+#define INA1 4
+#define INA2 9
+#define PWM_A 8
+#define INB1 18
+#define INB2 19
+#define PWM_B 16
+#define STAND_BY 20
+#define ENCODER_LEFT_A 2 // Fases A e B do encoder esquerdo (GPIO 2 e 3), como no Teste_Motores
+#define ENCODER_RIGHT_A 10 // Fases A e B do encoder direito (GPIO 10 e 11)
+#define WHEEL_VELOCITY_WINDOW 10 // Janela da velocidade das rodas (iterações do laço: 20 ms a 500 Hz)
+
+#define MPU6050_SDA 0
+#define MPU6050_SCL 1
+#define MPU6050_INT_PIN 28 // Pino ligado ao INT do MPU6050
+
+#define IMU_RATE_HZ 1000 // Taxa de amostragem do MPU6050
+
+// Ganhos, frequência do laço e limites são parâmetros ajustáveis pela serial e gravados na flash (src/parametros.c)
+
+#define COMMAND_LINE_MAX 64 // Maior comando aceito pela serial
+#define TELEMETRY_PERIOD_MS 100 // Telemetria a 10 Hz
+#define STATS_PERIOD_MS 1000 // Estatísticas do laço a cada segundo
+
+// Estatísticas do laço de controle, acumuladas pelo núcleo 1 e zeradas a cada leitura do núcleo 0
+typedef struct {
+    uint32_t loops; // Iterações executadas
+    uint32_t overruns; // Iterações que começaram um período inteiro atrasadas (laço mais longo que o período ou interrupções bloqueando o núcleo)
+    uint32_t loop_us_min; // Menor duração de uma iteração
+    uint32_t loop_us_max; // Maior duração de uma iteração
+    uint64_t loop_us_sum; // Soma das durações (para a média)
+    uint32_t jitter_us_max; // Maior desvio entre o instante esperado e o instante real de início
+    uint32_t latency_us_max; // Maior atraso entre o instante da amostra do MPU6050 e a escrita no PWM
+    uint32_t imu_samples; // Amostras consumidas
+    uint32_t stale_disarms; // Desarmes por falta de amostras
+} loop_stats_t;
+
+// Último estado do controlador, para a telemetria
+typedef struct {
+    int32_t angle; // Ângulo estimado (Q16 graus)
+    int32_t rate; // Velocidade angular (Q16 °/s)
+    int32_t rate_setpoint; // Saída da malha externa (Q16 °/s)
+    int32_t command; // Comando dos motores (Q15)
+    bool armed;
+    bool calibrated; // Bias do giroscópio medido
+} telemetry_t;
+
+static mpu6050_t imu;
+static spin_lock_t *shared_lock; // Protege tudo o que é trocado entre os núcleos (abaixo)
+
+static loop_stats_t loop_stats;
+static telemetry_t telemetry;
+static mpu6050_fifo_stats_t imu_stats; // Copiadas pelo núcleo 1, dono do módulo de aquisição
+static int32_t pending_params[PARAM_COUNT]; // Parâmetros novos aguardando a próxima iteração
+static bool params_pending = false;
+static volatile int arm_request = -1; // -1: nada; 0: desarmar; 1: armar
+static volatile uint32_t calibration_request = 0; // Amostras pedidas pelo comando calibrate (0: nada)
+static bool calibration_done = false; // Resultado da calibração pronto para o núcleo 0
+static bool calibration_ok = false;
+static mpu6050_offsets_t calibration_offsets; // Desvios medidos (LSB em ±2 g / ±250 °/s)
+static bool binary_telemetry = false; // true: quadros binários (tools/telemetria.py) no lugar do texto
+
+static int32_t params[PARAM_COUNT]; // Valores editados pelo núcleo 0 (serial) e gravados na flash
+static int32_t active_params[PARAM_COUNT]; // Cópia em uso pelo laço (núcleo 1), trocada inteira entre duas iterações
+
+static motor_driver_t motors; // Configurado pelo núcleo 0 antes de iniciar o núcleo 1; depois, usado apenas pelo laço
+
+void setup_motors() {
+    motor_config_t config = {
+        .left = {.in1 = INA1, .in2 = INA2, .pwm = PWM_A, .inverted = false},
+        .right = {.in1 = INB1, .in2 = INB2, .pwm = PWM_B, .inverted = false},
+        .standby_pin = STAND_BY,
+        .pwm_hz = (uint32_t)params[PARAM_MOTOR_PWM_HZ],
+        .slew_per_s = param_motor_slew(params), // Padrão sem rampa: o atraso da rampa entraria na malha de equilíbrio
+    };
+    if (!motor_driver_init(&motors, &config)) {
+        printf("PWM_A e PWM_B precisam estar em fatias de PWM diferentes\n");
+    }
+    motor_driver_stop(&motors, MOTOR_COAST);
+}
+
+// Encoders das rodas (PIO 0); sem eles, a malha das rodas recebe velocidade zero e não atua
+static encoder_t encoders[2]; // Esquerdo e direito
+static bool encoders_ok = false;
+
+void setup_encoders() {
+    uint pins[2] = {ENCODER_LEFT_A, ENCODER_RIGHT_A};
+    encoders_ok = true;
+    for (int i = 0; i < 2; i++) {
+        if (!encoder_init(&encoders[i], pio0, pins[i], false)) {
+            printf("Falha ao iniciar o encoder %d no PIO\n", i);
+            encoders_ok = false;
+        }
+    }
+}
+
+// Desvios do MPU6050 guardados nos parâmetros
+static void offsets_from_params(const int32_t *values, mpu6050_offsets_t *offsets) {
+    for (int axis = 0; axis < 3; axis++) {
+        offsets->accel[axis] = (int16_t)values[PARAM_ACCEL_OFFSET_X + axis];
+        offsets->gyro[axis] = (int16_t)values[PARAM_GYRO_OFFSET_X + axis];
+    }
+}
+
+// Estado do laço, usado apenas pelo núcleo 1
+static balance_controller_t controller;
+static pitch_estimator_t estimator; // Ângulo e velocidade angular a partir das amostras (src/estimador.c)
+static velocity_estimator_t wheel_velocity[2]; // Contagens/s de cada roda
+static uint32_t expected_us = 0; // Instante em que a próxima iteração deveria começar
+static uint32_t last_loop_us = 0; // Início da iteração anterior (dt do controlador)
+static telemetria_frame_t frame = {.type = TELEMETRIA_FRAME_CONTROL}; // Quadro da telemetria binária, completado a cada iteração
+static loop_stats_t local_stats; // Acumulado desde a última cópia para loop_stats
+static mpu6050_cal_t imu_cal; // Acumulação do comando calibrate
+static uint32_t imu_cal_samples = 0; // Amostras da calibração em andamento (0: nenhuma)
+
+static void reset_local_stats() {
+    memset(&local_stats, 0, sizeof(local_stats));
+    local_stats.loop_us_min = UINT32_MAX;
+}
+
+// Consome as amostras novas do MPU6050 e atualiza o ângulo; retorna o instante da amostra mais recente
+static uint32_t update_attitude() {
+    mpu6050_sample_t sample;
+
+    while (mpu6050_fifo_pop(&sample)) {
+        if (imu_cal_samples != 0 && mpu6050_cal_add(&imu_cal, &imu, &sample, imu_cal_samples)) {
+            mpu6050_offsets_t offsets;
+            bool ok = mpu6050_cal_finish(&imu_cal, &imu, &offsets);
+            if (ok) { // O DMA é dono do barramento I2C: a correção nova entra só na conversão (os registradores de offset ficam como na inicialização)
+                mpu6050_set_offsets(&imu, &offsets, false);
+                pitch_estimator_init(&estimator, IMU_RATE_HZ); // Mede de novo o bias residual do giroscópio
+            }
+            imu_cal_samples = 0;
+
+            uint32_t irq_state = spin_lock_blocking(shared_lock);
+            calibration_offsets = offsets;
+            calibration_ok = ok;
+            calibration_done = true;
+            spin_unlock(shared_lock, irq_state);
+            continue; // A amostra foi convertida com os desvios antigos
+        }
+        pitch_estimator_update(&estimator, &sample);
+        local_stats.imu_samples++;
+    }
+
+    return estimator.last_sample_us;
+}
+
+// Uma iteração do laço de controle (interrupção do temporizador no núcleo 1)
+bool control_loop(repeating_timer_t *t) {
+    uint32_t start = time_us_32();
+    uint32_t period_us = 1000000 / (uint32_t)active_params[PARAM_CONTROL_RATE_HZ];
+
+    // Pontualidade: o temporizador repete a partir do instante agendado, então o atraso não se acumula
+    int32_t late = 0;
+    if (expected_us != 0) {
+        late = (int32_t)(start - expected_us);
+        uint32_t jitter = late < 0 ? -late : late;
+        if (jitter > local_stats.jitter_us_max) {
+            local_stats.jitter_us_max = jitter;
+        }
+        if (late >= (int32_t)period_us) {
+            local_stats.overruns++;
+        }
+    }
+    uint32_t dt_us = last_loop_us != 0 ? start - last_loop_us : period_us;
+    last_loop_us = start;
+
+    // Parâmetros novos entram inteiros entre duas iterações, nunca no meio de uma (nem metade dos ganhos de uma versão e metade de outra)
+    uint32_t irq_state = spin_lock_blocking(shared_lock);
+    bool apply = params_pending;
+    if (apply) {
+        memcpy(active_params, pending_params, sizeof(active_params));
+        params_pending = false;
+    }
+    spin_unlock(shared_lock, irq_state);
+    if (apply) {
+        balance_gains_t gains;
+        param_balance_gains(active_params, &gains);
+        balance_set_gains(&controller, &gains);
+        motors.slew_per_s = param_motor_slew(active_params);
+        mpu6050_offsets_t offsets;
+        offsets_from_params(active_params, &offsets);
+        mpu6050_set_offsets(&imu, &offsets, false); // Só a parte em software: o DMA é dono do barramento I2C
+        period_us = 1000000 / (uint32_t)active_params[PARAM_CONTROL_RATE_HZ];
+        t->delay_us = -(int64_t)period_us; // Negativo: intervalo entre inícios, independente da duração da iteração
+    }
+    expected_us = start + period_us;
+
+    int request = arm_request;
+    if (request >= 0) {
+        arm_request = -1;
+        int32_t tilt = estimator.angle - controller.angle_offset;
+        int32_t arm_max = active_params[PARAM_ARM_MAX_ANGLE];
+        if (request == 0 || (estimator.calibrated && imu_cal_samples == 0 && tilt < arm_max && tilt > -arm_max)) {
+            balance_arm(&controller, request == 1);
+        }
+    }
+
+    uint32_t cal_request = calibration_request;
+    if (cal_request != 0) {
+        calibration_request = 0;
+        if (!controller.armed) { // Armado entre o comando e esta iteração: o pedido é ignorado
+            mpu6050_cal_reset(&imu_cal);
+            imu_cal_samples = cal_request;
+        }
+    }
+
+    uint32_t newest_us = update_attitude();
+
+    if (controller.armed && (!estimator.have_sample || start - newest_us > (uint32_t)active_params[PARAM_IMU_STALE_US])) {
+        balance_arm(&controller, false);
+        local_stats.stale_disarms++;
+    }
+
+    // Média das duas rodas, em voltas/s em relação ao chão (encoder_cpr = 0 desliga a malha das rodas)
+    int32_t wheel_speed = 0;
+    if (encoders_ok) {
+        int32_t counts_per_s = 0;
+        for (int i = 0; i < 2; i++) {
+            counts_per_s += velocity_update(&wheel_velocity[i], encoder_get_count(&encoders[i]), start) / 2;
+        }
+        wheel_speed = balance_wheel_speed(counts_per_s, active_params[PARAM_ENCODER_CPR], estimator.rate);
+    }
+
+    int32_t command = balance_step(&controller, estimator.angle, estimator.rate, wheel_speed, dt_us);
+    if (controller.armed) { // O comando Q15 do controlador já está na escala do driver
+        motor_driver_set(&motors, command, command, dt_us);
+    } else {
+        motor_driver_stop(&motors, MOTOR_COAST); // Desarmado ou caído: rodas livres
+    }
+
+    uint32_t end = time_us_32();
+    uint32_t loop_us = end - start;
+    local_stats.loops++;
+    local_stats.loop_us_sum += loop_us;
+    if (loop_us < local_stats.loop_us_min) {
+        local_stats.loop_us_min = loop_us;
+    }
+    if (loop_us > local_stats.loop_us_max) {
+        local_stats.loop_us_max = loop_us;
+    }
+    if (estimator.have_sample && end - newest_us > local_stats.latency_us_max) {
+        local_stats.latency_us_max = end - newest_us;
+    }
+
+    // Telemetria binária: uma cópia de 32 bytes para o buffer circular, sem trava; com o buffer cheio o quadro é descartado
+    frame.flags = (controller.armed ? TELEMETRIA_FLAG_ARMED : 0) | (estimator.calibrated ? TELEMETRIA_FLAG_CALIBRATED : 0);
+    frame.timestamp_us = start;
+    frame.angle = estimator.angle;
+    frame.rate = estimator.rate;
+    frame.rate_setpoint = controller.rate_setpoint;
+    frame.command_left = (int16_t)motors.left.speed;
+    frame.command_right = (int16_t)motors.right.speed;
+    frame.lateness_us = (int16_t)(late > INT16_MAX ? INT16_MAX : (late < INT16_MIN ? INT16_MIN : late));
+    telemetria_push(&frame);
+    frame.sequence++;
+    frame.loop_us = (uint16_t)(loop_us > UINT16_MAX ? UINT16_MAX : loop_us); // Vão no próximo quadro: a iteração atual ainda não terminou
+    frame.latency_us = estimator.have_sample ? (uint16_t)(end - newest_us > UINT16_MAX ? UINT16_MAX : end - newest_us) : 0;
+
+    // Publica o estado para o núcleo 0 (cópia curta com o spinlock)
+    irq_state = spin_lock_blocking(shared_lock);
+    telemetry.angle = estimator.angle;
+    telemetry.rate = estimator.rate;
+    telemetry.rate_setpoint = controller.rate_setpoint;
+    telemetry.command = command;
+    telemetry.armed = controller.armed;
+    telemetry.calibrated = estimator.calibrated;
+    loop_stats.loops += local_stats.loops;
+    loop_stats.overruns += local_stats.overruns;
+    loop_stats.loop_us_sum += local_stats.loop_us_sum;
+    loop_stats.imu_samples += local_stats.imu_samples;
+    loop_stats.stale_disarms += local_stats.stale_disarms;
+    if (local_stats.loop_us_min < loop_stats.loop_us_min) loop_stats.loop_us_min = local_stats.loop_us_min;
+    if (local_stats.loop_us_max > loop_stats.loop_us_max) loop_stats.loop_us_max = local_stats.loop_us_max;
+    if (local_stats.jitter_us_max > loop_stats.jitter_us_max) loop_stats.jitter_us_max = local_stats.jitter_us_max;
+    if (local_stats.latency_us_max > loop_stats.latency_us_max) loop_stats.latency_us_max = local_stats.latency_us_max;
+    spin_unlock(shared_lock, irq_state);
+    reset_local_stats();
+
+    return true;
+}
+
+// Núcleo 1: as interrupções do MPU6050 (pino INT e DMA) e do temporizador do laço são habilitadas aqui, então nunca disputam o núcleo com a USB
+void core1_entry() {
+    balance_gains_t gains;
+    param_balance_gains(active_params, &gains);
+    balance_init(&controller, &gains);
+    flash_safe_execute_core_init(); // Permite ao núcleo 0 pausar este núcleo durante a gravação dos parâmetros na flash
+    pitch_estimator_init(&estimator, IMU_RATE_HZ);
+    for (int i = 0; i < 2; i++) {
+        velocity_init(&wheel_velocity[i], WHEEL_VELOCITY_WINDOW);
+    }
+    reset_local_stats();
+
+    mpu6050_fifo_start(&imu, MPU6050_INT_PIN, IMU_RATE_HZ, 1); // Um quadro por transferência: menor atraso entre a medida e o laço
+
+    alarm_pool_t *pool = alarm_pool_create_with_unused_hardware_alarm(4); // Temporizador de hardware próprio, com a interrupção neste núcleo
+    repeating_timer_t timer;
+    alarm_pool_add_repeating_timer_us(pool, -(int64_t)(1000000 / active_params[PARAM_CONTROL_RATE_HZ]), control_loop, NULL, &timer);
+
+    uint32_t next_stats = time_us_32() + STATS_PERIOD_MS * 1000;
+    while (1) {
+        mpu6050_fifo_service(); // Ressincroniza o FIFO se houve transbordo ou erro de barramento
+
+        if ((int32_t)(time_us_32() - next_stats) >= 0) {
+            mpu6050_fifo_stats_t stats;
+            mpu6050_fifo_get_stats(&stats, true);
+            uint32_t irq_state = spin_lock_blocking(shared_lock);
+            imu_stats = stats;
+            spin_unlock(shared_lock, irq_state);
+            next_stats += STATS_PERIOD_MS * 1000;
+        }
+
+        __wfi(); // Dorme até a próxima interrupção (temporizador, INT ou DMA)
+    }
+}
+
+// Envia o conjunto completo de parâmetros ao núcleo 1, que o aplica no início da próxima iteração
+static void publish_params() {
+    uint32_t irq_state = spin_lock_blocking(shared_lock);
+    memcpy(pending_params, params, sizeof(pending_params));
+    params_pending = true;
+    spin_unlock(shared_lock, irq_state);
+}
+
+// Imprime um parâmetro: nome = valor [mínimo, máximo] descrição
+static void print_param(int id) {
+    char value[24], min[24], max[24];
+    param_format(id, params[id], value, sizeof(value));
+    param_format(id, param_defs[id].min, min, sizeof(min));
+    param_format(id, param_defs[id].max, max, sizeof(max));
+    printf("%s = %s [%s, %s] %s%s\n", param_defs[id].name, value, min, max, param_defs[id].description,
+           param_defs[id].reboot ? " (vale na proxima inicializacao)" : "");
+}
+
+// Comandos pela serial, uma linha por comando
+static void handle_command(char *line) {
+    char *command = strtok(line, " \t");
+    char *name = strtok(NULL, " \t");
+    char *value = strtok(NULL, " \t");
+    if (command == NULL) {
+        return;
+    }
+
+    if (strcmp(command, "list") == 0) {
+        for (int i = 0; i < PARAM_COUNT; i++) {
+            print_param(i);
+        }
+    } else if (strcmp(command, "get") == 0 || strcmp(command, "set") == 0) {
+        int id = name ? param_find(name) : -1;
+        if (id < 0) {
+            printf("Parametro desconhecido (use list)\n");
+            return;
+        }
+        if (command[0] == 's') {
+            int32_t parsed;
+            if (value == NULL || !param_parse(id, value, &parsed)) {
+                printf("Valor invalido para %s\n", param_defs[id].name);
+                return;
+            }
+            params[id] = parsed;
+            publish_params();
+        }
+        print_param(id);
+    } else if (strcmp(command, "save") == 0) {
+        uint32_t irq_state = spin_lock_blocking(shared_lock);
+        bool armed = telemetry.armed;
+        spin_unlock(shared_lock, irq_state);
+        if (armed) { // A gravação pausa o núcleo 1 por dezenas de milissegundos (apagamento do setor)
+            printf("Desarme antes de gravar\n");
+            return;
+        }
+        printf(param_flash_save(params) ? "Parametros gravados na flash\n" : "Falha ao gravar os parametros\n");
+    } else if (strcmp(command, "load") == 0) {
+        param_image_status_t status;
+        param_flash_load(params, &status);
+        publish_params();
+        printf("Parametros da flash: %s\n", param_image_status_name(status));
+    } else if (strcmp(command, "defaults") == 0) {
+        param_set_defaults(params);
+        publish_params();
+        printf("Parametros padrao (use save para gravar)\n");
+    } else if (strcmp(command, "arm") == 0 || strcmp(command, "disarm") == 0) {
+        arm_request = command[0] == 'a' ? 1 : 0;
+    } else if (strcmp(command, "calibrate") == 0) {
+        uint32_t irq_state = spin_lock_blocking(shared_lock);
+        bool armed = telemetry.armed;
+        spin_unlock(shared_lock, irq_state);
+        long samples = name ? strtol(name, NULL, 10) : MPU6050_CAL_SAMPLES_DEFAULT;
+        if (armed) {
+            printf("Desarme antes de calibrar\n");
+        } else if (samples < 100 || samples > 60000) {
+            printf("Numero de amostras invalido (100 a 60000)\n");
+        } else {
+            calibration_request = (uint32_t)samples;
+            printf("Calibrando com %ld amostras: mantenha o robo parado\n", samples);
+        }
+    } else if (strcmp(command, "bin") == 0) { // Alterna entre texto e quadros binários (o texto impresso depois disso aparece no meio dos quadros e é descartado pelo decodificador)
+        binary_telemetry = !binary_telemetry;
+        if (!binary_telemetry) printf("Telemetria em texto\n");
+    } else {
+        printf("Comandos: list | get <nome> | set <nome> <valor> | save | load | defaults | arm | disarm | calibrate [amostras] | bin\n");
+    }
+}
+
+int main() {
+
+    stdio_init_all();
+
+    gpio_init(BUTTON_A);
+    gpio_set_dir(BUTTON_A, GPIO_IN);
+    gpio_pull_up(BUTTON_A);
+
+    param_image_status_t status;
+    param_flash_load(params, &status);
+    memcpy(active_params, params, sizeof(active_params));
+
+    setup_motors();
+    setup_encoders();
+
+    i2c_init(i2c0, 400 * 1000);
+    gpio_set_function(MPU6050_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(MPU6050_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(MPU6050_SDA);
+    gpio_pull_up(MPU6050_SCL);
+
+    bi_decl(bi_2pins_with_func(MPU6050_SDA, MPU6050_SCL, GPIO_FUNC_I2C));
+
+    while (!mpu6050_init(&imu, i2c0, MPU6050_ADDRESS)) {
+        printf("MPU6050 nao encontrado, tentando novamente...\n");
+        sleep_ms(1000);
+    }
+    mpu6050_configure(&imu, MPU6050_ACCEL_2G, MPU6050_GYRO_250DPS, MPU6050_DLPF_44HZ);
+    mpu6050_offsets_t offsets;
+    offsets_from_params(params, &offsets);
+    mpu6050_set_offsets(&imu, &offsets, true); // Antes de iniciar o DMA: a correção vai para os registradores de offset do sensor
+
+    shared_lock = spin_lock_init(spin_lock_claim_unused(true));
+    memset(&loop_stats, 0, sizeof(loop_stats));
+    loop_stats.loop_us_min = UINT32_MAX;
+
+    multicore_launch_core1(core1_entry);
+
+    printf("Equilibrista: mantenha o robo parado em pe durante a calibracao e pressione A para armar\n");
+    printf("Parametros da flash: %s\n", param_image_status_name(status));
+    printf("Comandos: list | get <nome> | set <nome> <valor> | save | load | defaults | arm | disarm | calibrate [amostras] | bin\n");
+
+    char line[COMMAND_LINE_MAX];
+    size_t line_length = 0;
+    bool button_was_pressed = false;
+    absolute_time_t next_telemetry = make_timeout_time_ms(TELEMETRY_PERIOD_MS);
+    absolute_time_t next_stats = make_timeout_time_ms(STATS_PERIOD_MS);
+
+    while (true) {
+
+        int key;
+        while ((key = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) { // Acumula a linha sem bloquear
+            if (key == '\r' || key == '\n') {
+                line[line_length] = '\0';
+                handle_command(line);
+                line_length = 0;
+            } else if (line_length < sizeof(line) - 1) {
+                line[line_length++] = (char)key;
+            }
+        }
+
+        bool button_pressed = gpio_get(BUTTON_A) == 0;
+        if (button_pressed && !button_was_pressed) { // Borda de descida: alterna entre armado e desarmado
+            uint32_t irq_state = spin_lock_blocking(shared_lock);
+            bool armed = telemetry.armed;
+            spin_unlock(shared_lock, irq_state);
+            arm_request = armed ? 0 : 1;
+        }
+        button_was_pressed = button_pressed;
+
+        uint32_t irq_state = spin_lock_blocking(shared_lock);
+        bool calibrated = calibration_done;
+        bool calibration_valid = calibration_ok;
+        mpu6050_offsets_t measured = calibration_offsets;
+        calibration_done = false;
+        spin_unlock(shared_lock, irq_state);
+        if (calibrated && calibration_valid) { // O núcleo 1 já usa os desvios novos; a cópia nos parâmetros permite gravá-los
+            bool in_range = true;
+            for (int axis = 0; axis < 3; axis++) {
+                in_range &= param_set(params, PARAM_ACCEL_OFFSET_X + axis, measured.accel[axis]);
+                in_range &= param_set(params, PARAM_GYRO_OFFSET_X + axis, measured.gyro[axis]);
+            }
+            publish_params(); // Fora da faixa: o laço volta ao valor anterior do eixo
+            printf("Calibracao: acelerometro %d %d %d | giroscopio %d %d %d%s\n",
+                   measured.accel[0], measured.accel[1], measured.accel[2], measured.gyro[0], measured.gyro[1], measured.gyro[2],
+                   in_range ? " (use save para gravar)" : " (fora da faixa dos parametros: verifique o sensor)");
+        } else if (calibrated) {
+            printf("Calibracao falhou: nenhum eixo do acelerometro na vertical\n");
+        }
+
+        telemetria_service(binary_telemetry); // Esvazia o buffer da telemetria binária (ou descarta os quadros, no modo texto)
+
+        if (time_reached(next_telemetry) && !binary_telemetry) {
+            uint32_t irq_state = spin_lock_blocking(shared_lock);
+            telemetry_t snapshot = telemetry;
+            spin_unlock(shared_lock, irq_state);
+
+            printf("%s angulo %.2f graus | velocidade %.1f graus/s (alvo %.1f) | comando %.1f%%\n",
+                   !snapshot.calibrated ? "CALIBRANDO" : (snapshot.armed ? "ARMADO" : "DESARMADO"),
+                   snapshot.angle / 65536.f, snapshot.rate / 65536.f, snapshot.rate_setpoint / 65536.f,
+                   snapshot.command * 100.f / CONTROLE_COMMAND_MAX);
+            next_telemetry = make_timeout_time_ms(TELEMETRY_PERIOD_MS);
+        }
+
+        if (time_reached(next_stats)) {
+            uint32_t irq_state = spin_lock_blocking(shared_lock);
+            loop_stats_t stats = loop_stats;
+            mpu6050_fifo_stats_t imu_snapshot = imu_stats;
+            memset(&loop_stats, 0, sizeof(loop_stats));
+            loop_stats.loop_us_min = UINT32_MAX;
+            spin_unlock(shared_lock, irq_state);
+
+            if (stats.loops > 0 && !binary_telemetry) {
+                printf("Laco: %lu/s | duracao min/media/max %lu/%lu/%lu us | jitter max %lu us | latencia IMU->PWM max %lu us | atrasos %lu | amostras %lu/s (perdas %lu/%lu) | desarmes por IMU parada %lu\n",
+                       (unsigned long)stats.loops, (unsigned long)stats.loop_us_min,
+                       (unsigned long)(stats.loop_us_sum / stats.loops), (unsigned long)stats.loop_us_max,
+                       (unsigned long)stats.jitter_us_max, (unsigned long)stats.latency_us_max, (unsigned long)stats.overruns,
+                       (unsigned long)stats.imu_samples, (unsigned long)imu_snapshot.ring_drops,
+                       (unsigned long)imu_snapshot.fifo_drops, (unsigned long)stats.stale_disarms);
+            }
+            next_stats = make_timeout_time_ms(STATS_PERIOD_MS);
+        }
+
+        sleep_ms(1);
+    }
+}
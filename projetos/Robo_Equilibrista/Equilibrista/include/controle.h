@@ -0,0 +1,67 @@
+// Verifica se a macro CONTROLE_H já foi definida
+#ifndef CONTROLE_H
+// Define a macro CONTROLE_H para evitar múltiplas inclusões
+#define CONTROLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Lei de controle do robô equilibrista em ponto fixo, sem dependência do hardware (usada no firmware e nas simulações no computador)
+// Ângulos em Q16 graus, velocidades angulares em Q16 °/s, velocidade das rodas em Q16 voltas/s, ganhos em Q16 e comando do motor
+// em Q15 (-32767 a 32767 = -100% a 100%)
+
+#define CONTROLE_Q16(x) ((int32_t)((x) * 65536.0)) // Converte uma constante para Q16 (em tempo de compilação)
+#define CONTROLE_COMMAND_MAX 32767 // Comando máximo do motor (100%)
+
+// Controlador PID em ponto fixo
+typedef struct {
+    int32_t kp; // Ganho proporcional (Q16)
+    int32_t ki; // Ganho integral (Q16, por segundo)
+    int32_t kd; // Ganho derivativo (Q16, em segundos)
+    int32_t integral_limit; // Limite do termo integral, na unidade da saída (Q16) - anti-windup
+    int32_t output_limit; // Limite da saída (Q16)
+    int64_t integral; // Termo integral acumulado (Q16·µs: dividido por 10^6 na saída, sem perder erros pequenos)
+    int32_t previous_error; // Erro da atualização anterior (para o termo derivativo)
+    bool primed; // A primeira atualização não tem erro anterior
+} pid_q16_t;
+
+// Ganhos da cascata (alterados pelo núcleo 0 e aplicados pelo laço de controle entre duas iterações)
+typedef struct {
+    int32_t angle_kp; // Malha externa: °/s desejados por grau de erro (Q16)
+    int32_t angle_ki; // Malha externa: integral do erro de ângulo (Q16, por segundo)
+    int32_t rate_kp; // Malha interna: fração de comando por °/s de erro (Q16)
+    int32_t rate_ki; // Malha interna: integral do erro de velocidade angular (Q16, por segundo)
+    int32_t rate_kd; // Malha interna: derivada do erro de velocidade angular (Q16, em segundos)
+    int32_t angle_offset; // Ângulo de equilíbrio (Q16 graus), compensa o centro de massa fora do eixo
+    int32_t speed_kp; // Malha das rodas: graus de inclinação pedidos por volta/s de velocidade (Q16)
+    int32_t speed_ki; // Malha das rodas: graus por volta percorrida (Q16, por segundo)
+} balance_gains_t;
+
+// Controlador em cascata: velocidade das rodas → ângulo desejado → velocidade angular desejada → comando dos motores
+// A malha das rodas inclina o robô para trás quando ele anda para frente: sem ela, um erro constante na estimativa do ângulo
+// (o acelerômetro lê a aceleração das rodas como inclinação) vira aceleração constante até o comando saturar
+typedef struct {
+    pid_q16_t speed_pid; // Malha das rodas (a mais externa)
+    pid_q16_t angle_pid; // Malha externa
+    pid_q16_t rate_pid; // Malha interna
+    int32_t angle_offset; // Ângulo de equilíbrio (Q16 graus)
+    int32_t fall_angle; // Inclinação a partir da qual o robô é considerado caído (Q16 graus)
+    int32_t angle_setpoint; // Último ângulo desejado (Q16 graus), para telemetria
+    int32_t rate_setpoint; // Última velocidade angular desejada (Q16 °/s), para telemetria
+    bool armed; // Motores habilitados
+} balance_controller_t;
+
+void pid_init(pid_q16_t *pid, int32_t kp, int32_t ki, int32_t kd, int32_t integral_limit, int32_t output_limit); // Configura o PID e zera o estado
+void pid_reset(pid_q16_t *pid); // Zera integral e derivada
+int32_t pid_update(pid_q16_t *pid, int32_t error, uint32_t dt_us); // Atualiza com o erro (Q16) e o intervalo desde a última chamada; retorna a saída (Q16)
+
+void balance_init(balance_controller_t *ctrl, const balance_gains_t *gains); // Configura a cascata (desarmada)
+void balance_set_gains(balance_controller_t *ctrl, const balance_gains_t *gains); // Troca os ganhos mantendo o estado dos integradores
+void balance_arm(balance_controller_t *ctrl, bool armed); // Arma ou desarma (zera os integradores)
+int32_t balance_step(balance_controller_t *ctrl, int32_t angle, int32_t rate, int32_t wheel_speed, uint32_t dt_us); // Uma iteração: retorna o comando dos motores (Q15); desarma sozinho se o robô cair
+
+// Velocidade das rodas em relação ao chão (Q16 voltas/s) a partir da velocidade do encoder (contagens/s, medida em relação ao
+// corpo, onde está o motor) e da velocidade angular do corpo (Q16 °/s). counts_per_rev = 0: sem encoders, retorna 0
+int32_t balance_wheel_speed(int32_t counts_per_s, int32_t counts_per_rev, int32_t rate);
+
+#endif // Fim da diretiva de inclusão condicional
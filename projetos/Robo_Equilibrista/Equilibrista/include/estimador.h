@@ -0,0 +1,31 @@
+// Verifica se a macro ESTIMADOR_H já foi definida
+#ifndef ESTIMADOR_H
+// Define a macro ESTIMADOR_H para evitar múltiplas inclusões
+#define ESTIMADOR_H
+
+#include "include/mpu6050.h" // mpu6050_sample_t
+#include "include/attitude.h" // Filtro de Kalman e calibração do giroscópio
+
+// Estimativa da inclinação do robô a partir das amostras do MPU6050, sem dependência do hardware (usada no firmware e na simulação)
+// O primeiro segundo de amostras mede o bias do giroscópio (robô parado); depois, cada amostra atualiza o filtro de Kalman
+
+#define PITCH_ACCEL_H 0 // Eixo do acelerômetro ao longo do robô (X)
+#define PITCH_ACCEL_V 2 // Eixo do acelerômetro na vertical com o robô em pé (Z)
+#define PITCH_GYRO 1 // Eixo do giroscópio em torno do qual o robô tomba (Y)
+
+// Estado do estimador
+typedef struct {
+    attitude_kalman_t kalman;
+    attitude_gyro_cal_t gyro_cal;
+    uint32_t sample_rate_hz; // Taxa nominal das amostras (intervalo da primeira amostra e duração da calibração)
+    bool calibrated; // Bias do giroscópio medido
+    bool have_sample; // Já recebeu alguma amostra
+    uint32_t last_sample_us; // Instante da última amostra
+    int32_t angle; // Ângulo estimado (Q16 graus)
+    int32_t rate; // Velocidade angular sem o bias (Q16 °/s)
+} pitch_estimator_t;
+
+void pitch_estimator_init(pitch_estimator_t *est, uint32_t sample_rate_hz); // Zera o estado e recomeça a calibração
+void pitch_estimator_update(pitch_estimator_t *est, const mpu6050_sample_t *sample); // Consome uma amostra: calibra ou atualiza ângulo e velocidade angular
+
+#endif // Fim da diretiva de inclusão condicional
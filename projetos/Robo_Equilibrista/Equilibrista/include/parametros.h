@@ -0,0 +1,99 @@
+// Verifica se a macro PARAMETROS_H já foi definida
+#ifndef PARAMETROS_H
+// Define a macro PARAMETROS_H para evitar múltiplas inclusões
+#define PARAMETROS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "include/controle.h" // balance_gains_t
+
+// Registro de parâmetros ajustáveis em tempo de execução (ganhos, limites e frequências), com gravação em um setor da flash
+// Os valores ficam em um vetor int32_t indexado por param_id_t; o registro (nome, tipo, faixa e padrão) é constante e fica na flash
+// As funções deste arquivo não dependem do hardware (testadas no computador); a gravação na flash fica em src/parametros_flash.c
+//
+// Imagem na flash (little-endian):
+//   cabeçalho: magic u32 ("PARM"), format_version u16, count u16, crc32 u32 (do cabeçalho com crc32 = 0 e das entradas)
+//   entradas: name_hash u32 (FNV-1a do nome), value i32
+// As entradas são identificadas pelo hash do nome, e não pela posição: parâmetros novos recebem o padrão, parâmetros removidos
+// são ignorados e a ordem do registro pode mudar sem invalidar os valores gravados
+
+#define PARAM_IMAGE_MAGIC 0x4D524150u // "PARM"
+#define PARAM_IMAGE_VERSION 1 // Versão do formato da imagem
+#define PARAM_IMAGE_HEADER_BYTES 12
+#define PARAM_IMAGE_ENTRY_BYTES 8
+#define PARAM_IMAGE_MAX_BYTES (PARAM_IMAGE_HEADER_BYTES + PARAM_COUNT * PARAM_IMAGE_ENTRY_BYTES) // Tamanho da imagem do registro atual
+
+// Tipos de parâmetro
+typedef enum {
+    PARAM_Q16, // Ponto fixo Q16, lido e escrito como número decimal (ex.: 0.02)
+    PARAM_INT, // Inteiro
+} param_type_t;
+
+// Identificadores (índices no vetor de valores)
+typedef enum {
+    PARAM_ANGLE_KP,
+    PARAM_ANGLE_KI,
+    PARAM_RATE_KP,
+    PARAM_RATE_KI,
+    PARAM_RATE_KD,
+    PARAM_ANGLE_OFFSET,
+    PARAM_SPEED_KP,
+    PARAM_SPEED_KI,
+    PARAM_ENCODER_CPR,
+    PARAM_CONTROL_RATE_HZ,
+    PARAM_ARM_MAX_ANGLE,
+    PARAM_IMU_STALE_US,
+    PARAM_MOTOR_PWM_HZ,
+    PARAM_MOTOR_SLEW,
+    PARAM_ACCEL_OFFSET_X, // Desvios do MPU6050 (LSB em ±2 g / ±250 °/s), medidos pelo comando calibrate
+    PARAM_ACCEL_OFFSET_Y,
+    PARAM_ACCEL_OFFSET_Z,
+    PARAM_GYRO_OFFSET_X,
+    PARAM_GYRO_OFFSET_Y,
+    PARAM_GYRO_OFFSET_Z,
+    PARAM_COUNT
+} param_id_t;
+
+// Definição de um parâmetro
+typedef struct {
+    const char *name; // Nome usado nos comandos da serial
+    param_type_t type;
+    int32_t min; // Faixa válida (na representação armazenada: Q16 para PARAM_Q16)
+    int32_t max;
+    int32_t default_value;
+    bool reboot; // Só tem efeito na próxima inicialização (ex.: frequência do PWM)
+    const char *description;
+} param_def_t;
+
+// Resultado da leitura de uma imagem
+typedef enum {
+    PARAM_IMAGE_OK,
+    PARAM_IMAGE_BLANK, // Setor apagado (nunca gravado)
+    PARAM_IMAGE_BAD_MAGIC,
+    PARAM_IMAGE_BAD_VERSION,
+    PARAM_IMAGE_BAD_SIZE,
+    PARAM_IMAGE_BAD_CRC,
+} param_image_status_t;
+
+extern const param_def_t param_defs[PARAM_COUNT]; // Registro
+
+void param_set_defaults(int32_t *values); // Preenche todos os valores padrão
+int param_find(const char *name); // Índice do parâmetro pelo nome (-1 se não existir)
+bool param_set(int32_t *values, int id, int32_t value); // Grava um valor se estiver na faixa
+bool param_parse(int id, const char *text, int32_t *value); // Converte texto (decimal para Q16, inteiro para INT) e confere a faixa
+int param_format(int id, int32_t value, char *out, size_t size); // Texto do valor (como em snprintf)
+
+uint32_t param_crc32(const uint8_t *data, size_t length); // CRC-32 (IEEE 802.3, refletido, polinômio 0xEDB88320)
+uint32_t param_name_hash(const char *name); // FNV-1a de 32 bits
+size_t param_image_encode(const int32_t *values, uint8_t *out, size_t size); // Gera a imagem; retorna o tamanho (0 se não couber)
+param_image_status_t param_image_decode(const uint8_t *image, size_t size, int32_t *values, uint32_t *loaded); // Lê a imagem: padrão para ausentes ou fora da faixa; "loaded" recebe quantos vieram da imagem
+const char *param_image_status_name(param_image_status_t status); // Descrição do resultado
+
+void param_balance_gains(const int32_t *values, balance_gains_t *gains); // Ganhos da cascata a partir dos parâmetros
+uint32_t param_motor_slew(const int32_t *values); // Limite de variação do comando dos motores (Q15 por segundo; 0 = sem limite)
+
+bool param_flash_load(int32_t *values, param_image_status_t *status); // Lê o setor de parâmetros (padrões se inválido); true se a imagem era válida
+bool param_flash_save(const int32_t *values); // Apaga e grava o setor com o outro núcleo pausado (flash_safe_execute)
+
+#endif // Fim da diretiva de inclusão condicional
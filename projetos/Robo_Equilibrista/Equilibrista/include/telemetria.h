@@ -0,0 +1,59 @@
+// Verifica se a macro TELEMETRIA_H já foi definida
+#ifndef TELEMETRIA_H
+// Define a macro TELEMETRIA_H para evitar múltiplas inclusões
+#define TELEMETRIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Telemetria binária do laço de controle
+// O laço (núcleo 1) grava quadros de tamanho fixo em um buffer circular sem trava (um produtor, um consumidor) e nunca espera;
+// o núcleo 0 retira os quadros, acrescenta o CRC-16, codifica com COBS e envia pela USB CDC apenas o que cabe no buffer de transmissão
+//
+// No fio, cada quadro é: COBS(quadro || CRC-16 little-endian) seguido de um byte 0x00 (delimitador)
+// O CRC é o CRC-16/CCITT-FALSE (polinômio 0x1021, valor inicial 0xFFFF) sobre os bytes do quadro
+// Decodificador no computador: tools/telemetria.py
+
+#define TELEMETRIA_RING_SIZE 128 // Quadros no buffer circular (potência de 2): 256 ms a 500 Hz
+#define TELEMETRIA_FRAME_CONTROL 1 // Tipo do quadro do laço de controle
+#define TELEMETRIA_FLAG_ARMED 0x01 // Controlador armado
+#define TELEMETRIA_FLAG_CALIBRATED 0x02 // Bias do giroscópio medido
+#define TELEMETRIA_MAX_ENCODED (sizeof(telemetria_frame_t) + 2 + (sizeof(telemetria_frame_t) + 2) / 254 + 2) // Quadro + CRC + sobrecarga do COBS + delimitador
+
+// Quadro de uma iteração do laço (32 bytes, little-endian, sem preenchimento)
+typedef struct __attribute__((packed)) {
+    uint8_t type; // TELEMETRIA_FRAME_CONTROL
+    uint8_t flags; // TELEMETRIA_FLAG_*
+    uint16_t sequence; // Número da iteração (quadros perdidos aparecem como saltos)
+    uint32_t timestamp_us; // Início da iteração
+    int32_t angle; // Ângulo estimado (Q16 graus)
+    int32_t rate; // Velocidade angular (Q16 °/s)
+    int32_t rate_setpoint; // Saída da malha externa (Q16 °/s)
+    int16_t command_left; // Comando do motor esquerdo (Q15)
+    int16_t command_right; // Comando do motor direito (Q15)
+    uint16_t loop_us; // Duração da iteração anterior
+    int16_t lateness_us; // Atraso do início da iteração em relação ao instante agendado (negativo: adiantada)
+    uint16_t latency_us; // Atraso entre a amostra do MPU6050 e a escrita no PWM da iteração anterior
+    uint16_t dropped; // Quadros descartados até agora por buffer cheio (módulo 65536)
+} telemetria_frame_t;
+
+// Contadores do envio
+typedef struct {
+    uint32_t pushed; // Quadros gravados pelo laço
+    uint32_t dropped; // Quadros descartados por buffer cheio (o núcleo 0 ou a USB não acompanharam)
+    uint32_t sent; // Quadros enviados
+    uint32_t discarded; // Quadros retirados sem envio (telemetria desligada ou USB desconectada)
+    uint32_t bytes; // Bytes enviados
+} telemetria_stats_t;
+
+bool telemetria_push(telemetria_frame_t *frame); // Produtor (laço de controle): copia o quadro para o buffer; com o buffer cheio descarta e retorna false, sem esperar
+bool telemetria_pop(telemetria_frame_t *frame); // Consumidor: retira o quadro mais antigo (false se vazio)
+void telemetria_service(bool enabled); // Consumidor (núcleo 0): envia pela USB CDC os quadros que cabem no buffer de transmissão; desligada, descarta os quadros
+void telemetria_get_stats(telemetria_stats_t *stats); // Copia os contadores
+
+uint16_t telemetria_crc16(const uint8_t *data, size_t length); // CRC-16/CCITT-FALSE
+size_t telemetria_cobs_encode(const uint8_t *data, size_t length, uint8_t *out); // Codifica com COBS (sem o delimitador); retorna o tamanho codificado
+size_t telemetria_encode_frame(const telemetria_frame_t *frame, uint8_t *out); // Quadro completo para o fio (COBS de quadro + CRC, e o 0x00 final); "out" precisa de TELEMETRIA_MAX_ENCODED bytes
+
+#endif // Fim da diretiva de inclusão condicional
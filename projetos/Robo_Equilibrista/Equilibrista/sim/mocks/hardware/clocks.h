@@ -0,0 +1,11 @@
+// Substituto mínimo de hardware/clocks.h: clock do sistema fixo em 125 MHz
+#ifndef MOCK_HARDWARE_CLOCKS_H
+#define MOCK_HARDWARE_CLOCKS_H
+
+#include "pico/stdlib.h"
+
+enum clock_index { clk_sys = 5 };
+
+static inline uint32_t clock_get_hz(enum clock_index clk) { (void)clk; return 125000000; }
+
+#endif
@@ -0,0 +1,28 @@
+// Substituto mínimo de hardware/pwm.h: a simulação guarda o nível de cada canal para calcular a tensão nos motores
+#ifndef MOCK_HARDWARE_PWM_H
+#define MOCK_HARDWARE_PWM_H
+
+#include "pico/stdlib.h"
+
+typedef struct {
+    uint32_t div; // Divisor inteiro
+    uint32_t top; // Wrap
+} pwm_config;
+
+static inline uint pwm_gpio_to_slice_num(uint gpio) { return (gpio >> 1) & 7; }
+static inline uint pwm_gpio_to_channel(uint gpio) { return gpio & 1; }
+static inline pwm_config pwm_get_default_config(void) { return (pwm_config){1, 0xFFFF}; }
+static inline void pwm_config_set_clkdiv_int(pwm_config *c, uint div) { c->div = div; }
+static inline void pwm_config_set_wrap(pwm_config *c, uint16_t wrap) { c->top = wrap; }
+
+void pwm_init(uint slice_num, pwm_config *c, bool start);
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level);
+
+// Registrador de habilitação das fatias (pwm_hw->en) e escrita atômica de bits
+typedef struct {
+    volatile uint32_t en;
+} pwm_hw_t;
+extern pwm_hw_t *const pwm_hw;
+static inline void hw_set_bits(volatile uint32_t *addr, uint32_t mask) { *addr |= mask; }
+
+#endif
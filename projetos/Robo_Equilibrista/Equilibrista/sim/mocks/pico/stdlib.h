@@ -0,0 +1,28 @@
+// Substituto mínimo de pico/stdlib.h para rodar o firmware na simulação (host)
+// Acrescenta os GPIOs ao substituto dos testes do Acelerometro; tempo e pinos são implementados por sim/simulador.c
+#ifndef MOCK_PICO_STDLIB_H
+#define MOCK_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+#define GPIO_FUNC_PWM 4
+
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_put(uint gpio, bool value);
+void gpio_set_function(uint gpio, int function);
+
+#endif
@@ -0,0 +1,592 @@
+// Simulação no computador (host) do robô equilibrista em malha fechada, mais rápida que o tempo real
+// Planta: pêndulo invertido sobre rodas acionado por dois motores DC com caixa de redução, alimentados pela ponte H (TB6612)
+// Firmware: o mesmo código do laço de controle roda sem alterações sobre periféricos simulados
+//   - MPU6050 simulado por um banco de registradores, lido por mpu6050_read() (mesma decodificação do firmware), com bias, ruído,
+//     quantização, saturação do fundo de escala e o atraso do DLPF
+//   - pitch_estimator_update() (calibração do giroscópio e Kalman), balance_step() (PID em cascata) e parâmetros do registro
+//   - motor_driver_set() escreve nos pinos e no PWM simulados; a tensão média na ponte vira corrente e torque nas rodas
+//   - encoders nas rodas (contagem inteira do ângulo da roda em relação ao corpo), lidos por velocity_update() como no Teste_Motores
+//
+// Cada ensaio: o robô é segurado parado com uma inclinação inicial durante a calibração, é armado e solto, e depois recebe um
+// empurrão horizontal. O resultado é o tempo de acomodação e a maior inclinação após soltar e após o empurrão
+//
+// Compilação (a partir da pasta projetos/Robo_Equilibrista/Equilibrista):
+//   gcc -std=c11 -O2 -Isim/mocks -I../Acelerometro/tests/mocks -I. -I../Acelerometro -I../Teste_Motores sim/simulador.c src/controle.c src/estimador.c src/parametros.c ../Acelerometro/src/mpu6050.c ../Acelerometro/src/attitude.c ../Teste_Motores/src/motor.c ../Teste_Motores/src/velocidade.c -lm -o simulador
+//
+// Uso: ./simulador [opções] [parametro=valor | parametro=inicio:fim:passo ...]
+//   Os parâmetros são os mesmos dos comandos da serial (list); faixas geram uma varredura com todas as combinações
+//   --tilt <graus>   inclinação ao soltar (padrão 3)
+//   --push <N>       força do empurrão, aplicada por 100 ms no centro de massa (padrão 1,5; 0 desliga)
+//   --seed <n>       semente do ruído (padrão 1; todas as combinações de uma varredura usam o mesmo ruído)
+//   --ideal          o controlador recebe o ângulo, a velocidade angular e a velocidade das rodas verdadeiros (separa o ajuste dos
+//                    ganhos dos erros do estimador)
+//   --trace          imprime em CSV cada iteração do laço de um único ensaio
+//
+// Código de saída: 0 se nenhum ensaio caiu, 1 se algum caiu ou não armou (para usar como teste de regressão), 2 em erro de uso
+
+#define _GNU_SOURCE // M_PI
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "include/mpu6050.h"
+#include "include/estimador.h"
+#include "include/controle.h"
+#include "include/parametros.h"
+#include "include/motor.h"
+#include "include/velocidade.h"
+#include "hardware/pwm.h"
+
+#define PHYSICS_STEP_US 10 // Passo da integração da planta
+#define IMU_RATE_HZ 1000 // Taxa de amostragem do MPU6050, como no firmware
+#define IMU_READ_US 400 // Atraso entre o dado pronto e a amostra disponível para o laço (leitura I2C de um quadro a 400 kHz)
+#define HOLD_US 1500000 // Robô segurado: 1 s de calibração e 0,5 s para o Kalman convergir
+#define PUSH_DELAY_US 3000000 // Empurrão 3 s depois de soltar
+#define PUSH_US 100000 // Duração do empurrão
+#define AFTER_PUSH_US 3000000 // Observação depois do empurrão
+#define SETTLE_BAND_DEG 0.5 // Acomodado: inclinação dentro de ±0,5° até o fim da janela
+#define SETTLE_MARGIN_US 500000 // Sem acomodação se ainda saiu da faixa no último 0,5 s da janela
+#define GROUND_ANGLE_DEG 80.0 // O corpo encostou no chão
+#define MAX_SWEEP 8 // Parâmetros variados em uma varredura
+#define MAX_VALUES 64 // Valores por parâmetro
+#define GRAVITY 9.81
+#define WHEEL_VELOCITY_WINDOW 10 // Janela da velocidade das rodas (iterações do laço), como em Equilibrista.c
+
+// Pinos da ponte (arbitrários, em fatias de PWM diferentes como no firmware)
+#define SIM_INA1 4
+#define SIM_INA2 9
+#define SIM_PWM_A 8
+#define SIM_INB1 18
+#define SIM_INB2 19
+#define SIM_PWM_B 16
+#define SIM_STAND_BY 20
+
+// Planta: estimativas para um robô pequeno com motores TT 1:48, rodas de 65 mm e bateria 2S; meça o seu robô e ajuste
+static const struct {
+    double body_mass; // Corpo, placas e bateria (kg)
+    double com_height; // Do eixo das rodas ao centro de massa do corpo (m)
+    double body_inertia; // Momento de inércia do corpo em torno do centro de massa (kg·m²)
+    double wheel_radius; // m
+    double wheel_mass; // As duas rodas (kg)
+    double wheel_inertia; // As duas rodas, incluindo o rotor refletido pela redução (kg·m²)
+    double imu_height; // Do eixo das rodas ao MPU6050 (m)
+    double battery_v; // Tensão na ponte (V)
+    double motor_r; // Resistência do enrolamento (Ω)
+    double motor_kt; // Constante de torque na saída da redução, já com a eficiência da caixa (N·m/A)
+    double motor_ke; // Força contraeletromotriz na saída da redução (V·s/rad)
+    double motor_viscous; // Atrito viscoso na saída da redução (N·m·s/rad)
+    double gyro_bias_dps; // Bias do giroscópio (°/s)
+    double gyro_noise_dps; // Desvio padrão do ruído do giroscópio (°/s)
+    double accel_noise_g; // Desvio padrão do ruído do acelerômetro (g)
+} plant = {
+    .body_mass = 0.6,
+    .com_height = 0.07,
+    .body_inertia = 0.001,
+    .wheel_radius = 0.0325,
+    .wheel_mass = 0.06,
+    .wheel_inertia = 0.0002,
+    .imu_height = 0.05,
+    .battery_v = 7.4,
+    .motor_r = 5.0,
+    .motor_kt = 0.08,
+    .motor_ke = 0.28,
+    .motor_viscous = 0.0005,
+    .gyro_bias_dps = 1.5,
+    .gyro_noise_dps = 0.1,
+    .accel_noise_g = 0.01,
+};
+
+// Atraso do DLPF do MPU6050 por configuração (datasheet, em ms), modelado como um filtro de primeira ordem com essa constante de tempo
+static const double dlpf_accel_delay_ms[] = {0.0, 2.0, 3.0, 4.9, 8.5, 13.8, 19.0};
+static const double dlpf_gyro_delay_ms[] = {0.98, 1.9, 2.8, 4.8, 8.3, 13.4, 18.6};
+
+// ---- Periféricos simulados ----
+
+static uint64_t now_us; // Relógio da simulação
+static bool gpio_level[32];
+static uint16_t pwm_level[8][2];
+static uint16_t pwm_wrap[8];
+
+void sleep_ms(uint32_t ms) { now_us += ms * 1000ull; }
+void sleep_us(uint64_t us) { now_us += us; }
+uint32_t time_us_32(void) { return (uint32_t)now_us; }
+uint64_t time_us_64(void) { return now_us; }
+
+void gpio_init(uint gpio) { gpio_level[gpio] = false; }
+void gpio_set_dir(uint gpio, bool out) { (void)gpio; (void)out; }
+void gpio_put(uint gpio, bool value) { gpio_level[gpio] = value; }
+void gpio_set_function(uint gpio, int function) { (void)gpio; (void)function; }
+
+void pwm_init(uint slice_num, pwm_config *c, bool start) { (void)start; pwm_wrap[slice_num] = (uint16_t)c->top; }
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level) { pwm_level[slice_num][chan] = level; }
+static pwm_hw_t pwm_regs;
+pwm_hw_t *const pwm_hw = &pwm_regs;
+
+// MPU6050 no barramento I2C: banco de registradores preenchido pela planta a cada amostra
+static struct i2c_inst { int id; } bus0 = {0}, bus1 = {1};
+i2c_inst_t *const i2c0 = &bus0;
+i2c_inst_t *const i2c1 = &bus1;
+static uint8_t regs[128];
+static uint8_t reg_pointer;
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    if (i2c != i2c0 || addr != MPU6050_ADDRESS) return PICO_ERROR_GENERIC;
+    reg_pointer = src[0];
+    for (size_t i = 1; i < len; i++) {
+        regs[reg_pointer++ & 0x7F] = src[i];
+    }
+    if (reg_pointer == MPU6050_REG_PWR_MGMT_1 + 1 && len == 2 && src[1] & 0x80) { // Reset
+        memset(regs, 0, sizeof(regs));
+        regs[MPU6050_REG_WHO_AM_I] = MPU6050_WHO_AM_I_VALUE;
+    }
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)nostop;
+    if (i2c != i2c0 || addr != MPU6050_ADDRESS) return PICO_ERROR_GENERIC;
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = regs[reg_pointer++ & 0x7F];
+    }
+    return (int)len;
+}
+
+static void set_reg16(uint8_t reg, double value) {
+    long rounded = lround(value);
+    int16_t saturated = (int16_t)(rounded > INT16_MAX ? INT16_MAX : (rounded < INT16_MIN ? INT16_MIN : rounded));
+    regs[reg] = (uint8_t)((uint16_t)saturated >> 8);
+    regs[reg + 1] = (uint8_t)saturated;
+}
+
+static uint32_t rng_state;
+
+static uint32_t rand_32() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Ruído gaussiano (Box-Muller)
+static double gaussian() {
+    double u1 = (rand_32() + 1.0) / 4294967297.0;
+    double u2 = (rand_32() + 1.0) / 4294967297.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// ---- Ensaio ----
+
+// Configuração de um ensaio
+typedef struct {
+    int32_t params[PARAM_COUNT];
+    double tilt_deg; // Inclinação ao soltar
+    double push_n; // Força do empurrão
+    uint32_t seed;
+    bool ideal; // Controlador com o estado verdadeiro no lugar da estimativa
+    bool trace;
+} scenario_t;
+
+// Resultado de um ensaio
+typedef struct {
+    bool armed; // O controlador aceitou armar
+    bool fell; // Caiu (controlador desarmou por inclinação ou o corpo chegou ao chão)
+    double fall_s; // Instante da queda, desde a soltura
+    double settle_s; // Tempo de acomodação após soltar (negativo se não acomodou)
+    double max_deg; // Maior inclinação após soltar
+    double push_settle_s; // Tempo de acomodação após o empurrão (negativo se não acomodou)
+    double push_max_deg; // Maior inclinação após o empurrão
+    double command_rms; // Comando RMS (fração de 100%)
+    double saturated; // Fração das iterações com o comando saturado
+    double drift_m; // Deslocamento das rodas no fim do ensaio
+} result_t;
+
+// Estado da planta: deslocamento das rodas e inclinação do corpo (positiva para frente)
+typedef struct {
+    double x, v; // m, m/s
+    double theta, omega; // rad, rad/s
+    double wheel_rad; // Ângulo das rodas em relação ao corpo, o que o encoder mede (rad)
+    double accel_h, accel_v, gyro_dps; // Saídas verdadeiras do sensor após o DLPF (g, g, °/s)
+} plant_state_t;
+
+// Torque de um motor na roda a partir dos pinos e do PWM, como na ponte TB6612 (PWM baixo = freio, IN1 = IN2 = 0 ou STBY baixo = livre)
+static double motor_torque(const motor_t *motor, double relative_rad_s) {
+    bool in1 = gpio_level[motor->pins.in1], in2 = gpio_level[motor->pins.in2];
+    if (!gpio_level[SIM_STAND_BY] || (!in1 && !in2)) {
+        return 0.0;
+    }
+    double duty = in1 && in2 ? 0.0 : pwm_level[motor->slice][motor->channel] / (pwm_wrap[motor->slice] + 1.0);
+    double voltage = (in1 ? 1.0 : -1.0) * duty * plant.battery_v; // Tensão média: a corrente do motor não acompanha os 20 kHz
+    double current = (voltage - plant.motor_ke * relative_rad_s) / plant.motor_r;
+    return plant.motor_kt * current - plant.motor_viscous * relative_rad_s;
+}
+
+// Avança a planta um passo (Euler semi-implícito); force_n empurra o centro de massa para frente
+static void plant_step(plant_state_t *s, const motor_driver_t *motors, double force_n, bool held, double alpha_accel, double alpha_gyro) {
+    double dt = PHYSICS_STEP_US * 1e-6;
+    double xdd = 0.0, thdd = 0.0;
+
+    if (!held) {
+        double r = plant.wheel_radius, l = plant.com_height, m = plant.body_mass;
+        double relative = s->v / r - s->omega; // Rotação das rodas em relação ao corpo (onde está o estator)
+        double torque = motor_torque(&motors->left, relative) + motor_torque(&motors->right, relative);
+
+        // Lagrange com x e theta: [a, b·cos; b·cos, c]·[x''; theta''] = [Qx; Qtheta]
+        double a = m + plant.wheel_mass + plant.wheel_inertia / (r * r);
+        double b = m * l;
+        double c = plant.body_inertia + m * l * l;
+        double sn = sin(s->theta), cs = cos(s->theta);
+        double qx = torque / r + b * sn * s->omega * s->omega + force_n;
+        double qt = b * GRAVITY * sn - torque + force_n * l * cs; // A reação do torque das rodas inclina o corpo para trás
+        double det = a * c - b * b * cs * cs;
+        xdd = (c * qx - b * cs * qt) / det;
+        thdd = (a * qt - b * cs * qx) / det;
+
+        s->v += xdd * dt;
+        s->x += s->v * dt;
+        s->omega += thdd * dt;
+        s->theta += s->omega * dt;
+        s->wheel_rad += (s->v / r - s->omega) * dt;
+        if (fabs(s->theta) > GROUND_ANGLE_DEG * M_PI / 180.0) { // No chão
+            s->theta = copysign(GROUND_ANGLE_DEG * M_PI / 180.0, s->theta);
+            s->omega = 0.0;
+        }
+    }
+
+    // Força específica no MPU6050, nos eixos do sensor montados como o firmware espera (PITCH_ACCEL_H positivo com o robô tombado para frente)
+    double sn = sin(s->theta), cs = cos(s->theta), h = plant.imu_height;
+    double ax = xdd + h * (thdd * cs - s->omega * s->omega * sn);
+    double az = -h * (thdd * sn + s->omega * s->omega * cs) + GRAVITY;
+    s->accel_h += alpha_accel * ((-ax * cs + az * sn) / GRAVITY - s->accel_h);
+    s->accel_v += alpha_accel * ((ax * sn + az * cs) / GRAVITY - s->accel_v);
+    s->gyro_dps += alpha_gyro * (s->omega * 180.0 / M_PI - s->gyro_dps);
+}
+
+// Coeficiente do filtro de primeira ordem para o passo da planta
+static double lag_alpha(double delay_ms) {
+    double dt_ms = PHYSICS_STEP_US / 1000.0;
+    return dt_ms / (delay_ms + dt_ms);
+}
+
+// Converte as saídas do sensor para os registradores, com bias, ruído, quantização e saturação
+static void imu_write_registers(const mpu6050_t *imu, const plant_state_t *s) {
+    double lsb_g = mpu6050_accel_lsb_per_g(imu->accel_range);
+    double lsb_dps = mpu6050_gyro_lsb_per_10dps(imu->gyro_range) / 10.0;
+    double accel[3] = {0.0, 0.0, 0.0}, gyro[3];
+    accel[PITCH_ACCEL_H] = s->accel_h;
+    accel[PITCH_ACCEL_V] = s->accel_v;
+    for (int i = 0; i < 3; i++) {
+        gyro[i] = (i == PITCH_GYRO ? s->gyro_dps : 0.0) + plant.gyro_bias_dps + plant.gyro_noise_dps * gaussian();
+        set_reg16(MPU6050_REG_ACCEL_XOUT_H + 2 * i, (accel[i] + plant.accel_noise_g * gaussian()) * lsb_g);
+        set_reg16(MPU6050_REG_ACCEL_XOUT_H + 8 + 2 * i, gyro[i] * lsb_dps);
+    }
+    set_reg16(MPU6050_REG_ACCEL_XOUT_H + 6, (25.0 - 36.53) * 340.0); // 25 °C
+}
+
+// Acompanha a acomodação: último instante fora da faixa e maior inclinação numa janela
+typedef struct {
+    uint64_t start_us;
+    uint64_t last_outside_us;
+    double max_deg;
+} settle_t;
+
+static void settle_update(settle_t *st, double tilt_deg) {
+    if (fabs(tilt_deg) > SETTLE_BAND_DEG) st->last_outside_us = now_us;
+    if (fabs(tilt_deg) > st->max_deg) st->max_deg = fabs(tilt_deg);
+}
+
+static double settle_time(const settle_t *st, uint64_t end_us) {
+    if (st->last_outside_us + SETTLE_MARGIN_US > end_us) return -1.0;
+    return (st->last_outside_us - st->start_us) * 1e-6;
+}
+
+// Fila das amostras lidas pelo "DMA", liberadas para o laço depois do tempo de leitura
+#define SAMPLE_QUEUE 8
+
+static void run(const scenario_t *sc, result_t *res) {
+    memset(res, 0, sizeof(*res));
+    now_us = 0;
+    rng_state = sc->seed * 2654435761u | 1;
+    memset(gpio_level, 0, sizeof(gpio_level));
+
+    mpu6050_t imu;
+    if (!mpu6050_init(&imu, i2c0, MPU6050_ADDRESS) || !mpu6050_configure(&imu, MPU6050_ACCEL_2G, MPU6050_GYRO_250DPS, MPU6050_DLPF_44HZ)) {
+        fprintf(stderr, "MPU6050 simulado nao respondeu\n");
+        exit(1);
+    }
+    double alpha_accel = lag_alpha(dlpf_accel_delay_ms[imu.dlpf]);
+    double alpha_gyro = lag_alpha(dlpf_gyro_delay_ms[imu.dlpf]);
+
+    motor_driver_t motors;
+    motor_config_t config = {
+        .left = {.in1 = SIM_INA1, .in2 = SIM_INA2, .pwm = SIM_PWM_A, .inverted = false},
+        .right = {.in1 = SIM_INB1, .in2 = SIM_INB2, .pwm = SIM_PWM_B, .inverted = false},
+        .standby_pin = SIM_STAND_BY,
+        .pwm_hz = (uint32_t)sc->params[PARAM_MOTOR_PWM_HZ],
+        .slew_per_s = param_motor_slew(sc->params),
+    };
+    motor_driver_init(&motors, &config);
+    motor_driver_stop(&motors, MOTOR_COAST);
+
+    // Mesma sequência do núcleo 1 do firmware
+    balance_controller_t controller;
+    balance_gains_t gains;
+    param_balance_gains(sc->params, &gains);
+    balance_init(&controller, &gains);
+    pitch_estimator_t estimator;
+    pitch_estimator_init(&estimator, IMU_RATE_HZ);
+    velocity_estimator_t wheel_velocity;
+    velocity_init(&wheel_velocity, WHEEL_VELOCITY_WINDOW);
+    int32_t encoder_cpr = sc->params[PARAM_ENCODER_CPR];
+
+    plant_state_t s = {.theta = sc->tilt_deg * M_PI / 180.0};
+    s.accel_h = sin(s.theta);
+    s.accel_v = cos(s.theta);
+
+    mpu6050_sample_t queue[SAMPLE_QUEUE];
+    uint64_t ready_us[SAMPLE_QUEUE];
+    unsigned head = 0, tail = 0;
+
+    uint32_t period_us = 1000000 / (uint32_t)sc->params[PARAM_CONTROL_RATE_HZ];
+    uint64_t start_us = now_us; // A inicialização do MPU6050 avançou o relógio
+    uint64_t release_us = start_us + HOLD_US;
+    uint64_t push_us = release_us + PUSH_DELAY_US;
+    uint64_t end_us = push_us + AFTER_PUSH_US;
+    uint64_t next_sample_us = start_us, next_loop_us = start_us + period_us;
+    uint32_t last_loop_us = 0;
+    settle_t release = {.start_us = release_us, .last_outside_us = release_us}, push = {.start_us = push_us, .last_outside_us = push_us};
+    double command_sq = 0.0;
+    uint32_t loops = 0, saturated = 0;
+
+    if (sc->trace) {
+        printf("t_s,angulo_real,angulo_estimado,angulo_desejado,velocidade_estimada,velocidade_desejada,rodas_voltas_s,comando,posicao_m,velocidade_m_s\n");
+    }
+
+    while (now_us < end_us && !res->fell) {
+        bool held = now_us < release_us;
+        double force = now_us >= push_us && now_us < push_us + PUSH_US ? sc->push_n : 0.0;
+        plant_step(&s, &motors, force, held, alpha_accel, alpha_gyro);
+        now_us += PHYSICS_STEP_US;
+
+        if (now_us >= next_sample_us) { // Dado pronto: o firmware lê o quadro em seguida
+            imu_write_registers(&imu, &s);
+            mpu6050_read(&imu, &queue[head % SAMPLE_QUEUE]);
+            ready_us[head % SAMPLE_QUEUE] = now_us + IMU_READ_US;
+            head++;
+            next_sample_us += 1000000 / IMU_RATE_HZ;
+        }
+
+        if (now_us < next_loop_us) {
+            continue;
+        }
+
+        // Uma iteração do laço de controle, como control_loop() no firmware
+        uint32_t start = time_us_32();
+        uint32_t dt_us = last_loop_us != 0 ? start - last_loop_us : period_us;
+        last_loop_us = start;
+        next_loop_us += period_us;
+
+        if (now_us >= release_us && !res->armed && !controller.armed) { // Pedido de armar no instante em que o robô é solto
+            int32_t tilt = estimator.angle - controller.angle_offset;
+            int32_t arm_max = sc->params[PARAM_ARM_MAX_ANGLE];
+            if (estimator.calibrated && tilt < arm_max && tilt > -arm_max) {
+                balance_arm(&controller, true);
+                res->armed = true;
+            } else {
+                return; // Não armou: o robô cairia sem controle
+            }
+        }
+
+        while (tail != head && ready_us[tail % SAMPLE_QUEUE] <= now_us) {
+            pitch_estimator_update(&estimator, &queue[tail % SAMPLE_QUEUE]);
+            tail++;
+        }
+        if (controller.armed && start - estimator.last_sample_us > (uint32_t)sc->params[PARAM_IMU_STALE_US]) {
+            balance_arm(&controller, false);
+        }
+
+        int32_t count = (int32_t)floor(s.wheel_rad / (2.0 * M_PI) * encoder_cpr); // As duas rodas giram juntas: um encoder basta
+        int32_t counts_per_s = velocity_update(&wheel_velocity, count, start);
+        int32_t angle = estimator.angle, rate = estimator.rate;
+        int32_t wheel_speed = balance_wheel_speed(counts_per_s, encoder_cpr, rate);
+        if (sc->ideal) {
+            angle = (int32_t)lround(s.theta * 180.0 / M_PI * 65536.0);
+            rate = (int32_t)lround(s.omega * 180.0 / M_PI * 65536.0);
+            wheel_speed = encoder_cpr > 0 ? (int32_t)lround(s.v / (2.0 * M_PI * plant.wheel_radius) * 65536.0) : 0;
+        }
+        int32_t command = balance_step(&controller, angle, rate, wheel_speed, dt_us);
+        if (controller.armed) {
+            motor_driver_set(&motors, command, command, dt_us);
+        } else {
+            motor_driver_stop(&motors, MOTOR_COAST);
+        }
+
+        double tilt_deg = s.theta * 180.0 / M_PI;
+        if (res->armed) {
+            if (!controller.armed || fabs(tilt_deg) >= GROUND_ANGLE_DEG) {
+                res->fell = true;
+                res->fall_s = (now_us - release_us) * 1e-6;
+            }
+            settle_update(now_us < push_us ? &release : &push, tilt_deg);
+            command_sq += (double)command * command;
+            saturated += command >= CONTROLE_COMMAND_MAX || command <= -CONTROLE_COMMAND_MAX;
+            loops++;
+        }
+        if (sc->trace) {
+            printf("%.4f,%.3f,%.3f,%.3f,%.2f,%.2f,%.3f,%.4f,%.4f,%.4f\n", (now_us - start_us) * 1e-6, tilt_deg, estimator.angle / 65536.0,
+                   controller.angle_setpoint / 65536.0, estimator.rate / 65536.0, controller.rate_setpoint / 65536.0, wheel_speed / 65536.0,
+                   command / 32767.0, s.x, s.v);
+        }
+    }
+
+    res->settle_s = res->fell ? -1.0 : settle_time(&release, push_us);
+    res->max_deg = release.max_deg;
+    res->push_settle_s = res->fell ? -1.0 : settle_time(&push, end_us);
+    res->push_max_deg = push.max_deg;
+    res->command_rms = loops ? sqrt(command_sq / loops) / 32767.0 : 0.0;
+    res->saturated = loops ? (double)saturated / loops : 0.0;
+    res->drift_m = s.x;
+}
+
+// ---- Varredura ----
+
+typedef struct {
+    int id;
+    int count;
+    int32_t values[MAX_VALUES];
+} sweep_t;
+
+// "nome=valor" ou "nome=inicio:fim:passo"; cada valor passa por param_parse(), como no comando set
+static bool parse_sweep(const char *arg, sweep_t *sw) {
+    char name[32];
+    const char *eq = strchr(arg, '=');
+    if (eq == NULL || eq - arg >= (long)sizeof(name)) return false;
+    memcpy(name, arg, eq - arg);
+    name[eq - arg] = '\0';
+    sw->id = param_find(name);
+    sw->count = 0;
+    if (sw->id < 0) {
+        fprintf(stderr, "Parametro desconhecido: %s\n", name);
+        return false;
+    }
+
+    double start, end, step;
+    char text[32];
+    if (sscanf(eq + 1, "%lf:%lf:%lf", &start, &end, &step) == 3 && step > 0.0) {
+        for (double value = start; value <= end + step * 1e-6 && sw->count < MAX_VALUES; value += step) {
+            snprintf(text, sizeof(text), "%.6g", value);
+            if (!param_parse(sw->id, text, &sw->values[sw->count++])) {
+                fprintf(stderr, "Valor fora da faixa para %s: %s\n", name, text);
+                return false;
+            }
+        }
+        return sw->count > 0;
+    }
+    if (!param_parse(sw->id, eq + 1, &sw->values[0])) {
+        fprintf(stderr, "Valor invalido para %s: %s\n", name, eq + 1);
+        return false;
+    }
+    sw->count = 1;
+    return true;
+}
+
+static void print_header(const sweep_t *sweeps, int count) {
+    for (int i = 0; i < count; i++) {
+        printf("%-15s ", param_defs[sweeps[i].id].name);
+    }
+    printf("%-9s %9s %8s %9s %8s %8s %7s %8s\n", "resultado", "acomod_s", "max_deg", "empurr_s", "max_deg", "cmd_rms", "satur", "deriva_m");
+}
+
+static void print_result(const scenario_t *sc, const sweep_t *sweeps, int count, const result_t *res) {
+    char text[24];
+    for (int i = 0; i < count; i++) {
+        param_format(sweeps[i].id, sc->params[sweeps[i].id], text, sizeof(text));
+        printf("%-15s ", text);
+    }
+    if (!res->armed) {
+        printf("%-9s\n", "NAO ARMOU");
+        return;
+    }
+    const char *verdict = res->fell ? "CAIU" : (res->settle_s < 0 || res->push_settle_s < 0 ? "OSCILA" : "ESTAVEL");
+    char settle[16], push_settle[16];
+    snprintf(settle, sizeof(settle), res->settle_s < 0 ? "-" : "%.2f", res->settle_s);
+    snprintf(push_settle, sizeof(push_settle), res->push_settle_s < 0 ? "-" : "%.2f", res->push_settle_s);
+    if (res->fell) snprintf(settle, sizeof(settle), "em %.2f", res->fall_s);
+    printf("%-9s %9s %8.2f %9s %8.2f %7.1f%% %6.1f%% %8.3f\n", verdict, settle, res->max_deg, push_settle, res->push_max_deg,
+           res->command_rms * 100.0, res->saturated * 100.0, res->drift_m);
+}
+
+int main(int argc, char **argv) {
+    scenario_t sc = {.tilt_deg = 3.0, .push_n = 1.5, .seed = 1, .ideal = false, .trace = false};
+    param_set_defaults(sc.params);
+    sweep_t sweeps[MAX_SWEEP];
+    int sweep_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tilt") == 0 && i + 1 < argc) {
+            sc.tilt_deg = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--push") == 0 && i + 1 < argc) {
+            sc.push_n = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            sc.seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--ideal") == 0) {
+            sc.ideal = true;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            sc.trace = true;
+        } else if (sweep_count < MAX_SWEEP && parse_sweep(argv[i], &sweeps[sweep_count])) {
+            sweep_count++;
+        } else {
+            fprintf(stderr, "Uso: %s [--tilt graus] [--push N] [--seed n] [--ideal] [--trace] [parametro=valor | parametro=inicio:fim:passo ...]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int total = 1;
+    for (int i = 0; i < sweep_count; i++) {
+        total *= sweeps[i].count;
+    }
+    if (sc.trace && total != 1) {
+        fprintf(stderr, "--trace exige um unico ensaio\n");
+        return 2;
+    }
+
+    if (!sc.trace) {
+        printf("Planta: corpo %.2f kg com centro de massa a %.0f mm, rodas de %.0f mm, %.1f V | inclinacao inicial %.1f graus, empurrao %.1f N por %d ms%s\n",
+               plant.body_mass, plant.com_height * 1000, plant.wheel_radius * 2000, plant.battery_v, sc.tilt_deg, sc.push_n, PUSH_US / 1000,
+               sc.ideal ? " | estado verdadeiro no controlador" : "");
+        print_header(sweeps, sweep_count);
+    }
+
+    clock_t begin = clock();
+    int index[MAX_SWEEP] = {0};
+    int stable = 0;
+    int fallen = 0; // Ensaios que caíram ou não armaram
+    for (int n = 0; n < total; n++) {
+        for (int i = 0; i < sweep_count; i++) {
+            sc.params[sweeps[i].id] = sweeps[i].values[index[i]];
+        }
+        result_t res;
+        run(&sc, &res);
+        stable += res.armed && !res.fell && res.settle_s >= 0 && res.push_settle_s >= 0;
+        fallen += !res.armed || res.fell;
+        if (!sc.trace) {
+            print_result(&sc, sweeps, sweep_count, &res);
+        }
+        for (int i = sweep_count - 1; i >= 0; i--) { // Próxima combinação (o último parâmetro varia mais rápido)
+            if (++index[i] < sweeps[i].count) break;
+            index[i] = 0;
+        }
+    }
+    double wall_s = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+    if (!sc.trace) {
+        double simulated_s = total * (HOLD_US + PUSH_DELAY_US + AFTER_PUSH_US) * 1e-6;
+        printf("%d de %d ensaios estaveis | %.1f s simulados em %.2f s de processamento\n", stable, total, simulated_s, wall_s);
+    }
+    if (fallen > 0) {
+        fprintf(stderr, "%d de %d ensaios cairam ou nao armaram\n", fallen, total);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "include/controle.h" // Declarações da lei de controle
+
+#define FALL_ANGLE_DEG 35 // Inclinação a partir da qual o robô é considerado caído e os motores são desligados
+#define SPEED_ANGLE_LIMIT CONTROLE_Q16(10) // Inclinação máxima pedida pela malha das rodas (graus)
+#define SPEED_INTEGRAL_LIMIT CONTROLE_Q16(8) // Parcela máxima do integral da malha das rodas (graus)
+#define ANGLE_RATE_LIMIT CONTROLE_Q16(250) // Velocidade angular máxima pedida pela malha externa (°/s)
+#define ANGLE_INTEGRAL_LIMIT CONTROLE_Q16(60) // Parcela máxima do integral da malha externa (°/s)
+#define RATE_OUTPUT_LIMIT CONTROLE_Q16(1.0) // Saída máxima da malha interna (100% de comando)
+#define RATE_INTEGRAL_LIMIT CONTROLE_Q16(0.5) // Parcela máxima do integral da malha interna (50% de comando)
+#define PID_DT_MAX_US 100000 // Intervalo máximo somado ao integral (um laço parado não despeja segundos de erro de uma vez)
+
+// Satura um valor no intervalo [-limit, limit]
+static int32_t clamp(int64_t value, int32_t limit) {
+    return value > limit ? limit : (value < -limit ? -limit : (int32_t)value);
+}
+
+// Configura o PID e zera o estado
+void pid_init(pid_q16_t *pid, int32_t kp, int32_t ki, int32_t kd, int32_t integral_limit, int32_t output_limit) {
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->integral_limit = integral_limit;
+    pid->output_limit = output_limit;
+    pid_reset(pid);
+}
+
+// Zera integral e derivada
+void pid_reset(pid_q16_t *pid) {
+    pid->integral = 0;
+    pid->previous_error = 0;
+    pid->primed = false;
+}
+
+// saída = kp·e + Σ ki·e·dt + kd·Δe/dt, com o integral limitado (anti-windup) e a saída saturada
+int32_t pid_update(pid_q16_t *pid, int32_t error, uint32_t dt_us) {
+    if (dt_us == 0) {
+        dt_us = 1;
+    }
+
+    int64_t proportional = ((int64_t)pid->kp * error) >> 16;
+
+    // O ganho multiplica o erro antes da soma: trocar ki em tempo de execução não provoca salto na saída
+    // A soma fica em Q16·µs e só é dividida na saída: um erro pequeno (ki·e·dt abaixo de 1 em Q16) ainda acumula
+    uint32_t dt_integral = dt_us > PID_DT_MAX_US ? PID_DT_MAX_US : dt_us;
+    int64_t step = (((int64_t)pid->ki * error) * dt_integral) >> 16;
+    int64_t limit = (int64_t)pid->integral_limit * 1000000;
+    int64_t integral = pid->integral + step;
+    pid->integral = integral > limit ? limit : (integral < -limit ? -limit : integral);
+
+    int64_t derivative = 0;
+    if (pid->primed && pid->kd != 0) {
+        derivative = (((int64_t)pid->kd * (error - pid->previous_error)) >> 16) * 1000000 / dt_us;
+    }
+    pid->previous_error = error;
+    pid->primed = true;
+
+    return clamp(proportional + pid->integral / 1000000 + derivative, pid->output_limit);
+}
+
+// Configura a cascata (desarmada)
+void balance_init(balance_controller_t *ctrl, const balance_gains_t *gains) {
+    pid_init(&ctrl->speed_pid, 0, 0, 0, SPEED_INTEGRAL_LIMIT, SPEED_ANGLE_LIMIT);
+    pid_init(&ctrl->angle_pid, 0, 0, 0, ANGLE_INTEGRAL_LIMIT, ANGLE_RATE_LIMIT);
+    pid_init(&ctrl->rate_pid, 0, 0, 0, RATE_INTEGRAL_LIMIT, RATE_OUTPUT_LIMIT);
+    ctrl->fall_angle = CONTROLE_Q16(FALL_ANGLE_DEG);
+    ctrl->angle_setpoint = 0;
+    ctrl->rate_setpoint = 0;
+    ctrl->armed = false;
+    balance_set_gains(ctrl, gains);
+}
+
+// Troca os ganhos mantendo o estado dos integradores
+void balance_set_gains(balance_controller_t *ctrl, const balance_gains_t *gains) {
+    ctrl->angle_pid.kp = gains->angle_kp;
+    ctrl->angle_pid.ki = gains->angle_ki;
+    ctrl->rate_pid.kp = gains->rate_kp;
+    ctrl->rate_pid.ki = gains->rate_ki;
+    ctrl->rate_pid.kd = gains->rate_kd;
+    ctrl->angle_offset = gains->angle_offset;
+    ctrl->speed_pid.kp = gains->speed_kp;
+    ctrl->speed_pid.ki = gains->speed_ki;
+}
+
+// Arma ou desarma; os integradores sempre recomeçam do zero
+void balance_arm(balance_controller_t *ctrl, bool armed) {
+    pid_reset(&ctrl->speed_pid);
+    pid_reset(&ctrl->angle_pid);
+    pid_reset(&ctrl->rate_pid);
+    ctrl->angle_setpoint = ctrl->angle_offset;
+    ctrl->rate_setpoint = 0;
+    ctrl->armed = armed;
+}
+
+// Convenção de sinais: ângulo, velocidade angular e velocidade das rodas positivos = para frente; comando positivo = rodas para frente
+// Malha das rodas: erro = −velocidade → inclinação somada ao equilíbrio (andando para frente: pede inclinação para trás, que freia)
+// Malha externa: erro = ângulo desejado − ângulo → velocidade angular desejada (tombou para frente: pede rotação para trás)
+// Malha interna: erro = velocidade medida − desejada → comando (o corpo gira para trás quando as rodas aceleram para frente)
+int32_t balance_step(balance_controller_t *ctrl, int32_t angle, int32_t rate, int32_t wheel_speed, uint32_t dt_us) {
+    int32_t tilt = angle - ctrl->angle_offset;
+    if (tilt > ctrl->fall_angle || tilt < -ctrl->fall_angle) { // Caiu: desliga os motores até ser armado de novo
+        if (ctrl->armed) {
+            balance_arm(ctrl, false);
+        }
+        return 0;
+    }
+    if (!ctrl->armed) {
+        return 0;
+    }
+
+    ctrl->angle_setpoint = ctrl->angle_offset + pid_update(&ctrl->speed_pid, -wheel_speed, dt_us);
+    ctrl->rate_setpoint = pid_update(&ctrl->angle_pid, ctrl->angle_setpoint - angle, dt_us);
+    int32_t command = pid_update(&ctrl->rate_pid, rate - ctrl->rate_setpoint, dt_us);
+
+    return clamp(command >> 1, CONTROLE_COMMAND_MAX); // Q16 (1,0 = 100%) para Q15
+}
+
+// Voltas/s da roda em relação ao corpo mais as do corpo em relação ao chão: o encoder gira junto com o corpo quando ele inclina
+int32_t balance_wheel_speed(int32_t counts_per_s, int32_t counts_per_rev, int32_t rate) {
+    if (counts_per_rev <= 0) {
+        return 0;
+    }
+    return (int32_t)(((int64_t)counts_per_s << 16) / counts_per_rev + rate / 360);
+}
@@ -0,0 +1,30 @@
+#include "include/estimador.h" // Declarações do estimador
+
+// Zera o estado e recomeça a calibração
+void pitch_estimator_init(pitch_estimator_t *est, uint32_t sample_rate_hz) {
+    attitude_kalman_init(&est->kalman, ATTITUDE_Q24(0.001), ATTITUDE_Q24(0.003), ATTITUDE_Q24(1.0));
+    attitude_gyro_cal_reset(&est->gyro_cal);
+    est->sample_rate_hz = sample_rate_hz;
+    est->calibrated = false;
+    est->have_sample = false;
+    est->last_sample_us = 0;
+    est->angle = 0;
+    est->rate = 0;
+}
+
+// Consome uma amostra; o intervalo entre amostras vem dos instantes de leitura, e não da taxa nominal
+void pitch_estimator_update(pitch_estimator_t *est, const mpu6050_sample_t *sample) {
+    uint32_t dt_us = est->have_sample ? sample->timestamp_us - est->last_sample_us : 1000000 / est->sample_rate_hz;
+    est->last_sample_us = sample->timestamp_us;
+    est->have_sample = true;
+
+    if (!est->calibrated) { // O primeiro segundo com o robô parado mede o bias do giroscópio
+        est->calibrated = attitude_gyro_cal_add(&est->gyro_cal, sample->gyro_mdps, est->sample_rate_hz);
+        return;
+    }
+
+    int32_t accel_angle = attitude_accel_angle(sample->accel_mg[PITCH_ACCEL_H], sample->accel_mg[PITCH_ACCEL_V]);
+    int32_t rate_mdps = sample->gyro_mdps[PITCH_GYRO] - est->gyro_cal.bias_mdps[PITCH_GYRO];
+    est->angle = attitude_kalman_update(&est->kalman, accel_angle, rate_mdps, dt_us);
+    est->rate = (int32_t)(((int64_t)rate_mdps * 4294967) >> 16) - est->kalman.bias; // m°/s para Q16 °/s, menos o bias residual estimado pelo Kalman
+}
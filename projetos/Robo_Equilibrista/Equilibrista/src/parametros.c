@@ -0,0 +1,230 @@
+#include <stdio.h> // Para snprintf()
+#include <stdlib.h> // Para strtol() e strtod()
+#include <string.h> // Para strcmp() e memcpy()
+#include "include/parametros.h" // Declarações do registro
+
+#define Q16(x) CONTROLE_Q16(x)
+
+// Registro: valores padrão iguais aos usados antes dos parâmetros em tempo de execução
+const param_def_t param_defs[PARAM_COUNT] = {
+    [PARAM_ANGLE_KP] = {"angle_kp", PARAM_Q16, Q16(0), Q16(100), Q16(8.0), false, "malha de angulo: graus/s desejados por grau de erro"},
+    [PARAM_ANGLE_KI] = {"angle_ki", PARAM_Q16, Q16(0), Q16(100), Q16(0.0), false, "malha de angulo: ganho integral (por segundo)"},
+    [PARAM_RATE_KP] = {"rate_kp", PARAM_Q16, Q16(0), Q16(1), Q16(0.02), false, "malha de velocidade: fracao de comando por grau/s de erro"},
+    [PARAM_RATE_KI] = {"rate_ki", PARAM_Q16, Q16(0), Q16(10), Q16(0.05), false, "malha de velocidade: ganho integral (por segundo)"},
+    [PARAM_RATE_KD] = {"rate_kd", PARAM_Q16, Q16(0), Q16(0.1), Q16(0.0), false, "malha de velocidade: ganho derivativo (segundos)"},
+    [PARAM_ANGLE_OFFSET] = {"angle_offset", PARAM_Q16, Q16(-10), Q16(10), Q16(0.0), false, "angulo de equilibrio (graus)"},
+    [PARAM_SPEED_KP] = {"speed_kp", PARAM_Q16, Q16(0), Q16(50), Q16(14.0), false, "malha das rodas: graus de inclinacao por volta/s"},
+    [PARAM_SPEED_KI] = {"speed_ki", PARAM_Q16, Q16(0), Q16(50), Q16(2.0), false, "malha das rodas: graus por volta percorrida (por segundo)"},
+    [PARAM_ENCODER_CPR] = {"encoder_cpr", PARAM_INT, 0, 10000, 1440, false, "contagens do encoder por volta da roda (0 = sem encoders)"},
+    [PARAM_CONTROL_RATE_HZ] = {"control_rate_hz", PARAM_INT, 100, 1000, 500, false, "frequencia do laco de controle (Hz)"},
+    [PARAM_ARM_MAX_ANGLE] = {"arm_max_angle", PARAM_Q16, Q16(1), Q16(20), Q16(5.0), false, "inclinacao maxima para armar (graus)"},
+    [PARAM_IMU_STALE_US] = {"imu_stale_us", PARAM_INT, 2000, 100000, 20000, false, "tempo sem amostras do MPU6050 ate desarmar (us)"},
+    [PARAM_MOTOR_PWM_HZ] = {"motor_pwm_hz", PARAM_INT, 1000, 50000, 20000, true, "frequencia do PWM dos motores (Hz)"},
+    [PARAM_MOTOR_SLEW] = {"motor_slew", PARAM_Q16, Q16(0), Q16(100), Q16(0.0), false, "variacao maxima do comando por segundo (fracao/s; 0 = sem limite)"},
+    [PARAM_ACCEL_OFFSET_X] = {"accel_offset_x", PARAM_INT, -8192, 8192, 0, false, "desvio do acelerometro X (LSB de +-2 g)"},
+    [PARAM_ACCEL_OFFSET_Y] = {"accel_offset_y", PARAM_INT, -8192, 8192, 0, false, "desvio do acelerometro Y (LSB de +-2 g)"},
+    [PARAM_ACCEL_OFFSET_Z] = {"accel_offset_z", PARAM_INT, -8192, 8192, 0, false, "desvio do acelerometro Z (LSB de +-2 g)"},
+    [PARAM_GYRO_OFFSET_X] = {"gyro_offset_x", PARAM_INT, -13100, 13100, 0, false, "desvio do giroscopio X (LSB de +-250 graus/s)"},
+    [PARAM_GYRO_OFFSET_Y] = {"gyro_offset_y", PARAM_INT, -13100, 13100, 0, false, "desvio do giroscopio Y (LSB de +-250 graus/s)"},
+    [PARAM_GYRO_OFFSET_Z] = {"gyro_offset_z", PARAM_INT, -13100, 13100, 0, false, "desvio do giroscopio Z (LSB de +-250 graus/s)"},
+};
+
+// Preenche todos os valores padrão
+void param_set_defaults(int32_t *values) {
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        values[i] = param_defs[i].default_value;
+    }
+}
+
+// Índice do parâmetro pelo nome
+int param_find(const char *name) {
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        if (strcmp(param_defs[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Grava um valor se estiver na faixa
+bool param_set(int32_t *values, int id, int32_t value) {
+    if (id < 0 || id >= PARAM_COUNT || value < param_defs[id].min || value > param_defs[id].max) {
+        return false;
+    }
+    values[id] = value;
+    return true;
+}
+
+// Converte o texto para a representação armazenada e confere a faixa
+bool param_parse(int id, const char *text, int32_t *value) {
+    if (id < 0 || id >= PARAM_COUNT) {
+        return false;
+    }
+
+    char *end;
+    int64_t parsed;
+    if (param_defs[id].type == PARAM_Q16) {
+        double number = strtod(text, &end);
+        if (number > 32767.0 || number < -32768.0) {
+            return false;
+        }
+        parsed = (int64_t)(number * 65536.0 + (number >= 0 ? 0.5 : -0.5));
+    } else {
+        parsed = strtol(text, &end, 10);
+    }
+    if (end == text || *end != '\0' || parsed < param_defs[id].min || parsed > param_defs[id].max) {
+        return false;
+    }
+
+    *value = (int32_t)parsed;
+    return true;
+}
+
+// Texto do valor: Q16 com 5 casas decimais (resolução de 1/65536 ≈ 0,000015)
+int param_format(int id, int32_t value, char *out, size_t size) {
+    if (param_defs[id].type == PARAM_Q16) {
+        return snprintf(out, size, "%.5f", value / 65536.0);
+    }
+    return snprintf(out, size, "%ld", (long)value);
+}
+
+// CRC-32 bit a bit, em partes: a imagem só é calculada ao ler ou gravar a flash
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+// CRC-32 de um bloco
+uint32_t param_crc32(const uint8_t *data, size_t length) {
+    return ~crc32_update(0xFFFFFFFFu, data, length);
+}
+
+// FNV-1a de 32 bits
+uint32_t param_name_hash(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void put_u32(uint8_t *out, uint32_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get_u32(const uint8_t *in) {
+    return in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+// Gera a imagem (serializada byte a byte: independe do alinhamento e da ordem dos bytes da máquina)
+size_t param_image_encode(const int32_t *values, uint8_t *out, size_t size) {
+    size_t length = PARAM_IMAGE_HEADER_BYTES + PARAM_COUNT * PARAM_IMAGE_ENTRY_BYTES;
+    if (size < length) {
+        return 0;
+    }
+
+    put_u32(out, PARAM_IMAGE_MAGIC);
+    out[4] = (uint8_t)PARAM_IMAGE_VERSION;
+    out[5] = (uint8_t)(PARAM_IMAGE_VERSION >> 8);
+    out[6] = (uint8_t)PARAM_COUNT;
+    out[7] = (uint8_t)(PARAM_COUNT >> 8);
+    put_u32(out + 8, 0);
+
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        uint8_t *entry = out + PARAM_IMAGE_HEADER_BYTES + i * PARAM_IMAGE_ENTRY_BYTES;
+        put_u32(entry, param_name_hash(param_defs[i].name));
+        put_u32(entry + 4, (uint32_t)values[i]);
+    }
+
+    put_u32(out + 8, param_crc32(out, length));
+    return length;
+}
+
+// Lê a imagem; os valores só são alterados se ela for válida
+param_image_status_t param_image_decode(const uint8_t *image, size_t size, int32_t *values, uint32_t *loaded) {
+    *loaded = 0;
+    if (size < PARAM_IMAGE_HEADER_BYTES) {
+        return PARAM_IMAGE_BAD_SIZE;
+    }
+
+    uint32_t magic = get_u32(image);
+    if (magic == 0xFFFFFFFFu) {
+        return PARAM_IMAGE_BLANK;
+    }
+    if (magic != PARAM_IMAGE_MAGIC) {
+        return PARAM_IMAGE_BAD_MAGIC;
+    }
+    uint16_t version = image[4] | (image[5] << 8);
+    if (version != PARAM_IMAGE_VERSION) {
+        return PARAM_IMAGE_BAD_VERSION;
+    }
+    uint16_t count = image[6] | (image[7] << 8);
+    size_t length = PARAM_IMAGE_HEADER_BYTES + (size_t)count * PARAM_IMAGE_ENTRY_BYTES;
+    if (length > size) {
+        return PARAM_IMAGE_BAD_SIZE;
+    }
+
+    // CRC calculado com o campo do CRC zerado, como na gravação
+    uint8_t header[PARAM_IMAGE_HEADER_BYTES];
+    memcpy(header, image, 8);
+    put_u32(header + 8, 0);
+    uint32_t crc = crc32_update(0xFFFFFFFFu, header, sizeof(header));
+    crc = crc32_update(crc, image + PARAM_IMAGE_HEADER_BYTES, length - PARAM_IMAGE_HEADER_BYTES);
+    if (~crc != get_u32(image + 8)) {
+        return PARAM_IMAGE_BAD_CRC;
+    }
+
+    param_set_defaults(values);
+    for (uint16_t e = 0; e < count; e++) {
+        const uint8_t *entry = image + PARAM_IMAGE_HEADER_BYTES + e * PARAM_IMAGE_ENTRY_BYTES;
+        uint32_t hash = get_u32(entry);
+        for (int i = 0; i < PARAM_COUNT; i++) {
+            if (param_name_hash(param_defs[i].name) == hash) {
+                if (param_set(values, i, (int32_t)get_u32(entry + 4))) { // Fora da faixa (faixa alterada no firmware novo): fica o padrão
+                    (*loaded)++;
+                }
+                break;
+            }
+        }
+    }
+    return PARAM_IMAGE_OK;
+}
+
+// Descrição do resultado
+const char *param_image_status_name(param_image_status_t status) {
+    switch (status) {
+        case PARAM_IMAGE_OK: return "ok";
+        case PARAM_IMAGE_BLANK: return "setor vazio";
+        case PARAM_IMAGE_BAD_MAGIC: return "assinatura invalida";
+        case PARAM_IMAGE_BAD_VERSION: return "versao do formato diferente";
+        case PARAM_IMAGE_BAD_SIZE: return "tamanho invalido";
+        case PARAM_IMAGE_BAD_CRC: return "CRC invalido";
+    }
+    return "?";
+}
+
+// Ganhos da cascata a partir dos parâmetros
+void param_balance_gains(const int32_t *values, balance_gains_t *gains) {
+    gains->angle_kp = values[PARAM_ANGLE_KP];
+    gains->angle_ki = values[PARAM_ANGLE_KI];
+    gains->rate_kp = values[PARAM_RATE_KP];
+    gains->rate_ki = values[PARAM_RATE_KI];
+    gains->rate_kd = values[PARAM_RATE_KD];
+    gains->angle_offset = values[PARAM_ANGLE_OFFSET];
+    gains->speed_kp = values[PARAM_SPEED_KP];
+    gains->speed_ki = values[PARAM_SPEED_KI];
+}
+
+// Fração por segundo (Q16) para Q15 por segundo, a escala do comando e do driver dos motores
+uint32_t param_motor_slew(const int32_t *values) {
+    return (uint32_t)(((int64_t)values[PARAM_MOTOR_SLEW] * CONTROLE_COMMAND_MAX) >> 16);
+}
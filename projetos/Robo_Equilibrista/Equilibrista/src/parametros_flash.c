@@ -0,0 +1,45 @@
+#include <string.h> // Para memset() e memcmp()
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "pico/flash.h" // flash_safe_execute()
+#include "hardware/flash.h" // Apagamento e gravação da flash
+#include "include/parametros.h" // Registro e formato da imagem
+
+#define PARAM_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE) // Último setor da flash, longe do programa
+#define PARAM_FLASH_BYTES (((PARAM_IMAGE_MAX_BYTES) + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE * FLASH_PAGE_SIZE) // A gravação é feita em páginas inteiras
+#define PARAM_FLASH_TIMEOUT_MS 100 // Espera máxima para pausar o outro núcleo
+
+static uint8_t image_buffer[PARAM_FLASH_BYTES]; // Imagem a gravar (precisa estar na RAM)
+
+// Executada com o outro núcleo pausado e as interrupções desligadas: nada pode rodar da flash enquanto ela é apagada
+static void write_sector(void *param) {
+    (void)param;
+    flash_range_erase(PARAM_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(PARAM_FLASH_OFFSET, image_buffer, sizeof(image_buffer));
+}
+
+// A flash é lida diretamente pelo mapeamento XIP; com a imagem inválida, os valores ficam nos padrões
+bool param_flash_load(int32_t *values, param_image_status_t *status) {
+    const uint8_t *image = (const uint8_t *)(XIP_BASE + PARAM_FLASH_OFFSET);
+    uint32_t loaded;
+    *status = param_image_decode(image, FLASH_SECTOR_SIZE, values, &loaded);
+    if (*status != PARAM_IMAGE_OK) {
+        param_set_defaults(values);
+        return false;
+    }
+    return true;
+}
+
+// Grava e confere lendo de volta
+bool param_flash_save(const int32_t *values) {
+    memset(image_buffer, 0xFF, sizeof(image_buffer));
+    if (param_image_encode(values, image_buffer, sizeof(image_buffer)) == 0) {
+        return false;
+    }
+    if (flash_safe_execute(write_sector, NULL, PARAM_FLASH_TIMEOUT_MS) != PICO_OK) {
+        return false;
+    }
+
+    int32_t check[PARAM_COUNT];
+    param_image_status_t status;
+    return param_flash_load(check, &status) && memcmp(check, values, sizeof(check)) == 0;
+}
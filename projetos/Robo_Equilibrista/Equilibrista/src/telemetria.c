@@ -0,0 +1,131 @@
+#include <string.h> // Para memcpy()
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "hardware/sync.h" // Barreiras de memória entre os núcleos
+#include "tusb.h" // Estado e espaço livre da USB CDC
+#include "include/telemetria.h" // Declarações da telemetria
+
+// Buffer circular de um produtor e um consumidor: cada índice só é escrito por um dos lados, e as barreiras garantem que o quadro
+// esteja completo na memória antes de o índice avançar (e que o consumidor termine a cópia antes de liberar a posição)
+static telemetria_frame_t ring[TELEMETRIA_RING_SIZE];
+static volatile uint32_t write_index = 0; // Escrito apenas pelo produtor
+static volatile uint32_t read_index = 0; // Escrito apenas pelo consumidor
+static volatile uint32_t pushed = 0; // Contadores do produtor
+static volatile uint32_t dropped = 0;
+static telemetria_stats_t consumer_stats; // Contadores do consumidor (sent, discarded, bytes)
+
+static uint8_t pending[TELEMETRIA_MAX_ENCODED]; // Quadro codificado aguardando espaço na USB
+static size_t pending_length = 0;
+
+// Produtor: O(1), sem trava e sem espera
+bool telemetria_push(telemetria_frame_t *frame) {
+    uint32_t w = write_index;
+    if (w - read_index >= TELEMETRIA_RING_SIZE) {
+        dropped++;
+        return false;
+    }
+    frame->dropped = (uint16_t)dropped;
+    ring[w & (TELEMETRIA_RING_SIZE - 1)] = *frame;
+    __dmb(); // O quadro precisa estar visível para o outro núcleo antes do índice
+    write_index = w + 1;
+    pushed++;
+    return true;
+}
+
+// Consumidor: retira o quadro mais antigo
+bool telemetria_pop(telemetria_frame_t *frame) {
+    uint32_t r = read_index;
+    if (r == write_index) {
+        return false;
+    }
+    __dmb(); // Lê o quadro só depois de ver o índice atualizado
+    *frame = ring[r & (TELEMETRIA_RING_SIZE - 1)];
+    __dmb(); // Termina a cópia antes de devolver a posição ao produtor
+    read_index = r + 1;
+    return true;
+}
+
+// CRC-16/CCITT-FALSE, bit a bit: ~35 bytes por quadro no núcleo 0, sem tabela ocupando memória
+uint16_t telemetria_crc16(const uint8_t *data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// COBS: cada bloco começa com a distância até o próximo zero (ou 0xFF para um bloco de 254 bytes sem zero), então a saída não contém 0x00
+size_t telemetria_cobs_encode(const uint8_t *data, size_t length, uint8_t *out) {
+    size_t code_index = 0;
+    size_t out_index = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] == 0) {
+            out[code_index] = code;
+            code_index = out_index++;
+            code = 1;
+            continue;
+        }
+        out[out_index++] = data[i];
+        if (++code == 0xFF) {
+            out[code_index] = code;
+            code_index = out_index++;
+            code = 1;
+        }
+    }
+    out[code_index] = code;
+    return out_index;
+}
+
+// Quadro + CRC, codificados com COBS e terminados pelo delimitador
+size_t telemetria_encode_frame(const telemetria_frame_t *frame, uint8_t *out) {
+    uint8_t raw[sizeof(telemetria_frame_t) + 2];
+    memcpy(raw, frame, sizeof(telemetria_frame_t));
+    uint16_t crc = telemetria_crc16(raw, sizeof(telemetria_frame_t));
+    raw[sizeof(telemetria_frame_t)] = (uint8_t)crc;
+    raw[sizeof(telemetria_frame_t) + 1] = (uint8_t)(crc >> 8);
+
+    size_t length = telemetria_cobs_encode(raw, sizeof(raw), out);
+    out[length++] = 0x00;
+    return length;
+}
+
+// Envia apenas o que cabe no buffer de transmissão da CDC: nunca espera o computador ler (stdio_usb espera até 500 ms com o buffer cheio)
+// Um quadro que não cabe fica pendente e tem prioridade na próxima chamada; enquanto isso, o buffer circular absorve a diferença
+void telemetria_service(bool enabled) {
+    telemetria_frame_t frame;
+
+    if (!enabled || !tud_cdc_connected()) {
+        while (telemetria_pop(&frame)) {
+            consumer_stats.discarded++;
+        }
+        pending_length = 0;
+        return;
+    }
+
+    while (true) {
+        if (pending_length == 0) {
+            if (!telemetria_pop(&frame)) {
+                break;
+            }
+            pending_length = telemetria_encode_frame(&frame, pending);
+        }
+        if (tud_cdc_write_available() < pending_length) {
+            break;
+        }
+        stdio_put_string((const char *)pending, (int)pending_length, false, false); // Sem conversão de \n em \r\n: os bytes são binários
+        consumer_stats.sent++;
+        consumer_stats.bytes += pending_length;
+        pending_length = 0;
+    }
+}
+
+// Copia os contadores
+void telemetria_get_stats(telemetria_stats_t *stats) {
+    *stats = consumer_stats;
+    stats->pushed = pushed;
+    stats->dropped = dropped;
+}
@@ -0,0 +1,99 @@
+// Teste no computador (host) do PID em ponto fixo da lei de controle
+// Confere que um erro pequeno e constante, cujo ki·e·dt de cada iteração fica abaixo de 1 em Q16, ainda acumula no integral
+// (a 1 kHz, como no laço do núcleo 1), que o integral integra na taxa certa e que ele respeita o limite (anti-windup)
+//
+// Compilação e execução (a partir da pasta projetos/Robo_Equilibrista/Equilibrista):
+//   gcc -std=c11 -O2 -I. tests/teste_controle.c src/controle.c -o teste_controle && ./teste_controle
+
+#include <stdio.h>
+#include <stdint.h>
+#include "include/controle.h"
+
+static int failures = 0;
+
+static void check(int condition, const char *message) {
+    if (!condition) {
+        printf("FALHA: %s\n", message);
+        failures++;
+    }
+}
+
+// Só o integral: kp = kd = 0
+static int32_t run_integral(int32_t ki, int32_t error, int steps, uint32_t dt_us, int32_t limit) {
+    pid_q16_t pid;
+    pid_init(&pid, 0, ki, 0, limit, CONTROLE_Q16(1000));
+    int32_t output = 0;
+    for (int i = 0; i < steps; i++) {
+        output = pid_update(&pid, error, dt_us);
+    }
+    return output;
+}
+
+static void test_small_error(void) {
+    // ki = 0,05/s (o padrão de rate_ki) e erro de 0,1: 0,005 por segundo, ou 327 em Q16. A cada iteração de 1 ms,
+    // ki·e·dt vale 0,33 em Q16 (antes, truncado para 0 em toda iteração)
+    int32_t output = run_integral(CONTROLE_Q16(0.05), CONTROLE_Q16(0.1), 10000, 1000, CONTROLE_Q16(60));
+    int32_t expected = (int32_t)((int64_t)CONTROLE_Q16(0.05) * CONTROLE_Q16(0.1) * 10 >> 16); // 10 s, com ki e erro já arredondados em Q16
+    check(output > 0, "erro pequeno deveria acumular no integral");
+    check(output >= expected - 2 && output <= expected + 2, "integral de 10 s de erro pequeno");
+    printf("erro pequeno: %ld (esperado %ld)\n", (long)output, (long)expected);
+
+    // O mesmo no sentido negativo
+    check(run_integral(CONTROLE_Q16(0.05), -CONTROLE_Q16(0.1), 10000, 1000, CONTROLE_Q16(60)) == -output, "simetrico");
+}
+
+static void test_rate(void) {
+    // ki = 2/s, erro de 3°, 1 s em passos de 1 ms: 6 °/s
+    int32_t output = run_integral(CONTROLE_Q16(2), CONTROLE_Q16(3), 1000, 1000, CONTROLE_Q16(60));
+    check(output >= CONTROLE_Q16(6) - 2 && output <= CONTROLE_Q16(6) + 2, "integral de 1 s");
+
+    // O mesmo tempo em passos maiores dá o mesmo integral
+    check(run_integral(CONTROLE_Q16(2), CONTROLE_Q16(3), 100, 10000, CONTROLE_Q16(60)) == output, "independe do passo");
+}
+
+static void test_limit(void) {
+    int32_t limit = CONTROLE_Q16(5);
+    check(run_integral(CONTROLE_Q16(100), CONTROLE_Q16(30), 10000, 1000, limit) == limit, "limite positivo");
+    check(run_integral(CONTROLE_Q16(100), -CONTROLE_Q16(30), 10000, 1000, limit) == -limit, "limite negativo");
+
+    // Saindo do limite: o integral volta assim que o erro troca de sinal (não ficou acumulado além do limite)
+    pid_q16_t pid;
+    pid_init(&pid, 0, CONTROLE_Q16(1), 0, limit, CONTROLE_Q16(1000));
+    for (int i = 0; i < 100000; i++) pid_update(&pid, CONTROLE_Q16(30), 1000);
+    int32_t output = pid_update(&pid, -CONTROLE_Q16(30), 1000);
+    check(output < limit, "sem acumular alem do limite");
+
+    // Um intervalo longo (laço parado) soma no máximo 100 ms
+    int32_t long_gap = run_integral(CONTROLE_Q16(1), CONTROLE_Q16(1), 1, 5000000, CONTROLE_Q16(60));
+    check(long_gap == CONTROLE_Q16(0.1), "intervalo longo limitado");
+}
+
+// Malha das rodas: andando para frente, o ângulo desejado vai para trás do equilíbrio
+static void test_wheel_speed(void) {
+    balance_gains_t gains = {.angle_kp = CONTROLE_Q16(8), .rate_kp = CONTROLE_Q16(0.02), .angle_offset = CONTROLE_Q16(1),
+                             .speed_kp = CONTROLE_Q16(14)};
+    balance_controller_t ctrl;
+    balance_init(&ctrl, &gains);
+    balance_arm(&ctrl, true);
+
+    balance_step(&ctrl, CONTROLE_Q16(1), 0, CONTROLE_Q16(0.5), 2000);
+    check(ctrl.angle_setpoint == CONTROLE_Q16(1) - CONTROLE_Q16(7), "0,5 volta/s para frente: 7 graus para tras");
+    balance_step(&ctrl, CONTROLE_Q16(1), 0, CONTROLE_Q16(5), 2000);
+    check(ctrl.angle_setpoint == CONTROLE_Q16(1) - CONTROLE_Q16(10), "inclinacao pedida limitada a 10 graus");
+    balance_step(&ctrl, CONTROLE_Q16(1), 0, 0, 2000);
+    check(ctrl.angle_setpoint == CONTROLE_Q16(1) && ctrl.rate_setpoint == 0, "parado no equilibrio: nada a corrigir");
+
+    // 1440 contagens por volta: 720 contagens/s são 0,5 volta/s; o corpo girando 360 °/s para trás soma -1 volta/s
+    check(balance_wheel_speed(720, 1440, 0) == CONTROLE_Q16(0.5), "contagens para voltas/s");
+    check(balance_wheel_speed(720, 1440, -CONTROLE_Q16(360)) == -CONTROLE_Q16(0.5), "rotacao do corpo somada");
+    check(balance_wheel_speed(720, 0, 0) == 0, "sem encoders");
+}
+
+int main(void) {
+    test_small_error();
+    test_rate();
+    test_limit();
+    test_wheel_speed();
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+// Teste no computador (host) do registro de parâmetros e do formato da imagem gravada na flash
+// Confere os padrões e as faixas do registro, a conversão de texto, a ida e volta da imagem, a detecção de setor vazio, assinatura,
+// versão e CRC inválidos, e a compatibilidade entre versões do firmware (parâmetros desconhecidos, ausentes ou fora da faixa)
+//
+// Compilação e execução (a partir da pasta projetos/Robo_Equilibrista/Equilibrista):
+//   gcc -std=c11 -O2 -I. tests/teste_parametros.c src/parametros.c -o teste_parametros && ./teste_parametros
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "include/parametros.h"
+
+static int failures = 0;
+
+static void check(int condition, const char *message) {
+    if (!condition) {
+        printf("FALHA: %s\n", message);
+        failures++;
+    }
+}
+
+static void put_u32(uint8_t *out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+// Recalcula o CRC de uma imagem alterada pelo teste
+static void reseal(uint8_t *image, size_t length) {
+    put_u32(image + 8, 0);
+    put_u32(image + 8, param_crc32(image, length));
+}
+
+static void test_registry() {
+    int32_t values[PARAM_COUNT];
+    param_set_defaults(values);
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        check(param_defs[i].name != NULL, "parametro sem nome");
+        check(values[i] >= param_defs[i].min && values[i] <= param_defs[i].max, "padrao fora da faixa");
+        check(param_find(param_defs[i].name) == i, "param_find deveria achar o proprio indice");
+        for (int j = 0; j < i; j++) {
+            check(param_name_hash(param_defs[i].name) != param_name_hash(param_defs[j].name), "hashes de nomes repetidos");
+        }
+    }
+    check(param_find("inexistente") == -1, "nome inexistente deveria retornar -1");
+
+    // Texto -> valor
+    int32_t value;
+    check(param_parse(PARAM_RATE_KP, "0.02", &value) && value == 1311, "0.02 em Q16 deveria ser 1311");
+    check(param_parse(PARAM_ANGLE_OFFSET, "-1.5", &value) && value == -98304, "-1.5 em Q16");
+    check(param_parse(PARAM_CONTROL_RATE_HZ, "250", &value) && value == 250, "inteiro valido");
+    check(!param_parse(PARAM_CONTROL_RATE_HZ, "5000", &value), "acima do maximo deveria falhar");
+    check(!param_parse(PARAM_CONTROL_RATE_HZ, "25x", &value), "texto com lixo deveria falhar");
+    check(!param_parse(PARAM_CONTROL_RATE_HZ, "", &value), "texto vazio deveria falhar");
+    check(!param_parse(PARAM_RATE_KP, "1e9", &value), "Q16 fora do intervalo representavel deveria falhar");
+    check(!param_set(values, PARAM_RATE_KP, param_defs[PARAM_RATE_KP].max + 1), "param_set fora da faixa deveria falhar");
+
+    // Valor -> texto -> valor
+    char text[24];
+    param_format(PARAM_RATE_KD, 123, text, sizeof(text));
+    check(param_parse(PARAM_RATE_KD, text, &value) && value == 123, "formatacao Q16 deveria voltar ao mesmo valor");
+}
+
+static void test_image() {
+    int32_t values[PARAM_COUNT], loaded_values[PARAM_COUNT];
+    uint8_t image[PARAM_IMAGE_MAX_BYTES + 16];
+    uint32_t loaded;
+
+    // Ida e volta com valores diferentes dos padrões
+    param_set_defaults(values);
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        values[i] = param_defs[i].max - i;
+    }
+    size_t length = param_image_encode(values, image, sizeof(image));
+    check(length == PARAM_IMAGE_HEADER_BYTES + PARAM_COUNT * PARAM_IMAGE_ENTRY_BYTES, "tamanho da imagem");
+    check(param_image_encode(values, image, length - 1) == 0, "buffer pequeno deveria falhar");
+    check(param_image_decode(image, length, loaded_values, &loaded) == PARAM_IMAGE_OK, "imagem valida deveria ser aceita");
+    check(loaded == PARAM_COUNT && memcmp(values, loaded_values, sizeof(values)) == 0, "ida e volta deveria preservar os valores");
+    check(image[0] == 'P' && image[1] == 'A' && image[2] == 'R' && image[3] == 'M', "assinatura PARM no inicio");
+    printf("Imagem: %zu bytes para %d parametros\n", length, PARAM_COUNT);
+
+    // Setor apagado, assinatura, versão e tamanho
+    uint8_t blank[64];
+    memset(blank, 0xFF, sizeof(blank));
+    check(param_image_decode(blank, sizeof(blank), loaded_values, &loaded) == PARAM_IMAGE_BLANK, "setor apagado");
+    uint8_t copy[sizeof(image)];
+    memcpy(copy, image, length);
+    copy[0] ^= 1;
+    check(param_image_decode(copy, length, loaded_values, &loaded) == PARAM_IMAGE_BAD_MAGIC, "assinatura errada");
+    memcpy(copy, image, length);
+    copy[4] = PARAM_IMAGE_VERSION + 1;
+    reseal(copy, length);
+    check(param_image_decode(copy, length, loaded_values, &loaded) == PARAM_IMAGE_BAD_VERSION, "versao diferente");
+    check(param_image_decode(image, length - 1, loaded_values, &loaded) == PARAM_IMAGE_BAD_SIZE, "imagem truncada");
+
+    // Qualquer bit trocado nas entradas ou no cabeçalho é detectado pelo CRC
+    int undetected = 0;
+    for (size_t bit = 0; bit < length * 8; bit++) {
+        if (bit / 8 < 6) continue; // Assinatura e versão têm verificação própria
+        memcpy(copy, image, length);
+        copy[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        param_image_status_t status = param_image_decode(copy, sizeof(copy), loaded_values, &loaded);
+        if (status == PARAM_IMAGE_OK) undetected++;
+    }
+    check(undetected == 0, "toda troca de um bit deveria ser detectada");
+
+    // Imagem de outra versão do firmware: uma entrada de parâmetro removido, uma fora da faixa atual e um parâmetro ausente
+    memcpy(copy, image, length);
+    uint8_t *first = copy + PARAM_IMAGE_HEADER_BYTES;
+    uint8_t *second = first + PARAM_IMAGE_ENTRY_BYTES;
+    put_u32(first, param_name_hash("parametro_removido"));
+    put_u32(second + 4, (uint32_t)(param_defs[1].max + 1));
+    copy[6] = PARAM_COUNT - 1; // A última entrada fica de fora (parâmetro novo no firmware)
+    size_t shorter = length - PARAM_IMAGE_ENTRY_BYTES;
+    reseal(copy, shorter);
+    check(param_image_decode(copy, shorter, loaded_values, &loaded) == PARAM_IMAGE_OK, "imagem de outra versao deveria ser aceita");
+    check(loaded == PARAM_COUNT - 3, "so as entradas conhecidas e validas deveriam ser carregadas");
+    check(loaded_values[0] == param_defs[0].default_value, "parametro sem entrada deveria ficar no padrao");
+    check(loaded_values[1] == param_defs[1].default_value, "valor fora da faixa deveria voltar ao padrao");
+    check(loaded_values[PARAM_COUNT - 1] == param_defs[PARAM_COUNT - 1].default_value, "parametro novo deveria ficar no padrao");
+    check(loaded_values[2] == values[2], "demais parametros deveriam vir da imagem");
+
+    // Ordem das entradas não importa
+    memcpy(copy, image, length);
+    uint8_t swap[PARAM_IMAGE_ENTRY_BYTES];
+    memcpy(swap, first, sizeof(swap));
+    memcpy(first, copy + length - PARAM_IMAGE_ENTRY_BYTES, sizeof(swap));
+    memcpy(copy + length - PARAM_IMAGE_ENTRY_BYTES, swap, sizeof(swap));
+    reseal(copy, length);
+    check(param_image_decode(copy, length, loaded_values, &loaded) == PARAM_IMAGE_OK && memcmp(values, loaded_values, sizeof(values)) == 0,
+          "entradas em outra ordem deveriam produzir os mesmos valores");
+
+    check(param_crc32((const uint8_t *)"123456789", 9) == 0xCBF43926u, "CRC-32 do vetor de verificacao padrao");
+}
+
+int main() {
+    test_registry();
+    test_image();
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}
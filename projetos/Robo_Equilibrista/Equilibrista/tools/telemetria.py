@@ -0,0 +1,253 @@
+#!/usr/bin/env python3
+"""Decodificador e gráfico da telemetria binária do Equilibrista (src/telemetria.c).
+
+Cada quadro chega como COBS(quadro || CRC-16) seguido de 0x00. O quadro tem 32 bytes little-endian:
+
+    type u8, flags u8, sequence u16, timestamp_us u32,
+    angle i32 (Q16 graus), rate i32 (Q16 graus/s), rate_setpoint i32 (Q16 graus/s),
+    command_left i16 (Q15), command_right i16 (Q15),
+    loop_us u16, lateness_us i16, latency_us u16, dropped u16
+
+O CRC é o CRC-16/CCITT-FALSE sobre os 32 bytes. Quadros com CRC errado (por exemplo, texto do printf
+misturado ao fluxo) são contados e descartados.
+
+Uso:
+    python3 tools/telemetria.py /dev/ttyACM0 --toggle            # envia o comando bin (liga os quadros binários) e mostra um resumo por segundo
+    python3 tools/telemetria.py /dev/ttyACM0 --csv > ensaio.csv   # uma linha CSV por quadro, em unidades físicas
+    python3 tools/telemetria.py /dev/ttyACM0 --plot               # gráfico ao vivo (requer matplotlib)
+    python3 tools/telemetria.py captura.bin --csv                 # decodifica uma captura gravada
+
+O dispositivo é aberto uma vez só, para leitura e escrita, e posto em modo bruto (tty.setraw): sem eco,
+sem modo canônico e sem tradução de 0x0D, que corromperiam os quadros COBS e devolveriam o fluxo binário
+ao interpretador de comandos do firmware. A USB CDC ignora a taxa em baud; basta a biblioteca padrão
+(em sistemas com termios), exceto para --plot.
+"""
+
+import argparse
+import collections
+import os
+import stat
+import struct
+import sys
+import time
+
+FRAME = struct.Struct("<BBHIiiihhHhHH")
+FRAME_CONTROL = 1
+FLAG_ARMED = 0x01
+FLAG_CALIBRATED = 0x02
+FIELDS = ("sequence", "timestamp_us", "armed", "calibrated", "angle_deg", "rate_dps", "rate_setpoint_dps",
+          "command_left", "command_right", "loop_us", "lateness_us", "latency_us", "dropped")
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE (polinômio 0x1021, valor inicial 0xFFFF)."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    """Decodifica um bloco COBS (sem o delimitador); retorna None se estiver malformado."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_frame(payload):
+    """Confere tamanho, CRC e tipo; retorna um dicionário em unidades físicas ou None."""
+    if len(payload) != FRAME.size + 2:
+        return None
+    body, crc = payload[:FRAME.size], payload[FRAME.size] | (payload[FRAME.size + 1] << 8)
+    if crc16(body) != crc:
+        return None
+    (frame_type, flags, sequence, timestamp_us, angle, rate, rate_setpoint, command_left, command_right,
+     loop_us, lateness_us, latency_us, dropped) = FRAME.unpack(body)
+    if frame_type != FRAME_CONTROL:
+        return None
+    return {
+        "sequence": sequence,
+        "timestamp_us": timestamp_us,
+        "armed": int(bool(flags & FLAG_ARMED)),
+        "calibrated": int(bool(flags & FLAG_CALIBRATED)),
+        "angle_deg": angle / 65536.0,
+        "rate_dps": rate / 65536.0,
+        "rate_setpoint_dps": rate_setpoint / 65536.0,
+        "command_left": command_left / 32767.0,
+        "command_right": command_right / 32767.0,
+        "loop_us": loop_us,
+        "lateness_us": lateness_us,
+        "latency_us": latency_us,
+        "dropped": dropped,
+    }
+
+
+class Decoder:
+    """Separa os quadros pelo delimitador 0x00 e acumula os contadores de erro e de perda."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.frames = 0
+        self.bad = 0
+        self.lost = 0
+        self.last_sequence = None
+
+    def feed(self, data):
+        self.buffer += data
+        while True:
+            end = self.buffer.find(b"\x00")
+            if end < 0:
+                return
+            chunk = bytes(self.buffer[:end])
+            del self.buffer[:end + 1]
+            if not chunk:
+                continue
+            payload = cobs_decode(chunk)
+            frame = parse_frame(payload) if payload is not None else None
+            if frame is None:
+                self.bad += 1
+                continue
+            if self.last_sequence is not None:
+                self.lost += (frame["sequence"] - self.last_sequence - 1) & 0xFFFF
+            self.last_sequence = frame["sequence"]
+            self.frames += 1
+            yield frame
+
+
+def open_source(path):
+    """Abre a origem: entrada padrão ("-"), arquivo capturado (só leitura) ou dispositivo serial em modo bruto.
+
+    Retorna (stream, is_device). O dispositivo é aberto em leitura e escrita, para o comando bin sair pelo mesmo descritor.
+    """
+    if path == "-":
+        return sys.stdin.buffer, False
+    if not stat.S_ISCHR(os.stat(path).st_mode):
+        return open(path, "rb", buffering=0), False
+
+    import termios
+    import tty
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    try:
+        tty.setraw(fd)  # Sem eco, sem ICANON/ICRNL/ISIG e sem processamento da saída; VMIN = 1, VTIME = 0
+        termios.tcflush(fd, termios.TCIFLUSH)  # Descarta o que chegou antes do modo bruto
+    except termios.error:
+        os.close(fd)
+        raise
+    return os.fdopen(fd, "r+b", buffering=0), True
+
+
+def read_chunks(stream):
+    """Lê do dispositivo, de um arquivo ou da entrada padrão em blocos pequenos."""
+    try:
+        while True:
+            data = stream.read(4096)
+            if not data:
+                return
+            yield data
+    finally:
+        if stream is not sys.stdin.buffer:
+            stream.close()
+
+
+def summary_line(window):
+    frames = list(window)
+    if not frames:
+        return "sem quadros"
+    loop = [f["loop_us"] for f in frames]
+    late = [abs(f["lateness_us"]) for f in frames]
+    latency = [f["latency_us"] for f in frames]
+    last = frames[-1]
+    return ("%s angulo %+6.2f | vel %+7.1f (alvo %+7.1f) | comando %+5.0f%% | laco max %d us | jitter max %d us | "
+            "latencia max %d us" % ("ARMADO" if last["armed"] else "DESARMADO", last["angle_deg"], last["rate_dps"],
+                                    last["rate_setpoint_dps"], last["command_left"] * 100, max(loop), max(late), max(latency)))
+
+
+def run_plot(chunks, decoder, seconds):
+    import matplotlib.pyplot as plt
+    from matplotlib.animation import FuncAnimation
+
+    history = collections.deque(maxlen=int(seconds * 1000))
+    fig, (ax_angle, ax_command) = plt.subplots(2, 1, sharex=True)
+    angle_line, = ax_angle.plot([], [], label="angulo (graus)")
+    setpoint_line, = ax_angle.plot([], [], label="vel. desejada / 10 (graus/s)")
+    command_line, = ax_command.plot([], [], label="comando (%)")
+    ax_angle.legend(loc="upper left")
+    ax_command.legend(loc="upper left")
+    ax_command.set_xlabel("tempo (s)")
+
+    def update(_):
+        for data in chunks:
+            history.extend(decoder.feed(data))
+            break
+        if not history:
+            return angle_line, setpoint_line, command_line
+        t0 = history[-1]["timestamp_us"]
+        t = [(((f["timestamp_us"] - t0 + 2 ** 31) & 0xFFFFFFFF) - 2 ** 31) / 1e6 for f in history]  # Segundos até o último quadro
+        angle_line.set_data(t, [f["angle_deg"] for f in history])
+        setpoint_line.set_data(t, [f["rate_setpoint_dps"] / 10 for f in history])
+        command_line.set_data(t, [f["command_left"] * 100 for f in history])
+        for ax in (ax_angle, ax_command):
+            ax.relim()
+            ax.autoscale_view()
+        return angle_line, setpoint_line, command_line
+
+    _animation = FuncAnimation(fig, update, interval=50, cache_frame_data=False)
+    plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decodifica a telemetria binaria do Equilibrista")
+    parser.add_argument("source", help="dispositivo serial (ex.: /dev/ttyACM0), arquivo capturado ou - para a entrada padrao")
+    parser.add_argument("--toggle", action="store_true", help="envia o comando bin ao abrir, para ligar os quadros binarios")
+    parser.add_argument("--csv", action="store_true", help="imprime uma linha CSV por quadro")
+    parser.add_argument("--plot", action="store_true", help="grafico ao vivo (requer matplotlib)")
+    parser.add_argument("--window", type=float, default=5.0, help="segundos exibidos no grafico (padrao 5)")
+    args = parser.parse_args()
+
+    stream, is_device = open_source(args.source)
+    if args.toggle:
+        if is_device:
+            stream.write(b"bin\n")  # Já em modo bruto: o eco do terminal não volta ao firmware
+        else:
+            print("--toggle ignorado: a origem nao e um dispositivo serial", file=sys.stderr)
+
+    decoder = Decoder()
+    chunks = read_chunks(stream)
+
+    if args.plot:
+        run_plot(chunks, decoder, args.window)
+        return
+
+    if args.csv:
+        print(",".join(FIELDS))
+    window = collections.deque(maxlen=1000)
+    next_report = time.monotonic() + 1.0
+    try:
+        for data in chunks:
+            for frame in decoder.feed(data):
+                if args.csv:
+                    print(",".join(str(round(frame[k], 4)) for k in FIELDS))
+                else:
+                    window.append(frame)
+            if not args.csv and time.monotonic() >= next_report:
+                print("%s | quadros %d, perdidos %d, invalidos %d" % (summary_line(window), decoder.frames, decoder.lost, decoder.bad))
+                window.clear()
+                next_report += 1.0
+    except KeyboardInterrupt:
+        pass
+    print("Quadros: %d | perdidos (saltos de sequencia): %d | invalidos (CRC/COBS): %d" % (decoder.frames, decoder.lost, decoder.bad),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
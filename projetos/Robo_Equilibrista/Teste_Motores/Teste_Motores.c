@@ -1,8 +1,9 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
-#include "hardware/pwm.h" 
-#include "hardware/gpio.h" 
-#include "hardware/clocks.h" 
+#include "hardware/pio.h"
+#include "include/motor.h"
+#include "include/encoder.h"
+#include "include/velocidade.h"
 
 #define BUTTON_A  5 
 #define BUTTON_B  6
@@ -13,10 +14,24 @@
 #define INB2 19
 #define PWM_B 16
 #define STAND_BY 20
-#define PERIOD 2000
-#define DIVIDER_PWM 16.
-
-uint16_t pwm_val = 0;
+#define ENCODER_LEFT_A 2 // Fases A e B do encoder esquerdo (GPIO 2 e 3)
+#define ENCODER_RIGHT_A 10 // Fases A e B do encoder direito (GPIO 10 e 11)
+#define ENCODER_COUNTS_PER_REV 1440 // Contagens por volta da roda: 4 bordas x pulsos do encoder x redução (ajuste para o motor usado)
+
+#define TEST_SPEED_CPS 2880 // Velocidade do teste em malha fechada (contagens/s; 2 voltas/s com 1440 contagens por volta)
+#define SLEW_PER_S MOTOR_Q15(2.0) // De parado a 100% em 0,5 s
+#define UPDATE_MS 10 // Período da malha de velocidade
+#define VELOCITY_WINDOW 5 // Janela da estimativa de velocidade (5 x 10 ms)
+#define SPEED_KP SPEED_PI_Q16(4.0) // Ganhos do PI de velocidade (comando Q15 por contagem/s)
+#define SPEED_KI SPEED_PI_Q16(40.0)
+#define REPORT_MS 500 // Impressão das velocidades
+
+motor_driver_t motors;
+encoder_t encoders[2]; // Esquerdo e direito
+velocity_estimator_t velocities[2];
+speed_pi_t speed_pis[2];
+int32_t target = 0; // Velocidade pedida pelos botões (contagens/s)
+bool braking = true;
 
 void setup_gpios() {
 
@@ -29,72 +44,46 @@ void setup_gpios() {
     gpio_set_dir(BUTTON_B, GPIO_IN);
     gpio_pull_up(BUTTON_B); 
 
-    gpio_init(INA1);
-    gpio_set_dir(INA1, GPIO_OUT);
-
-    gpio_init(INA2);
-    gpio_set_dir(INA2, GPIO_OUT);
-
-    gpio_init(INB1);
-    gpio_set_dir(INB1, GPIO_OUT);
-
-    gpio_init(INB2);
-    gpio_set_dir(INB2, GPIO_OUT);
-
-    gpio_init(STAND_BY);
-    gpio_set_dir(STAND_BY, GPIO_OUT);
-    gpio_put(STAND_BY, 1);
-
-    gpio_init(PWM_A);
-    gpio_init(PWM_B);
-
-    gpio_set_function(PWM_A, GPIO_FUNC_PWM);
-    gpio_set_function(PWM_B, GPIO_FUNC_PWM);
-
-    uint slice_a = pwm_gpio_to_slice_num(PWM_A);
-    uint slice_b = pwm_gpio_to_slice_num(PWM_B); 
-    
-    pwm_set_clkdiv(slice_a, DIVIDER_PWM);
-    pwm_set_clkdiv(slice_b, DIVIDER_PWM);
-
-    pwm_set_wrap(slice_a, PERIOD);      
-    pwm_set_wrap(slice_b, PERIOD);
-
-    pwm_set_gpio_level(PWM_A, pwm_val);
-    pwm_set_gpio_level(PWM_B, pwm_val);
-
-    pwm_set_enabled(slice_a, true);          
-    pwm_set_enabled(slice_b, true);         
+    motor_config_t config = {
+        .left = {.in1 = INA1, .in2 = INA2, .pwm = PWM_A, .inverted = false},
+        .right = {.in1 = INB1, .in2 = INB2, .pwm = PWM_B, .inverted = false},
+        .standby_pin = STAND_BY,
+        .pwm_hz = MOTOR_PWM_HZ_DEFAULT,
+        .slew_per_s = SLEW_PER_S,
+    };
+    if (!motor_driver_init(&motors, &config)) {
+        printf("PWM_A e PWM_B precisam estar em fatias de PWM diferentes\n");
+    }
+    printf("PWM dos motores: %lu Hz, wrap %u\n", (unsigned long)motors.pwm_hz, motors.wrap);
+
+    uint encoder_pins[2] = {ENCODER_LEFT_A, ENCODER_RIGHT_A};
+    for (int i = 0; i < 2; i++) {
+        if (!encoder_init(&encoders[i], pio0, encoder_pins[i], false)) {
+            printf("Falha ao iniciar o encoder %d no PIO\n", i);
+        }
+        velocity_init(&velocities[i], VELOCITY_WINDOW);
+        speed_pi_init(&speed_pis[i], SPEED_KP, SPEED_KI);
+    }
 }
 
 void start_engines() {
 
-    pwm_val = 128 << 8;
-
     if(gpio_get(BUTTON_A) == 0) {
-
-        gpio_put(INA1, 1);
-        gpio_put(INA2, 0);
-        gpio_put(INB1, 1);
-        gpio_put(INB2, 0);
-
-        pwm_set_gpio_level(PWM_A, pwm_val);
-        pwm_set_gpio_level(PWM_B, pwm_val);
-
-        sleep_ms(100);
-
+        target = TEST_SPEED_CPS;
+        if (braking) {
+            speed_pi_reset(&speed_pis[0]);
+            speed_pi_reset(&speed_pis[1]);
+        }
+        braking = false;
     }
 }
 
 void stop_engines() {
 
     if(gpio_get(BUTTON_B) == 0) {
-
-    pwm_set_gpio_level(PWM_A, 0);
-    pwm_set_gpio_level(PWM_B, 0);
-
-    sleep_ms(100);
-
+        target = 0;
+        braking = true;
+        motor_driver_stop(&motors, MOTOR_BRAKE);
     }
 }
 
@@ -103,12 +92,35 @@ int main()
     stdio_init_all();
     setup_gpios();
 
+    absolute_time_t next_update = make_timeout_time_ms(UPDATE_MS);
+    absolute_time_t next_report = make_timeout_time_ms(REPORT_MS);
+    int32_t speed[2] = {0, 0};
+
     while (true) {
 
         start_engines();
 
         stop_engines();
 
-        sleep_ms(300);
+        // Malha de velocidade: contagem do PIO -> velocidade na janela -> PI por roda -> PWM (com a rampa do driver)
+        uint32_t now = time_us_32();
+        int32_t command[2];
+        for (int i = 0; i < 2; i++) {
+            speed[i] = velocity_update(&velocities[i], encoder_get_count(&encoders[i]), now);
+            command[i] = speed_pi_update(&speed_pis[i], target, speed[i], UPDATE_MS * 1000);
+        }
+        if (!braking) {
+            motor_driver_set(&motors, command[0], command[1], UPDATE_MS * 1000);
+        }
+
+        if (time_reached(next_report)) {
+            printf("Alvo %ld cont/s | esquerda %ld cont/s (%.2f voltas/s, comando %.0f%%) | direita %ld cont/s (%.2f voltas/s, comando %.0f%%)\n",
+                   (long)target, (long)speed[0], speed[0] / (float)ENCODER_COUNTS_PER_REV, motors.left.speed * 100.f / MOTOR_SPEED_MAX,
+                   (long)speed[1], speed[1] / (float)ENCODER_COUNTS_PER_REV, motors.right.speed * 100.f / MOTOR_SPEED_MAX);
+            next_report = make_timeout_time_ms(REPORT_MS);
+        }
+
+        sleep_until(next_update);
+        next_update = delayed_by_us(next_update, UPDATE_MS * 1000);
     }
 }
@@ -0,0 +1,22 @@
+// Verifica se a macro ENCODER_H já foi definida
+#ifndef ENCODER_H
+// Define a macro ENCODER_H para evitar múltiplas inclusões
+#define ENCODER_H
+
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+#include "hardware/pio.h" // Blocos PIO
+
+// Leitura de encoders em quadratura por PIO: uma máquina de estados por roda conta as bordas sem uso da CPU (src/quadrature_encoder.pio)
+
+// Encoder de uma roda
+typedef struct {
+    PIO pio; // Bloco PIO
+    uint sm; // Máquina de estados
+    uint pin_a; // Fase A (a fase B fica em pin_a + 1)
+    bool inverted; // Inverte o sinal da contagem (roda montada espelhada)
+} encoder_t;
+
+bool encoder_init(encoder_t *enc, PIO pio, uint pin_a, bool inverted); // Carrega o programa (uma vez por bloco, no endereço 0) e inicia uma máquina de estados livre; false se não houver máquina ou memória de instruções
+int32_t encoder_get_count(encoder_t *enc); // Contagem atual (quatro por ciclo do encoder); leva alguns ciclos de clock
+
+#endif // Fim da diretiva de inclusão condicional
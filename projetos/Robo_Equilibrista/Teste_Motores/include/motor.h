@@ -0,0 +1,62 @@
+// Verifica se a macro MOTOR_H já foi definida
+#ifndef MOTOR_H
+// Define a macro MOTOR_H para evitar múltiplas inclusões
+#define MOTOR_H
+
+#include "pico/stdlib.h" // Biblioteca padrão do Raspberry Pi Pico
+
+// Driver dos dois motores em uma ponte H dupla do tipo TB6612 (IN1/IN2 e PWM por motor, STBY comum)
+// Velocidade com sinal em Q15: -32767 a 32767 = -100% a 100% (ré a frente)
+
+#define MOTOR_Q15(x) ((int32_t)((x) * 32767.0)) // Converte uma velocidade entre -1 e 1 para Q15 (em tempo de compilação)
+#define MOTOR_SPEED_MAX 32767 // Velocidade máxima (100%)
+#define MOTOR_PWM_HZ_DEFAULT 20000 // 20 kHz: acima da faixa audível, sem o chiado do PWM de ~3,9 kHz usado em Teste_Motores
+
+// Modo de parada
+typedef enum {
+    MOTOR_COAST, // IN1 = IN2 = 0: ponte desligada, o motor gira livre até parar
+    MOTOR_BRAKE, // IN1 = IN2 = 1: terminais em curto, o motor freia
+} motor_stop_mode_t;
+
+// Pinos e ajustes de um motor
+typedef struct {
+    uint in1; // Entrada 1 da ponte (sentido)
+    uint in2; // Entrada 2 da ponte (sentido)
+    uint pwm; // Pino de PWM (cada motor precisa de uma fatia de PWM diferente)
+    bool inverted; // Inverte o sentido (motor montado espelhado)
+} motor_pins_t;
+
+// Configuração do driver
+typedef struct {
+    motor_pins_t left; // Motor esquerdo (A)
+    motor_pins_t right; // Motor direito (B)
+    uint standby_pin; // Pino STBY da ponte
+    uint32_t pwm_hz; // Frequência do PWM
+    uint32_t slew_per_s; // Variação máxima da velocidade por segundo (Q15/s; 0 = sem limite)
+} motor_config_t;
+
+// Estado de um motor
+typedef struct {
+    motor_pins_t pins;
+    uint slice; // Fatia de PWM
+    uint channel; // Canal da fatia (A ou B)
+    int32_t speed; // Velocidade aplicada (Q15), após o limite de variação
+} motor_t;
+
+// Driver dos dois motores
+typedef struct {
+    motor_t left;
+    motor_t right;
+    uint standby_pin;
+    uint16_t wrap; // Valor máximo do contador do PWM (100% = wrap + 1)
+    uint32_t pwm_hz; // Frequência obtida (pode diferir um pouco da pedida pelo arredondamento)
+    uint32_t slew_per_s;
+} motor_driver_t;
+
+bool motor_driver_init(motor_driver_t *drv, const motor_config_t *config); // Configura pinos e PWM e inicia as duas fatias no mesmo instante (motores parados, ponte habilitada); false se os dois PWMs estiverem na mesma fatia
+void motor_driver_set(motor_driver_t *drv, int32_t left, int32_t right, uint32_t dt_us); // Aproxima as velocidades (Q15) do alvo respeitando o limite de variação em dt_us e atualiza os dois motores
+void motor_driver_stop(motor_driver_t *drv, motor_stop_mode_t mode); // Para os dois motores imediatamente (ignora o limite de variação)
+void motor_driver_enable(motor_driver_t *drv, bool enabled); // Habilita ou desabilita a ponte pelo pino STBY
+uint16_t motor_speed_to_level(int32_t speed, uint16_t wrap); // Nível do PWM para o módulo da velocidade (0 a wrap + 1)
+
+#endif // Fim da diretiva de inclusão condicional
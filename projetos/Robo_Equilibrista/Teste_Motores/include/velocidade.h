@@ -0,0 +1,42 @@
+// Verifica se a macro VELOCIDADE_H já foi definida
+#ifndef VELOCIDADE_H
+// Define a macro VELOCIDADE_H para evitar múltiplas inclusões
+#define VELOCIDADE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Estimativa de velocidade a partir da contagem do encoder e controle PI de velocidade por motor, sem dependência do hardware
+// Velocidades em contagens por segundo (quatro contagens por ciclo do encoder); comando do motor em Q15, como em motor.h
+
+#define VELOCITY_WINDOW_MAX 32 // Maior janela da estimativa (amostras)
+#define SPEED_PI_Q16(x) ((int32_t)((x) * 65536.0)) // Converte uma constante para Q16 (em tempo de compilação)
+#define SPEED_PI_OUTPUT_MAX 32767 // Comando máximo (100%)
+#define SPEED_PI_DT_MAX_US 100000 // Intervalo máximo somado ao integral por chamada
+
+// Velocidade pela diferença de contagem ao longo das últimas "window" amostras
+// Janela curta: resposta rápida, mas resolução ruim em baixa velocidade (uma contagem a mais muda muito o resultado); janela longa: o contrário
+typedef struct {
+    int32_t counts[VELOCITY_WINDOW_MAX]; // Contagens das últimas amostras (buffer circular)
+    uint32_t times_us[VELOCITY_WINDOW_MAX]; // Instantes das amostras
+    uint32_t window; // Tamanho da janela (amostras)
+    uint32_t head; // Posição da próxima amostra
+    uint32_t filled; // Amostras válidas no buffer
+    int32_t velocity; // Última estimativa (contagens/s)
+} velocity_estimator_t;
+
+// PI de velocidade de um motor
+typedef struct {
+    int32_t kp; // Comando (Q15) por contagem/s de erro (Q16)
+    int32_t ki; // Comando (Q15) por contagem de erro acumulada (Q16, por segundo)
+    int64_t integral; // Termo integral (Q15·µs: dividido por 10^6 na saída, sem perder erros pequenos)
+} speed_pi_t;
+
+void velocity_init(velocity_estimator_t *ve, uint32_t window); // Configura a janela (1 a VELOCITY_WINDOW_MAX amostras) e descarta o histórico
+int32_t velocity_update(velocity_estimator_t *ve, int32_t count, uint32_t timestamp_us); // Acrescenta uma amostra e retorna a velocidade (contagens/s)
+
+void speed_pi_init(speed_pi_t *pi, int32_t kp, int32_t ki); // Configura os ganhos e zera o integral
+void speed_pi_reset(speed_pi_t *pi); // Zera o integral
+int32_t speed_pi_update(speed_pi_t *pi, int32_t target, int32_t measured, uint32_t dt_us); // Retorna o comando (Q15) para a velocidade desejada (contagens/s)
+
+#endif // Fim da diretiva de inclusão condicional
@@ -0,0 +1,40 @@
+#include "include/encoder.h" // Declarações dos encoders
+#include "quadrature_encoder.pio.h" // Programa PIO gerado pelo pioasm
+
+// Programa já carregado em cada bloco PIO
+static bool program_loaded[NUM_PIOS];
+
+// O programa salta por "mov pc, isr" para a tabela no endereço 0: precisa ser carregado exatamente ali, e as duas rodas compartilham a mesma cópia
+bool encoder_init(encoder_t *enc, PIO pio, uint pin_a, bool inverted) {
+    uint index = pio_get_index(pio);
+    if (!program_loaded[index]) {
+        if (!pio_can_add_program_at_offset(pio, &quadrature_encoder_program, 0)) {
+            return false;
+        }
+        pio_add_program_at_offset(pio, &quadrature_encoder_program, 0);
+        program_loaded[index] = true;
+    }
+
+    int sm = pio_claim_unused_sm(pio, false);
+    if (sm < 0) {
+        return false;
+    }
+
+    enc->pio = pio;
+    enc->sm = (uint)sm;
+    enc->pin_a = pin_a;
+    enc->inverted = inverted;
+    quadrature_encoder_program_init(pio, enc->sm, pin_a, 1.0f);
+    return true;
+}
+
+// A máquina de estados publica a contagem sem parar e descarta publicações com a FIFO cheia: os valores na FIFO podem ser antigos
+// Esvazia a FIFO e espera uma publicação nova (no máximo ~11 ciclos do clock da máquina de estados)
+int32_t encoder_get_count(encoder_t *enc) {
+    uint stale = pio_sm_get_rx_fifo_level(enc->pio, enc->sm);
+    while (stale-- > 0) {
+        pio_sm_get(enc->pio, enc->sm);
+    }
+    int32_t count = (int32_t)pio_sm_get_blocking(enc->pio, enc->sm);
+    return enc->inverted ? -count : count;
+}
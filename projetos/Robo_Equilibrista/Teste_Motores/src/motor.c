@@ -0,0 +1,135 @@
+#include "hardware/pwm.h" // Fatias de PWM
+#include "hardware/clocks.h" // Frequência do clock do sistema
+#include "include/motor.h" // Declarações do driver
+
+#define WRAP_MAX 65534 // O nível de 100% (wrap + 1) precisa caber em 16 bits
+
+// Configura os pinos de um motor (ponte desligada)
+static void motor_init(motor_t *motor, const motor_pins_t *pins) {
+    motor->pins = *pins;
+    motor->slice = pwm_gpio_to_slice_num(pins->pwm);
+    motor->channel = pwm_gpio_to_channel(pins->pwm);
+    motor->speed = 0;
+
+    gpio_init(pins->in1);
+    gpio_set_dir(pins->in1, GPIO_OUT);
+    gpio_put(pins->in1, 0);
+
+    gpio_init(pins->in2);
+    gpio_set_dir(pins->in2, GPIO_OUT);
+    gpio_put(pins->in2, 0);
+
+    gpio_set_function(pins->pwm, GPIO_FUNC_PWM);
+}
+
+// Nível do PWM para o módulo da velocidade: 32767 corresponde a wrap + 1 (saída sempre em nível alto)
+uint16_t motor_speed_to_level(int32_t speed, uint16_t wrap) {
+    uint32_t magnitude = speed < 0 ? -speed : speed;
+    if (magnitude > MOTOR_SPEED_MAX) {
+        magnitude = MOTOR_SPEED_MAX;
+    }
+    return (uint16_t)((magnitude * ((uint32_t)wrap + 1) + MOTOR_SPEED_MAX / 2) / MOTOR_SPEED_MAX);
+}
+
+// Escreve sentido e nível de um motor
+static void motor_apply(const motor_driver_t *drv, const motor_t *motor) {
+    bool forward = (motor->speed >= 0) != motor->pins.inverted;
+    gpio_put(motor->pins.in1, forward);
+    gpio_put(motor->pins.in2, !forward);
+    pwm_set_chan_level(motor->slice, motor->channel, motor_speed_to_level(motor->speed, drv->wrap));
+}
+
+// Aproxima a velocidade do alvo em no máximo "step"
+static int32_t slew(int32_t current, int32_t target, int32_t step) {
+    if (target > current + step) {
+        return current + step;
+    }
+    if (target < current - step) {
+        return current - step;
+    }
+    return target;
+}
+
+// Escolhe o menor divisor inteiro que mantém o wrap em 16 bits, para a maior resolução possível na frequência pedida
+bool motor_driver_init(motor_driver_t *drv, const motor_config_t *config) {
+    uint32_t pwm_hz = config->pwm_hz > 0 ? config->pwm_hz : MOTOR_PWM_HZ_DEFAULT;
+    uint32_t clock_hz = clock_get_hz(clk_sys);
+    uint32_t divider = (clock_hz / pwm_hz + WRAP_MAX) / (WRAP_MAX + 1); // ceil(clock / (f · 65535))
+    if (divider < 1) {
+        divider = 1;
+    } else if (divider > 255) {
+        divider = 255;
+    }
+    uint32_t wrap = clock_hz / (divider * pwm_hz) - 1;
+    if (wrap > WRAP_MAX) {
+        wrap = WRAP_MAX;
+    }
+
+    drv->wrap = (uint16_t)wrap;
+    drv->pwm_hz = clock_hz / (divider * (wrap + 1));
+    drv->slew_per_s = config->slew_per_s;
+    drv->standby_pin = config->standby_pin;
+
+    motor_init(&drv->left, &config->left);
+    motor_init(&drv->right, &config->right);
+    if (drv->left.slice == drv->right.slice) { // Dois canais da mesma fatia compartilham frequência e fase; este driver assume fatias separadas
+        return false;
+    }
+
+    gpio_init(drv->standby_pin);
+    gpio_set_dir(drv->standby_pin, GPIO_OUT);
+
+    pwm_config cfg = pwm_get_default_config();
+    pwm_config_set_clkdiv_int(&cfg, divider);
+    pwm_config_set_wrap(&cfg, drv->wrap);
+    pwm_init(drv->left.slice, &cfg, false);
+    pwm_init(drv->right.slice, &cfg, false);
+    pwm_set_chan_level(drv->left.slice, drv->left.channel, 0);
+    pwm_set_chan_level(drv->right.slice, drv->right.channel, 0);
+
+    // Contadores zerados e partida simultânea: os períodos das duas fatias ficam alinhados, e dois níveis escritos em sequência entram no mesmo período
+    // Só liga os bits das duas fatias (pwm_set_mask_enabled() reescreveria o registrador e desligaria buzzer, LEDs e servos)
+    hw_set_bits(&pwm_hw->en, (1u << drv->left.slice) | (1u << drv->right.slice));
+
+    gpio_put(drv->standby_pin, 1);
+    return true;
+}
+
+// Os níveis têm buffer duplo no hardware e só valem a partir do próximo início de período; escrever os dois em sequência mantém esquerdo e direito no mesmo período
+void motor_driver_set(motor_driver_t *drv, int32_t left, int32_t right, uint32_t dt_us) {
+    left = left > MOTOR_SPEED_MAX ? MOTOR_SPEED_MAX : (left < -MOTOR_SPEED_MAX ? -MOTOR_SPEED_MAX : left);
+    right = right > MOTOR_SPEED_MAX ? MOTOR_SPEED_MAX : (right < -MOTOR_SPEED_MAX ? -MOTOR_SPEED_MAX : right);
+
+    if (drv->slew_per_s > 0) {
+        uint64_t step = (uint64_t)drv->slew_per_s * dt_us / 1000000;
+        if (step > 2 * MOTOR_SPEED_MAX) {
+            step = 2 * MOTOR_SPEED_MAX;
+        }
+        left = slew(drv->left.speed, left, (int32_t)step);
+        right = slew(drv->right.speed, right, (int32_t)step);
+    }
+
+    drv->left.speed = left;
+    drv->right.speed = right;
+    motor_apply(drv, &drv->left);
+    motor_apply(drv, &drv->right);
+}
+
+// TB6612: IN1 = IN2 = 0 deixa o motor livre; IN1 = IN2 = 1 com PWM alto coloca os terminais em curto (freio)
+void motor_driver_stop(motor_driver_t *drv, motor_stop_mode_t mode) {
+    bool brake = mode == MOTOR_BRAKE;
+    uint16_t level = brake ? drv->wrap + 1 : 0;
+    motor_t *motors[2] = {&drv->left, &drv->right};
+
+    for (int i = 0; i < 2; i++) {
+        gpio_put(motors[i]->pins.in1, brake);
+        gpio_put(motors[i]->pins.in2, brake);
+        pwm_set_chan_level(motors[i]->slice, motors[i]->channel, level);
+        motors[i]->speed = 0;
+    }
+}
+
+// STBY em nível baixo desliga as duas pontes (motores livres)
+void motor_driver_enable(motor_driver_t *drv, bool enabled) {
+    gpio_put(drv->standby_pin, enabled);
+}
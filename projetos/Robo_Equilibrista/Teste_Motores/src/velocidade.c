@@ -0,0 +1,68 @@
+#include "include/velocidade.h" // Declarações da estimativa de velocidade e do PI
+
+// Configura a janela e descarta o histórico
+void velocity_init(velocity_estimator_t *ve, uint32_t window) {
+    ve->window = window < 1 ? 1 : (window > VELOCITY_WINDOW_MAX ? VELOCITY_WINDOW_MAX : window);
+    ve->head = 0;
+    ve->filled = 0;
+    ve->velocity = 0;
+}
+
+// Diferença entre a amostra atual e a amostra mais antiga da janela, dividida pelo intervalo real entre elas (tolera laço com jitter)
+int32_t velocity_update(velocity_estimator_t *ve, int32_t count, uint32_t timestamp_us) {
+    if (ve->filled > 0) {
+        uint32_t span = ve->filled < ve->window ? ve->filled : ve->window;
+        uint32_t oldest = (ve->head + VELOCITY_WINDOW_MAX - span) % VELOCITY_WINDOW_MAX;
+        uint32_t dt_us = timestamp_us - ve->times_us[oldest];
+        if (dt_us > 0) {
+            // A diferença usa aritmética modular de 32 bits: continua correta quando a contagem do encoder dá a volta
+            int32_t delta = (int32_t)((uint32_t)count - (uint32_t)ve->counts[oldest]);
+            ve->velocity = (int32_t)((int64_t)delta * 1000000 / dt_us);
+        }
+    }
+
+    ve->counts[ve->head] = count;
+    ve->times_us[ve->head] = timestamp_us;
+    ve->head = (ve->head + 1) % VELOCITY_WINDOW_MAX;
+    if (ve->filled < VELOCITY_WINDOW_MAX) {
+        ve->filled++;
+    }
+    return ve->velocity;
+}
+
+// Configura os ganhos e zera o integral
+void speed_pi_init(speed_pi_t *pi, int32_t kp, int32_t ki) {
+    pi->kp = kp;
+    pi->ki = ki;
+    speed_pi_reset(pi);
+}
+
+// Zera o integral
+void speed_pi_reset(speed_pi_t *pi) {
+    pi->integral = 0;
+}
+
+// Satura um valor no intervalo do comando
+static int32_t clamp_output(int64_t value) {
+    return value > SPEED_PI_OUTPUT_MAX ? SPEED_PI_OUTPUT_MAX : (value < -SPEED_PI_OUTPUT_MAX ? -SPEED_PI_OUTPUT_MAX : (int32_t)value);
+}
+
+// Anti-windup por integração condicional: com a saída saturada, o integral só acumula no sentido que tira da saturação
+// O integral fica em Q15·µs e só é dividido na saída: a 1 kHz, um erro pequeno (ki·e·dt abaixo de 1 em Q15) ainda acumula
+int32_t speed_pi_update(speed_pi_t *pi, int32_t target, int32_t measured, uint32_t dt_us) {
+    int32_t error = target - measured;
+    int64_t proportional = ((int64_t)pi->kp * error) >> 16;
+    uint32_t dt_integral = dt_us > SPEED_PI_DT_MAX_US ? SPEED_PI_DT_MAX_US : dt_us;
+    int64_t step = (((int64_t)pi->ki * error) * dt_integral) >> 16;
+
+    int64_t unclamped = proportional + (pi->integral + step) / 1000000;
+    bool saturated_high = unclamped > SPEED_PI_OUTPUT_MAX && step > 0;
+    bool saturated_low = unclamped < -SPEED_PI_OUTPUT_MAX && step < 0;
+    if (!saturated_high && !saturated_low) {
+        int64_t limit = (int64_t)SPEED_PI_OUTPUT_MAX * 1000000;
+        int64_t integral = pi->integral + step;
+        pi->integral = integral > limit ? limit : (integral < -limit ? -limit : integral);
+    }
+
+    return clamp_output(proportional + pi->integral / 1000000);
+}
@@ -0,0 +1,387 @@
+// Teste no computador (host) do decodificador de quadratura e da estimativa de velocidade
+// O programa src/quadrature_encoder.pio é lido e executado por um simulador de PIO (apenas as instruções que ele usa: jmp, mov, in, out e push),
+// uma instrução por ciclo, com os pinos A e B gerados por um encoder simulado; a contagem deve coincidir com a posição do encoder
+// em taxas de borda até o limite do programa. Em seguida, a estimativa de velocidade e o PI de velocidade são conferidos com um motor simulado
+//
+// Compilação e execução (a partir da pasta projetos/Robo_Equilibrista/Teste_Motores):
+//   gcc -std=c11 -O2 -I. tests/teste_encoder.c src/velocidade.c -lm -o teste_encoder && ./teste_encoder
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "include/velocidade.h"
+
+#define PIO_SOURCE "src/quadrature_encoder.pio"
+#define MAX_INSTRUCTIONS 32 // Memória de instruções de um bloco PIO
+#define MAX_LABELS 16
+#define FIFO_DEPTH 8 // FIFO de recepção unida (PIO_FIFO_JOIN_RX)
+
+// Instruções do subconjunto simulado
+typedef enum { OP_JMP, OP_JMP_X_DEC, OP_MOV, OP_IN_PINS, OP_OUT_ISR, OP_PUSH_NOBLOCK } opcode_t;
+typedef enum { REG_X, REG_ISR, REG_OSR, REG_PC } reg_t;
+
+typedef struct {
+    opcode_t op;
+    int target; // Destino do salto
+    reg_t dst, src; // Registradores do mov
+    int invert; // mov com ~
+    int bits; // Bits do in/out
+    char label[32]; // Destino do salto antes da resolução
+} instruction_t;
+
+typedef struct {
+    instruction_t code[MAX_INSTRUCTIONS];
+    int length;
+    int origin;
+    char label_names[MAX_LABELS][32];
+    int label_addresses[MAX_LABELS];
+    int labels;
+} program_t;
+
+// Máquina de estados simulada
+typedef struct {
+    uint32_t x, isr, osr;
+    int pc;
+    uint32_t fifo[FIFO_DEPTH];
+    int fifo_level;
+    uint64_t pushes_dropped;
+} sm_t;
+
+static int failures = 0;
+
+static void check(int condition, const char *message) {
+    if (!condition) {
+        printf("FALHA: %s\n", message);
+        failures++;
+    }
+}
+
+static uint32_t rng_state = 0x9E3779B9u; // Estado do gerador xorshift32
+
+static uint32_t rand_32() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static reg_t parse_reg(const char *name) {
+    if (!strcmp(name, "x")) return REG_X;
+    if (!strcmp(name, "isr")) return REG_ISR;
+    if (!strcmp(name, "osr")) return REG_OSR;
+    if (!strcmp(name, "pc")) return REG_PC;
+    fprintf(stderr, "registrador nao suportado: %s\n", name);
+    exit(2);
+}
+
+// Montador mínimo: ignora comentários, diretivas e o bloco % c-sdk; resolve os rótulos no final
+static void assemble(const char *path, program_t *prog) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "nao foi possivel abrir %s (execute a partir da pasta Teste_Motores)\n", path);
+        exit(2);
+    }
+    memset(prog, 0, sizeof(*prog));
+    prog->origin = -1;
+
+    char line[256];
+    int in_c_block = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (!strncmp(line, "% c-sdk", 7)) { in_c_block = 1; continue; }
+        if (in_c_block) { if (!strncmp(line, "%}", 2)) in_c_block = 0; continue; }
+
+        char *comment = strchr(line, ';');
+        if (comment) *comment = '\0';
+        for (char *p = line; *p; p++) if (*p == ',') *p = ' ';
+
+        char words[4][32] = {{0}};
+        int n = sscanf(line, "%31s %31s %31s %31s", words[0], words[1], words[2], words[3]);
+        if (n <= 0) continue;
+
+        if (!strcmp(words[0], ".origin")) { prog->origin = atoi(words[1]); continue; }
+        if (words[0][0] == '.') continue;
+
+        char *label = !strcmp(words[0], "public") ? words[1] : words[0];
+        size_t len = strlen(label);
+        if (label[len - 1] == ':') {
+            label[len - 1] = '\0';
+            strcpy(prog->label_names[prog->labels], label);
+            prog->label_addresses[prog->labels++] = prog->length;
+            continue;
+        }
+
+        instruction_t *ins = &prog->code[prog->length++];
+        if (!strcmp(words[0], "jmp")) {
+            if (n == 3 && !strcmp(words[1], "x--")) {
+                ins->op = OP_JMP_X_DEC;
+                strcpy(ins->label, words[2]);
+            } else {
+                ins->op = OP_JMP;
+                strcpy(ins->label, words[1]);
+            }
+        } else if (!strcmp(words[0], "mov")) {
+            ins->op = OP_MOV;
+            ins->dst = parse_reg(words[1]);
+            ins->invert = words[2][0] == '~' || words[2][0] == '!';
+            ins->src = parse_reg(words[2] + (ins->invert ? 1 : 0));
+        } else if (!strcmp(words[0], "in") && !strcmp(words[1], "pins")) {
+            ins->op = OP_IN_PINS;
+            ins->bits = atoi(words[2]);
+        } else if (!strcmp(words[0], "out") && !strcmp(words[1], "isr")) {
+            ins->op = OP_OUT_ISR;
+            ins->bits = atoi(words[2]);
+        } else if (!strcmp(words[0], "push") && !strcmp(words[1], "noblock")) {
+            ins->op = OP_PUSH_NOBLOCK;
+        } else {
+            fprintf(stderr, "instrucao nao suportada: %s\n", words[0]);
+            exit(2);
+        }
+    }
+    fclose(f);
+
+    for (int i = 0; i < prog->length; i++) {
+        instruction_t *ins = &prog->code[i];
+        if (ins->op != OP_JMP && ins->op != OP_JMP_X_DEC) continue;
+        ins->target = -1;
+        for (int l = 0; l < prog->labels; l++) {
+            if (!strcmp(prog->label_names[l], ins->label)) ins->target = prog->label_addresses[l];
+        }
+        if (ins->target < 0) {
+            fprintf(stderr, "rotulo desconhecido: %s\n", ins->label);
+            exit(2);
+        }
+    }
+}
+
+static int label_address(const program_t *prog, const char *name) {
+    for (int l = 0; l < prog->labels; l++) {
+        if (!strcmp(prog->label_names[l], name)) return prog->label_addresses[l];
+    }
+    return -1;
+}
+
+static uint32_t *reg_ptr(sm_t *sm, reg_t reg) {
+    return reg == REG_X ? &sm->x : (reg == REG_ISR ? &sm->isr : &sm->osr);
+}
+
+// Executa uma instrução (um ciclo); ISR desloca para a esquerda e OSR para a direita, como em quadrature_encoder_program_init()
+static void step(const program_t *prog, sm_t *sm, uint32_t pins) {
+    const instruction_t *ins = &prog->code[sm->pc];
+    int next = sm->pc + 1;
+
+    switch (ins->op) {
+        case OP_JMP:
+            next = ins->target;
+            break;
+        case OP_JMP_X_DEC:
+            if (sm->x != 0) next = ins->target;
+            sm->x--;
+            break;
+        case OP_MOV: {
+            uint32_t value = ins->src == REG_PC ? (uint32_t)sm->pc : *reg_ptr(sm, ins->src);
+            if (ins->invert) value = ~value;
+            if (ins->dst == REG_PC) next = (int)(value & (MAX_INSTRUCTIONS - 1));
+            else *reg_ptr(sm, ins->dst) = value;
+            break;
+        }
+        case OP_IN_PINS:
+            sm->isr = (sm->isr << ins->bits) | (pins & ((1u << ins->bits) - 1));
+            break;
+        case OP_OUT_ISR:
+            sm->isr = sm->osr & ((1u << ins->bits) - 1);
+            sm->osr >>= ins->bits;
+            break;
+        case OP_PUSH_NOBLOCK:
+            if (sm->fifo_level < FIFO_DEPTH) sm->fifo[sm->fifo_level++] = sm->isr;
+            else sm->pushes_dropped++;
+            sm->isr = 0;
+            break;
+    }
+
+    if (next >= prog->length) next = 0; // Sem .wrap: volta ao início do programa
+    sm->pc = next;
+}
+
+// Leitura como em encoder_get_count(): descarta os valores antigos da FIFO e espera uma publicação nova
+// Antes, a máquina executa alguns ciclos com os pinos parados: a última borda só entra na contagem na amostra seguinte (até 11 ciclos depois)
+static int32_t read_count(const program_t *prog, sm_t *sm, uint32_t pins) {
+    for (int c = 0; c < MAX_INSTRUCTIONS; c++) step(prog, sm, pins);
+    sm->fifo_level = 0;
+    while (sm->fifo_level == 0) step(prog, sm, pins);
+    sm->fifo_level = 0;
+    return (int32_t)sm->fifo[0];
+}
+
+// Pinos do encoder na posição p (valor B:A): 00 -> 01 -> 11 -> 10 no sentido positivo
+static uint32_t encoder_pins(int64_t position) {
+    static const uint32_t gray[4] = {0, 1, 3, 2};
+    return gray[position & 3];
+}
+
+// Inicia a máquina como quadrature_encoder_program_init(): OSR com o estado atual dos pinos e salto para "update"
+static void sm_start(const program_t *prog, sm_t *sm, uint32_t pins) {
+    memset(sm, 0, sizeof(*sm));
+    sm->isr = pins & 3;
+    sm->osr = sm->isr;
+    sm->pc = label_address(prog, "update");
+}
+
+// Gera "edges" bordas espaçadas de "spacing" ciclos (mais um jitter de até "jitter" ciclos), com inversões de sentido aleatórias
+// Retorna a diferença entre a contagem lida e a posição real
+static int64_t run_encoder(const program_t *prog, int edges, int spacing, int jitter, int64_t *final_position, uint64_t *cycles_out) {
+    sm_t sm;
+    int64_t position = 0;
+    int direction = 1;
+    sm_start(prog, &sm, encoder_pins(position));
+
+    uint64_t cycles = 0;
+    for (int e = 0; e < edges; e++) {
+        int wait = spacing + (jitter > 0 ? (int)(rand_32() % (uint32_t)(jitter + 1)) : 0);
+        for (int c = 0; c < wait; c++, cycles++) step(prog, &sm, encoder_pins(position));
+        if (rand_32() % 1000 == 0) direction = -direction; // Inversão de sentido a cada ~1000 bordas
+        position += direction;
+    }
+    int32_t count = read_count(prog, &sm, encoder_pins(position));
+
+    *final_position = position;
+    *cycles_out = cycles;
+    return (int64_t)count - position;
+}
+
+static void test_pio_program() {
+    program_t prog;
+    assemble(PIO_SOURCE, &prog);
+
+    check(prog.origin == 0, "o programa deve ter .origin 0 (tabela de saltos no endereco 0)");
+    check(prog.length <= MAX_INSTRUCTIONS, "programa maior que a memoria de instrucoes");
+    check(label_address(&prog, "update") >= 16, "a tabela deve ocupar os enderecos 0 a 15");
+    printf("Programa: %d instrucoes\n", prog.length);
+
+    // Sentido e contagem básicos: um ciclo completo para frente = +4, para trás = -4
+    sm_t sm;
+    int64_t position = 0;
+    sm_start(&prog, &sm, encoder_pins(position));
+    for (int e = 0; e < 4; e++) {
+        for (int c = 0; c < 50; c++) step(&prog, &sm, encoder_pins(position));
+        position++;
+    }
+    check(read_count(&prog, &sm, encoder_pins(position)) == 4, "um ciclo para frente deveria contar +4");
+    for (int e = 0; e < 8; e++) {
+        for (int c = 0; c < 50; c++) step(&prog, &sm, encoder_pins(position));
+        position--;
+    }
+    check(read_count(&prog, &sm, encoder_pins(position)) == -4, "dois ciclos para tras deveriam chegar a -4");
+
+    // Partida fora do estado 00 não conta borda inexistente
+    sm_start(&prog, &sm, encoder_pins(2));
+    for (int c = 0; c < 100; c++) step(&prog, &sm, encoder_pins(2));
+    check(read_count(&prog, &sm, encoder_pins(2)) == 0, "partida no estado 11 nao deveria contar");
+
+    // Varredura da taxa de bordas: 200 mil bordas por espaçamento, com jitter de até 3 ciclos e inversões aleatórias
+    int min_exact = 0;
+    printf("Espacamento (ciclos) | bordas/s a 125 MHz | erro de contagem\n");
+    for (int spacing = 40; spacing >= 6; spacing--) {
+        int64_t final_position;
+        uint64_t cycles;
+        int64_t error = run_encoder(&prog, 200000, spacing, 3, &final_position, &cycles);
+        double rate = 125e6 * 200000.0 / (double)cycles;
+        if (spacing <= 16 || spacing % 10 == 0) {
+            printf("  %2d a %2d            | %9.2f M         | %lld\n", spacing, spacing + 3, rate / 1e6, (long long)error);
+        }
+        if (error == 0) min_exact = spacing;
+        else break;
+    }
+    printf("Menor espacamento sem erro: %d ciclos (%.1f M bordas/s a 125 MHz)\n", min_exact, 125.0 / min_exact);
+    check(min_exact > 0 && min_exact <= 12, "o programa deveria contar sem erro com bordas a cada 12 ciclos");
+
+    // Contagem longa em alta velocidade: 2 milhões de bordas no sentido positivo passam de 2^21 sem perder nada
+    int64_t final_position;
+    uint64_t cycles;
+    rng_state = 12345;
+    check(run_encoder(&prog, 2000000, 16, 0, &final_position, &cycles) == 0, "contagem longa deveria ser exata");
+}
+
+// Motor simulado de primeira ordem: velocidade (contagens/s) segue comando · ganho com constante de tempo tau
+static void test_velocity_and_pi() {
+    // Velocidade constante: a janela longa reduz o erro de quantização
+    velocity_estimator_t short_window, long_window;
+    velocity_init(&short_window, 1);
+    velocity_init(&long_window, 20);
+    const double true_cps = 733.0; // Não múltiplo da taxa de amostragem: a contagem por período alterna
+    double short_error = 0, long_error = 0;
+    int n_samples = 0;
+    for (int n = 0; n < 2000; n++) {
+        uint32_t t = (uint32_t)n * 1000; // 1 kHz
+        int32_t count = (int32_t)(true_cps * t / 1e6);
+        int32_t v_short = velocity_update(&short_window, count, t);
+        int32_t v_long = velocity_update(&long_window, count, t);
+        if (n >= 20) {
+            short_error += abs(v_short - (int32_t)true_cps);
+            long_error += abs(v_long - (int32_t)true_cps);
+            n_samples++;
+        }
+    }
+    short_error /= n_samples;
+    long_error /= n_samples;
+    printf("Erro medio da velocidade a %.0f contagens/s: janela 1 = %.0f, janela 20 = %.0f contagens/s\n", true_cps, short_error, long_error);
+    check(long_error < short_error / 5, "a janela longa deveria reduzir o erro de quantizacao");
+    check(long_error < 40, "janela de 20 amostras deveria errar menos de 40 contagens/s");
+
+    // Contagem que dá a volta em 32 bits
+    velocity_estimator_t wrap;
+    velocity_init(&wrap, 4);
+    int32_t v = 0;
+    for (int n = 0; n < 10; n++) {
+        uint32_t count = 0x7FFFFF00u + (uint32_t)n * 100;
+        v = velocity_update(&wrap, (int32_t)count, (uint32_t)n * 1000);
+    }
+    check(v == 100000, "velocidade deveria continuar correta quando a contagem da a volta");
+
+    // PI fechando a malha sobre o motor simulado, com leitura pelo estimador (janela de 10 ms) a cada 10 ms
+    speed_pi_t pi;
+    speed_pi_init(&pi, SPEED_PI_Q16(4.0), SPEED_PI_Q16(40.0));
+    velocity_estimator_t ve;
+    velocity_init(&ve, 1);
+    const double gain = 8000.0 / 32767.0; // 100% de comando = 8000 contagens/s em regime
+    const double tau = 0.08; // Constante de tempo mecânica (s)
+    double speed = 0, position = 0;
+    int32_t command = 0, measured = 0;
+    const int32_t target = 3000;
+    double final_error = 0;
+    for (int n = 0; n < 300; n++) { // 3 s
+        for (int k = 0; k < 10; k++) { // Motor integrado a 1 kHz
+            speed += (command * gain - speed) * 0.001 / tau;
+            position += speed * 0.001;
+        }
+        measured = velocity_update(&ve, (int32_t)position, (uint32_t)(n + 1) * 10000);
+        command = speed_pi_update(&pi, target, measured, 10000);
+        if (n >= 200) final_error += fabs(speed - target);
+    }
+    (void)measured;
+    final_error /= 100;
+    printf("PI de velocidade: erro medio no ultimo segundo = %.1f contagens/s (alvo %d)\n", final_error, target);
+    check(final_error < 30, "o PI deveria levar a velocidade ao alvo");
+
+    // Anti-windup: alvo impossível satura o comando; ao voltar a um alvo alcançável, a resposta não fica presa na saturação
+    speed_pi_reset(&pi);
+    for (int n = 0; n < 300; n++) command = speed_pi_update(&pi, 20000, 8000, 10000);
+    check(command == SPEED_PI_OUTPUT_MAX, "alvo impossivel deveria saturar o comando");
+    check(pi.integral <= (int64_t)SPEED_PI_OUTPUT_MAX * 1000000, "integral deveria ficar limitado");
+    command = speed_pi_update(&pi, 3000, 8000, 10000);
+    check(command < SPEED_PI_OUTPUT_MAX / 2, "comando deveria sair da saturacao logo apos reduzir o alvo");
+
+    // Erro pequeno a 1 kHz: ki = 40 e 10 contagens/s de erro somam 0,4 em Q15 por iteração (antes, truncado para 0)
+    speed_pi_init(&pi, 0, SPEED_PI_Q16(40.0));
+    for (int n = 0; n < 1000; n++) command = speed_pi_update(&pi, 1010, 1000, 1000);
+    check(command >= 399 && command <= 400, "erro pequeno deveria acumular no integral (1 s: 400)");
+}
+
+int main() {
+    test_pio_program();
+    test_velocity_and_pi();
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures ? 1 : 0;
+}